@@ -20,7 +20,7 @@
 # Modified by Johannes Ring, 2011, 2012
 #
 # First added:  2010-03-26
-# Last changed: 2012-03-15
+# Last changed: 2026-10-16
 
 import os, sys, time
 
@@ -37,19 +37,23 @@ def run_bench(arg, directory, files):
     name = directory.replace("./", "").replace("/", "-")
     print "Running benchmark %s..." % name
 
-    # Remove old logfile
+    # Remove old logfile and timings
     cwd = os.getcwd()
     logfile = os.path.join(cwd, "logs", name + ".log")
-    try:
-        os.remove(logfile)
-    except:
-        pass
-
-    # Run benchmark
+    timingsfile = os.path.join(cwd, "logs", name + "-timings.json")
+    for f in [logfile, timingsfile]:
+        try:
+            os.remove(f)
+        except:
+            pass
+
+    # Run benchmark (DOLFIN writes all timings to timingsfile at exit)
     os.chdir(directory)
+    os.environ["DOLFIN_TIMINGS_FILE"] = timingsfile
     t0 = time.time()
     status = os.system(os.path.join(os.curdir, bench_exec) + " > %s" % logfile)
     elapsed_time = time.time() - t0
+    del os.environ["DOLFIN_TIMINGS_FILE"]
 
     # Change to toplevel directory
     os.chdir(cwd)
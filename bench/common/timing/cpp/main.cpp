@@ -16,7 +16,7 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2010-11-16
-// Last changed: 2010-11-16
+// Last changed: 2026-10-16
 
 #include <dolfin.h>
 
@@ -52,7 +52,27 @@ int main(int argc, char* argv[])
   }
   timer_class.stop();
 
-  summary();
+  // Test profile scope (pre-registered task)
+  const std::size_t task = Profiler::register_task("ProfileScope (inner)");
+  Timer timer_scope("ProfileScope class");
+  for (int i = 0; i < NUM_REPS; i++)
+  {
+    ProfileScope scope(task);
+  }
+  timer_scope.stop();
+
+  // Test profile scope in multi-threaded loop
+  Timer timer_threads("ProfileScope class (threads)");
+  #ifdef HAS_OPENMP
+  #pragma omp parallel for
+  #endif
+  for (int i = 0; i < NUM_REPS; i++)
+  {
+    ProfileScope scope(task);
+  }
+  timer_threads.stop();
+
+  list_timings();
 
   return 0;
 }
@@ -16,11 +16,12 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2008-07-22
-// Last changed: 2011-09-21
+// Last changed: 2026-10-16
 
 #include <string>
 #include <vector>
 #include <iostream>
+#include <boost/lexical_cast.hpp>
 #include <dolfin.h>
 #include "forms.h"
 
@@ -50,6 +51,64 @@ double reassemble_form(Form& form)
   return time() - t0;
 }
 
+double build_sparsity(Form& form)
+{
+  // Build sparsity pattern only (using current number of threads)
+  std::vector<const GenericDofMap*> dofmaps;
+  for (std::size_t i = 0; i < form.rank(); ++i)
+    dofmaps.push_back(form.function_space(i)->dofmap().get());
+  SparsityPattern pattern(0);
+  const double t0 = time();
+  SparsityPatternBuilder::build(pattern, form.mesh(), dofmaps,
+                                form.ufc_form()->has_cell_integrals(),
+                                form.ufc_form()->has_interior_facet_integrals(),
+                                form.ufc_form()->has_exterior_facet_integrals(),
+                                false);
+  return time() - t0;
+}
+
+// Global sum of traversed dofs (prevents the loop being optimised away)
+dolfin::la_index dof_checksum = 0;
+
+double traverse_dofmap(Form& form)
+{
+  // Repeatedly access all cell dofs of the test space dof map
+  const Mesh& mesh = form.mesh();
+  const GenericDofMap& dofmap = *form.function_space(0)->dofmap();
+  const std::size_t num_sweeps = 10;
+  const double t0 = time();
+  for (std::size_t k = 0; k < num_sweeps; ++k)
+  {
+    for (std::size_t i = 0; i < mesh.num_cells(); ++i)
+    {
+      const ArrayView<const dolfin::la_index> dofs = dofmap.cell_dofs(i);
+      for (std::size_t j = 0; j < dofs.size(); ++j)
+        dof_checksum += dofs[j];
+    }
+  }
+  return (time() - t0)/static_cast<double>(num_sweeps);
+}
+
+double dofmap_memory_flat(Form& form)
+{
+  // Bytes used by contiguous cell dof storage (in MB)
+  const Mesh& mesh = form.mesh();
+  const GenericDofMap& dofmap = *form.function_space(0)->dofmap();
+  std::size_t num_entries = 0;
+  for (std::size_t i = 0; i < mesh.num_cells(); ++i)
+    num_entries += dofmap.cell_dimension(i);
+  return static_cast<double>(num_entries*sizeof(dolfin::la_index))/(1024.0*1024.0);
+}
+
+double dofmap_memory_nested(Form& form)
+{
+  // Bytes that would be used with one std::vector per cell (in MB,
+  // not counting heap allocator overhead)
+  const std::size_t num_cells = form.mesh().num_cells();
+  return dofmap_memory_flat(form)
+    + static_cast<double>(num_cells*sizeof(std::vector<dolfin::la_index>))/(1024.0*1024.0);
+}
+
 int main(int argc, char* argv[])
 {
   info("Assembly for various forms and backends");
@@ -97,6 +156,9 @@ int main(int argc, char* argv[])
   Table t5("Assemble cells");
   Table t6("Overhead");
   Table t7("Reassemble total");
+  Table t8("Dofmap traversal");
+  Table t9("Dofmap memory (MB)");
+  Table t10("Build sparsity (threads)");
 
   // Benchmark assembly
   for (unsigned int i = 0; i < forms.size(); i++)
@@ -140,6 +202,30 @@ int main(int argc, char* argv[])
     }
   }
 
+  // Benchmark dof map storage and cell dof access
+  for (unsigned int i = 0; i < forms.size(); i++)
+  {
+    std::cout << "Form: " << forms[i] << std::endl;
+    t8(forms[i], "time") = bench_form(forms[i], traverse_dofmap);
+    t9(forms[i], "flat") = bench_form(forms[i], dofmap_memory_flat);
+    t9(forms[i], "nested") = bench_form(forms[i], dofmap_memory_nested);
+  }
+
+  // Benchmark building of sparsity pattern for different number of
+  // threads
+  for (unsigned int i = 0; i < forms.size(); i++)
+  {
+    std::cout << "Form: " << forms[i] << std::endl;
+    const int num_threads[4] = {0, 1, 2, 4};
+    for (unsigned int k = 0; k < 4; k++)
+    {
+      parameters["num_threads"] = num_threads[k];
+      t10(forms[i], "threads = " + boost::lexical_cast<std::string>(num_threads[k]))
+        = bench_form(forms[i], build_sparsity);
+    }
+    parameters["num_threads"] = 0;
+  }
+
   // Display results
   set_log_active(true);
   std::cout << std::endl; info(t0, true);
@@ -151,6 +237,9 @@ int main(int argc, char* argv[])
   std::cout << std::endl; info(t6, true);
   if (argc == 1)
     std::cout << std::endl; info(t7, true);
+  std::cout << std::endl; info(t8, true);
+  std::cout << std::endl; info(t9, true);
+  std::cout << std::endl; info(t10, true);
 
   /*
   // Display LaTeX tables
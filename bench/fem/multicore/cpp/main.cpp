@@ -16,7 +16,7 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2010-11-11
-// Last changed: 2012-11-02
+// Last changed: 2026-10-16
 //
 // If run without command-line arguments, this benchmark iterates from
 // zero to MAX_NUM_THREADS. If a command-line argument --num_threads n
@@ -28,6 +28,7 @@
 #include <dolfin/fem/AssemblerBase.h>
 #include "Poisson.h"
 #include "NavierStokes.h"
+#include "DGPoisson.h"
 
 #define MAX_NUM_THREADS 1
 #define SIZE 32
@@ -81,6 +82,20 @@ class NavierStokesFactory
   }
 };
 
+class DGPoissonFactory
+{
+  public:
+
+  static boost::shared_ptr<Form> a(const Mesh& mesh)
+  {
+    // Create function space (interior facet integrals dominate)
+    boost::shared_ptr<FunctionSpace> _V(new DGPoisson::FunctionSpace(mesh));
+    boost::shared_ptr<Form> _a(new DGPoisson::BilinearForm(_V, _V));
+    return _a;
+  }
+
+};
+
 double bench(std::string form, boost::shared_ptr<const Form> a)
 {
   std::size_t num_threads = parameters["num_threads"];
@@ -128,6 +143,7 @@ int main(int argc, char* argv[])
   std::vector<std::pair<std::string, boost::shared_ptr<const Form> > > forms;
   forms.push_back(std::make_pair("Poisson", PoissonFactory::a(mesh)));
   forms.push_back(std::make_pair("NavierStokes", NavierStokesFactory::a(mesh)));
+  forms.push_back(std::make_pair("DGPoisson", DGPoissonFactory::a(mesh)));
 
   // If parameter num_threads has been set, just run once
   if (parameters["num_threads"].change_count() > 0)
@@ -16,15 +16,20 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2010-06-10
-// Last changed: 2012-12-12
+// Last changed: 2026-10-16
 //
 // Description: Benchmark for the evaluations of functions at arbitrary points.
 
+#include <sstream>
 #include <dolfin.h>
 #include "P1.h"
 
 using namespace dolfin;
 
+#define SIZE 32
+#define NUM_POINTS 1000000
+#define MAX_NUM_THREADS 4
+
 class F : public Expression
 {
 public:
@@ -36,57 +41,73 @@ public:
 
 };
 
-#ifdef HAS_CGAL
-
 int main(int argc, char* argv[])
 {
   not_working_in_parallel("Function evalutation benchmark");
 
-  info("Evaluations of functions at arbitrary points.");
+  parameters.parse(argc, argv);
 
-  const std::size_t mesh_max_size = 32;
-  const std::size_t num_points  = 10000000;
-
-  // Start timing
-  tic();
-  for (std::size_t N = 10; N < mesh_max_size; N += 2)
-  {
-    UnitCubeMesh mesh(N, N, N);
+  info("Evaluations of functions at %d arbitrary points.", NUM_POINTS);
 
-    P1::FunctionSpace V0(mesh);
-    Function f0(V0);
-    F f;
-    f0.interpolate(f);
+  UnitCubeMesh mesh(SIZE, SIZE, SIZE);
+  P1::FunctionSpace V(mesh);
+  Function f(V);
+  F f_exact;
+  f.interpolate(f_exact);
 
-    Array<double> X(3);
-    Array<double> value(1);
+  // Create random points (produces same sequence each test)
+  srand(1);
+  Array<double> X(3*NUM_POINTS);
+  for (std::size_t i = 0; i < 3*NUM_POINTS; ++i)
+    X[i] = std::rand()/static_cast<double>(RAND_MAX);
 
-    // Initialize random generator generator (produces same sequence each test).
-    srand(1);
+  Table timings("Function evaluation");
 
-    for (std::size_t i = 1; i <= num_points; ++i)
+  // Evaluate point by point
+  #ifdef HAS_CGAL
+  {
+    Array<double> value(1);
+    double sum = 0.0;
+    tic();
+    for (std::size_t i = 0; i < NUM_POINTS; ++i)
     {
-      X[0] = std::rand()/static_cast<double>(RAND_MAX);
-      X[1] = std::rand()/static_cast<double>(RAND_MAX);
-      X[2] = std::rand()/static_cast<double>(RAND_MAX);
-
-      f.eval(value, X);
+      Array<double> x(3, &X[3*i]);
+      f.eval(value, x);
+      sum += value[0];
     }
-
-    // Use X variable.
-    info("x = %.12e\ty = %.12e\tz = %.12e\tf(x) = %.12e", X[0], X[1], X[2], value[0]);
+    const double t = toc();
+    timings("point by point", "time") = t;
+    info("Sum of values: %.12e", sum);
+    info("BENCH point-by-point %g", t);
   }
-  info("BENCH  %g",toc());
-
-  return 0;
-}
+  #else
+  info("DOLFIN must be compiled with CGAL to run point by point evaluation.");
+  #endif
+
+  // Evaluate batch of points, first serial and then with increasing
+  // number of threads
+  Array<double> values(NUM_POINTS);
+  for (int num_threads = 0; num_threads <= MAX_NUM_THREADS; num_threads++)
+  {
+    parameters["num_threads"] = num_threads;
+    std::stringstream s;
+    s << "batch, " << num_threads << " threads";
+
+    tic();
+    f.eval_points(values, X);
+    const double t = toc();
+    timings(s.str(), "time") = t;
+
+    double sum = 0.0;
+    for (std::size_t i = 0; i < NUM_POINTS; ++i)
+      sum += values[i];
+    info("Sum of values: %.12e", sum);
+    info("BENCH batch-%d %g", num_threads, t);
+  }
+  parameters["num_threads"] = 0;
 
-#else
+  info("");
+  info(timings, true);
 
-int main()
-{
-  info("DOLFIN must be compiled with CGAL to run function eval benchmark.");
   return 0;
 }
-
-#endif
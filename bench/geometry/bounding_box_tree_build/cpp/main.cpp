@@ -19,8 +19,12 @@
 // one call to compute_entities, which is dominated by building). The call to
 // compute_entities is included so that we may compare the timing to CGAL.
 //
+// Run with argument "refit" to measure instead the update of the tree
+// after moving the mesh vertices, or "build" to measure only building
+// of the tree. An optional second argument gives the number of threads.
+//
 // First added:  2013-04-18
-// Last changed: 2013-05-29
+// Last changed: 2026-10-16
 
 #include <vector>
 #include <dolfin.h>
@@ -56,12 +60,69 @@ void bench_dolfin()
   std::vector<unsigned int> cells = intersection.intersected_cells();
 }
 
+double bench_dolfin_build()
+{
+  cout << "Running DOLFIN build bench" << endl;
+
+  // Create mesh
+  UnitCubeMesh mesh(SIZE, SIZE, SIZE);
+
+  // Build tree
+  tic();
+  for (int i = 0; i < NUM_REPS; i++)
+  {
+    BoundingBoxTree tree;
+    tree.build(mesh);
+  }
+
+  return toc();
+}
+
+double bench_dolfin_refit()
+{
+  cout << "Running DOLFIN refit bench" << endl;
+
+  // Create mesh and tree
+  UnitCubeMesh mesh(SIZE, SIZE, SIZE);
+  BoundingBoxTree tree;
+  tree.build(mesh);
+
+  // Move mesh and update tree
+  double t = 0.0;
+  for (int i = 0; i < NUM_REPS; i++)
+  {
+    std::vector<double>& x = mesh.coordinates();
+    for (std::size_t j = 0; j < x.size(); j++)
+      x[j] *= 1.01;
+
+    tic();
+    tree.refit(mesh);
+    t += toc();
+  }
+
+  return t;
+}
+
 int main(int argc, char* argv[])
 {
   // Select which benchmark to run
   bool run_cgal = argc > 1 && strcasecmp(argv[1], "cgal") == 0;
+  bool run_build = argc > 1 && strcasecmp(argv[1], "build") == 0;
+  bool run_refit = argc > 1 && strcasecmp(argv[1], "refit") == 0;
+  parameters["num_threads"] = argc > 2 ? atoi(argv[2]) : 0;
 
   // Run benchmark
+  if (run_build)
+  {
+    info("BENCH %g", bench_dolfin_build());
+    return 0;
+  }
+  if (run_refit)
+  {
+    info("BENCH %g", bench_dolfin_refit());
+    return 0;
+  }
+
   tic();
   for (int i = 0; i < NUM_REPS; i++)
   {
@@ -15,10 +15,11 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
-// This benchmark measures the performance of compute_entity_collisions.
+// This benchmark measures the performance of compute_entity_collisions
+// (one point at a time, or batched for a list of points).
 //
 // First added:  2013-05-23
-// Last changed: 2013-05-30
+// Last changed: 2026-10-16
 
 #include <vector>
 #include <dolfin.h>
@@ -82,6 +83,34 @@ double bench_dolfin(const Mesh& mesh)
   return toc();
 }
 
+double bench_dolfin_batch(const Mesh& mesh, int num_threads)
+{
+  cout << "Running DOLFIN batch bench (" << num_threads << " threads)" << endl;
+  parameters["num_threads"] = num_threads;
+
+  // First call
+  BoundingBoxTree tree;
+  tree.build(mesh);
+  tree.compute_entity_collisions(Point(0.0, 0.0, 0.0), mesh);
+
+  // Create points (same as for single point queries)
+  std::vector<double> points(3*NUM_REPS);
+  for (int i = 0; i < NUM_REPS; i++)
+  {
+    const double x = static_cast<double>(i + 1) / static_cast<double>(NUM_REPS);
+    points[3*i]     = x;
+    points[3*i + 1] = x;
+    points[3*i + 2] = x;
+  }
+
+  // Call once for all points
+  tic();
+  std::vector<unsigned int> offsets, entities;
+  tree.compute_entity_collisions(points, mesh, offsets, entities);
+
+  return toc();
+}
+
 int main(int argc, char* argv[])
 {
   // Create mesh
@@ -89,11 +118,15 @@ int main(int argc, char* argv[])
 
   // Select which benchmark to run
   bool run_cgal = argc > 1 && strcasecmp(argv[1], "cgal") == 0;
+  bool run_batch = argc > 1 && strcasecmp(argv[1], "batch") == 0;
+  const int num_threads = argc > 2 ? atoi(argv[2]) : 0;
 
   // Run benchmark
   double t = 0.0;
   if (run_cgal)
     t = bench_cgal(mesh);
+  else if (run_batch)
+    t = bench_dolfin_batch(mesh, num_threads);
   else
     t = bench_dolfin(mesh);
 
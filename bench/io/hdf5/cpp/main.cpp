@@ -0,0 +1,138 @@
+// Copyright (C) 2026 agent
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+//
+// This benchmark measures the time for writing and reading a vector
+// and a mesh with HDF5File, for a number of settings of chunking,
+// compression and collective reads. Run with mpirun -np
+// <num_processes> to measure parallel I/O. File access settings may
+// be given on the command line, e.g. --hdf5_alignment 1048576
+// --hdf5_metadata_cache_size 8388608. The reported times are the
+// maximum over all processes.
+//
+// First added:  2026-10-16
+// Last changed: 2026-10-16
+
+#include <string>
+#include <dolfin.h>
+
+using namespace dolfin;
+
+#define NUM_REPS 3
+#define VECTOR_SIZE 16777216
+#define SIZE 32
+
+#ifdef HAS_HDF5
+
+// Set parameters of file for given setting
+void set_parameters(HDF5File& file, const std::string setting)
+{
+  if (setting == "independent")
+    file.parameters["collective_read"] = false;
+  else if (setting == "chunked")
+    file.parameters["chunking"] = true;
+  else if (setting == "chunked-large")
+  {
+    file.parameters["chunking"] = true;
+    file.parameters["chunk_size"] = 1048576;
+  }
+  else if (setting == "compressed")
+  {
+    file.parameters["compression"] = 4;
+    file.parameters["shuffle"] = true;
+  }
+}
+
+// Write and read vector and mesh, and return times for writing and
+// reading
+std::pair<double, double> bench_setting(const std::string setting,
+                                        const GenericVector& x,
+                                        const Mesh& mesh)
+{
+  const std::string filename = "bench-" + setting + ".h5";
+  double t_write = 0.0;
+  double t_read = 0.0;
+  for (int i = 0; i < NUM_REPS; i++)
+  {
+    // Write
+    MPI::barrier();
+    tic();
+    {
+      HDF5File file(filename, "w");
+      set_parameters(file, setting);
+      file.write(x, "/vector");
+      file.write(mesh, "/mesh");
+    }
+    t_write += MPI::max(toc());
+
+    // Read
+    MPI::barrier();
+    tic();
+    {
+      HDF5File file(filename, "r");
+      set_parameters(file, setting);
+      Vector y;
+      file.read(y, "/vector", false);
+      Mesh mesh_in;
+      file.read(mesh_in, "/mesh");
+    }
+    t_read += MPI::max(toc());
+  }
+
+  return std::make_pair(t_write, t_read);
+}
+
+#endif
+
+int main(int argc, char* argv[])
+{
+  #ifdef HAS_HDF5
+  parameters.parse(argc, argv);
+
+  info("Writing and reading vector of size %d and unit cube of size %d x %d x %d with HDF5 on %d processes (%d repetitions)",
+       VECTOR_SIZE, SIZE, SIZE, SIZE, MPI::num_processes(), NUM_REPS);
+
+  // Create data
+  Vector x(VECTOR_SIZE);
+  x = 1.0;
+  UnitCubeMesh mesh(SIZE, SIZE, SIZE);
+
+  // Settings (compression is not supported with MPI-IO)
+  std::vector<std::string> settings;
+  settings.push_back("default");
+  settings.push_back("chunked");
+  settings.push_back("chunked-large");
+  if (MPI::num_processes() > 1)
+    settings.push_back("independent");
+  else
+    settings.push_back("compressed");
+
+  double t = 0.0;
+  for (std::size_t i = 0; i < settings.size(); i++)
+  {
+    const std::pair<double, double> ti = bench_setting(settings[i], x, mesh);
+    info("BENCH %s-write %g", settings[i].c_str(), ti.first);
+    info("BENCH %s-read %g", settings[i].c_str(), ti.second);
+    t += ti.first + ti.second;
+  }
+
+  info("BENCH %g", t);
+  #else
+  info("DOLFIN must be configured with HDF5 to run this benchmark");
+  #endif
+
+  return 0;
+}
@@ -0,0 +1,56 @@
+// Copyright (C) 2026 agent
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+//
+// This benchmark measures the time for distributing a mesh in parallel
+// (partitioning, distribution of cells and vertices and computation of
+// shared vertices). Run with mpirun -np <num_processes> to measure the
+// distribution time versus the number of processes. The reported time
+// is the maximum over all processes.
+//
+// First added:  2026-10-16
+// Last changed: 2026-10-16
+
+#include <dolfin.h>
+
+using namespace dolfin;
+
+#define NUM_REPS 5
+#define SIZE 64
+
+int main(int argc, char* argv[])
+{
+  parameters.parse(argc, argv);
+
+  info("Distributing unit cube of size %d x %d x %d on %d processes (%d repetitions)",
+       SIZE, SIZE, SIZE, MPI::num_processes(), NUM_REPS);
+
+  double t = 0.0;
+  for (int i = 0; i < NUM_REPS; i++)
+  {
+    MPI::barrier();
+    tic();
+    UnitCubeMesh mesh(SIZE, SIZE, SIZE);
+    t += toc();
+  }
+
+  // Report timings for the stages of the distribution
+  list_timings();
+
+  info("BENCH %g", MPI::max(t));
+
+  return 0;
+}
@@ -16,8 +16,9 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2010-11-25
-// Last changed: 2012-12-12
+// Last changed: 2026-10-16
 
+#include <sstream>
 #include <dolfin.h>
 #include <dolfin/log/LogLevel.h>
 
@@ -25,31 +26,73 @@ using namespace dolfin;
 
 #define NUM_REPS 5
 #define SIZE 64
+#define MAX_NUM_THREADS 4
 
 // Use for quick testing
 //#define NUM_REPS 2
 //#define SIZE 32
 
+// Compute entities of given dimension (from scratch) and return time
+double bench_entities(Mesh& mesh, std::size_t dim)
+{
+  double t = 0.0;
+  for (int i = 0; i < NUM_REPS; i++)
+  {
+    mesh.clean();
+    tic();
+    mesh.init(dim);
+    t += toc();
+  }
+  return t/static_cast<double>(NUM_REPS);
+}
+
 int main(int argc, char* argv[])
 {
   info("Creating cell-cell connectivity for unit cube of size %d x %d x %d (%d repetitions)",
        SIZE, SIZE, SIZE, NUM_REPS);
 
-  set_log_level(DBG);
-
   parameters.parse(argc, argv);
 
   UnitCubeMesh mesh(SIZE, SIZE, SIZE);
   const int D = mesh.topology().dim();
 
+  set_log_level(DBG);
   for (int i = 0; i < NUM_REPS; i++)
   {
     mesh.clean();
     mesh.init(D, D);
     dolfin::cout << "Created unit cube: " << mesh << dolfin::endl;
   }
+  set_log_level(INFO);
 
   summary();
 
+  // Time creation of edges and faces, first serial and then with
+  // increasing number of threads
+  Table timings("Compute entities");
+  Table speedups("Speedups");
+  for (int num_threads = 0; num_threads <= MAX_NUM_THREADS; num_threads++)
+  {
+    parameters["num_threads"] = num_threads;
+    std::stringstream s;
+    s << num_threads << " threads";
+
+    const double t1 = bench_entities(mesh, 1);
+    const double t2 = bench_entities(mesh, 2);
+    timings(s.str(), "edges") = t1;
+    timings(s.str(), "faces") = t2;
+    speedups(s.str(), "edges") = timings.get_value("0 threads", "edges") / t1;
+    speedups(s.str(), "faces") = timings.get_value("0 threads", "faces") / t2;
+
+    info("BENCH edges-%d %g", num_threads, t1);
+    info("BENCH faces-%d %g", num_threads, t2);
+  }
+  parameters["num_threads"] = 0;
+
+  info("");
+  info(timings, true);
+  info("");
+  info(speedups, true);
+
   return 0;
 }
@@ -0,0 +1,172 @@
+// Copyright (C) 2026 agent
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+//
+// This benchmark measures the time for computing barycenter
+// quadrature rules for the intersections of the cells of a unit cube
+// (square) mesh and the cells of a translated copy of the mesh,
+// using floating-point clipping of the simplices and, if DOLFIN is
+// configured with CGAL, exact intersection of Nef polyhedra. The
+// translations include the degenerate case of coinciding meshes.
+//
+// First added:  2026-10-16
+// Last changed: 2026-10-16
+
+#include <vector>
+#include <dolfin.h>
+
+#ifdef HAS_CGAL
+#include <CGAL/Polyhedron_3.h>
+#endif
+
+using namespace dolfin;
+
+#define NUM_REPS 10
+#define SIZE_3D 8
+#define SIZE_2D 64
+#define SIZE_EXACT_3D 2
+
+typedef std::vector<std::vector<Point> > Simplices;
+
+// Extract vertex coordinates of cells of mesh, translated by given point
+Simplices simplices(const Mesh& mesh, const Point& translation)
+{
+  Simplices s(mesh.num_cells());
+  for (CellIterator cell(mesh); !cell.end(); ++cell)
+    for (VertexIterator vertex(*cell); !vertex.end(); ++vertex)
+      s[cell->index()].push_back(vertex->point() + translation);
+  return s;
+}
+
+// Compute quadrature rules for intersections of all pairs of simplices
+// and return total volume
+double intersect(const Simplices& s0, const Simplices& s1)
+{
+  double volume = 0.0;
+  for (std::size_t i = 0; i < s0.size(); i++)
+  {
+    for (std::size_t j = 0; j < s1.size(); j++)
+    {
+      BarycenterQuadrature quadrature(s0[i], s1[j]);
+      for (std::size_t k = 0; k < quadrature.size(); k++)
+        volume += quadrature.weights()[k];
+    }
+  }
+  return volume;
+}
+
+// Run floating-point benchmark for given meshes and translations
+double bench_float(const Mesh& mesh, const std::vector<Point>& translations)
+{
+  const Simplices s0 = simplices(mesh, Point());
+  double t = 0.0;
+  for (std::size_t i = 0; i < translations.size(); i++)
+  {
+    const Simplices s1 = simplices(mesh, translations[i]);
+    double volume = 0.0;
+    tic();
+    for (int j = 0; j < NUM_REPS; j++)
+      volume = intersect(s0, s1);
+    t += toc();
+    info("Volume of intersection %d: %g", i, volume);
+  }
+  return t;
+}
+
+#ifdef HAS_CGAL
+
+// Create Nef polyhedron for tetrahedron
+Nef_polyhedron_3 make_polyhedron(const std::vector<Point>& s)
+{
+  std::vector<Kernel::Point_3> p;
+  for (std::size_t i = 0; i < s.size(); i++)
+    p.push_back(Kernel::Point_3(s[i].x(), s[i].y(), s[i].z()));
+  CGAL::Polyhedron_3<Kernel> polyhedron;
+  polyhedron.make_tetrahedron(p[0], p[1], p[2], p[3]);
+  return Nef_polyhedron_3(polyhedron);
+}
+
+// Run exact benchmark for given meshes and translations
+double bench_exact(const Mesh& mesh, const std::vector<Point>& translations)
+{
+  const Simplices s0 = simplices(mesh, Point());
+  double t = 0.0;
+  for (std::size_t i = 0; i < translations.size(); i++)
+  {
+    const Simplices s1 = simplices(mesh, translations[i]);
+    double volume = 0.0;
+    tic();
+    for (std::size_t j = 0; j < s0.size(); j++)
+    {
+      for (std::size_t k = 0; k < s1.size(); k++)
+      {
+        const Nef_polyhedron_3 p = make_polyhedron(s0[j])*make_polyhedron(s1[k]);
+        BarycenterQuadrature quadrature(p);
+        for (std::size_t l = 0; l < quadrature.size(); l++)
+          volume += quadrature.weights()[l];
+      }
+    }
+    t += toc();
+    info("Volume of intersection %d (exact): %g", i, volume);
+  }
+  return t;
+}
+
+#endif
+
+// Translations of meshes relative to cell size h (coinciding,
+// shifted along an axis and shifted in a general direction)
+std::vector<Point> translations(double h, std::size_t dim)
+{
+  std::vector<Point> t;
+  t.push_back(Point(0.0, 0.0, 0.0));
+  t.push_back(Point(0.5*h, 0.0, 0.0));
+  t.push_back(Point(0.3*h, 0.2*h, dim == 3 ? 0.1*h : 0.0));
+  return t;
+}
+
+int main()
+{
+  // Tetrahedra
+  UnitCubeMesh cube(SIZE_3D, SIZE_3D, SIZE_3D);
+  info("Intersecting %d x %d tetrahedra (%d repetitions)",
+       cube.num_cells(), cube.num_cells(), NUM_REPS);
+  const double t_3d = bench_float(cube, translations(1.0/SIZE_3D, 3));
+  info("BENCH float-3D %g", t_3d);
+
+  // Triangles
+  UnitSquareMesh square(SIZE_2D, SIZE_2D);
+  info("Intersecting %d x %d triangles (%d repetitions)",
+       square.num_cells(), square.num_cells(), NUM_REPS);
+  const double t_2d = bench_float(square, translations(1.0/SIZE_2D, 2));
+  info("BENCH float-2D %g", t_2d);
+
+  info("BENCH %g", t_3d + t_2d);
+
+  // Exact intersections (for comparison, on a smaller mesh)
+  #ifdef HAS_CGAL
+  UnitCubeMesh small_cube(SIZE_EXACT_3D, SIZE_EXACT_3D, SIZE_EXACT_3D);
+  info("Intersecting %d x %d tetrahedra (float and exact)",
+       small_cube.num_cells(), small_cube.num_cells());
+  const std::vector<Point> t = translations(1.0/SIZE_EXACT_3D, 3);
+  info("BENCH float-3D-small %g", bench_float(small_cube, t)/NUM_REPS);
+  info("BENCH exact-3D-small %g", bench_exact(small_cube, t));
+  #else
+  info("DOLFIN must be configured with CGAL to compare with exact intersection");
+  #endif
+
+  return 0;
+}
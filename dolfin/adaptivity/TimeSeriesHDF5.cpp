@@ -16,7 +16,7 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2013-04-10
-// Last changed: 2013-05-09
+// Last changed: 2026-10-16
 
 #ifdef HAS_HDF5
 
@@ -24,72 +24,24 @@
 #include <iostream>
 #include <sstream>
 #include <boost/lexical_cast.hpp>
-#include <boost/scoped_ptr.hpp>
 
 #include <dolfin/log/LogStream.h>
 #include <dolfin/common/constants.h>
+#include <dolfin/common/MPI.h>
 #include <dolfin/io/File.h>
 #include <dolfin/io/HDF5File.h>
 #include <dolfin/io/HDF5Interface.h>
 #include <dolfin/la/GenericVector.h>
-#include <dolfin/la/GenericLinearAlgebraFactory.h>
 
 #include "TimeSeriesHDF5.h"
 
 using namespace dolfin;
 
-// Template function for storing objects
-template <typename T>
-void TimeSeriesHDF5::store_object(const T& object, double t,
-                                  std::vector<double>& times,
-                                  std::string series_name,
-                                  std::string group_name)
-{
-  // Write object
-
-  // Check for pre-existing file to append to
-  std::string mode = "w";
-  if(File::exists(series_name) &&
-     (_vector_times.size() > 0 || _mesh_times.size() > 0))
-    mode = "a";
-
-  // Get file handle for low level operations
-  HDF5File hdf5_file(series_name, mode);
-  const hid_t fid = hdf5_file.hdf5_file_id;
-
-  // Find existing datasets (should be equal to number of times)
-  std::size_t nobjs = 0;
-  if(HDF5Interface::has_group(fid, group_name))
-    nobjs = HDF5Interface::num_datasets_in_group(fid, group_name);
-
-  dolfin_assert(nobjs == times.size());
-
-  // Write new dataset (mesh or vector)
-  std::string dataset_name = group_name + "/"
-    + boost::lexical_cast<std::string>(nobjs);
-  hdf5_file.write(object, dataset_name);
-
-  // Check that time values are strictly increasing
-  const std::size_t n = times.size();
-  if (n >= 2 and (times[n - 1] - times[n - 2])*(t - times[n - 1]) < 0.0)
-  {
-    dolfin_error("TimeSeries.cpp",
-                 "store object to time series",
-                 "Sample points must be strictly monotone (t_0 = %g, t_1 = %g, t_2 = %g)",
-                 times[n - 2], times[n - 1], t);
-  }
-
-  // Add time
-  times.push_back(t);
-
-  // Store times
-  HDF5Interface::add_attribute(fid, group_name, "times", times);
-
-}
-
 //-----------------------------------------------------------------------------
 TimeSeriesHDF5::TimeSeriesHDF5(std::string name) : _name(name + ".h5"),
-  _cleared(false)
+  _cleared(false), _vector_datasets(false),
+  _cache_rows(0, 0),
+  _cache_range(0, 0)
 {
   // Set default parameters
   parameters = default_parameters();
@@ -97,23 +49,39 @@ TimeSeriesHDF5::TimeSeriesHDF5(std::string name) : _name(name + ".h5"),
   if (File::exists(_name))
   {
     // Read from file
-    const hid_t hdf5_file_id = HDF5Interface::open_file(_name, "r", true);
+    const HDF5File hdf5_file(_name, "r");
+    const hid_t hdf5_file_id = hdf5_file.hdf5_file_id;
+
+    if (HDF5Interface::has_dataset(hdf5_file_id, "/Vector/times"))
+    {
+      const std::size_t num_samples
+        = HDF5Interface::get_dataset_size(hdf5_file_id, "/Vector/times")[0];
+      HDF5Interface::read_rows(hdf5_file_id, "/Vector/times",
+                               std::make_pair(0, num_samples),
+                               std::make_pair(0, 1), _vector_times,
+                               hdf5_file.mpi_io);
+    }
+    else if (HDF5Interface::has_group(hdf5_file_id, "/Vector") &&
+             HDF5Interface::has_attribute(hdf5_file_id, "/Vector", "times"))
+    {
+      // Old format: one dataset /Vector/<i> per sample
+      HDF5Interface::get_attribute(hdf5_file_id, "/Vector", "times",
+                                   _vector_times);
+      _vector_datasets = true;
+    }
 
-    if(HDF5Interface::has_group(hdf5_file_id, "/Vector") &&
-       HDF5Interface::has_attribute(hdf5_file_id, "/Vector", "times"))
+    if (!_vector_times.empty())
+    {
+      log(PROGRESS, "Found %d vector sample(s) in time series.",
+          _vector_times.size());
+      if (!monotone(_vector_times))
       {
-        HDF5Interface::get_attribute(hdf5_file_id, "/Vector", "times",
-                                     _vector_times);
-        log(PROGRESS, "Found %d vector sample(s) in time series.",
-            _vector_times.size());
-        if (!monotone(_vector_times))
-        {
-          dolfin_error("TimeSeriesHDF5.cpp",
-                       "read time series from file",
-                       "Sample points for vector data are not strictly monotone in series \"%s\"",
-                       name.c_str());
-        }
+        dolfin_error("TimeSeriesHDF5.cpp",
+                     "read time series from file",
+                     "Sample points for vector data are not strictly monotone in series \"%s\"",
+                     name.c_str());
       }
+    }
 
     if(HDF5Interface::has_group(hdf5_file_id, "/Mesh") &&
        HDF5Interface::has_attribute(hdf5_file_id, "/Mesh", "times"))
@@ -130,8 +98,6 @@ TimeSeriesHDF5::TimeSeriesHDF5(std::string name) : _name(name + ".h5"),
                      name.c_str());
       }
     }
-
-    HDF5Interface::close_file(hdf5_file_id);
   }
   else
     log(PROGRESS, "No samples found in time series.");
@@ -140,7 +106,7 @@ TimeSeriesHDF5::TimeSeriesHDF5(std::string name) : _name(name + ".h5"),
 //-----------------------------------------------------------------------------
 TimeSeriesHDF5::~TimeSeriesHDF5()
 {
-  // Do nothing (keep files)
+  // Do nothing (files are kept)
 }
 //-----------------------------------------------------------------------------
 void TimeSeriesHDF5::store(const GenericVector& vector, double t)
@@ -150,9 +116,41 @@ void TimeSeriesHDF5::store(const GenericVector& vector, double t)
   if (!_cleared && clear_on_write)
     clear();
 
-  // Store object
-  store_object(vector, t, _vector_times, _name, "/Vector");
+  // Vectors stored in the old format cannot be appended to
+  if (_vector_datasets)
+  {
+    dolfin_error("TimeSeriesHDF5.cpp",
+                 "store vector to time series",
+                 "Time series \"%s\" stores vectors in an old format, which cannot be appended to (set parameter \"clear_on_write\" to overwrite the series)",
+                 _name.c_str());
+  }
+
+  // Check that time values are strictly monotone
+  check_monotone(t, _vector_times);
+
+  HDF5File hdf5_file(_name, file_mode());
+  const hid_t fid = hdf5_file.hdf5_file_id;
 
+  // Check that there is one stored vector for each time
+  dolfin_assert(!HDF5Interface::has_dataset(fid, "/Vector/values")
+                || HDF5Interface::get_dataset_size(fid, "/Vector/values")[0]
+                   == _vector_times.size());
+
+  // Append values as a new row of the vector dataset
+  std::vector<double> values;
+  vector.get_local(values);
+  const int compression = parameters["compression"];
+  HDF5Interface::append_row(fid, "/Vector/values", values,
+                            vector.local_range(), vector.size(),
+                            hdf5_file.mpi_io, compression);
+
+  // Append time (written by process 0)
+  const bool root = MPI::process_number() == 0;
+  const std::vector<double> time(root ? 1 : 0, t);
+  HDF5Interface::append_row(fid, "/Vector/times", time,
+                            std::make_pair(root ? 0 : 1, 1), 1,
+                            hdf5_file.mpi_io, 0);
+  _vector_times.push_back(t);
 }
 //-----------------------------------------------------------------------------
 void TimeSeriesHDF5::store(const Mesh& mesh, double t)
@@ -162,53 +160,78 @@ void TimeSeriesHDF5::store(const Mesh& mesh, double t)
   if (!_cleared && clear_on_write)
     clear();
 
-  // Store object
-  store_object(mesh, t, _mesh_times, _name, "/Mesh");
+  // Check that time values are strictly monotone
+  check_monotone(t, _mesh_times);
+
+  HDF5File hdf5_file(_name, file_mode());
+  const hid_t fid = hdf5_file.hdf5_file_id;
+
+  // Find existing datasets (should be equal to number of times)
+  std::size_t nobjs = 0;
+  if (HDF5Interface::has_group(fid, "/Mesh"))
+    nobjs = HDF5Interface::num_datasets_in_group(fid, "/Mesh");
+  dolfin_assert(nobjs == _mesh_times.size());
 
+  // Write new mesh
+  hdf5_file.write(mesh, "/Mesh/" + boost::lexical_cast<std::string>(nobjs));
+
+  // Add and store times
+  _mesh_times.push_back(t);
+  HDF5Interface::add_attribute(fid, "/Mesh", "times", _mesh_times);
 }
 //-----------------------------------------------------------------------------
 void TimeSeriesHDF5::retrieve(GenericVector& vector, double t,
                               bool interpolate) const
 {
-  HDF5File hdf5_file(_name, "r");
-  const std::size_t zero = 0;
-  vector.resize(1,&zero);
-
-  // Interpolate value
+  // Find closest pair (interpolation) or closest index
+  std::pair<std::size_t, std::size_t> index_pair;
   if (interpolate)
+    index_pair = find_closest_pair(t, _vector_times, _name, "vector");
+  else
+  {
+    const std::size_t index = find_closest_index(t, _vector_times, _name,
+                                                 "vector");
+    index_pair = std::make_pair(index, index);
+  }
+  const std::size_t i0 = index_pair.first;
+  const std::size_t i1 = index_pair.second;
+
+  // Open file (closed when done, so the series does not hold on to
+  // the file between calls)
+  const HDF5File hdf5_file(_name, "r");
+
+  // Resize vector if it does not match the stored vectors
+  const std::size_t N = _vector_datasets ?
+    HDF5Interface::get_dataset_size(hdf5_file.hdf5_file_id,
+                                    vector_dataset(i0))[0] :
+    HDF5Interface::get_dataset_size(hdf5_file.hdf5_file_id,
+                                    "/Vector/values")[1];
+  if (vector.size() != N)
+    vector.resize(MPI::local_range(N));
+
+  // Read values (unless already cached)
+  const std::pair<std::size_t, std::size_t> range = vector.local_range();
+  prefetch(hdf5_file, i0, i1, range);
+  const std::size_t n = range.second - range.first;
+  const double* x0 = cached_values(i0);
+
+  // Special case: same index
+  if (i0 == i1)
   {
-    // Find closest pair
-    const std::pair<std::size_t, std::size_t> index_pair
-      = find_closest_pair(t, _vector_times, _name, "vector");
-    const std::size_t i0 = index_pair.first;
-    const std::size_t i1 = index_pair.second;
-
-    // Special case: same index
-    if (i0 == i1)
+    if (interpolate)
+      log(PROGRESS, "Reading vector value at t = %g.", _vector_times[i0]);
+    else
     {
-      hdf5_file.read(vector, "/Vector/" + boost::lexical_cast<std::string>(i0));
-      log(PROGRESS, "Reading vector value at t = %g.", _vector_times[0]);
-      return;
+      log(PROGRESS, "Reading vector at t = %g (close to t = %g).",
+          _vector_times[i0], t);
     }
-
+    _values.assign(x0, x0 + n);
+  }
+  else
+  {
     log(PROGRESS, "Interpolating vector value at t = %g in interval [%g, %g].",
         t, _vector_times[i0], _vector_times[i1]);
 
-    // Read vectors
-    GenericVector& x0(vector);
-    boost::shared_ptr<GenericVector> x1 = x0.factory().create_vector();
-    hdf5_file.read(x0, "/Vector/" + boost::lexical_cast<std::string>(i0));
-    hdf5_file.read(*x1, "/Vector/" + boost::lexical_cast<std::string>(i1));
-
-    // Check that the vectors have the same size
-    if (x0.size() != x1->size())
-    {
-      dolfin_error("TimeSeries.cpp",
-                   "interpolate vector value in time series",
-                   "Vector sizes don't match (%d and %d)",
-                   x0.size(), x1->size());
-    }
-
     // Compute weights for linear interpolation
     const double dt = _vector_times[i1] - _vector_times[i0];
     dolfin_assert(std::abs(dt) > DOLFIN_EPS);
@@ -216,24 +239,14 @@ void TimeSeriesHDF5::retrieve(GenericVector& vector, double t,
     const double w1 = 1.0 - w0;
 
     // Interpolate
-    x0 *= w0;
-    x0.axpy(w1, *x1);
+    const double* x1 = cached_values(i1);
+    _values.resize(n);
+    for (std::size_t i = 0; i < n; ++i)
+      _values[i] = w0*x0[i] + w1*x1[i];
   }
 
-  // Read closest value
-  else
-  {
-    // Find closest index
-    const std::size_t index = find_closest_index(t, _vector_times, _name,
-                                                 "vector");
-
-    log(PROGRESS, "Reading vector at t = %g (close to t = %g).",
-        _vector_times[index], t);
-
-    // Read vector
-    hdf5_file.read(vector, "/Vector/"
-                   + boost::lexical_cast<std::string>(index));
-  }
+  vector.set_local(_values);
+  vector.apply("insert");
 }
 //-----------------------------------------------------------------------------
 void TimeSeriesHDF5::retrieve(Mesh& mesh, double t) const
@@ -247,7 +260,6 @@ void TimeSeriesHDF5::retrieve(Mesh& mesh, double t) const
   // Read mesh
   HDF5File hdf5_file(_name, "r");
   hdf5_file.read(mesh, "/Mesh/" + boost::lexical_cast<std::string>(index));
-
 }
 //-----------------------------------------------------------------------------
 std::vector<double> TimeSeriesHDF5::vector_times() const
@@ -265,6 +277,11 @@ void TimeSeriesHDF5::clear()
   _vector_times.clear();
   _mesh_times.clear();
   _cleared = true;
+  _vector_datasets = false;
+
+  // Drop cached values, the file is recreated when values are stored
+  _cache.clear();
+  _cache_rows = std::make_pair(0, 0);
 }
 //-----------------------------------------------------------------------------
 std::string TimeSeriesHDF5::str(bool verbose) const
@@ -296,6 +313,99 @@ std::string TimeSeriesHDF5::str(bool verbose) const
   return s.str();
 }
 //-----------------------------------------------------------------------------
+std::string TimeSeriesHDF5::file_mode() const
+{
+  // Append if values have been stored, otherwise (re)create file
+  if (File::exists(_name) &&
+      (_vector_times.size() > 0 || _mesh_times.size() > 0))
+  {
+    return "a";
+  }
+  return "w";
+}
+//-----------------------------------------------------------------------------
+void TimeSeriesHDF5::prefetch(const HDF5File& hdf5_file,
+                              std::size_t i0, std::size_t i1,
+                              std::pair<std::size_t, std::size_t> range) const
+{
+  // Check if samples are already cached
+  if (range == _cache_range && _cache_rows.first <= i0
+      && i1 < _cache_rows.second)
+  {
+    return;
+  }
+
+  // Size of window of samples to read
+  const int prefetch_steps = parameters["prefetch_steps"];
+  const std::size_t window = std::max((std::size_t) std::max(prefetch_steps, 1),
+                                      i1 - i0 + 1);
+
+  // Extend window in the direction of the sweep through the series,
+  // i.e. backward if moving towards earlier samples or (initially)
+  // if starting from the last sample
+  const std::size_t num_samples = _vector_times.size();
+  const bool backward = _cache_rows.second > _cache_rows.first ?
+    i0 < _cache_rows.first : i1 + 1 == num_samples;
+  std::pair<std::size_t, std::size_t> rows;
+  if (backward)
+  {
+    rows.second = i1 + 1;
+    rows.first = rows.second > window ? rows.second - window : 0;
+  }
+  else
+  {
+    rows.first = i0;
+    rows.second = std::min(num_samples, i0 + window);
+  }
+
+  // Read samples
+  if (_vector_datasets)
+  {
+    const std::size_t n = range.second - range.first;
+    _cache.resize((rows.second - rows.first)*n);
+    std::vector<double> values;
+    for (std::size_t i = rows.first; i < rows.second; i++)
+    {
+      HDF5Interface::read_dataset(hdf5_file.hdf5_file_id, vector_dataset(i),
+                                  range, values);
+      dolfin_assert(values.size() == n);
+      std::copy(values.begin(), values.end(),
+                _cache.begin() + (i - rows.first)*n);
+    }
+  }
+  else
+  {
+    HDF5Interface::read_rows(hdf5_file.hdf5_file_id, "/Vector/values",
+                             rows, range, _cache, hdf5_file.mpi_io);
+  }
+  _cache_rows = rows;
+  _cache_range = range;
+}
+//-----------------------------------------------------------------------------
+std::string TimeSeriesHDF5::vector_dataset(std::size_t i)
+{
+  return "/Vector/" + boost::lexical_cast<std::string>(i);
+}
+//-----------------------------------------------------------------------------
+const double* TimeSeriesHDF5::cached_values(std::size_t i) const
+{
+  dolfin_assert(_cache_rows.first <= i && i < _cache_rows.second);
+  const std::size_t n = _cache_range.second - _cache_range.first;
+  return _cache.data() + (i - _cache_rows.first)*n;
+}
+//-----------------------------------------------------------------------------
+void TimeSeriesHDF5::check_monotone(double t, const std::vector<double>& times)
+{
+  const std::size_t n = times.size();
+  if (n >= 2 and (times[n - 1] - times[n - 2])*(t - times[n - 1]) < 0.0)
+  {
+    dolfin_error("TimeSeriesHDF5.cpp",
+                 "store object to time series",
+                 "Sample points must be strictly monotone (t_0 = %g, t_1 = %g, t_2 = %g)",
+                 times[n - 2], times[n - 1], t);
+  }
+}
+//-----------------------------------------------------------------------------
 bool TimeSeriesHDF5::monotone(const std::vector<double>& times)
 {
   // If size of time series is 0 or 1 they are always monotone
@@ -16,7 +16,7 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2009-11-11
-// Last changed: 2013-05-09
+// Last changed: 2026-10-16
 
 #ifndef __TIME_SERIES_HDF5_H
 #define __TIME_SERIES_HDF5_H
@@ -24,6 +24,7 @@
 #ifdef HAS_HDF5
 
 #include <string>
+#include <utility>
 #include <vector>
 #include <dolfin/common/Variable.h>
 
@@ -32,6 +33,7 @@ namespace dolfin
 
   // Forward declarations
   class GenericVector;
+  class HDF5File;
   class Mesh;
 
   /// This class stores a time series of objects to file(s) in a
@@ -44,6 +46,17 @@ namespace dolfin
   /// file before (for a series with the same name) and in that
   /// case reuse those values. If new values are stored, old
   /// values will be cleared.
+  ///
+  /// All vectors are stored as the rows of a single chunked (and
+  /// optionally compressed) HDF5 dataset. The file is only open
+  /// while values are stored or retrieved, so several time series may
+  /// refer to the same file (but not write to it at the same time).
+  /// When vectors are retrieved, a
+  /// window of neighbouring samples (in the direction of the sweep
+  /// through the series) is read at once and cached, such that a
+  /// forward or reverse sweep in time reads each sample only once.
+  /// Time series stored in the old format (one dataset per vector)
+  /// can still be read, but not appended to.
 
   class TimeSeriesHDF5 : public Variable
   {
@@ -124,16 +137,29 @@ namespace dolfin
     {
       Parameters p("time_series");
       p.add("clear_on_write", true);
+      p.add("compression", 0, 0, 9);
+      p.add("prefetch_steps", 8);
       return p;
     }
 
   private:
 
-    template <typename T>
-    void store_object(const T& object, double t,
-                      std::vector<double>& times,
-                      std::string series_name,
-                      std::string group_name);
+    // Return mode for opening file for writing (append or create)
+    std::string file_mode() const;
+
+    // Read vector samples i0 to i1 (inclusive) and neighbouring
+    // samples from file into cache, unless already cached
+    void prefetch(const HDF5File& hdf5_file, std::size_t i0, std::size_t i1,
+                  std::pair<std::size_t, std::size_t> range) const;
+
+    // Return name of dataset for vector sample (old format)
+    static std::string vector_dataset(std::size_t i);
+
+    // Return cached values of vector sample
+    const double* cached_values(std::size_t i) const;
+
+    // Check that times remain strictly monotone when adding t
+    static void check_monotone(double t, const std::vector<double>& times);
 
     // Check if values are strictly increasing
     static bool monotone(const std::vector<double>& times);
@@ -159,6 +185,18 @@ namespace dolfin
     // True if series has been cleared
     bool _cleared;
 
+    // True if vectors are stored in the old format (one dataset per
+    // sample), which may be read but not appended to
+    bool _vector_datasets;
+
+    // Cached vector samples (rows) and local range of cached values
+    mutable std::vector<double> _cache;
+    mutable std::pair<std::size_t, std::size_t> _cache_rows;
+    mutable std::pair<std::size_t, std::size_t> _cache_range;
+
+    // Work array for interpolated values
+    mutable std::vector<double> _values;
+
   };
 
 }
@@ -16,15 +16,206 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // Modified by Anders Logg 2011
+// Modified by agent, 2026
 //
 // First added:  2010-10-11
-// Last changed: 2011-11-12
+// Last changed: 2026-10-16
 
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#ifdef HAS_OPENMP
+#include <omp.h>
+#endif
+
+#include <dolfin/common/MPI.h>
 #include <dolfin/la/Vector.h>
+#include <dolfin/log/log.h>
 #include <dolfin/mesh/Mesh.h>
 #include <dolfin/mesh/MeshFunction.h>
+#include <dolfin/parameter/GlobalParameters.h>
 #include "marking.h"
 
+// Number of buckets used in each step of the threshold search
+static const std::size_t num_buckets = 256;
+
+// Number of remaining candidates (over all processes) below which the
+// threshold search gathers and sorts the candidates
+static const std::size_t max_num_gathered = 4096;
+
+//-----------------------------------------------------------------------------
+// Mark all cells with indicator greater than or equal to threshold
+static void mark_threshold(dolfin::MeshFunction<bool>& markers,
+                           const dolfin::MeshFunction<double>& indicators,
+                           double threshold)
+{
+  dolfin_assert(markers.size() == indicators.size());
+  const int num_cells = indicators.size();
+  const double* eta = indicators.values();
+  bool* marked = markers.values();
+
+  const std::size_t num_threads = dolfin::parameters["num_threads"];
+  #ifdef HAS_OPENMP
+  #pragma omp parallel for num_threads(std::max(num_threads, (std::size_t) 1))
+  #endif
+  for (int i = 0; i < num_cells; ++i)
+    marked[i] = eta[i] >= threshold;
+}
+//-----------------------------------------------------------------------------
+// Compute global number of indicators, sum, min and max of indicators
+static void compute_statistics(const dolfin::MeshFunction<double>& indicators,
+                               std::size_t& num_cells, double& sum,
+                               double& min, double& max)
+{
+  const int n = indicators.size();
+  const double* eta = indicators.values();
+
+  // Compute local statistics, one entry per thread
+  const std::size_t num_threads = dolfin::parameters["num_threads"];
+  const std::size_t m = std::max(num_threads, (std::size_t) 1);
+  std::vector<double> sums(m, 0.0);
+  std::vector<double> mins(m, std::numeric_limits<double>::max());
+  std::vector<double> maxs(m, -std::numeric_limits<double>::max());
+
+  #ifdef HAS_OPENMP
+  #pragma omp parallel num_threads(m)
+  #endif
+  {
+    std::size_t thread = 0;
+    #ifdef HAS_OPENMP
+    thread = omp_get_thread_num();
+    #pragma omp for
+    #endif
+    for (int i = 0; i < n; ++i)
+    {
+      sums[thread] += eta[i];
+      mins[thread] = std::min(mins[thread], eta[i]);
+      maxs[thread] = std::max(maxs[thread], eta[i]);
+    }
+  }
+
+  // Reduce over threads and processes
+  num_cells = dolfin::MPI::sum(indicators.size());
+  sum = dolfin::MPI::sum(std::accumulate(sums.begin(), sums.end(), 0.0));
+  min = dolfin::MPI::min(*std::min_element(mins.begin(), mins.end()));
+  max = dolfin::MPI::max(*std::max_element(maxs.begin(), maxs.end()));
+}
+//-----------------------------------------------------------------------------
+// Compute bucket of value in range [lo, hi]
+static std::size_t bucket(double value, double lo, double hi)
+{
+  const double x = (value - lo)/(hi - lo)*num_buckets;
+  return x < num_buckets ? (std::size_t) x : num_buckets - 1;
+}
+//-----------------------------------------------------------------------------
+// Compute the largest threshold t such that the sum (over all
+// processes) of the indicators greater than or equal to t is at least
+// target. The threshold is found by repeatedly computing a histogram
+// of the remaining candidates and narrowing the search to the bucket
+// where the target is reached. The histogram is computed in parallel
+// by threads and summed over processes.
+static double dorfler_threshold(const dolfin::MeshFunction<double>& indicators,
+                                double target, double lo, double hi)
+{
+  const std::size_t num_threads = dolfin::parameters["num_threads"];
+  const std::size_t m = std::max(num_threads, (std::size_t) 1);
+
+  // Candidates for threshold (local indicators in [lo, hi]) and sum
+  // of indicators above candidates
+  std::vector<double> candidates(indicators.values(),
+                                 indicators.values() + indicators.size());
+  double above = 0.0;
+  std::size_t num_candidates = dolfin::MPI::sum(candidates.size());
+
+  while (lo < hi && num_candidates > max_num_gathered)
+  {
+    // Compute histogram (number of candidates and sum of candidates
+    // in each bucket), one per thread
+    const int n = candidates.size();
+    std::vector<std::vector<double> > histograms(m,
+                                      std::vector<double>(2*num_buckets, 0.0));
+    #ifdef HAS_OPENMP
+    #pragma omp parallel num_threads(m)
+    #endif
+    {
+      std::size_t thread = 0;
+      #ifdef HAS_OPENMP
+      thread = omp_get_thread_num();
+      #pragma omp for
+      #endif
+      for (int i = 0; i < n; ++i)
+      {
+        const std::size_t b = bucket(candidates[i], lo, hi);
+        histograms[thread][2*b] += 1.0;
+        histograms[thread][2*b + 1] += candidates[i];
+      }
+    }
+
+    // Reduce over threads and processes
+    std::vector<double> histogram(2*num_buckets, 0.0);
+    for (std::size_t i = 0; i < m; ++i)
+    {
+      std::transform(histogram.begin(), histogram.end(),
+                     histograms[i].begin(), histogram.begin(),
+                     std::plus<double>());
+    }
+    histogram = dolfin::MPI::sum(histogram);
+
+    // Find bucket where target is reached, starting from the top
+    std::size_t b = num_buckets - 1;
+    while (b > 0 && above + histogram[2*b + 1] < target)
+    {
+      above += histogram[2*b + 1];
+      --b;
+    }
+    num_candidates = (std::size_t) (histogram[2*b] + 0.5);
+
+    // Keep candidates in bucket
+    std::vector<double>::iterator it = candidates.begin();
+    for (int i = 0; i < n; ++i)
+    {
+      if (bucket(candidates[i], lo, hi) == b)
+        *it++ = candidates[i];
+    }
+    candidates.erase(it, candidates.end());
+
+    // Update range
+    double local_lo = std::numeric_limits<double>::max();
+    double local_hi = -std::numeric_limits<double>::max();
+    if (!candidates.empty())
+    {
+      local_lo = *std::min_element(candidates.begin(), candidates.end());
+      local_hi = *std::max_element(candidates.begin(), candidates.end());
+    }
+    lo = dolfin::MPI::min(local_lo);
+    hi = dolfin::MPI::max(local_hi);
+  }
+
+  // All remaining candidates are equal
+  if (!(lo < hi))
+    return lo;
+
+  // Gather remaining candidates and sort in decreasing order
+  std::vector<std::vector<double> > gathered;
+  dolfin::MPI::all_gather(candidates, gathered);
+  candidates.clear();
+  for (std::size_t i = 0; i < gathered.size(); ++i)
+    candidates.insert(candidates.end(), gathered[i].begin(), gathered[i].end());
+  std::sort(candidates.begin(), candidates.end(), std::greater<double>());
+
+  // Find threshold
+  for (std::size_t i = 0; i < candidates.size(); ++i)
+  {
+    above += candidates[i];
+    if (above >= target)
+      return candidates[i];
+  }
+
+  return lo;
+}
 //-----------------------------------------------------------------------------
 void dolfin::mark(dolfin::MeshFunction<bool>& markers,
                   const dolfin::MeshFunction<double>& indicators,
@@ -33,6 +224,12 @@ void dolfin::mark(dolfin::MeshFunction<bool>& markers,
 {
   if (strategy == "dorfler")
     dolfin::dorfler_mark(markers, indicators, fraction);
+  else if (strategy == "maximum")
+    dolfin::maximum_mark(markers, indicators, fraction);
+  else if (strategy == "equidistribution")
+    dolfin::equidistribution_mark(markers, indicators, fraction);
+  else if (strategy == "recursive")
+    dolfin::recursive_mark(markers, indicators, fraction);
   else
   {
     dolfin::dolfin_error("marking.cpp",
@@ -48,46 +245,109 @@ void dolfin::mark(dolfin::MeshFunction<bool>& markers,
     if (markers[i])
       num_marked++;
   }
+  num_marked = MPI::sum(num_marked);
+  const std::size_t num_cells = MPI::sum(markers.size());
 
   // Report the number of marked cells
   log(PROGRESS,
       "Marking %d cells out of %d (%.1f%%) for refinement",
-      num_marked, markers.size(), 100.0*num_marked/markers.size());
+      num_marked, num_cells, 100.0*num_marked/num_cells);
 }
 //-----------------------------------------------------------------------------
 void dolfin::dorfler_mark(dolfin::MeshFunction<bool>& markers,
                           const dolfin::MeshFunction<double>& indicators,
                           const double fraction)
 {
-  // Extract mesh
-  const dolfin::Mesh& mesh = *markers.mesh();
-
-  // Initialize marker mesh function
-  markers.set_all(false);
-
-  // Sort cell indices by indicators and compute sum of error
-  // indicators
-  std::map<double, std::size_t> sorted_cells;
-  std::map<double, std::size_t>::reverse_iterator it;
-  double eta_T_H = 0;
-  for (std::size_t i = 0; i < mesh.num_cells(); i++)
+  // Compute global statistics
+  std::size_t num_cells = 0;
+  double eta_T_H = 0.0, eta_min = 0.0, eta_max = 0.0;
+  compute_statistics(indicators, num_cells, eta_T_H, eta_min, eta_max);
+
+  // Mark nothing if fraction is zero or there are no cells
+  if (fraction <= 0.0 || num_cells == 0)
   {
-    const double value = indicators[i];
-    eta_T_H += value;
-    sorted_cells[value] = i;
+    markers.set_all(false);
+    return;
   }
 
-  // Determine stopping criterion for marking
-  const double stop = fraction*eta_T_H;
+  // Find threshold and mark cells
+  const double threshold = dorfler_threshold(indicators, fraction*eta_T_H,
+                                             eta_min, eta_max);
+  mark_threshold(markers, indicators, threshold);
+}
+//-----------------------------------------------------------------------------
+void dolfin::maximum_mark(dolfin::MeshFunction<bool>& markers,
+                          const dolfin::MeshFunction<double>& indicators,
+                          const double fraction)
+{
+  // Compute global statistics
+  std::size_t num_cells = 0;
+  double eta_T_H = 0.0, eta_min = 0.0, eta_max = 0.0;
+  compute_statistics(indicators, num_cells, eta_T_H, eta_min, eta_max);
+
+  mark_threshold(markers, indicators, fraction*eta_max);
+}
+//-----------------------------------------------------------------------------
+void dolfin::equidistribution_mark(dolfin::MeshFunction<bool>& markers,
+                                   const dolfin::MeshFunction<double>& indicators,
+                                   const double fraction)
+{
+  // Compute global statistics
+  std::size_t num_cells = 0;
+  double eta_T_H = 0.0, eta_min = 0.0, eta_max = 0.0;
+  compute_statistics(indicators, num_cells, eta_T_H, eta_min, eta_max);
+
+  if (num_cells == 0)
+    return;
+
+  mark_threshold(markers, indicators, fraction*eta_T_H/num_cells);
+}
+//-----------------------------------------------------------------------------
+void dolfin::recursive_mark(dolfin::MeshFunction<bool>& markers,
+                            const dolfin::MeshFunction<double>& indicators,
+                            const double fraction)
+{
+  // Compute global statistics
+  std::size_t num_cells = 0;
+  double eta_T_H = 0.0, eta_min = 0.0, eta_max = 0.0;
+  compute_statistics(indicators, num_cells, eta_T_H, eta_min, eta_max);
 
-  // Mark using Dorfler algorithm
-  double eta_A = 0.0;
-  for (it = sorted_cells.rbegin(); it != sorted_cells.rend(); it++) {
-    if (eta_A > stop)
-      return;
+  // Mark nothing if fraction is zero or there are no cells, and
+  // everything if the fraction is one (or larger)
+  if (fraction <= 0.0 || num_cells == 0)
+  {
+    markers.set_all(false);
+    return;
+  }
+  if (fraction >= 1.0)
+  {
+    mark_threshold(markers, indicators, eta_min);
+    return;
+  }
 
-    markers[it->second] = true;
-    eta_A += it->first;
+  // Lower threshold by fraction until the sum of the indicators above
+  // the threshold is at least fraction times the total sum
+  const int n = indicators.size();
+  const double* eta = indicators.values();
+  const double target = fraction*eta_T_H;
+  const std::size_t num_threads = dolfin::parameters["num_threads"];
+  double threshold = eta_max;
+  while (threshold > eta_min)
+  {
+    double eta_A = 0.0;
+    #ifdef HAS_OPENMP
+    #pragma omp parallel for reduction(+:eta_A) num_threads(std::max(num_threads, (std::size_t) 1))
+    #endif
+    for (int i = 0; i < n; ++i)
+    {
+      if (eta[i] >= threshold)
+        eta_A += eta[i];
+    }
+    if (MPI::sum(eta_A) >= target)
+      break;
+    threshold *= fraction;
   }
+
+  mark_threshold(markers, indicators, std::max(threshold, eta_min));
 }
 //-----------------------------------------------------------------------------
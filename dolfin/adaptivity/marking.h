@@ -16,7 +16,7 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2010-10-11
-// Last changed: 2012-09-03
+// Last changed: 2026-10-16
 
 #ifndef __MARKING_H
 #define __MARKING_H
@@ -39,7 +39,8 @@ namespace dolfin
   ///         error indicators (one per cell)
   ///
   ///     strategy (std::string)
-  ///         the marking strategy
+  ///         the marking strategy ("dorfler", "maximum",
+  ///         "equidistribution" or "recursive")
   ///
   ///     fraction (double)
   ///         the marking fraction
@@ -48,7 +49,12 @@ namespace dolfin
             const std::string strategy,
             const double fraction);
 
-  /// Mark cells using Dorfler marking
+  /// Mark cells using Dorfler marking: mark the cells with the
+  /// largest indicators such that the sum of the marked indicators is
+  /// at least fraction times the sum of all indicators. Cells with
+  /// equal indicators are either all marked or all left unmarked.
+  /// The threshold is computed without sorting by a histogram-based
+  /// search over all processes.
   ///
   /// *Arguments*
   ///     markers (_MeshFunction_ <bool>)
@@ -63,6 +69,59 @@ namespace dolfin
                     const dolfin::MeshFunction<double>& indicators,
                     const double fraction);
 
+  /// Mark cells using maximum marking: mark the cells with indicator
+  /// greater than or equal to fraction times the largest indicator
+  ///
+  /// *Arguments*
+  ///     markers (_MeshFunction_ <bool>)
+  ///         the cell markers (to be computed)
+  ///
+  ///     indicators (_MeshFunction_ <double>)
+  ///         error indicators (one per cell)
+  ///
+  ///     fraction (double)
+  ///         the marking fraction
+  void maximum_mark(MeshFunction<bool>& markers,
+                    const dolfin::MeshFunction<double>& indicators,
+                    const double fraction);
+
+  /// Mark cells using equidistribution marking: mark the cells with
+  /// indicator greater than or equal to fraction times the mean
+  /// indicator
+  ///
+  /// *Arguments*
+  ///     markers (_MeshFunction_ <bool>)
+  ///         the cell markers (to be computed)
+  ///
+  ///     indicators (_MeshFunction_ <double>)
+  ///         error indicators (one per cell)
+  ///
+  ///     fraction (double)
+  ///         the marking fraction
+  void equidistribution_mark(MeshFunction<bool>& markers,
+                             const dolfin::MeshFunction<double>& indicators,
+                             const double fraction);
+
+  /// Mark cells using recursive marking: starting from the largest
+  /// indicator, lower the threshold by the factor fraction until the
+  /// sum of the indicators above the threshold is at least fraction
+  /// times the sum of all indicators, and mark the cells above the
+  /// threshold. This approximates Dorfler marking using only global
+  /// sums.
+  ///
+  /// *Arguments*
+  ///     markers (_MeshFunction_ <bool>)
+  ///         the cell markers (to be computed)
+  ///
+  ///     indicators (_MeshFunction_ <double>)
+  ///         error indicators (one per cell)
+  ///
+  ///     fraction (double)
+  ///         the marking fraction
+  void recursive_mark(MeshFunction<bool>& markers,
+                      const dolfin::MeshFunction<double>& indicators,
+                      const double fraction);
+
 }
 
 #endif
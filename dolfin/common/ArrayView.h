@@ -0,0 +1,86 @@
+// Copyright (C) 2026 agent
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+//
+// First added:  2026-10-16
+// Last changed: 2026-10-16
+
+#ifndef __DOLFIN_ARRAY_VIEW_H
+#define __DOLFIN_ARRAY_VIEW_H
+
+#include <cstddef>
+#include <dolfin/log/log.h>
+
+namespace dolfin
+{
+
+  /// This class provides a light-weight, non-owning view into a
+  /// contiguous block of data, e.g. the dofs of one cell in a
+  /// dof map. Unlike _Array_, it can be freely copied and returned
+  /// by value. The viewed data must outlive the view.
+
+  template <typename T> class ArrayView
+  {
+
+  public:
+
+    /// Create empty view
+    ArrayView() : _size(0), _x(0) {}
+
+    /// Create view of N entries starting at x
+    ArrayView(std::size_t N, T* x) : _size(N), _x(x) {}
+
+    /// Copy constructor (the view, not the data, is copied)
+    template <typename S>
+    ArrayView(const ArrayView<S>& x) : _size(x.size()), _x(x.data()) {}
+
+    /// Return size of array
+    std::size_t size() const
+    { return _size; }
+
+    /// Return true if view is empty
+    bool empty() const
+    { return _size == 0; }
+
+    /// Access value of given entry
+    T& operator[] (std::size_t i) const
+    { dolfin_assert(i < _size); return _x[i]; }
+
+    /// Return pointer to data
+    T* data() const
+    { return _x; }
+
+    /// Pointer to start of array
+    T* begin() const
+    { return _x; }
+
+    /// Pointer to beyond end of array
+    T* end() const
+    { return _x + _size; }
+
+  private:
+
+    // Length of array
+    std::size_t _size;
+
+    // Array data
+    T* _x;
+
+  };
+
+}
+
+#endif
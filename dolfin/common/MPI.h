@@ -21,7 +21,7 @@
 // Modified by Joachim B Haga 2012
 //
 // First added:  2007-11-30
-// Last changed: 2013-01-11
+// Last changed: 2026-10-16
 
 #ifndef __MPI_DOLFIN_WRAPPER_H
 #define __MPI_DOLFIN_WRAPPER_H
@@ -250,6 +250,25 @@ namespace dolfin
       #endif
     }
 
+    /// Sum arrays of values entry-wise and return sums
+    template<typename T>
+    static std::vector<T> sum(const std::vector<T>& values)
+    {
+      #ifdef HAS_MPI
+      MPICommunicator mpi_comm;
+      boost::mpi::communicator comm(*mpi_comm, boost::mpi::comm_attach);
+      std::vector<T> out(values.size());
+      if (!values.empty())
+      {
+        boost::mpi::all_reduce(comm, &values[0], values.size(), &out[0],
+                               std::plus<T>());
+      }
+      return out;
+      #else
+      return values;
+      #endif
+    }
+
     /// All reduce
     template<typename T, typename X> static T all_reduce(const T& value, X op)
     {
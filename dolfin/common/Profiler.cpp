@@ -0,0 +1,226 @@
+// Copyright (C) 2026 agent
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+//
+// First added:  2026-10-16
+// Last changed: 2026-10-16
+
+#include <cstdlib>
+#include <map>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+
+#include <dolfin/log/log.h>
+#include <dolfin/log/LogManager.h>
+#include "timing.h"
+#include "Profiler.h"
+
+using namespace dolfin;
+
+//-----------------------------------------------------------------------------
+// Profile of timings for one thread, stored as a tree of tasks. Node
+// 0 is the root, and the children of a node are the tasks timed
+// within the scope of the node.
+class Profiler::ThreadProfile
+{
+public:
+
+  ThreadProfile() : current(0)
+  { add_node(0, 0); }
+
+  // Return child node of parent for given task (created if not found)
+  std::size_t child(std::size_t parent, std::size_t task)
+  {
+    const std::vector<std::size_t>& c = children[parent];
+    for (std::size_t i = 0; i < c.size(); ++i)
+    {
+      if (tasks[c[i]] == task)
+        return c[i];
+    }
+    const std::size_t node = add_node(parent, task);
+    children[parent].push_back(node);
+    return node;
+  }
+
+  // Add node
+  std::size_t add_node(std::size_t parent, std::size_t task)
+  {
+    tasks.push_back(task);
+    parents.push_back(parent);
+    children.push_back(std::vector<std::size_t>());
+    num_timings.push_back(0);
+    total_times.push_back(0.0);
+    return tasks.size() - 1;
+  }
+
+  // Cleanup function for thread_specific_ptr (profiles are owned by
+  // the profiler data such that timings survive the thread)
+  static void no_cleanup(ThreadProfile*) {}
+
+  // Task, parent and children of each node
+  std::vector<std::size_t> tasks;
+  std::vector<std::size_t> parents;
+  std::vector<std::vector<std::size_t> > children;
+
+  // Accumulated number of timings and time for each node
+  std::vector<std::size_t> num_timings;
+  std::vector<double> total_times;
+
+  // Current node
+  std::size_t current;
+
+};
+//-----------------------------------------------------------------------------
+// Global profiler data
+class Profiler::Data
+{
+public:
+
+  Data() : profile(&ThreadProfile::no_cleanup) {}
+
+  // Mutex for registration of tasks and profiles
+  boost::mutex mutex;
+
+  // Map from task name to id and list of task names
+  std::map<std::string, std::size_t> task_ids;
+  std::vector<std::string> task_names;
+
+  // Profiles for all threads
+  std::vector<boost::shared_ptr<ThreadProfile> > profiles;
+
+  // Profile of current thread
+  boost::thread_specific_ptr<ThreadProfile> profile;
+
+};
+//-----------------------------------------------------------------------------
+std::size_t Profiler::register_task(std::string task)
+{
+  Data& d = data();
+  boost::mutex::scoped_lock lock(d.mutex);
+
+  std::map<std::string, std::size_t>::const_iterator it = d.task_ids.find(task);
+  if (it != d.task_ids.end())
+    return it->second;
+
+  const std::size_t id = d.task_names.size();
+  d.task_ids[task] = id;
+  d.task_names.push_back(task);
+  return id;
+}
+//-----------------------------------------------------------------------------
+std::string Profiler::task_name(std::size_t task)
+{
+  Data& d = data();
+  boost::mutex::scoped_lock lock(d.mutex);
+  dolfin_assert(task < d.task_names.size());
+  return d.task_names[task];
+}
+//-----------------------------------------------------------------------------
+void Profiler::add(std::size_t task, double elapsed_time)
+{
+  ThreadProfile& p = thread_profile();
+  const std::size_t node = p.child(0, task);
+  p.num_timings[node] += 1;
+  p.total_times[node] += elapsed_time;
+}
+//-----------------------------------------------------------------------------
+std::size_t Profiler::enter(std::size_t task)
+{
+  ThreadProfile& p = thread_profile();
+  p.current = p.child(p.current, task);
+  return p.current;
+}
+//-----------------------------------------------------------------------------
+void Profiler::leave(std::size_t node, double elapsed_time)
+{
+  ThreadProfile& p = thread_profile();
+  dolfin_assert(node < p.tasks.size());
+  p.num_timings[node] += 1;
+  p.total_times[node] += elapsed_time;
+  p.current = p.parents[node];
+}
+//-----------------------------------------------------------------------------
+void Profiler::flush()
+{
+  Data& d = data();
+  boost::mutex::scoped_lock lock(d.mutex);
+
+  // Register accumulated timings of all nodes with the logger and
+  // reset the nodes
+  for (std::size_t i = 0; i < d.profiles.size(); ++i)
+  {
+    ThreadProfile& p = *d.profiles[i];
+    for (std::size_t node = 1; node < p.tasks.size(); ++node)
+    {
+      if (p.num_timings[node] == 0)
+        continue;
+
+      // Build name of task from path to root
+      std::string task = d.task_names[p.tasks[node]];
+      for (std::size_t n = p.parents[node]; n != 0; n = p.parents[n])
+        task = d.task_names[p.tasks[n]] + " > " + task;
+
+      LogManager::logger.register_timing(task, p.total_times[node],
+                                         p.num_timings[node]);
+      p.num_timings[node] = 0;
+      p.total_times[node] = 0.0;
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+Profiler::Data& Profiler::data()
+{
+  static Data d;
+
+  // Register dump of timings at exit. This is done after the data
+  // has been created so that the data is destroyed after the dump.
+  static const bool dump_registered
+    = std::getenv("DOLFIN_TIMINGS_FILE") && std::atexit(dump_at_exit) == 0;
+  (void) dump_registered;
+
+  return d;
+}
+//-----------------------------------------------------------------------------
+Profiler::ThreadProfile& Profiler::thread_profile()
+{
+  // Get data first, since profile lives in data
+  Data& d = data();
+
+  // Create profile for thread if not already done
+  ThreadProfile* p = d.profile.get();
+  if (!p)
+  {
+    boost::shared_ptr<ThreadProfile> profile(new ThreadProfile);
+    {
+      boost::mutex::scoped_lock lock(d.mutex);
+      d.profiles.push_back(profile);
+    }
+    d.profile.reset(profile.get());
+    p = profile.get();
+  }
+
+  return *p;
+}
+//-----------------------------------------------------------------------------
+void Profiler::dump_at_exit()
+{
+  const char* filename = std::getenv("DOLFIN_TIMINGS_FILE");
+  if (filename)
+    dump_timings(filename);
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,136 @@
+// Copyright (C) 2026 agent
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+//
+// First added:  2026-10-16
+// Last changed: 2026-10-16
+
+#ifndef __PROFILER_H
+#define __PROFILER_H
+
+#include <cstddef>
+#include <string>
+#include "timing.h"
+
+namespace dolfin
+{
+
+  /// This class implements a low-overhead, thread-safe backend for
+  /// timing of tasks. Tasks are registered once (by name) and then
+  /// referred to by an integer id. Timings are accumulated in
+  /// thread-local profiles, which are only merged with the global
+  /// timings when these are requested (e.g. by list_timings). Nested
+  /// timings (see _ProfileScope_) are stored hierarchically and
+  /// reported as "parent > child".
+  ///
+  /// Typical usage in an inner loop is
+  ///
+  ///   static const std::size_t task = Profiler::register_task("Tabulate tensor");
+  ///   for (...)
+  ///   {
+  ///     ProfileScope scope(task);
+  ///     ...
+  ///   }
+  ///
+  /// If the environment variable DOLFIN_TIMINGS_FILE is set, all
+  /// timings are written to the given file (JSON or CSV, depending
+  /// on the suffix) at program exit.
+
+  class Profiler
+  {
+  public:
+
+    /// Register task and return its id. Registering the same task
+    /// twice returns the same id.
+    ///
+    /// *Arguments*
+    ///     task (std::string)
+    ///         Name of task.
+    ///
+    /// *Returns*
+    ///     std::size_t
+    ///         The id of the task.
+    static std::size_t register_task(std::string task);
+
+    /// Return name of task with given id
+    static std::string task_name(std::size_t task);
+
+    /// Add timing for task (not nested in the current scope)
+    ///
+    /// *Arguments*
+    ///     task (std::size_t)
+    ///         The id of the task.
+    ///     elapsed_time (double)
+    ///         The elapsed time.
+    static void add(std::size_t task, double elapsed_time);
+
+    /// Enter scope for task in current thread and return its node in
+    /// the profile of the thread
+    static std::size_t enter(std::size_t task);
+
+    /// Leave scope (node returned by enter) and add timing
+    static void leave(std::size_t node, double elapsed_time);
+
+    /// Move timings accumulated by all threads to the global timings
+    /// (reported by list_timings). Must not be called while other
+    /// threads are timing tasks.
+    static void flush();
+
+  private:
+
+    class ThreadProfile;
+    class Data;
+
+    // Return global profiler data
+    static Data& data();
+
+    // Return profile of calling thread
+    static ThreadProfile& thread_profile();
+
+    // Write timings to file given by DOLFIN_TIMINGS_FILE (at exit)
+    static void dump_at_exit();
+
+  };
+
+  /// A ProfileScope times a (pre-registered) task from construction
+  /// to destruction. Scopes may be nested, in which case the timing
+  /// is reported as part of the enclosing scope.
+
+  class ProfileScope
+  {
+  public:
+
+    /// Start timing of task
+    ProfileScope(std::size_t task)
+      : _node(Profiler::enter(task)), _t(time()) {}
+
+    /// Stop timing of task
+    ~ProfileScope()
+    { Profiler::leave(_node, time() - _t); }
+
+  private:
+
+    // Node in thread profile
+    std::size_t _node;
+
+    // Start time
+    double _t;
+
+  };
+
+}
+
+#endif
@@ -16,7 +16,7 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2008-06-13
-// Last changed: 2010-11-16
+// Last changed: 2026-10-16
 
 #ifndef __TIMER_H
 #define __TIMER_H
@@ -24,7 +24,7 @@
 #include <iostream>
 
 #include <dolfin/parameter/GlobalParameters.h>
-#include <dolfin/log/LogManager.h>
+#include "Profiler.h"
 #include "timing.h"
 
 namespace dolfin
@@ -45,16 +45,39 @@ namespace dolfin
   /// by calling
   ///
   ///   list_timings();
+  ///
+  /// Timings are accumulated per thread by the _Profiler_. Creating a
+  /// timer from a task name reads the global parameter "timer_prefix"
+  /// and registers the task (a locked lookup), so such timers must be
+  /// created outside multi-threaded regions. Inside these regions
+  /// (and for inner loops), register the task beforehand and create
+  /// the timer from the task id:
+  ///
+  ///   const std::size_t task = Timer::register_task("Assembling over cells");
+  ///   #pragma omp parallel
+  ///   {
+  ///     Timer timer(task);
+  ///     ...
+  ///   }
 
   class Timer
   {
   public:
 
-    /// Create timer
-    Timer(std::string task) : _task(""), t(time()), stopped(false)
+    /// Create timer (not inside multi-threaded regions)
+    Timer(std::string task)
+      : _task(register_task(task)), t(time()), stopped(false) {}
+
+    /// Create timer for task registered by register_task (may be
+    /// used inside multi-threaded regions)
+    explicit Timer(std::size_t task) : _task(task), t(time()), stopped(false) {}
+
+    /// Register task (with the prefix given by the global parameter
+    /// "timer_prefix") and return its id
+    static std::size_t register_task(std::string task)
     {
       const std::string prefix = parameters["timer_prefix"];
-      _task = prefix + task;
+      return Profiler::register_task(prefix + task);
     }
 
     /// Destructor
@@ -69,7 +92,7 @@ namespace dolfin
     double stop()
     {
       t = time() - t;
-      LogManager::logger.register_timing(_task, t);
+      Profiler::add(_task, t);
       stopped = true;
       return t;
     }
@@ -80,8 +103,8 @@ namespace dolfin
 
   private:
 
-    // Name of task
-    std::string _task;
+    // Id of task
+    std::size_t _task;
 
     // Start time
     double t;
@@ -16,7 +16,7 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2003-12-21
-// Last changed: 2012-11-01
+// Last changed: 2026-10-16
 
 // Uncomment this for testing std::clock
 //#define _WIN32
@@ -27,7 +27,10 @@
 #include <sys/time.h>
 #endif
 
+#include <sstream>
+
 #include "MPI.h"
+#include "SubSystemsManager.h"
 #include <dolfin/log/log.h>
 #include <dolfin/log/LogManager.h>
 #include "timing.h"
@@ -115,3 +118,19 @@ double dolfin::timing(std::string task, bool reset)
   return LogManager::logger.timing(task, reset);
 }
 //-----------------------------------------------------------------------------
+void dolfin::dump_timings(std::string filename)
+{
+  // Append process number when running in parallel (MPI may already
+  // have been finalized if called at exit)
+  if (SubSystemsManager::mpi_initialized()
+      && !SubSystemsManager::mpi_finalized() && MPI::num_processes() > 1)
+  {
+    const std::size_t dot = filename.rfind('.');
+    std::stringstream s;
+    s << "_p" << MPI::process_number();
+    filename.insert(dot == std::string::npos ? filename.size() : dot, s.str());
+  }
+
+  LogManager::logger.dump_timings(filename);
+}
+//-----------------------------------------------------------------------------
@@ -16,7 +16,7 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2005-12-21
-// Last changed: 2012-11-01
+// Last changed: 2026-10-16
 
 #ifndef __TIMING_H
 #define __TIMING_H
@@ -53,6 +53,11 @@ namespace dolfin
   /// for task
   double timing(std::string task, bool reset=false);
 
+  /// Write timings to file in JSON (suffix .json) or CSV (suffix
+  /// .csv) format. When running in parallel, the process number is
+  /// appended to the file name.
+  void dump_timings(std::string filename);
+
 }
 
 #endif
@@ -22,8 +22,9 @@
 // Modified by Martin Alnaes 2013
 //
 // First added:  2007-01-17
-// Last changed: 2013-01-18
+// Last changed: 2026-10-16
 
+#include <algorithm>
 #include <boost/scoped_ptr.hpp>
 
 #include <dolfin/log/dolfin_log.h>
@@ -122,6 +123,13 @@ void Assembler::assemble_cells(GenericTensor& A,
   if (!ufc.form.has_cell_integrals())
     return;
 
+  // Use blocked assembly if requested
+  if (cell_block_size > 1)
+  {
+    assemble_cell_blocks(A, a, ufc, domains, values);
+    return;
+  }
+
   // Set timer
   Timer timer("Assemble cells");
 
@@ -137,7 +145,7 @@ void Assembler::assemble_cells(GenericTensor& A,
     dofmaps.push_back(a.function_space(i)->dofmap().get());
 
   // Vector to hold dof map for a cell
-  std::vector<const std::vector<dolfin::la_index>* > dofs(form_rank);
+  std::vector<ArrayView<const dolfin::la_index> > dofs(form_rank);
 
   // Cell integral
   ufc::cell_integral* integral = ufc.default_cell_integral.get();
@@ -164,8 +172,8 @@ void Assembler::assemble_cells(GenericTensor& A,
     bool empty_dofmap = false;
     for (std::size_t i = 0; i < form_rank; ++i)
     {
-      dofs[i] = &(dofmaps[i]->cell_dofs(cell->index()));
-      empty_dofmap = empty_dofmap || dofs[i]->size() == 0;
+      dofs[i] = dofmaps[i]->cell_dofs(cell->index());
+      empty_dofmap = empty_dofmap || dofs[i].size() == 0;
     }
 
     // Skip if at least one dofmap is empty
@@ -188,6 +196,137 @@ void Assembler::assemble_cells(GenericTensor& A,
   }
 }
 //-----------------------------------------------------------------------------
+void Assembler::assemble_cell_blocks(GenericTensor& A,
+                                     const Form& a,
+                                     UFC& ufc,
+                                     const MeshFunction<std::size_t>* domains,
+                                     std::vector<double>* values)
+{
+  // Set timer
+  Timer timer("Assemble cells");
+
+  // Extract mesh
+  const Mesh& mesh = a.mesh();
+
+  // Form rank and number of coefficients
+  const std::size_t form_rank = ufc.form.rank();
+  const std::size_t num_coefficients = ufc.form.num_coefficients();
+
+  // Collect pointers to dof maps
+  std::vector<const GenericDofMap*> dofmaps;
+  for (std::size_t i = 0; i < form_rank; ++i)
+    dofmaps.push_back(a.function_space(i)->dofmap().get());
+
+  // Cell integral
+  ufc::cell_integral* integral = ufc.default_cell_integral.get();
+
+  // Check whether integral is domain-dependent
+  bool use_domains = domains && !domains->empty();
+
+  // Sizes of per-cell data
+  const std::size_t block_size = cell_block_size;
+  const std::size_t tensor_size = ufc.A.size();
+  const std::size_t coordinates_size = ufc.cell.vertex_coordinates.size();
+
+  // Scratch data for a block of cells. Each quantity is stored
+  // contiguously for all cells of the block
+  std::vector<std::size_t> block_cells(block_size);
+  std::vector<ufc::cell_integral*> block_integrals(block_size);
+  std::vector<double> block_coordinates(block_size*coordinates_size);
+  std::vector<int> block_orientations(block_size);
+  std::vector<double> block_tensors(block_size*tensor_size);
+  std::vector<ArrayView<const dolfin::la_index> >
+    block_dofs(block_size*form_rank);
+
+  // Coefficient values for a block of cells, one array per
+  // coefficient, and the per-cell pointers passed to tabulate_tensor
+  std::vector<std::vector<double> > block_w(num_coefficients);
+  std::vector<double*> block_w_pointers(std::max(block_size*num_coefficients,
+                                                 (std::size_t) 1), 0);
+  for (std::size_t i = 0; i < num_coefficients; ++i)
+  {
+    const std::size_t dim = ufc.coefficient_dimension(i);
+    block_w[i].resize(block_size*dim);
+    for (std::size_t k = 0; k < block_size; ++k)
+      block_w_pointers[k*num_coefficients + i] = &block_w[i][k*dim];
+  }
+
+  // Assemble over cells
+  Progress p(AssemblerBase::progress_message(A.rank(), "cells"), mesh.num_cells());
+  CellIterator cell(mesh);
+  while (!cell.end())
+  {
+    // Gather data for the next block of cells
+    std::size_t n = 0;
+    for (; n < block_size && !cell.end(); ++cell)
+    {
+      // Get integral for sub domain (if any)
+      if (use_domains)
+        integral = ufc.get_cell_integral((*domains)[*cell]);
+
+      // Skip if no integral on current domain
+      if (!integral)
+        continue;
+
+      // Get local-to-global dof maps for cell, skipping the cell if
+      // at least one dofmap is empty
+      bool empty_dofmap = false;
+      for (std::size_t i = 0; i < form_rank; ++i)
+      {
+        block_dofs[n*form_rank + i] = dofmaps[i]->cell_dofs(cell->index());
+        empty_dofmap = empty_dofmap || block_dofs[n*form_rank + i].size() == 0;
+      }
+      if (empty_dofmap)
+        continue;
+
+      // Update to current cell
+      ufc.update(*cell);
+
+      // Copy geometry and restricted coefficients into block storage
+      std::copy(ufc.cell.vertex_coordinates.begin(),
+                ufc.cell.vertex_coordinates.end(),
+                block_coordinates.begin() + n*coordinates_size);
+      block_orientations[n] = ufc.cell.orientation;
+      const double* const * w = ufc.w();
+      for (std::size_t i = 0; i < num_coefficients; ++i)
+      {
+        const std::size_t dim = ufc.coefficient_dimension(i);
+        std::copy(w[i], w[i] + dim, block_w[i].begin() + n*dim);
+      }
+
+      block_cells[n] = cell->index();
+      block_integrals[n] = integral;
+      ++n;
+    }
+
+    // Tabulate cell tensors for block
+    for (std::size_t k = 0; k < n; ++k)
+    {
+      block_integrals[k]->tabulate_tensor(&block_tensors[k*tensor_size],
+                                          &block_w_pointers[k*num_coefficients],
+                                          &block_coordinates[k*coordinates_size],
+                                          block_orientations[k]);
+    }
+
+    // Add entries to global tensor. Either store values cell-by-cell
+    // (currently only available for functionals)
+    if (values && form_rank == 0)
+    {
+      for (std::size_t k = 0; k < n; ++k)
+        (*values)[block_cells[k]] = block_tensors[k*tensor_size];
+    }
+    else if (n > 0)
+    {
+      // Non-empty cell dof maps have the full element dimension, so
+      // the element tensors are packed as expected by add_blocks
+      A.add_blocks(&block_tensors[0], n, block_dofs);
+    }
+
+    for (std::size_t k = 0; k < n; ++k)
+      p++;
+  }
+}
+//-----------------------------------------------------------------------------
 void Assembler::assemble_exterior_facets(GenericTensor& A,
                                          const Form& a,
                                          UFC& ufc,
@@ -213,7 +352,7 @@ void Assembler::assemble_exterior_facets(GenericTensor& A,
     dofmaps.push_back(a.function_space(i)->dofmap().get());
 
   // Vector to hold dof map for a cell
-  std::vector<const std::vector<dolfin::la_index>* > dofs(form_rank);
+  std::vector<ArrayView<const dolfin::la_index> > dofs(form_rank);
 
   // Exterior facet integral
   const ufc::exterior_facet_integral* integral = ufc.default_exterior_facet_integral.get();
@@ -259,7 +398,7 @@ void Assembler::assemble_exterior_facets(GenericTensor& A,
 
     // Get local-to-global dof maps for cell
     for (std::size_t i = 0; i < form_rank; ++i)
-      dofs[i] = &(dofmaps[i]->cell_dofs(mesh_cell.index()));
+      dofs[i] = dofmaps[i]->cell_dofs(mesh_cell.index());
 
     // Tabulate exterior facet tensor
     integral->tabulate_tensor(&ufc.A[0],
@@ -299,13 +438,9 @@ void Assembler::assemble_interior_facets(GenericTensor& A, const Form& a,
   for (std::size_t i = 0; i < form_rank; ++i)
     dofmaps.push_back(a.function_space(i)->dofmap().get());
 
-  // Vector to hold dofs for cells, and a vector holding pointers to same
+  // Vector to hold dofs for cells, and a vector holding views of same
   std::vector<std::vector<dolfin::la_index> > macro_dofs(form_rank);
-  std::vector<const std::vector<dolfin::la_index>* > macro_dof_ptrs(form_rank);
-  for (std::size_t i = 0; i < form_rank; i++)
-  {
-    macro_dof_ptrs[i] = &macro_dofs[i];
-  }
+  std::vector<ArrayView<const dolfin::la_index> > macro_dof_ptrs(form_rank);
 
   // Interior facet integral
   const ufc::interior_facet_integral* integral
@@ -369,9 +504,9 @@ void Assembler::assemble_interior_facets(GenericTensor& A, const Form& a,
     for (std::size_t i = 0; i < form_rank; i++)
     {
       // Get dofs for each cell
-      const std::vector<dolfin::la_index>& cell_dofs0
+      const ArrayView<const dolfin::la_index> cell_dofs0
         = dofmaps[i]->cell_dofs(cell0.index());
-      const std::vector<dolfin::la_index>& cell_dofs1
+      const ArrayView<const dolfin::la_index> cell_dofs1
         = dofmaps[i]->cell_dofs(cell1.index());
 
       // Create space in macro dof vector
@@ -382,6 +517,8 @@ void Assembler::assemble_interior_facets(GenericTensor& A, const Form& a,
                 macro_dofs[i].begin());
       std::copy(cell_dofs1.begin(), cell_dofs1.end(),
                 macro_dofs[i].begin() + cell_dofs0.size());
+      macro_dof_ptrs[i] = ArrayView<const dolfin::la_index>(macro_dofs[i].size(),
+                                                            macro_dofs[i].data());
     }
 
     // Tabulate interior facet tensor on macro element
@@ -401,7 +538,7 @@ void Assembler::assemble_interior_facets(GenericTensor& A, const Form& a,
 //-----------------------------------------------------------------------------
 void Assembler::add_to_global_tensor(GenericTensor& A,
                                      std::vector<double>& cell_tensor,
-                                     std::vector<const std::vector<dolfin::la_index>* >& dofs)
+                                     std::vector<ArrayView<const dolfin::la_index> >& dofs)
 {
   A.add(&cell_tensor[0], dofs);
 }
@@ -20,12 +20,13 @@
 // Modified by Joachim B Haga, 2012.
 //
 // First added:  2007-01-17
-// Last changed: 2012-10-04
+// Last changed: 2026-10-16
 
 #ifndef __ASSEMBLER_H
 #define __ASSEMBLER_H
 
 #include <vector>
+#include <dolfin/common/ArrayView.h>
 #include "AssemblerBase.h"
 
 namespace dolfin
@@ -55,7 +56,17 @@ namespace dolfin
   {
   public:
 
-    Assembler() {}
+    Assembler() : cell_block_size(1) {}
+
+    /// cell_block_size (std::size_t)
+    ///     Default value is 1.
+    ///     If larger than 1, cell integrals are assembled in blocks
+    ///     of (up to) this many cells: geometry and coefficients are
+    ///     gathered for the whole block, the element tensors are
+    ///     tabulated one after another and then added to the global
+    ///     tensor in a single call. This bypasses
+    ///     add_to_global_tensor.
+    std::size_t cell_block_size;
 
     /// Assemble tensor from given form
     ///
@@ -90,11 +101,16 @@ namespace dolfin
 
   protected:
 
+    // Assemble over cells in blocks of cell_block_size cells
+    void assemble_cell_blocks(GenericTensor& A, const Form& a, UFC& ufc,
+                              const MeshFunction<std::size_t>* domains,
+                              std::vector<double>* values);
+
     /// Add cell tensor to global tensor. Hook to allow the SymmetricAssembler
     /// to split the cell tensor into symmetric/antisymmetric parts.
     void add_to_global_tensor(GenericTensor& A,
                               std::vector<double>& cell_tensor,
-                              std::vector<const std::vector<dolfin::la_index>* >& dofs);
+                              std::vector<ArrayView<const dolfin::la_index> >& dofs);
 
   };
 
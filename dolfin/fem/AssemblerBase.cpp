@@ -21,7 +21,7 @@
 // Modified by Johannes Ring, 2012
 //
 // First added:  2007-01-17
-// Last changed: 2013-03-30
+// Last changed: 2026-10-16
 
 #include <boost/scoped_ptr.hpp>
 #include <dolfin/common/Timer.h>
@@ -29,8 +29,6 @@
 #include <dolfin/function/GenericFunction.h>
 #include <dolfin/la/GenericMatrix.h>
 #include <dolfin/la/GenericTensor.h>
-#include <dolfin/la/SparsityPattern.h>
-#include <dolfin/la/GenericLinearAlgebraFactory.h>
 #include <dolfin/la/TensorLayout.h>
 #include <dolfin/log/dolfin_log.h>
 #include <dolfin/common/MPI.h>
@@ -40,7 +38,7 @@
 #include "FiniteElement.h"
 #include "Form.h"
 #include "GenericDofMap.h"
-#include "SparsityPatternBuilder.h"
+#include "TensorLayoutCache.h"
 #include "AssemblerBase.h"
 
 
@@ -60,47 +58,12 @@ void AssemblerBase::init_global_tensor(GenericTensor& A, const Form& a)
 
   if (reset_sparsity)
   {
-    Timer t0("Build sparsity");
-
-    // Create layout for initialising tensor
-    boost::shared_ptr<TensorLayout> tensor_layout = A.factory().create_layout(a.rank());
+    // Get layout (with sparsity pattern) for initialising tensor,
+    // reused from previous assembly over the same mesh and dof maps
+    boost::shared_ptr<const TensorLayout> tensor_layout
+      = TensorLayoutCache::layout(a, A.factory(), keep_diagonal);
     dolfin_assert(tensor_layout);
 
-    std::vector<std::size_t> global_dimensions(a.rank());
-    std::vector<std::pair<std::size_t, std::size_t> > local_range(a.rank());
-    std::vector<std::size_t> block_sizes;
-    for (std::size_t i = 0; i < a.rank(); i++)
-    {
-      dolfin_assert(dofmaps[i]);
-      global_dimensions[i] = dofmaps[i]->global_dimension();
-      local_range[i]       = dofmaps[i]->ownership_range();
-      block_sizes.push_back(dofmaps[i]->block_size);
-    }
-
-    // Set block size for sparsity graphs
-    std::size_t block_size = 1;
-    if (a.rank() == 2)
-    {
-      const std::vector<std::size_t> _bs(a.rank(), dofmaps[0]->block_size);
-      block_size = (block_sizes == _bs) ? dofmaps[0]->block_size : 1;
-    }
-
-    // Initialise tensor layout
-    tensor_layout->init(global_dimensions, block_size, local_range);
-
-    // Build sparsity pattern if required
-    if (tensor_layout->sparsity_pattern())
-    {
-      GenericSparsityPattern& pattern = *tensor_layout->sparsity_pattern();
-      SparsityPatternBuilder::build(pattern,
-                                a.mesh(), dofmaps,
-                                a.ufc_form()->has_cell_integrals(),
-                                a.ufc_form()->has_interior_facet_integrals(),
-                                a.ufc_form()->has_exterior_facet_integrals(),
-                                keep_diagonal);
-    }
-    t0.stop();
-
     // Initialize tensor
     Timer t1("Init tensor");
     A.init(*tensor_layout);
@@ -126,10 +89,6 @@ void AssemblerBase::init_global_tensor(GenericTensor& A, const Form& a)
       }
       A.apply("flush");
     }
-
-    // Delete sparsity pattern
-    Timer t2("Delete sparsity");
-    t2.stop();
   }
   else
   {
@@ -21,11 +21,13 @@
 // Modified by Joachim B. Haga, 2012
 //
 // First added:  2007-04-10
-// Last changed: 2012-02-29
+// Last changed: 2026-10-16
 
+#include <algorithm>
 #include <map>
 #include <utility>
 #include <boost/assign/list_of.hpp>
+#include <boost/functional/hash.hpp>
 
 #include <dolfin/common/Array.h>
 #include <dolfin/common/constants.h>
@@ -184,6 +186,9 @@ const DirichletBC& DirichletBC::operator= (const DirichletBC& bc)
   _user_sub_domain = bc._user_sub_domain;
   _facets = bc._facets;
 
+  // Boundary dofs are recomputed when needed
+  _boundary_dofs.clear();
+
   // Call assignment operator for base class
   Hierarchical<DirichletBC>::operator=(bc);
 
@@ -269,30 +274,36 @@ void DirichletBC::get_boundary_values(Map& boundary_values,
   // Create local data
   LocalData data(*_function_space);
 
-  // Compute dofs and values
-  compute_bc(boundary_values, data, method);
+  // Compute dofs (or get cached dofs) and values
+  std::vector<double> values;
+  if (method == "default" || method == _method)
+  {
+    const BoundaryDofs& bdofs = boundary_dofs(data);
+    compute_bc_values(values, bdofs, data);
+    for (std::size_t i = 0; i < bdofs.dofs.size(); ++i)
+      boundary_values[bdofs.dofs[i]] = values[i];
+  }
+  else
+  {
+    BoundaryDofs bdofs;
+    compute_bc(bdofs, data, method);
+    compute_bc_values(values, bdofs, data);
+    for (std::size_t i = 0; i < bdofs.dofs.size(); ++i)
+      boundary_values[bdofs.dofs[i]] = values[i];
+  }
 }
 //-----------------------------------------------------------------------------
 void DirichletBC::zero(GenericMatrix& A) const
 {
-  // A map to hold the mapping from boundary dofs to boundary values
-  Map boundary_values;
-
   // Create local data for application of boundary conditions
   LocalData data(*_function_space);
 
-  // Compute dofs and values
-  compute_bc(boundary_values, data, _method);
-
-  // Copy boundary value data to arrays
-  std::vector<dolfin::la_index> dofs(boundary_values.size());
-  Map::const_iterator bv;
-  std::size_t i = 0;
-  for (bv = boundary_values.begin(); bv != boundary_values.end(); ++bv)
-    dofs[i++] = bv->first;
+  // Get boundary dofs (values are not needed)
+  const BoundaryDofs& bdofs = boundary_dofs(data);
+  const std::vector<dolfin::la_index>& dofs = bdofs.dofs;
 
   // Modify linear system (A_ii = 1)
-  A.zero(boundary_values.size(), dofs.data());
+  A.zero(dofs.size(), dofs.data());
 
   // Finalise changes to A
   A.apply("insert");
@@ -496,6 +507,11 @@ void DirichletBC::set_value(boost::shared_ptr<const GenericFunction> g)
   _g = g;
 }
 //-----------------------------------------------------------------------------
+void DirichletBC::clear_cache()
+{
+  _boundary_dofs.clear();
+}
+//-----------------------------------------------------------------------------
 std::string DirichletBC::method() const
 {
   return _method;
@@ -510,26 +526,16 @@ void DirichletBC::apply(GenericMatrix* A,
   // Check arguments
   check_arguments(A, b, x);
 
-  // A map to hold the mapping from boundary dofs to boundary values
-  Map boundary_values;
-
   // Create local data for application of boundary conditions
   LocalData data(*_function_space);
 
-  // Compute dofs and values
-  compute_bc(boundary_values, data, _method);
-
-  // Copy boundary value data to arrays
-  const std::size_t size = boundary_values.size();
-  std::vector<dolfin::la_index> dofs(size);
-  std::vector<double> values(size);
-  Map::const_iterator bv;
-  std::size_t counter = 0;
-  for (bv = boundary_values.begin(); bv != boundary_values.end(); ++bv)
-  {
-    dofs[counter]     = bv->first;
-    values[counter++] = bv->second;
-  }
+  // Get boundary dofs (computed once and cached) and evaluate
+  // boundary values at these dofs
+  const BoundaryDofs& bdofs = boundary_dofs(data);
+  const std::vector<dolfin::la_index>& dofs = bdofs.dofs;
+  std::vector<double> values;
+  compute_bc_values(values, bdofs, data);
+  const std::size_t size = dofs.size();
 
   // Modify boundary values for nonlinear problems
   if (x)
@@ -537,7 +543,7 @@ void DirichletBC::apply(GenericMatrix* A,
     // Get values (these must reside in local portion (including ghost
     // values) of the vector
     std::vector<double> x_values(size);
-    x->get_local(&x_values[0], dofs.size(), &dofs[0]);
+    x->get_local(x_values.data(), size, dofs.data());
 
     // Modify RHS entries
     for (std::size_t i = 0; i < size; i++)
@@ -549,7 +555,7 @@ void DirichletBC::apply(GenericMatrix* A,
   // Modify RHS vector (b[i] = value) and apply changes
   if (b)
   {
-    b->set(&values[0], size, &dofs[0]);
+    b->set(values.data(), size, dofs.data());
     b->apply("insert");
   }
 
@@ -558,7 +564,7 @@ void DirichletBC::apply(GenericMatrix* A,
   {
     const bool use_ident = parameters["use_ident"];
     if (use_ident)
-      A->ident(size, &dofs[0]);
+      A->ident(size, dofs.data());
     else
     {
       for (std::size_t i = 0; i < size; i++)
@@ -649,31 +655,12 @@ void DirichletBC::init_from_sub_domain(boost::shared_ptr<const SubDomain>
                                        sub_domain) const
 {
   dolfin_assert(_facets.size() == 0);
-
-  // FIXME: This can be made more efficient, we should be able to
-  // FIXME: extract the facets without first creating a MeshFunction on
-  // FIXME: the entire mesh and then extracting the subset. This is done
-  // FIXME: mainly for convenience (we may reuse mark() in SubDomain).
-
   dolfin_assert(_function_space->mesh());
   const Mesh& mesh = *_function_space->mesh();
 
-  // Create mesh function for sub domain markers on facets
-  const std::size_t dim = mesh.topology().dim();
-  _function_space->mesh()->init(dim - 1);
-  MeshFunction<std::size_t> sub_domains(mesh, dim - 1);
-
-  // Set geometric dimension (needed for SWIG interface)
-  sub_domain->_geometric_dimension = mesh.geometry().dim();
-
-  // Mark everything as sub domain 1
-  sub_domains = 1;
-
-  // Mark the sub domain as sub domain 0
-  sub_domain->mark(sub_domains, 0, _check_midpoint);
-
-  // Initialize from mesh function
-  init_from_mesh_function(sub_domains, 0);
+  // Compute facets inside sub domain
+  const std::size_t D = mesh.topology().dim();
+  sub_domain->compute_entities(_facets, mesh, D - 1, _check_midpoint);
 }
 //-----------------------------------------------------------------------------
 void DirichletBC::init_from_mesh_function(const MeshFunction<std::size_t>& sub_domains,
@@ -723,7 +710,49 @@ void DirichletBC::init_from_mesh(std::size_t sub_domain) const
   }
 }
 //-----------------------------------------------------------------------------
-void DirichletBC::compute_bc(Map& boundary_values, LocalData& data,
+const DirichletBC::BoundaryDofs& DirichletBC::boundary_dofs(LocalData& data) const
+{
+  dolfin_assert(_function_space->mesh());
+  dolfin_assert(_function_space->dofmap());
+  const Mesh& mesh = *_function_space->mesh();
+  const GenericDofMap* dofmap = _function_space->dofmap().get();
+
+  // Boundary dofs found by the geometric and pointwise methods
+  // depend on the coordinates, which may change in place (mesh.move(),
+  // mesh smoothing), so include a (local) hash of the coordinates
+  std::size_t coordinates_hash = 0;
+  if (_method != "topological")
+  {
+    boost::hash<std::vector<double> > dhash;
+    coordinates_hash = dhash(mesh.geometry().x());
+  }
+
+  // Check if cached boundary dofs are still valid
+  BoundaryDofs& bdofs = _boundary_dofs;
+  if (bdofs.valid && bdofs.method == _method
+      && bdofs.mesh_id == mesh.id()
+      && bdofs.num_cells == mesh.num_cells()
+      && bdofs.num_vertices == mesh.num_vertices()
+      && bdofs.coordinates_hash == coordinates_hash
+      && bdofs.dofmap == dofmap)
+  {
+    return bdofs;
+  }
+
+  // Recompute boundary dofs
+  compute_bc(bdofs, data, _method);
+  bdofs.valid = true;
+  bdofs.method = _method;
+  bdofs.mesh_id = mesh.id();
+  bdofs.num_cells = mesh.num_cells();
+  bdofs.num_vertices = mesh.num_vertices();
+  bdofs.coordinates_hash = coordinates_hash;
+  bdofs.dofmap = dofmap;
+
+  return bdofs;
+}
+//-----------------------------------------------------------------------------
+void DirichletBC::compute_bc(BoundaryDofs& bdofs, LocalData& data,
                              std::string method) const
 {
   Timer timer("DirichletBC compute bc");
@@ -732,22 +761,69 @@ void DirichletBC::compute_bc(Map& boundary_values, LocalData& data,
   if (method == "default")
     method = _method;
 
+  // Map from boundary dof to the cell (and local dof) from which its
+  // value is taken
+  SourceMap sources;
+
   // Choose strategy
+  bdofs.clear();
   if (method == "topological")
-    compute_bc_topological(boundary_values, data);
+    compute_bc_topological(sources, bdofs, data);
   else if (method == "geometric")
-    compute_bc_geometric(boundary_values, data);
+    compute_bc_geometric(sources, bdofs, data);
   else if (method == "pointwise")
-    compute_bc_pointwise(boundary_values, data);
+    compute_bc_pointwise(sources, bdofs, data);
   else
   {
     dolfin_error("DirichletBC.cpp",
                  "compute boundary conditions",
                  "Unknown method for application of boundary conditions");
   }
+
+  // Build sorted list of boundary dofs
+  bdofs.build(sources);
 }
 //-----------------------------------------------------------------------------
-void DirichletBC::compute_bc_topological(Map& boundary_values,
+void DirichletBC::compute_bc_values(std::vector<double>& values,
+                                    const BoundaryDofs& bdofs,
+                                    LocalData& data) const
+{
+  dolfin_assert(_function_space->mesh());
+  dolfin_assert(_function_space->element());
+  dolfin_assert(_g);
+  const Mesh& mesh = *_function_space->mesh();
+  const FiniteElement& element = *_function_space->element();
+
+  values.resize(bdofs.dofs.size());
+  if (bdofs.dofs.empty())
+    return;
+
+  // Create UFC cell object
+  UFCCell ufc_cell(mesh);
+
+  // Restrict g once on each cell and pick values for boundary dofs
+  for (std::size_t i = 0; i < bdofs.cells.size(); ++i)
+  {
+    // Skip cells that do not provide any boundary values
+    if (bdofs.offsets[i] == bdofs.offsets[i + 1])
+      continue;
+
+    // Update UFC cell
+    const Cell ufc_cell_entity(mesh, bdofs.ufc_cells[i]);
+    ufc_cell.update(ufc_cell_entity, bdofs.local_facets[i]);
+
+    // Restrict coefficient to cell
+    const Cell cell(mesh, bdofs.cells[i]);
+    _g->restrict(&data.w[0], element, cell, ufc_cell);
+
+    // Set boundary values
+    for (std::size_t j = bdofs.offsets[i]; j < bdofs.offsets[i + 1]; ++j)
+      values[bdofs.positions[j]] = data.w[bdofs.local_dofs[j]];
+  }
+}
+//-----------------------------------------------------------------------------
+void DirichletBC::compute_bc_topological(SourceMap& sources,
+                                         BoundaryDofs& bdofs,
                                          LocalData& data) const
 {
   dolfin_assert(_function_space);
@@ -770,9 +846,6 @@ void DirichletBC::compute_bc_topological(Map& boundary_values,
   const Mesh& mesh = *_function_space->mesh();
   const GenericDofMap& dofmap = *_function_space->dofmap();
 
-  // Create UFC cell object
-  UFCCell ufc_cell(mesh);
-
   // Topological dimension
   const std::size_t D = mesh.topology().dim();
 
@@ -786,7 +859,7 @@ void DirichletBC::compute_bc_topological(Map& boundary_values,
 
   // Iterate over marked
   dolfin_assert(_function_space->element());
-  Progress p("Computing Dirichlet boundary values, topological search", _facets.size());
+  Progress p("Computing Dirichlet boundary dofs, topological search", _facets.size());
   for (std::size_t f = 0; f < _facets.size(); ++f)
   {
     // Create facet
@@ -819,30 +892,28 @@ void DirichletBC::compute_bc_topological(Map& boundary_values,
     // Get local index of facet with respect to the cell
     const size_t facet_local_index  = cell.index(facet);
 
-    // Update UFC cell
-    ufc_cell.update(cell, facet_local_index);
-
-    // Restrict coefficient to cell
-    _g->restrict(&data.w[0], *_function_space->element(), cell, ufc_cell);
+    // Record cell on which coefficient is restricted
+    const std::size_t entry = bdofs.add_cell(cell.index(), cell.index(),
+                                             facet_local_index);
 
     // Tabulate dofs on cell
-    const std::vector<dolfin::la_index>& cell_dofs = dofmap.cell_dofs(cell.index());
+    const ArrayView<const dolfin::la_index> cell_dofs = dofmap.cell_dofs(cell.index());
 
     // Tabulate which dofs are on the facet
     dofmap.tabulate_facet_dofs(data.facet_dofs, facet_local_index);
 
-    // Pick values for facet
+    // Pick dofs for facet
     for (std::size_t i = 0; i < dofmap.num_facet_dofs(); i++)
     {
       const std::size_t global_dof = cell_dofs[data.facet_dofs[i]];
-      const double value = data.w[data.facet_dofs[i]];
-      boundary_values[global_dof] = value;
+      sources[global_dof] = std::make_pair(entry, data.facet_dofs[i]);
     }
     p++;
   }
 }
 //-----------------------------------------------------------------------------
-void DirichletBC::compute_bc_geometric(Map& boundary_values,
+void DirichletBC::compute_bc_geometric(SourceMap& sources,
+                                       BoundaryDofs& bdofs,
                                        LocalData& data) const
 {
   dolfin_assert(_function_space);
@@ -878,7 +949,7 @@ void DirichletBC::compute_bc_geometric(Map& boundary_values,
   const std::size_t D = mesh.topology().dim();
 
   // Iterate over facets
-  Progress p("Computing Dirichlet boundary values, geometric search", _facets.size());
+  Progress p("Computing Dirichlet boundary dofs, geometric search", _facets.size());
   for (std::size_t f = 0; f < _facets.size(); ++f)
   {
     // Create facet
@@ -902,10 +973,11 @@ void DirichletBC::compute_bc_geometric(Map& boundary_values,
         ufc_cell.update(*c, local_facet);
 
         bool tabulated = false;
-        bool interpolated = false;
+        std::size_t entry = 0;
+        bool recorded = false;
 
         // Tabulate dofs on cell
-        const std::vector<dolfin::la_index>& cell_dofs
+        const ArrayView<const dolfin::la_index> cell_dofs
           = dofmap.cell_dofs(c->index());
 
         // Loop over all dofs on cell
@@ -928,23 +1000,24 @@ void DirichletBC::compute_bc_geometric(Map& boundary_values,
           if (already_visited.in_range(global_dof) && !already_visited.insert(global_dof))
             continue;
 
-          // Restrict if not already done
-          if (!interpolated)
+          // Record cell on which coefficient is restricted if not
+          // already done
+          if (!recorded)
           {
-            _g->restrict(&data.w[0], *_function_space->element(), cell, ufc_cell);
-            interpolated = true;
+            entry = bdofs.add_cell(cell.index(), c->index(), local_facet);
+            recorded = true;
           }
 
-          // Set boundary value
-          const double value = data.w[i];
-          boundary_values[global_dof] = value;
+          // Set boundary dof
+          sources[global_dof] = std::make_pair(entry, i);
         }
       }
     }
   }
 }
 //-----------------------------------------------------------------------------
-void DirichletBC::compute_bc_pointwise(Map& boundary_values,
+void DirichletBC::compute_bc_pointwise(SourceMap& sources,
+                                       BoundaryDofs& bdofs,
                                        LocalData& data) const
 {
   dolfin_assert(_function_space);
@@ -976,7 +1049,7 @@ void DirichletBC::compute_bc_pointwise(Map& boundary_values,
                                  : dofmap.ownership_range());
 
   // Iterate over cells
-  Progress p("Computing Dirichlet boundary values, pointwise search", mesh.num_cells());
+  Progress p("Computing Dirichlet boundary dofs, pointwise search", mesh.num_cells());
   for (CellIterator cell(mesh); !cell.end(); ++cell)
   {
     // Update UFC cell
@@ -986,10 +1059,11 @@ void DirichletBC::compute_bc_pointwise(Map& boundary_values,
     dofmap.tabulate_coordinates(data.coordinates, ufc_cell);
 
     // Tabulate dofs on cell
-    const std::vector<dolfin::la_index>& cell_dofs = dofmap.cell_dofs(cell->index());
+    const ArrayView<const dolfin::la_index> cell_dofs = dofmap.cell_dofs(cell->index());
 
-    // Interpolate function only once and only on cells where necessary
-    bool already_interpolated = false;
+    // Record cell only once and only on cells where necessary
+    std::size_t entry = 0;
+    bool recorded = false;
 
     // Loop all dofs on cell
     for (std::size_t i = 0; i < dofmap.cell_dimension(cell->index()); ++i)
@@ -1005,17 +1079,15 @@ void DirichletBC::compute_bc_pointwise(Map& boundary_values,
       if (!_user_sub_domain->inside(x, false))
         continue;
 
-      if (!already_interpolated)
+      // Record cell on which coefficient is restricted
+      if (!recorded)
       {
-        already_interpolated = true;
-
-        // Restrict coefficient to cell
-        _g->restrict(&data.w[0], *_function_space->element(), *cell, ufc_cell);
+        entry = bdofs.add_cell(cell->index(), cell->index(), -1);
+        recorded = true;
       }
 
-      // Set boundary value
-      const double value = data.w[i];
-      boundary_values[global_dof] = value;
+      // Set boundary dof
+      sources[global_dof] = std::make_pair(entry, i);
     }
 
     p++;
@@ -1142,3 +1214,55 @@ DirichletBC::LocalData::LocalData(const FunctionSpace& V)
   // Do nothing
 }
 //-----------------------------------------------------------------------------
+void DirichletBC::BoundaryDofs::clear()
+{
+  dofs.clear();
+  cells.clear();
+  ufc_cells.clear();
+  local_facets.clear();
+  offsets.clear();
+  local_dofs.clear();
+  positions.clear();
+  valid = false;
+}
+//-----------------------------------------------------------------------------
+std::size_t DirichletBC::BoundaryDofs::add_cell(std::size_t cell,
+                                                std::size_t ufc_cell,
+                                                int local_facet)
+{
+  cells.push_back(cell);
+  ufc_cells.push_back(ufc_cell);
+  local_facets.push_back(local_facet);
+  return cells.size() - 1;
+}
+//-----------------------------------------------------------------------------
+void DirichletBC::BoundaryDofs::build(const SourceMap& sources)
+{
+  // Sort boundary dofs
+  std::vector<std::pair<std::size_t, std::pair<std::size_t, std::size_t> > >
+    sorted_sources(sources.begin(), sources.end());
+  std::sort(sorted_sources.begin(), sorted_sources.end());
+
+  // Copy dofs and count number of dofs taken from each cell
+  dofs.resize(sorted_sources.size());
+  offsets.assign(cells.size() + 1, 0);
+  for (std::size_t i = 0; i < sorted_sources.size(); ++i)
+  {
+    dofs[i] = sorted_sources[i].first;
+    offsets[sorted_sources[i].second.first + 1]++;
+  }
+  for (std::size_t i = 0; i < cells.size(); ++i)
+    offsets[i + 1] += offsets[i];
+
+  // Insert local dofs and positions in sorted dof list for each cell
+  std::vector<std::size_t> counter(offsets.begin(), offsets.end() - 1);
+  local_dofs.resize(sorted_sources.size());
+  positions.resize(sorted_sources.size());
+  for (std::size_t i = 0; i < sorted_sources.size(); ++i)
+  {
+    const std::size_t entry = sorted_sources[i].second.first;
+    local_dofs[counter[entry]] = sorted_sources[i].second.second;
+    positions[counter[entry]++] = i;
+  }
+}
+//-----------------------------------------------------------------------------
@@ -20,7 +20,7 @@
 // Modified by Joachim B Haga, 2012
 //
 // First added:  2007-04-10
-// Last changed: 2012-11-14
+// Last changed: 2026-10-16
 //
 // FIXME: This class needs some cleanup, in particular collecting
 //        all data from different representations into a common
@@ -47,6 +47,7 @@ namespace dolfin
 
   class GenericFunction;
   class FunctionSpace;
+  class GenericDofMap;
   class Facet;
   class Restriction;
   class GenericMatrix;
@@ -415,6 +416,15 @@ namespace dolfin
     /// Set value to 0.0
     void homogenize();
 
+    /// Clear cached boundary dofs. The boundary dofs (but not the
+    /// boundary values) are computed once and reused by subsequent
+    /// calls to apply(). The cache is refreshed automatically if the
+    /// mesh or the dof map changes, including when the mesh
+    /// coordinates are modified in place (e.g. moved) and the
+    /// geometric or pointwise method is used. Clearing the cache is
+    /// only needed to release its memory.
+    void clear_cache();
+
     /// Return method used for computing Dirichet dofs
     ///
     /// *Returns*
@@ -434,6 +444,12 @@ namespace dolfin
   private:
 
     class LocalData;
+    class BoundaryDofs;
+
+    // Map from boundary dof to (index of cell in BoundaryDofs, local
+    // dof on that cell) used while computing boundary dofs
+    typedef boost::unordered_map<std::size_t, std::pair<std::size_t, std::size_t> >
+      SourceMap;
 
     // Apply boundary conditions, common method
     void apply(GenericMatrix* A, GenericVector* b,
@@ -456,23 +472,31 @@ namespace dolfin
     // Initialize sub domain markers from mesh
     void init_from_mesh(std::size_t sub_domain) const;
 
-    // Compute dofs and values for application of boundary conditions using
-    // given method
-    void compute_bc(Map& boundary_values, LocalData& data,
+    // Return boundary dofs for the default method, recomputing them
+    // if necessary
+    const BoundaryDofs& boundary_dofs(LocalData& data) const;
+
+    // Compute boundary dofs for application of boundary conditions
+    // using given method
+    void compute_bc(BoundaryDofs& bdofs, LocalData& data,
                     std::string method) const;
 
-    // Compute boundary values for facet (topological approach)
-    void compute_bc_topological(Map& boundary_values,
+    // Compute boundary dofs (topological approach)
+    void compute_bc_topological(SourceMap& sources, BoundaryDofs& bdofs,
                                 LocalData& data) const;
 
-    // Compute boundary values for facet (geometrical approach)
-    void compute_bc_geometric(Map& boundary_values,
+    // Compute boundary dofs (geometrical approach)
+    void compute_bc_geometric(SourceMap& sources, BoundaryDofs& bdofs,
                               LocalData& data) const;
 
-    // Compute boundary values for facet (pointwise approach)
-    void compute_bc_pointwise(Map& boundary_values,
+    // Compute boundary dofs (pointwise approach)
+    void compute_bc_pointwise(SourceMap& sources, BoundaryDofs& bdofs,
                               LocalData& data) const;
 
+    // Evaluate boundary value g at boundary dofs
+    void compute_bc_values(std::vector<double>& values,
+                           const BoundaryDofs& bdofs, LocalData& data) const;
+
     // Check if the point is in the same plane as the given facet
     bool on_facet(const double* coordinates, const Facet& facet) const;
 
@@ -531,6 +555,56 @@ namespace dolfin
 
     };
 
+    // Boundary dofs, together with the cells on which the boundary
+    // value g is restricted to compute the values at these dofs
+    class BoundaryDofs
+    {
+    public:
+
+      // Constructor
+      BoundaryDofs() : valid(false), method(""), mesh_id(0), num_cells(0),
+        num_vertices(0), coordinates_hash(0), dofmap(0) {}
+
+      // Clear all data
+      void clear();
+
+      // Add cell on which g is restricted and return its index
+      std::size_t add_cell(std::size_t cell, std::size_t ufc_cell,
+                           int local_facet);
+
+      // Build sorted dof array and cell - dof map from sources
+      void build(const SourceMap& sources);
+
+      // Boundary dofs (sorted)
+      std::vector<dolfin::la_index> dofs;
+
+      // Cells on which g is restricted (cell passed to restrict and
+      // cell and local facet of UFC cell)
+      std::vector<std::size_t> cells;
+      std::vector<std::size_t> ufc_cells;
+      std::vector<int> local_facets;
+
+      // Local dofs and positions in dofs of the boundary dofs
+      // computed on each cell (cell i owns entries offsets[i] to
+      // offsets[i + 1] - 1)
+      std::vector<std::size_t> offsets;
+      std::vector<std::size_t> local_dofs;
+      std::vector<std::size_t> positions;
+
+      // Data used to check if cached boundary dofs are still valid
+      bool valid;
+      std::string method;
+      std::size_t mesh_id;
+      std::size_t num_cells;
+      std::size_t num_vertices;
+      std::size_t coordinates_hash;
+      const GenericDofMap* dofmap;
+
+    };
+
+    // Cached boundary dofs (for default method)
+    mutable BoundaryDofs _boundary_dofs;
+
 
   };
 
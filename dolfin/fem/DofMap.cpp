@@ -24,7 +24,7 @@
 // Modified by Jan Blechta, 2013
 //
 // First added:  2007-03-01
-// Last changed: 2013-03-04
+// Last changed: 2026-10-16
 
 #include <boost/unordered_map.hpp>
 #include <dolfin/common/MPI.h>
@@ -44,7 +44,8 @@ using namespace dolfin;
 //-----------------------------------------------------------------------------
 DofMap::DofMap(boost::shared_ptr<const ufc::dofmap> ufc_dofmap,
                const Mesh& mesh)
-   : _ufc_dofmap(ufc_dofmap), _global_dimension(0), _ufc_offset(0)
+   : _cell_stride(0), _num_cells(0), _ufc_dofmap(ufc_dofmap),
+     _global_dimension(0), _ufc_offset(0)
 {
   dolfin_assert(_ufc_dofmap);
 
@@ -55,7 +56,8 @@ DofMap::DofMap(boost::shared_ptr<const ufc::dofmap> ufc_dofmap,
 DofMap::DofMap(boost::shared_ptr<const ufc::dofmap> ufc_dofmap,
                const Mesh& mesh,
                boost::shared_ptr<const SubDomain> constrained_domain)
-  : _ufc_dofmap(ufc_dofmap), _global_dimension(0), _ufc_offset(0)
+  : _cell_stride(0), _num_cells(0), _ufc_dofmap(ufc_dofmap),
+    _global_dimension(0), _ufc_offset(0)
 {
   dolfin_assert(_ufc_dofmap);
 
@@ -81,8 +83,8 @@ DofMap::DofMap(boost::shared_ptr<const ufc::dofmap> ufc_dofmap,
 //-----------------------------------------------------------------------------
 DofMap::DofMap(boost::shared_ptr<const ufc::dofmap> ufc_dofmap,
                boost::shared_ptr<const Restriction> restriction)
-  : _ufc_dofmap(ufc_dofmap), _restriction(restriction), _global_dimension(0),
-    _ufc_offset(0)
+  : _cell_stride(0), _num_cells(0), _ufc_dofmap(ufc_dofmap),
+    _restriction(restriction), _global_dimension(0), _ufc_offset(0)
 {
   dolfin_assert(_ufc_dofmap);
   dolfin_assert(_restriction);
@@ -104,7 +106,8 @@ DofMap::DofMap(boost::shared_ptr<const ufc::dofmap> ufc_dofmap,
 //-----------------------------------------------------------------------------
 DofMap::DofMap(const DofMap& parent_dofmap,
   const std::vector<std::size_t>& component, const Mesh& mesh)
-  : _global_dimension(0), _ufc_offset(0), _ownership_range(0, 0)
+  : _cell_stride(0), _num_cells(0), _global_dimension(0), _ufc_offset(0),
+    _ownership_range(0, 0)
 {
   // Note: Ownership range is set to zero since dofmap is a view
 
@@ -117,8 +120,8 @@ DofMap::DofMap(const DofMap& parent_dofmap,
 //-----------------------------------------------------------------------------
 DofMap::DofMap(boost::unordered_map<std::size_t, std::size_t>& collapsed_map,
                const DofMap& dofmap_view, const Mesh& mesh)
-   :  _ufc_dofmap(dofmap_view._ufc_dofmap), _global_dimension(0),
-      _ufc_offset(0)
+   :  _cell_stride(0), _num_cells(0), _ufc_dofmap(dofmap_view._ufc_dofmap),
+      _global_dimension(0), _ufc_offset(0)
 {
   dolfin_assert(_ufc_dofmap);
 
@@ -145,9 +148,9 @@ DofMap::DofMap(boost::unordered_map<std::size_t, std::size_t>& collapsed_map,
   DofMapBuilder::build(*this, mesh, slave_master_mesh_entities, _restriction);
 
   // Dimension sanity checks
-  dolfin_assert(dofmap_view._dofmap.size() == mesh.num_cells());
+  dolfin_assert(dofmap_view._num_cells == mesh.num_cells());
   dolfin_assert(global_dimension() == dofmap_view.global_dimension());
-  dolfin_assert(_dofmap.size() == mesh.num_cells());
+  dolfin_assert(_num_cells == mesh.num_cells());
 
   // FIXME: Could we use a std::vector instead of std::map if the
   //        collapsed dof map is contiguous (0, . . . , n)?
@@ -156,12 +159,13 @@ DofMap::DofMap(boost::unordered_map<std::size_t, std::size_t>& collapsed_map,
   collapsed_map.clear();
   for (std::size_t i = 0; i < mesh.num_cells(); ++i)
   {
-    const std::vector<dolfin::la_index>& view_cell_dofs = dofmap_view._dofmap[i];
-    const std::vector<dolfin::la_index>& cell_dofs = _dofmap[i];
-    dolfin_assert(view_cell_dofs.size() == cell_dofs.size());
+    const ArrayView<const dolfin::la_index> view_cell_dofs
+      = dofmap_view.cell_dofs(i);
+    const ArrayView<const dolfin::la_index> _cell_dofs = cell_dofs(i);
+    dolfin_assert(view_cell_dofs.size() == _cell_dofs.size());
 
     for (std::size_t j = 0; j < view_cell_dofs.size(); ++j)
-      collapsed_map[cell_dofs[j]] = view_cell_dofs[j];
+      collapsed_map[_cell_dofs[j]] = view_cell_dofs[j];
   }
 }
 //-----------------------------------------------------------------------------
@@ -169,6 +173,9 @@ DofMap::DofMap(const DofMap& dofmap)
 {
   // Copy data
   _dofmap = dofmap._dofmap;
+  _cell_offsets = dofmap._cell_offsets;
+  _cell_stride = dofmap._cell_stride;
+  _num_cells = dofmap._num_cells;
   _ufc_dofmap = dofmap._ufc_dofmap;
   ufc_map_to_dofmap = dofmap.ufc_map_to_dofmap;
   _global_dimension = dofmap._global_dimension;
@@ -192,8 +199,11 @@ std::size_t DofMap::global_dimension() const
 //-----------------------------------------------------------------------------
 std::size_t DofMap::cell_dimension(std::size_t cell_index) const
 {
-  dolfin_assert(cell_index < _dofmap.size());
-  return _dofmap[cell_index].size();
+  dolfin_assert(cell_index < _num_cells);
+  if (_cell_offsets.empty())
+    return _cell_stride;
+  else
+    return _cell_offsets[cell_index + 1] - _cell_offsets[cell_index];
 }
 //-----------------------------------------------------------------------------
 std::size_t DofMap::max_cell_dimension() const
@@ -322,7 +332,7 @@ std::vector<double> DofMap::tabulate_all_coordinates(const Mesh& mesh) const
     ufc_cell.update(*cell);
 
     // Get local-to-global map
-    const std::vector<dolfin::la_index>& dofs = cell_dofs(cell->index());
+    const ArrayView<const dolfin::la_index> dofs = cell_dofs(cell->index());
 
     // Tabulate dof coordinates on cell
     tabulate_coordinates(coordinates, ufc_cell);
@@ -394,7 +404,7 @@ std::vector<dolfin::la_index> DofMap::dof_to_vertex_map(Mesh& mesh) const
     }
 
     // Get all cell dofs
-    const std::vector<dolfin::la_index>& _cell_dofs = cell_dofs(cell.index());
+    const ArrayView<const dolfin::la_index> _cell_dofs = cell_dofs(cell.index());
 
     // Tabulate local to local map of dofs on local vertex
     _ufc_dofmap->tabulate_entity_dofs(local_to_local_map.data(), 0, local_vertex_ind);
@@ -465,11 +475,11 @@ boost::shared_ptr<GenericDofMap>
 void DofMap::set(GenericVector& x, double value) const
 {
   std::vector<double> _value;
-  std::vector<std::vector<dolfin::la_index> >::const_iterator cell_dofs;
-  for (cell_dofs = _dofmap.begin(); cell_dofs != _dofmap.end(); ++cell_dofs)
+  for (std::size_t i = 0; i < _num_cells; ++i)
   {
-    _value.resize(cell_dofs->size(), value);
-    x.set(_value.data(), cell_dofs->size(), cell_dofs->data());
+    const ArrayView<const dolfin::la_index> dofs = cell_dofs(i);
+    _value.resize(dofs.size(), value);
+    x.set(_value.data(), dofs.size(), dofs.data());
   }
   x.apply("add");
 }
@@ -486,7 +496,7 @@ void DofMap::set_x(GenericVector& x, double value, std::size_t component,
     ufc_cell.update(*cell);
 
     // Get local-to-global map
-    const std::vector<dolfin::la_index>& dofs = cell_dofs(cell->index());
+    const ArrayView<const dolfin::la_index> dofs = cell_dofs(cell->index());
 
     // Tabulate dof coordinates
     tabulate_coordinates(coordinates, ufc_cell);
@@ -532,13 +542,14 @@ std::string DofMap::str(bool verbose) const
   if (verbose)
   {
     // Cell loop
-    for (std::size_t i = 0; i < _dofmap.size(); ++i)
+    for (std::size_t i = 0; i < _num_cells; ++i)
     {
-      s << prefix.str() << "Local cell index, cell dofmap dimension: " << i << ", " << _dofmap[i].size() << std::endl;
+      const ArrayView<const dolfin::la_index> dofs = cell_dofs(i);
+      s << prefix.str() << "Local cell index, cell dofmap dimension: " << i << ", " << dofs.size() << std::endl;
 
       // Local dof loop
-      for (std::size_t j = 0; j < _dofmap[i].size(); ++j)
-        s << prefix.str() <<  "  " << "Local, global dof indices: " << j << ", " << _dofmap[i][j] << std::endl;
+      for (std::size_t j = 0; j < dofs.size(); ++j)
+        s << prefix.str() <<  "  " << "Local, global dof indices: " << j << ", " << dofs[j] << std::endl;
     }
   }
 
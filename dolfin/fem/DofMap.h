@@ -23,7 +23,7 @@
 // Modified by Jan Blechta, 2013
 //
 // First added:  2007-03-01
-// Last changed: 2013-03-04
+// Last changed: 2026-10-16
 
 #ifndef __DOLFIN_DOF_MAP_H
 #define __DOLFIN_DOF_MAP_H
@@ -37,6 +37,7 @@
 #include <boost/unordered_map.hpp>
 #include <ufc.h>
 
+#include <dolfin/common/ArrayView.h>
 #include <dolfin/common/types.h>
 #include <dolfin/mesh/Cell.h>
 #include "GenericDofMap.h"
@@ -228,12 +229,24 @@ namespace dolfin
     ///         The cell index.
     ///
     /// *Returns*
-    ///     std::vector<dolfin::la_index>
+    ///     ArrayView<const dolfin::la_index>
     ///         Local-to-global mapping of dofs.
-    const std::vector<dolfin::la_index>& cell_dofs(std::size_t cell_index) const
+    ArrayView<const dolfin::la_index> cell_dofs(std::size_t cell_index) const
     {
-      dolfin_assert(cell_index < _dofmap.size());
-      return _dofmap[cell_index];
+      dolfin_assert(cell_index < _num_cells);
+      if (_cell_offsets.empty())
+      {
+        // Fast path: all cells have the same number of dofs
+        return ArrayView<const dolfin::la_index>(_cell_stride,
+                                   _dofmap.data() + cell_index*_cell_stride);
+      }
+      else
+      {
+        const std::size_t offset = _cell_offsets[cell_index];
+        return ArrayView<const dolfin::la_index>(_cell_offsets[cell_index + 1]
+                                                 - offset,
+                                                 _dofmap.data() + offset);
+      }
     }
 
     /// Tabulate local-local facet dofs
@@ -385,13 +398,14 @@ namespace dolfin
     void set_x(GenericVector& x, double value, std::size_t component,
                const Mesh& mesh) const;
 
-    /// Return the underlying dof map data. Intended for internal library
+    /// Return the underlying dof map data. The dofs for all cells are
+    /// stored contiguously, cell by cell. Intended for internal library
     /// use only.
     ///
     /// *Returns*
-    ///     std::vector<std::vector<dolfin::la_index> >
-    ///         The local-to-global map for each cell.
-    const std::vector<std::vector<dolfin::la_index> >& data() const
+    ///     std::vector<dolfin::la_index>
+    ///         The local-to-global map for all cells.
+    const std::vector<dolfin::la_index>& data() const
     { return _dofmap; }
 
     /// Return informal string representation (pretty-print)
@@ -418,8 +432,21 @@ namespace dolfin
     static void check_provided_entities(const ufc::dofmap& dofmap,
                                         const Mesh& mesh);
 
-    // Local-to-global dof map (dofs for cell dofmap[i])
-    std::vector<std::vector<dolfin::la_index> > _dofmap;
+    // Local-to-global dof map. The dofs for all cells are stored
+    // contiguously, cell by cell (compressed row storage)
+    std::vector<dolfin::la_index> _dofmap;
+
+    // Offset of the dofs for cell i in _dofmap is _cell_offsets[i]
+    // (size num_cells + 1). Empty if all cells have the same number
+    // of dofs, in which case the offset is i*_cell_stride.
+    std::vector<std::size_t> _cell_offsets;
+
+    // Number of dofs per cell if all cells have the same number of
+    // dofs (used when _cell_offsets is empty)
+    std::size_t _cell_stride;
+
+    // Number of cells in the dof map
+    std::size_t _num_cells;
 
     // UFC dof map
     boost::shared_ptr<const ufc::dofmap> _ufc_dofmap;
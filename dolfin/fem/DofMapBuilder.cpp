@@ -22,7 +22,7 @@
 // Modified by Martin Alnaes, 2013
 //
 // First added:  2008-08-12
-// Last changed: 2013-01-08
+// Last changed: 2026-10-16
 
 #include <ufc.h>
 #include <boost/random.hpp>
@@ -133,9 +133,9 @@ void DofMapBuilder::build_sub_map(DofMap& sub_dofmap,
                    parent_dofmap.slave_master_mesh_entities, restriction);
 
   // Add offset to dofmap
-  for (std::size_t i = 0; i < sub_dofmap._dofmap.size(); ++i)
-    for (std::size_t j = 0; j < sub_dofmap._dofmap[i].size(); ++j)
-      sub_dofmap._dofmap[i][j] += offset;
+  std::vector<dolfin::la_index>::iterator dof;
+  for (dof = sub_dofmap._dofmap.begin(); dof != sub_dofmap._dofmap.end(); ++dof)
+    *dof += offset;
 
   // Correct dofmap for non-UFC numbering
   sub_dofmap.ufc_map_to_dofmap.clear();
@@ -145,37 +145,31 @@ void DofMapBuilder::build_sub_map(DofMap& sub_dofmap,
   if (!parent_dofmap.ufc_map_to_dofmap.empty())
   {
     boost::unordered_map<std::size_t, std::size_t>::const_iterator ufc_to_current_dof;
-    std::vector<std::vector<dolfin::la_index> >::iterator cell_map;
-    std::vector<dolfin::la_index>::iterator dof;
-    for (cell_map = sub_dofmap._dofmap.begin();
-        cell_map != sub_dofmap._dofmap.end(); ++cell_map)
+    for (dof = sub_dofmap._dofmap.begin(); dof != sub_dofmap._dofmap.end(); ++dof)
     {
-      for (dof = cell_map->begin(); dof != cell_map->end(); ++dof)
+      // Get dof index
+      ufc_to_current_dof = parent_dofmap.ufc_map_to_dofmap.find(*dof);
+      dolfin_assert(ufc_to_current_dof != parent_dofmap.ufc_map_to_dofmap.end());
+
+      // Add to ufc-to-current dof map
+      sub_dofmap.ufc_map_to_dofmap.insert(*ufc_to_current_dof);
+
+      // Set dof index
+      *dof = ufc_to_current_dof->second;
+
+      // Add to off-process dof owner map
+      boost::unordered_map<std::size_t, unsigned int>::const_iterator
+        parent_off_proc = parent_dofmap._off_process_owner.find(*dof);
+      if (parent_off_proc != parent_dofmap._off_process_owner.end())
+        sub_dofmap._off_process_owner.insert(*parent_off_proc);
+
+      // Add to shared-dof process map, and update the set of neighbours
+      boost::unordered_map<std::size_t, std::vector<unsigned int> >::const_iterator
+        parent_shared = parent_dofmap._shared_dofs.find(*dof);
+      if (parent_shared != parent_dofmap._shared_dofs.end())
       {
-        // Get dof index
-        ufc_to_current_dof = parent_dofmap.ufc_map_to_dofmap.find(*dof);
-        dolfin_assert(ufc_to_current_dof != parent_dofmap.ufc_map_to_dofmap.end());
-
-        // Add to ufc-to-current dof map
-        sub_dofmap.ufc_map_to_dofmap.insert(*ufc_to_current_dof);
-
-        // Set dof index
-        *dof = ufc_to_current_dof->second;
-
-        // Add to off-process dof owner map
-        boost::unordered_map<std::size_t, unsigned int>::const_iterator
-          parent_off_proc = parent_dofmap._off_process_owner.find(*dof);
-        if (parent_off_proc != parent_dofmap._off_process_owner.end())
-          sub_dofmap._off_process_owner.insert(*parent_off_proc);
-
-        // Add to shared-dof process map, and update the set of neighbours
-        boost::unordered_map<std::size_t, std::vector<unsigned int> >::const_iterator
-          parent_shared = parent_dofmap._shared_dofs.find(*dof);
-        if (parent_shared != parent_dofmap._shared_dofs.end())
-        {
-          sub_dofmap._shared_dofs.insert(*parent_shared);
-          sub_dofmap._neighbours.insert(parent_shared->second.begin(), parent_shared->second.end());
-        }
+        sub_dofmap._shared_dofs.insert(*parent_shared);
+        sub_dofmap._neighbours.insert(parent_shared->second.begin(), parent_shared->second.end());
       }
     }
   }
@@ -380,13 +374,12 @@ void DofMapBuilder::reorder_local(DofMap& dofmap, const Mesh& mesh,
   // Build local graph for blocks
   for (CellIterator cell(mesh); !cell.end(); ++cell)
   {
-    const std::vector<dolfin::la_index>& dofs0 = dofmap.cell_dofs(cell->index());
-    const std::vector<dolfin::la_index>& dofs1 = dofmap.cell_dofs(cell->index());
+    const ArrayView<const dolfin::la_index> dofs0 = dofmap.cell_dofs(cell->index());
+    const ArrayView<const dolfin::la_index> dofs1 = dofmap.cell_dofs(cell->index());
 
     dolfin_assert(dofs0.size() % block_size == 0);
     const std::size_t nodes_per_cell = dofs0.size()/block_size;
 
-    std::vector<dolfin::la_index>::const_iterator node0, node1;
     for (std::size_t i = 0; i < nodes_per_cell; ++i)
       for (std::size_t j = 0; j < nodes_per_cell; ++j)
         if (dofs0[i] != dofs1[j])
@@ -397,17 +390,13 @@ void DofMapBuilder::reorder_local(DofMap& dofmap, const Mesh& mesh,
   const std::vector<std::size_t> block_remap
     = BoostGraphOrdering::compute_cuthill_mckee(graph, true);
 
-  // Re-number dofs for each cell
-  std::vector<std::vector<dolfin::la_index> >::iterator cell_map;
+  // Re-number dofs for each cell (all cells are stored contiguously)
   std::vector<dolfin::la_index>::iterator dof;
-  for (cell_map = dofmap._dofmap.begin(); cell_map != dofmap._dofmap.end(); ++cell_map)
+  for (dof = dofmap._dofmap.begin(); dof != dofmap._dofmap.end(); ++dof)
   {
-    for (dof = cell_map->begin(); dof != cell_map->end(); ++dof)
-    {
-      const std::size_t old_node = (*dof) % num_nodes;
-      const std::size_t new_node = block_remap[old_node];
-      *dof = new_node*block_size + (*dof)/num_nodes;
-    }
+    const std::size_t old_node = (*dof) % num_nodes;
+    const std::size_t new_node = block_remap[old_node];
+    *dof = new_node*block_size + (*dof)/num_nodes;
   }
 
   // Store re-ordering map (from UFC dofmap)
@@ -498,19 +487,40 @@ void DofMapBuilder::build_ufc_dofmap(DofMap& dofmap,
     }
   }
 
-  // Allocate space for dof map
-  dofmap._dofmap.resize(mesh.num_cells());
   dofmap._off_process_owner.clear();
   dolfin_assert(dofmap._ufc_dofmap);
 
+  // Get standard local element dimension
+  const std::size_t local_dim = dofmap._ufc_dofmap->local_dimension();
+
+  // Allocate space for dof map. All cells have local_dim dofs unless
+  // the space is restricted, in which case cells outside the
+  // restriction have no dofs and explicit cell offsets are required.
+  const std::size_t num_cells = mesh.num_cells();
+  dofmap._num_cells = num_cells;
+  dofmap._cell_stride = local_dim;
+  dofmap._cell_offsets.clear();
+  if (!restriction)
+    dofmap._dofmap.resize(num_cells*local_dim);
+  else
+  {
+    std::size_t num_restricted_cells = 0;
+    dofmap._cell_offsets.resize(num_cells + 1);
+    dofmap._cell_offsets[0] = 0;
+    for (CellIterator cell(mesh); !cell.end(); ++cell)
+    {
+      if (restriction->contains(*cell))
+        ++num_restricted_cells;
+      dofmap._cell_offsets[cell->index() + 1] = num_restricted_cells*local_dim;
+    }
+    dofmap._dofmap.resize(num_restricted_cells*local_dim);
+  }
+
   // Maps used to renumber dofs for restricted meshes
   map restricted_dofs;         // map from old to new dof
 
   // Holder for UFC 64-bit dofmap integers
-  std::vector<std::size_t> ufc_dofs;
-
-  // Get standard local element dimension
-  const std::size_t local_dim = dofmap._ufc_dofmap->local_dimension();
+  std::vector<std::size_t> ufc_dofs(local_dim);
 
   // Build dofmap from ufc::dofmap
   UFCCell ufc_cell(mesh);
@@ -535,20 +545,21 @@ void DofMapBuilder::build_ufc_dofmap(DofMap& dofmap,
     ufc_cell.entity_indices[D][0] = cell->index();
     ufc_cell.index = cell->index();
 
-    // Get container for cell dofs
-    std::vector<dolfin::la_index>& cell_dofs = dofmap._dofmap[cell->index()];
-    cell_dofs.resize(local_dim);
+    // Get position of cell dofs in contiguous storage
+    const std::size_t offset = restriction ? dofmap._cell_offsets[cell->index()]
+                                           : cell->index()*local_dim;
+    dolfin_assert(offset + local_dim <= dofmap._dofmap.size());
+    dolfin::la_index* cell_dofs = dofmap._dofmap.data() + offset;
 
     // Tabulate standard UFC dof map
-    ufc_dofs.resize(local_dim);
     dofmap._ufc_dofmap->tabulate_dofs(ufc_dofs.data(),
                                       dofmap.num_global_mesh_entities, ufc_cell);
-    std::copy(ufc_dofs.begin(), ufc_dofs.end(), cell_dofs.begin());
+    std::copy(ufc_dofs.begin(), ufc_dofs.end(), cell_dofs);
 
     // Renumber dofs if mesh is restricted
     if (restriction)
     {
-      for (std::size_t i = 0; i < cell_dofs.size(); i++)
+      for (std::size_t i = 0; i < local_dim; i++)
       {
         map_iterator it = restricted_dofs.find(cell_dofs[i]);
         if (it == restricted_dofs.end())
@@ -665,7 +676,7 @@ void DofMapBuilder::compute_node_ownership(boost::array<set, 3>& node_ownership,
         continue;
 
       // Tabulate dofs on cell
-      const std::vector<dolfin::la_index>& cell_dofs = dofmap.cell_dofs(c.index());
+      const ArrayView<const dolfin::la_index> cell_dofs = dofmap.cell_dofs(c.index());
 
       // Tabulate which dofs are on the facet
       dofmap.tabulate_facet_dofs(facet_dofs, c.index(f));
@@ -771,7 +782,7 @@ void DofMapBuilder::compute_node_ownership(boost::array<set, 3>& node_ownership,
   // Mark all shared-and-owned dofs as owned by the processes
   for (CellIterator cell(mesh); !cell.end(); ++cell)
   {
-    const std::vector<dolfin::la_index>& cell_dofs = dofmap.cell_dofs(cell->index());
+    const ArrayView<const dolfin::la_index> cell_dofs = dofmap.cell_dofs(cell->index());
     //const std::size_t cell_dimension = dofmap.cell_dimension(cell->index());
     for (std::size_t i = 0; i < cell_dofs.size(); ++i)
     {
@@ -837,9 +848,7 @@ void DofMapBuilder::parallel_renumber(const boost::array<set, 3>& node_ownership
                  "The degree of freedom mapping cannot be renumbered twice");
   }
 
-  const std::vector<std::vector<dolfin::la_index> >& old_dofmap = dofmap._dofmap;
-  std::vector<std::vector<dolfin::la_index> > new_dofmap(old_dofmap.size());
-  dolfin_assert(old_dofmap.size() == mesh.num_cells());
+  dolfin_assert(dofmap._num_cells == mesh.num_cells());
 
   // Compute offset for owned and non-shared nodes
   const std::size_t process_offset = MPI::global_offset(owned_nodes.size(), true);
@@ -863,17 +872,16 @@ void DofMapBuilder::parallel_renumber(const boost::array<set, 3>& node_ownership
     }
 
     // Build local graph, based on old dof map, with contiguous numbering
-    for (std::size_t cell = 0; cell < old_dofmap.size(); ++cell)
+    for (std::size_t cell = 0; cell < dofmap._num_cells; ++cell)
     {
       // Cell dofmaps with old indices
-      const std::vector<dolfin::la_index>& dofs0 = dofmap.cell_dofs(cell);
-      const std::vector<dolfin::la_index>& dofs1 = dofmap.cell_dofs(cell);
+      const ArrayView<const dolfin::la_index> dofs0 = dofmap.cell_dofs(cell);
+      const ArrayView<const dolfin::la_index> dofs1 = dofmap.cell_dofs(cell);
 
       dolfin_assert(dofs0.size() % block_size == 0);
       const std::size_t nodes_per_cell = dofs0.size()/block_size;
 
       // Loop over each node in dofs0
-      std::vector<dolfin::la_index>::const_iterator dof0, dof1;
       for (std::size_t i = 0; i < nodes_per_cell; ++i)
       {
         const std::size_t n0_old = dofs0[i] % num_nodes;
@@ -1015,47 +1023,17 @@ void DofMapBuilder::parallel_renumber(const boost::array<set, 3>& node_ownership
     dofmap._neighbours.insert(it->second.begin(), it->second.end());
   }
 
-  // Build new dofmap
-  for (CellIterator cell(mesh); !cell.end(); ++cell)
+  // Renumber dofs in place. The storage layout (cells outside a
+  // restriction have no dofs) is unchanged by renumbering.
+  std::vector<dolfin::la_index>::iterator dof;
+  for (dof = dofmap._dofmap.begin(); dof != dofmap._dofmap.end(); ++dof)
   {
-    // Skip cells not included in restriction
-    if (restriction && !restriction->contains(*cell))
-      continue;
-
-    // Get cell index and dimension
-    const std::size_t cell_index = cell->index();
-    const std::size_t cell_dimension = dofmap.cell_dimension(cell_index);
-
-    // Resize cell map and insert dofs
-    new_dofmap[cell_index].resize(cell_dimension);
-    for (std::size_t i = 0; i < cell_dimension; ++i)
-    {
-      // Get old dof
-      //std::size_t old_index = old_dofmap[cell_index][i];
-      //std::size_t old_node = old_dofmap[cell_index][i] % num_nodes;
-
-      // Map back to original (and common) numbering for restricted space
-      //if (restriction)
-      //{
-      //  const map_iterator it = restricted_nodes_inverse.find(old_index);
-      //  dolfin_assert(it != restricted_nodes_inverse.end());
-      //  old_index = it->second;
-      //}
-
-      // Insert dof
-      //new_dofmap[cell_index][i] = old_to_new_node_index[old_index];
-      //new_dofmap[cell_index][i] = old_to_new_node_index[old_index];
-
-      const std::size_t old_index = old_dofmap[cell_index][i];
-      const std::size_t old_node  = old_index % num_nodes;
-      const std::size_t new_node  = old_to_new_node_index[old_node];
-      new_dofmap[cell_index][i]   = new_node*block_size + old_index/num_nodes;
-    }
+    const std::size_t old_index = *dof;
+    const std::size_t old_node  = old_index % num_nodes;
+    const std::size_t new_node  = old_to_new_node_index[old_node];
+    *dof = new_node*block_size + old_index/num_nodes;
   }
 
-  // Set new dof map
-  dofmap._dofmap = new_dofmap;
-
   // Set ownership range
   dofmap._ownership_range
     = std::make_pair(block_size*process_offset,
@@ -19,12 +19,13 @@
 // Modified by Martin Alnes 2008
 //
 // First added:  2007-12-10
-// Last changed: 2011-11-14
+// Last changed: 2026-10-16
 
 #include <string>
 #include <boost/scoped_ptr.hpp>
 #include <dolfin/common/NoDeleter.h>
 #include <dolfin/fem/FiniteElement.h>
+#include <dolfin/fem/GenericDofMap.h>
 #include <dolfin/function/Function.h>
 #include <dolfin/function/FunctionSpace.h>
 #include <dolfin/function/GenericFunction.h>
@@ -101,10 +102,31 @@ std::vector<std::size_t> Form::coloring(std::size_t entity_dim) const
   }
   else if (entity_dim == cell_dim - 1)
   {
+    // Check whether all dofs are associated with cell interiors
+    // (e.g. DG spaces), in which case two facets can only share dofs
+    // if they are incident to a common cell
+    bool cell_local_dofs = true;
+    for (std::size_t i = 0; i < _function_spaces.size(); ++i)
+    {
+      dolfin_assert(_function_spaces[i]);
+      dolfin_assert(_function_spaces[i]->dofmap());
+      const GenericDofMap& dofmap = *_function_spaces[i]->dofmap();
+      for (std::size_t d = 0; d < cell_dim; ++d)
+      {
+        if (dofmap.num_entity_dofs(d) > 0)
+          cell_local_dofs = false;
+      }
+    }
+
+    // Facets sharing a cell (cell-local dofs) or facets whose cells
+    // share a vertex (general case) get different colors
     _coloring.push_back(cell_dim - 1);
     _coloring.push_back(cell_dim);
-    _coloring.push_back(0);
-    _coloring.push_back(cell_dim);
+    if (!cell_local_dofs)
+    {
+      _coloring.push_back(0);
+      _coloring.push_back(cell_dim);
+    }
     _coloring.push_back(cell_dim - 1);
   }
   else
@@ -32,6 +32,7 @@
 #include <boost/unordered_map.hpp>
 #include <boost/unordered_set.hpp>
 
+#include <dolfin/common/ArrayView.h>
 #include <dolfin/common/types.h>
 #include <dolfin/common/Variable.h>
 
@@ -95,8 +96,9 @@ namespace dolfin
     virtual const boost::unordered_map<std::size_t, unsigned int>&
       off_process_owner() const = 0;
 
-    /// Local-to-global mapping of dofs on a cell
-    virtual const std::vector<dolfin::la_index>& cell_dofs(std::size_t cell_index) const = 0;
+    /// Local-to-global mapping of dofs on a cell. The returned view
+    /// is valid for as long as the dof map is not modified.
+    virtual ArrayView<const dolfin::la_index> cell_dofs(std::size_t cell_index) const = 0;
 
     /// Tabulate local-local facet dofs
     virtual void tabulate_facet_dofs(std::vector<std::size_t>& dofs,
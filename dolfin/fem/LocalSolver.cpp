@@ -16,8 +16,10 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2013-02-12
-// Last changed:
+// Last changed: 2026-10-16
 
+#include <algorithm>
+#include <utility>
 #include <armadillo>
 
 #include <dolfin/la/GenericVector.h>
@@ -27,6 +29,7 @@
 #include <dolfin/mesh/Cell.h>
 #include <dolfin/function/GenericFunction.h>
 #include <dolfin/function/FunctionSpace.h>
+#include <dolfin/parameter/GlobalParameters.h>
 #include "GenericDofMap.h"
 #include "Form.h"
 #include "UFC.h"
@@ -58,18 +61,14 @@ void LocalSolver::solve(GenericVector& x, const Form& a, const Form& L,
   for (std::size_t i = 0; i < coefficients_L.size(); ++i)
     coefficients_L[i]->update();
 
-  // Form ranks
-  const std::size_t rank_a = ufc_a.form.rank();
-  const std::size_t rank_L = ufc_L.form.rank();
-
   // Check form ranks
-  dolfin_assert(rank_a == 2);
-  dolfin_assert(rank_L == 1);
+  dolfin_assert(ufc_a.form.rank() == 2);
+  dolfin_assert(ufc_L.form.rank() == 1);
 
   // Collect pointers to dof maps
   boost::shared_ptr<const GenericDofMap> dofmap_a0 = a.function_space(0)->dofmap();
   boost::shared_ptr<const GenericDofMap> dofmap_a1 = a.function_space(1)->dofmap();
-  boost::shared_ptr<const GenericDofMap> dofmap_L = a.function_space(0)->dofmap();
+  boost::shared_ptr<const GenericDofMap> dofmap_L = L.function_space(0)->dofmap();
   dolfin_assert(dofmap_a0);
   dolfin_assert(dofmap_a1);
   dolfin_assert(dofmap_L);
@@ -79,54 +78,365 @@ void LocalSolver::solve(GenericVector& x, const Form& a, const Form& L,
   x.resize(local_range);
 
   // Cell integrals
-  ufc::cell_integral* integral_a = ufc_a.default_cell_integral.get();
-  ufc::cell_integral* integral_L = ufc_L.default_cell_integral.get();
+  const ufc::cell_integral* integral_a = ufc_a.default_cell_integral.get();
+  const ufc::cell_integral* integral_L = ufc_L.default_cell_integral.get();
+  dolfin_assert(integral_a);
+  dolfin_assert(integral_L);
+
+  // Compute offsets of local problems (the local problems must be
+  // square and a and L must match)
+  const int num_cells = mesh.num_cells();
+  std::vector<std::size_t> matrix_offsets, vector_offsets;
+  compute_offsets(matrix_offsets, vector_offsets, *dofmap_L, num_cells);
+  std::vector<double> x_local(vector_offsets.back());
+
+  // Solve local problems (in parallel, cells are independent)
+  bool singular = false;
+  const std::size_t num_threads = dolfin::parameters["num_threads"];
+  #ifdef HAS_OPENMP
+  #pragma omp parallel num_threads(std::max(num_threads, (std::size_t) 1))
+  #endif
+  {
+    // Data for each thread
+    UFC _ufc_a(ufc_a);
+    UFC _ufc_L(ufc_L);
+    arma::mat A;
+    arma::vec b, x_cell;
+
+    #ifdef HAS_OPENMP
+    #pragma omp for schedule(guided) reduction(||:singular)
+    #endif
+    for (int i = 0; i < num_cells; ++i)
+    {
+      // Update to current cell
+      const Cell cell(mesh, i);
+      _ufc_a.update(cell);
+      _ufc_L.update(cell);
+
+      // Tabulate A and b on cell
+      const std::size_t n = vector_offsets[i + 1] - vector_offsets[i];
+      dolfin_assert(n == dofmap_a0->cell_dimension(i));
+      dolfin_assert(n == dofmap_a1->cell_dimension(i));
+      A.set_size(n, n);
+      b.set_size(n);
+      integral_a->tabulate_tensor(A.memptr(),
+                                  _ufc_a.w(),
+                                  &_ufc_a.cell.vertex_coordinates[0],
+                                  _ufc_a.cell.orientation);
+      integral_L->tabulate_tensor(b.memptr(),
+                                  _ufc_L.w(),
+                                  &_ufc_L.cell.vertex_coordinates[0],
+                                  _ufc_L.cell.orientation);
+
+      // Solve local problem (Armadillo uses column-major)
+      bool solved = n == 0;
+      if (n > 0 && symmetric)
+        solved = arma::solve(x_cell, A, b);
+      else if (n > 0)
+        solved = arma::solve(x_cell, A.t(), b);
+      if (solved)
+        std::copy(x_cell.begin(), x_cell.end(), x_local.begin() + vector_offsets[i]);
+      else
+        singular = true;
+    }
+  }
+
+  if (singular)
+  {
+    dolfin_error("LocalSolver.cpp",
+                 "solve local problems",
+                 "Local matrix is singular");
+  }
+
+  // Set solution in global vector
+  set_solution(x, x_local, vector_offsets, *dofmap_L);
+}
+//----------------------------------------------------------------------------
+void LocalSolver::factorize(const Form& a, bool symmetric)
+{
+  UFC ufc_a(a);
+
+  // Set timer
+  Timer timer("Local solver factorization");
+
+  // Extract mesh
+  const Mesh& mesh = a.mesh();
+
+  // Update off-process coefficients
+  const std::vector<boost::shared_ptr<const GenericFunction> >
+    coefficients_a = a.coefficients();
+  for (std::size_t i = 0; i < coefficients_a.size(); ++i)
+    coefficients_a[i]->update();
 
-  // Armadillo data structures
-  arma::mat A;
-  arma::vec b, x_local;
+  // Check form rank
+  dolfin_assert(ufc_a.form.rank() == 2);
 
-  // Assemble over cells
-  Progress p("Performing local (cell-wise) solve", mesh.num_cells());
-  for (CellIterator cell(mesh); !cell.end(); ++cell)
+  // Get dof map
+  boost::shared_ptr<const GenericDofMap> dofmap_a = a.function_space(0)->dofmap();
+  dolfin_assert(dofmap_a);
+
+  // Cell integral
+  const ufc::cell_integral* integral_a = ufc_a.default_cell_integral.get();
+  dolfin_assert(integral_a);
+
+  // Allocate storage for factorizations
+  const int num_cells = mesh.num_cells();
+  compute_offsets(_matrix_offsets, _vector_offsets, *dofmap_a, num_cells);
+  _factors.resize(_matrix_offsets.back());
+  _permutations.resize(_vector_offsets.back());
+
+  // Factorize local matrices (in parallel, cells are independent)
+  bool singular = false;
+  const std::size_t num_threads = dolfin::parameters["num_threads"];
+  #ifdef HAS_OPENMP
+  #pragma omp parallel num_threads(std::max(num_threads, (std::size_t) 1))
+  #endif
+  {
+    // Data for each thread
+    UFC _ufc_a(ufc_a);
+    arma::mat A;
+
+    #ifdef HAS_OPENMP
+    #pragma omp for schedule(guided) reduction(||:singular)
+    #endif
+    for (int i = 0; i < num_cells; ++i)
+    {
+      // Update to current cell
+      const Cell cell(mesh, i);
+      _ufc_a.update(cell);
+
+      // Tabulate A on cell and factorize
+      const std::size_t n = _vector_offsets[i + 1] - _vector_offsets[i];
+      dolfin_assert(n == a.function_space(1)->dofmap()->cell_dimension(i));
+      A.set_size(n, n);
+      integral_a->tabulate_tensor(A.memptr(),
+                                  _ufc_a.w(),
+                                  &_ufc_a.cell.vertex_coordinates[0],
+                                  _ufc_a.cell.orientation);
+      if (!factorize_local(A, &_factors[_matrix_offsets[i]],
+                           &_permutations[_vector_offsets[i]], symmetric))
+      {
+        singular = true;
+      }
+    }
+  }
+
+  if (singular)
+  {
+    clear_factorization();
+    dolfin_error("LocalSolver.cpp",
+                 "factorize local problems",
+                 "Local matrix is singular");
+  }
+}
+//----------------------------------------------------------------------------
+void LocalSolver::solve(GenericVector& x, const Form& L) const
+{
+  UFC ufc_L(L);
+
+  // Set timer
+  Timer timer("Local solver");
+
+  // Extract mesh
+  const Mesh& mesh = L.mesh();
+
+  // Check that factorizations have been computed for mesh
+  const int num_cells = mesh.num_cells();
+  if (_vector_offsets.size() != mesh.num_cells() + 1)
+  {
+    dolfin_error("LocalSolver.cpp",
+                 "solve local problems",
+                 "Local factorizations have not been computed for this mesh. Call factorize() first");
+  }
+
+  // Update off-process coefficients
+  const std::vector<boost::shared_ptr<const GenericFunction> >
+    coefficients_L = L.coefficients();
+  for (std::size_t i = 0; i < coefficients_L.size(); ++i)
+    coefficients_L[i]->update();
+
+  // Check form rank
+  dolfin_assert(ufc_L.form.rank() == 1);
+
+  // Get dof map
+  boost::shared_ptr<const GenericDofMap> dofmap_L = L.function_space(0)->dofmap();
+  dolfin_assert(dofmap_L);
+
+  // Check that local dimensions of L match the factorizations
+  for (int i = 0; i < num_cells; ++i)
+  {
+    const std::size_t n = _vector_offsets[i + 1] - _vector_offsets[i];
+    if (dofmap_L->cell_dimension(i) != n)
+    {
+      dolfin_error("LocalSolver.cpp",
+                   "solve local problems",
+                   "Local dimension of linear form (%d) on cell %d does not match local factorization (%d)",
+                   dofmap_L->cell_dimension(i), i, n);
+    }
+  }
+
+  // Initialise vector
+  std::pair<std::size_t, std::size_t> local_range = dofmap_L->ownership_range();
+  x.resize(local_range);
+
+  // Cell integral
+  const ufc::cell_integral* integral_L = ufc_L.default_cell_integral.get();
+  dolfin_assert(integral_L);
+
+  // Solve local problems (in parallel, cells are independent)
+  std::vector<double> x_local(_vector_offsets.back());
+  const std::size_t num_threads = dolfin::parameters["num_threads"];
+  #ifdef HAS_OPENMP
+  #pragma omp parallel num_threads(std::max(num_threads, (std::size_t) 1))
+  #endif
+  {
+    // Data for each thread
+    UFC _ufc_L(ufc_L);
+
+    #ifdef HAS_OPENMP
+    #pragma omp for schedule(guided)
+    #endif
+    for (int i = 0; i < num_cells; ++i)
+    {
+      // Update to current cell
+      const Cell cell(mesh, i);
+      _ufc_L.update(cell);
+
+      // Tabulate b on cell and solve in place
+      const std::size_t n = _vector_offsets[i + 1] - _vector_offsets[i];
+      double* b = &x_local[_vector_offsets[i]];
+      integral_L->tabulate_tensor(b,
+                                  _ufc_L.w(),
+                                  &_ufc_L.cell.vertex_coordinates[0],
+                                  _ufc_L.cell.orientation);
+      solve_local(b, &_factors[_matrix_offsets[i]],
+                  &_permutations[_vector_offsets[i]], n);
+    }
+  }
+
+  // Set solution in global vector
+  set_solution(x, x_local, _vector_offsets, *dofmap_L);
+}
+//----------------------------------------------------------------------------
+void LocalSolver::clear_factorization()
+{
+  std::vector<double>().swap(_factors);
+  std::vector<int>().swap(_permutations);
+  std::vector<std::size_t>().swap(_matrix_offsets);
+  std::vector<std::size_t>().swap(_vector_offsets);
+}
+//----------------------------------------------------------------------------
+bool LocalSolver::factorize_local(const arma::mat& A, double* factors,
+                                  int* permutation, bool symmetric)
+{
+  const std::size_t n = A.n_rows;
+  if (n == 0)
+    return true;
+
+  // Factors are stored in given memory (column-major)
+  arma::mat F(factors, n, n, false, true);
+
+  // Try Cholesky factorization A = U^T U and store U (marked by
+  // permutation[0] < 0). The factorization is computed into local
+  // storage since it fails for indefinite matrices.
+  if (symmetric)
+  {
+    arma::mat U;
+    if (arma::chol(U, A))
+    {
+      F = U;
+      permutation[0] = -1;
+      return true;
+    }
+  }
+
+  // LU factorization PA = LU of the matrix (tabulated row-major, so
+  // A holds its transpose)
+  arma::mat L, U, P;
+  if (!arma::lu(L, U, P, A.t()))
+    return false;
+
+  // Store U and the strictly lower part of L (unit diagonal) in one
+  // matrix, check for zero pivots and store permutation as row indices
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    if (U(i, i) == 0.0)
+      return false;
+    for (std::size_t j = 0; j < n; ++j)
+    {
+      F(i, j) = j < i ? L(i, j) : U(i, j);
+      if (P(i, j) != 0.0)
+        permutation[i] = j;
+    }
+  }
+
+  return true;
+}
+//----------------------------------------------------------------------------
+void LocalSolver::solve_local(double* b, const double* factors,
+                              const int* permutation, std::size_t n)
+{
+  if (n == 0)
+    return;
+
+  // Factors (column-major)
+  const double* F = factors;
+  const bool cholesky = permutation[0] < 0;
+
+  // Permute right-hand side (LU only)
+  std::vector<double> x(n);
+  for (std::size_t i = 0; i < n; ++i)
+    x[i] = b[cholesky ? i : permutation[i]];
+
+  // Forward substitution (with U^T for Cholesky, unit lower L for LU)
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    double sum = x[i];
+    for (std::size_t k = 0; k < i; ++k)
+      sum -= (cholesky ? F[k + i*n] : F[i + k*n])*x[k];
+    x[i] = cholesky ? sum/F[i + i*n] : sum;
+  }
+
+  // Backward substitution (with U)
+  for (std::size_t i = n; i-- > 0;)
+  {
+    double sum = x[i];
+    for (std::size_t k = i + 1; k < n; ++k)
+      sum -= F[i + k*n]*x[k];
+    x[i] = sum/F[i + i*n];
+  }
+
+  std::copy(x.begin(), x.end(), b);
+}
+//----------------------------------------------------------------------------
+void LocalSolver::compute_offsets(std::vector<std::size_t>& matrix_offsets,
+                                  std::vector<std::size_t>& vector_offsets,
+                                  const GenericDofMap& dofmap,
+                                  std::size_t num_cells)
+{
+  matrix_offsets.resize(num_cells + 1);
+  vector_offsets.resize(num_cells + 1);
+  matrix_offsets[0] = 0;
+  vector_offsets[0] = 0;
+  for (std::size_t i = 0; i < num_cells; ++i)
+  {
+    const std::size_t n = dofmap.cell_dimension(i);
+    matrix_offsets[i + 1] = matrix_offsets[i] + n*n;
+    vector_offsets[i + 1] = vector_offsets[i] + n;
+  }
+}
+//----------------------------------------------------------------------------
+void LocalSolver::set_solution(GenericVector& x,
+                               const std::vector<double>& x_local,
+                               const std::vector<std::size_t>& vector_offsets,
+                               const GenericDofMap& dofmap)
+{
+  for (std::size_t i = 0; i + 1 < vector_offsets.size(); ++i)
   {
-    // Update to current cell
-    ufc_a.update(*cell);
-    ufc_L.update(*cell);
-
-    // Get local-to-global dof maps for cell
-    const std::vector<dolfin::la_index>& dofs_a0 = dofmap_a0->cell_dofs(cell->index());
-    const std::vector<dolfin::la_index>& dofs_a1 = dofmap_a1->cell_dofs(cell->index());
-    const std::vector<dolfin::la_index>& dofs_L  = dofmap_L->cell_dofs(cell->index());
-
-    // Check that local problem is square and a and L match
-    dolfin_assert(dofs_a0.size() == dofs_a1.size());
-    dolfin_assert(dofs_a1.size() == dofs_L.size());
-
-    // Resize A and b
-    A.set_size(dofs_a0.size(), dofs_a1.size());
-    b.set_size(dofs_L.size());
-
-    // Tabulate A and b on cell
-    integral_a->tabulate_tensor(A.memptr(),
-                                ufc_a.w(),
-                                &ufc_a.cell.vertex_coordinates[0],
-                                ufc_a.cell.orientation);
-    integral_L->tabulate_tensor(b.memptr(),
-                                ufc_L.w(),
-                                &ufc_L.cell.vertex_coordinates[0],
-                                ufc_L.cell.orientation);
-
-    // Solve local problem (Armadillo uses column-major)
-    if (symmetric)
-      arma::solve(x_local, A, b);
-    else
-      arma::solve(x_local, A.t(), b);
-
-    // Set solution in global vector
-    x.set(x_local.memptr(), dofs_a0.size(), dofs_a0.data());
-
-    p++;
+    const ArrayView<const dolfin::la_index> dofs = dofmap.cell_dofs(i);
+    dolfin_assert(dofs.size() == vector_offsets[i + 1] - vector_offsets[i]);
+    if (dofs.size() > 0)
+      x.set(&x_local[vector_offsets[i]], dofs.size(), dofs.data());
   }
 
   // Finalise vector
@@ -16,11 +16,14 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2013-02-12
-// Last changed:
+// Last changed: 2026-10-16
 
 #ifndef __LOCAL_SOLVER_H
 #define __LOCAL_SOLVER_H
 
+#include <vector>
+#include <armadillo>
+
 namespace dolfin
 {
 
@@ -37,8 +40,15 @@ namespace dolfin
   /// This class can be used for post-processing solutions, e.g. computing
   /// stress fields for visualisation, far more cheaply that using
   /// global projections.
+  ///
+  /// When the left-hand side does not change between solves, the
+  /// local factorizations may be computed once by factorize() and
+  /// reused for new right-hand sides by solve(x, L). Local problems
+  /// are solved in parallel using the number of threads given by the
+  /// global parameter "num_threads".
 
   // Forward declarations
+  class GenericDofMap;
   class GenericVector;
   class Form;
 
@@ -51,6 +61,62 @@ namespace dolfin
     void solve(GenericVector& x, const Form& a, const Form& L,
                bool symmetric=false) const;
 
+    /// Compute and store factorizations of the local (cell-wise)
+    /// left-hand sides. Cholesky factorizations are used if the local
+    /// matrices are symmetric positive definite, and LU
+    /// factorizations (with partial pivoting) otherwise.
+    ///
+    /// *Arguments*
+    ///     a (_Form_)
+    ///         The bilinear form.
+    ///     symmetric (bool)
+    ///         True if the local matrices are symmetric (try Cholesky).
+    void factorize(const Form& a, bool symmetric=false);
+
+    /// Solve local (cell-wise) problem using stored factorizations
+    /// and copy result into global vector x.
+    ///
+    /// *Arguments*
+    ///     x (_GenericVector_)
+    ///         The solution vector.
+    ///     L (_Form_)
+    ///         The linear form.
+    void solve(GenericVector& x, const Form& L) const;
+
+    /// Remove stored factorizations
+    void clear_factorization();
+
+  private:
+
+    // Factorize local matrix (tabulated row-major), using Cholesky if
+    // symmetric positive definite and LU otherwise, and store the
+    // factors (U, or L and U packed in one matrix) and row
+    // permutation. Returns false if the matrix is singular.
+    static bool factorize_local(const arma::mat& A, double* factors,
+                                int* permutation, bool symmetric);
+
+    // Solve local problem in place using factorization
+    static void solve_local(double* b, const double* factors,
+                            const int* permutation, std::size_t n);
+
+    // Compute offsets of local matrices (n x n) and vectors (n)
+    static void compute_offsets(std::vector<std::size_t>& matrix_offsets,
+                                std::vector<std::size_t>& vector_offsets,
+                                const GenericDofMap& dofmap,
+                                std::size_t num_cells);
+
+    // Copy local solutions into global vector
+    static void set_solution(GenericVector& x,
+                             const std::vector<double>& x_local,
+                             const std::vector<std::size_t>& vector_offsets,
+                             const GenericDofMap& dofmap);
+
+    // Stored factorizations (triangular factors and row
+    // permutations), for all cells in one array each
+    std::vector<double> _factors;
+    std::vector<int> _permutations;
+    std::vector<std::size_t> _matrix_offsets, _vector_offsets;
+
   };
 
 }
@@ -21,12 +21,13 @@
 // Modified by Anders Logg 2010-2013
 //
 // First added:  2010-11-10
-// Last changed: 2013-02-26
+// Last changed: 2026-10-16
 
 #ifdef HAS_OPENMP
 
 #include <algorithm>
 #include <map>
+#include <numeric>
 #include <utility>
 #include <vector>
 #include <omp.h>
@@ -146,7 +147,7 @@ void OpenMpAssembler::assemble_cells(GenericTensor& A, const Form& a,
     dofmaps.push_back(a.function_space(i)->dofmap().get());
 
   // Vector to hold dof map for a cell
-  std::vector<const std::vector<dolfin::la_index>* > dofs(form_rank);
+  std::vector<ArrayView<const dolfin::la_index> > dofs(form_rank);
 
   // Color mesh
   std::vector<std::size_t> coloring_type = a.coloring(mesh.topology().dim());
@@ -203,7 +204,7 @@ void OpenMpAssembler::assemble_cells(GenericTensor& A, const Form& a,
 
       // Get local-to-global dof maps for cell
       for (std::size_t i = 0; i < form_rank; ++i)
-        dofs[i] = &(dofmaps[i]->cell_dofs(index));
+        dofs[i] = dofmaps[i]->cell_dofs(index);
 
       // Tabulate cell tensor
       integral->tabulate_tensor(&ufc.A[0],
@@ -275,7 +276,7 @@ void OpenMpAssembler::assemble_cells_and_exterior_facets(GenericTensor& A,
     dofmaps.push_back(a.function_space(i)->dofmap().get());
 
   // Vector to hold dof maps for a cell
-  std::vector<const std::vector<dolfin::la_index>* > dofs(form_rank);
+  std::vector<ArrayView<const dolfin::la_index> > dofs(form_rank);
 
   // FIXME: Pass or determine coloring type
   // Define graph type
@@ -333,12 +334,12 @@ void OpenMpAssembler::assemble_cells_and_exterior_facets(GenericTensor& A,
 
       // Get local-to-global dof maps for cell
       for (std::size_t i = 0; i < form_rank; ++i)
-        dofs[i] = &(dofmaps[i]->cell_dofs(cell_index));
+        dofs[i] = dofmaps[i]->cell_dofs(cell_index);
 
       // Get number of entries in cell tensor
       std::size_t dim = 1;
       for (std::size_t i = 0; i < form_rank; ++i)
-        dim *= dofs[i]->size();
+        dim *= dofs[i].size();
 
       // Tabulate cell tensor if we have a cell_integral
       if (cell_integral)
@@ -416,7 +417,11 @@ void OpenMpAssembler::assemble_interior_facets(GenericTensor& A, const Form& a,
                                        const MeshFunction<std::size_t>* domains,
                                        std::vector<double>* values)
 {
-  warning("OpenMpAssembler::assemble_interior_facets is untested.");
+  // Skip assembly if there are no interior facet integrals
+  if (!_ufc.form.has_interior_facet_integrals())
+    return;
+
+  Timer timer("Assemble interior facets");
 
   // Extract mesh
   const Mesh& mesh = a.mesh();
@@ -426,26 +431,20 @@ void OpenMpAssembler::assemble_interior_facets(GenericTensor& A, const Form& a,
 
   dolfin_assert(!values);
 
-  // Skip assembly if there are no interior facet integrals
-  if (!_ufc.form.has_interior_facet_integrals())
-    return;
-
-  Timer timer("Assemble interior facets");
-
   // Set number of OpenMP threads (from parameter systems)
-  omp_set_num_threads(parameters["num_threads"]);
-
-  // Get integral for sub domain (if any)
+  const int num_threads = parameters["num_threads"];
+  omp_set_num_threads(num_threads);
 
+  // Check whether integral is domain-dependent
   bool use_domains = domains && !domains->empty();
-  if (use_domains)
-  {
-    dolfin_error("OpenMPAssembler.cpp",
-                 "perform multithreaded assembly using OpenMP assembler",
-                 "Subdomains are not yet handled");
-  }
 
-  // Color mesh
+  // Compute facets and facet - cell connectivity if not already computed
+  mesh.init(D - 1);
+  mesh.init(D - 1, D);
+  dolfin_assert(mesh.ordered());
+
+  // Color facets such that facets of the same color do not share any
+  // cell dofs
   std::vector<std::size_t> coloring_type = a.coloring(D - 1);
   mesh.color(coloring_type);
 
@@ -467,11 +466,6 @@ void OpenMpAssembler::assemble_interior_facets(GenericTensor& A, const Form& a,
   const ufc::interior_facet_integral* integral
     = ufc.default_interior_facet_integral.get();
 
-  // Compute facets and facet - cell connectivity if not already computed
-  mesh.init(D - 1);
-  mesh.init(D - 1, D);
-  dolfin_assert(mesh.ordered());
-
   // Get interior facet directions (if any)
   const std::vector<std::size_t>* facet_orientation = NULL;
   if (mesh.data().exists("facet_orientation", D - 1))
@@ -504,8 +498,15 @@ void OpenMpAssembler::assemble_interior_facets(GenericTensor& A, const Form& a,
   const std::vector<std::vector<std::size_t> >& entities_of_color
     = mesh_coloring->second.second;
 
-  // Assemble over interior facets (loop over colours, then cells of same color)
+  // If assembling a scalar we need to ensure each threads assemble
+  // its own scalar
+  std::vector<double> scalars(num_threads, 0.0);
+
+  // Assemble over interior facets (loop over colours, then facets of
+  // same color)
   const std::size_t num_colors = entities_of_color.size();
+  Progress p(AssemblerBase::progress_message(A.rank(), "interior facets"),
+             num_colors);
   for (std::size_t color = 0; color < num_colors; ++color)
   {
     // Get the array of facet indices of current color
@@ -514,24 +515,19 @@ void OpenMpAssembler::assemble_interior_facets(GenericTensor& A, const Form& a,
     // Number of facets of current color
     const int num_facets = colored_facets.size();
 
-    // OpenMP test loop over cells of the same color
-    Progress p(AssemblerBase::progress_message(A.rank(), "interior facets"),
-               mesh.num_facets());
+    // OpenMP loop over facets of the same color
     #pragma omp parallel for schedule(guided, 20) firstprivate(ufc, macro_dofs, integral)
     for (int facet_index = 0; facet_index < num_facets; ++facet_index)
     {
       // Facet index
       const std::size_t index = colored_facets[facet_index];
 
-      // Create cell
+      // Create facet
       const Facet facet(mesh, index);
 
       // Only consider interior facets
       if (facet.exterior())
-      {
-        p++;
         continue;
-      }
 
       // Get integral for sub domain (if any)
       if (use_domains)
@@ -558,9 +554,9 @@ void OpenMpAssembler::assemble_interior_facets(GenericTensor& A, const Form& a,
       for (std::size_t i = 0; i < form_rank; i++)
       {
         // Get dofs for each cell
-        const std::vector<dolfin::la_index>& cell_dofs0
+        const ArrayView<const dolfin::la_index> cell_dofs0
           = dofmaps[i]->cell_dofs(cell0.index());
-        const std::vector<dolfin::la_index>& cell_dofs1
+        const ArrayView<const dolfin::la_index> cell_dofs1
           = dofmaps[i]->cell_dofs(cell1.index());
 
         // Create space in macro dof vector
@@ -581,10 +577,21 @@ void OpenMpAssembler::assemble_interior_facets(GenericTensor& A, const Form& a,
                                 local_facet1);
 
       // Add entries to global tensor
-      A.add(&ufc.macro_A[0], macro_dofs);
-
-      p++;
+      if (form_rank == 0)
+        scalars[omp_get_thread_num()] += ufc.macro_A[0];
+      else
+        A.add(&ufc.macro_A[0], macro_dofs);
     }
+
+    p++;
+  }
+
+  // If we assemble a scalar we need to sum the contributions from each thread
+  if (form_rank == 0)
+  {
+    const double scalar_sum = std::accumulate(scalars.begin(),
+                                              scalars.end(), 0.0);
+    A.add(&scalar_sum, macro_dofs);
   }
 }
 //-----------------------------------------------------------------------------
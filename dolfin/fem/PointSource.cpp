@@ -108,7 +108,7 @@ void PointSource::apply(GenericVector& b)
 
   // Compute local-to-global mapping
   dolfin_assert(_V->dofmap());
-  const std::vector<dolfin::la_index>& dofs = _V->dofmap()->cell_dofs(cell.index());
+  const ArrayView<const dolfin::la_index> dofs = _V->dofmap()->cell_dofs(cell.index());
 
   // Add values to vector
   dolfin_assert(_V->element()->space_dimension() == _V->dofmap()->cell_dimension(cell.index()));
@@ -19,7 +19,11 @@
 // Modified by Anders Logg 2008-2011
 //
 // First added:  2007-05-24
-// Last changed: 2011-11-14
+// Last changed: 2026-10-16
+
+#ifdef HAS_OPENMP
+#include <omp.h>
+#endif
 
 #include <dolfin/common/timing.h>
 #include <dolfin/common/MPI.h>
@@ -27,6 +31,7 @@
 #include <dolfin/mesh/Cell.h>
 #include <dolfin/mesh/Facet.h>
 #include <dolfin/mesh/Mesh.h>
+#include <dolfin/parameter/GlobalParameters.h>
 #include "GenericDofMap.h"
 #include "SparsityPatternBuilder.h"
 
@@ -61,23 +66,51 @@ void SparsityPatternBuilder::build(GenericSparsityPattern& sparsity_pattern,
   if (rank < 2)
     return;
 
-  // Create vector to point to dofs
-  std::vector<const std::vector<dolfin::la_index>* > dofs(rank);
+  // Create vector to hold views of dofs
+  std::vector<ArrayView<const dolfin::la_index> > dofs(rank);
 
   // FIXME: We iterate over the entire mesh even if the function space
   // is restricted. This works out fine since the local dofmap
   // returned on each cell will be an empty vector, but we might think
   // about optimizing this further.
 
+  // Build sparsity pattern for cell integrals in parallel if
+  // supported by the sparsity pattern (each thread inserts entries
+  // into a buffer of its own)
+  const std::size_t num_threads = parameters["num_threads"];
+  if (cells && num_threads > 0 && sparsity_pattern.threaded_insert())
+  {
+    const int num_cells = mesh.num_cells();
+    #ifdef HAS_OPENMP
+    #pragma omp parallel num_threads(num_threads)
+    #endif
+    {
+      std::vector<ArrayView<const dolfin::la_index> > cell_dofs(rank);
+
+      #ifdef HAS_OPENMP
+      #pragma omp for schedule(static)
+      #endif
+      for (int cell_index = 0; cell_index < num_cells; ++cell_index)
+      {
+        // Tabulate dofs for each dimension
+        for (std::size_t i = 0; i < rank; ++i)
+          cell_dofs[i] = dofmaps[i]->cell_dofs(cell_index);
+
+        // Insert non-zeroes in sparsity pattern
+        sparsity_pattern.insert(cell_dofs);
+      }
+    }
+  }
+
   // Build sparsity pattern for cell integrals
-  if (cells)
+  else if (cells)
   {
     Progress p("Building sparsity pattern over cells", mesh.num_cells());
     for (CellIterator cell(mesh); !cell.end(); ++cell)
     {
       // Tabulate dofs for each dimension and get local dimensions
       for (std::size_t i = 0; i < rank; ++i)
-        dofs[i] = &dofmaps[i]->cell_dofs(cell->index());
+        dofs[i] = dofmaps[i]->cell_dofs(cell->index());
 
       // Insert non-zeroes in sparsity pattern
       sparsity_pattern.insert(dofs);
@@ -122,7 +155,7 @@ void SparsityPatternBuilder::build(GenericSparsityPattern& sparsity_pattern,
 
         // Tabulate dofs for each dimension and get local dimensions
         for (std::size_t i = 0; i < rank; ++i)
-          dofs[i] = &dofmaps[i]->cell_dofs(cell.index());
+          dofs[i] = dofmaps[i]->cell_dofs(cell.index());
 
         // Insert dofs
         sparsity_pattern.insert(dofs);
@@ -137,8 +170,8 @@ void SparsityPatternBuilder::build(GenericSparsityPattern& sparsity_pattern,
         for (std::size_t i = 0; i < rank; i++)
         {
           // Get dofs for each cell
-          const std::vector<dolfin::la_index>& cell_dofs0 = dofmaps[i]->cell_dofs(cell0.index());
-          const std::vector<dolfin::la_index>& cell_dofs1 = dofmaps[i]->cell_dofs(cell1.index());
+          const ArrayView<const dolfin::la_index> cell_dofs0 = dofmaps[i]->cell_dofs(cell0.index());
+          const ArrayView<const dolfin::la_index> cell_dofs1 = dofmaps[i]->cell_dofs(cell1.index());
 
           // Create space in macro dof vector
           macro_dofs[i].resize(cell_dofs0.size() + cell_dofs1.size());
@@ -147,8 +180,9 @@ void SparsityPatternBuilder::build(GenericSparsityPattern& sparsity_pattern,
           std::copy(cell_dofs0.begin(), cell_dofs0.end(), macro_dofs[i].begin());
           std::copy(cell_dofs1.begin(), cell_dofs1.end(), macro_dofs[i].begin() + cell_dofs0.size());
 
-          // Store pointer to macro dofs
-          dofs[i] = &macro_dofs[i];
+          // Store view of macro dofs
+          dofs[i] = ArrayView<const dolfin::la_index>(macro_dofs[i].size(),
+                                                      macro_dofs[i].data());
         }
 
         // Insert dofs
@@ -163,13 +197,13 @@ void SparsityPatternBuilder::build(GenericSparsityPattern& sparsity_pattern,
   {
     Progress p("Building sparsity pattern over diagonal", local_range[0].second-local_range[0].first);
 
-    std::vector<dolfin::la_index> diagonal_dof(1, 0);
+    dolfin::la_index diagonal_dof = 0;
     for (std::size_t i = 0; i < rank; ++i)
-      dofs[i] = &diagonal_dof;
+      dofs[i] = ArrayView<const dolfin::la_index>(1, &diagonal_dof);
 
     for (std::size_t j = local_range[0].first; j < local_range[0].second; j++)
     {
-      diagonal_dof[0] = j;
+      diagonal_dof = j;
 
       // Insert diagonal non-zeroes in sparsity pattern
       sparsity_pattern.insert(dofs);
@@ -354,8 +354,8 @@ void SystemAssembler::cell_wise_assembly(GenericMatrix* A, GenericVector* b,
     L_dofmaps.push_back(L.function_space(i)->dofmap().get());
 
   // Vector to hold dof map for a cell
-  std::vector<const std::vector<dolfin::la_index>* > a_dofs(a_rank);
-  std::vector<const std::vector<dolfin::la_index>* > L_dofs(L_rank);
+  std::vector<ArrayView<const dolfin::la_index> > a_dofs(a_rank);
+  std::vector<ArrayView<const dolfin::la_index> > L_dofs(L_rank);
 
   // Create pointers to hold integral objects
   const ufc::cell_integral* A_cell_integral = A_ufc.default_cell_integral.get();
@@ -468,11 +468,11 @@ void SystemAssembler::cell_wise_assembly(GenericMatrix* A, GenericVector* b,
     }
 
     // Get local-to-global dof maps for cell
-    a_dofs[0] = &(a_dofmaps[0]->cell_dofs(cell->index()));
-    a_dofs[1] = &(a_dofmaps[1]->cell_dofs(cell->index()));
-    L_dofs[0] = &(L_dofmaps[0]->cell_dofs(cell->index()));
+    a_dofs[0] = a_dofmaps[0]->cell_dofs(cell->index());
+    a_dofs[1] = a_dofmaps[1]->cell_dofs(cell->index());
+    L_dofs[0] = L_dofmaps[0]->cell_dofs(cell->index());
 
-    dolfin_assert(L_dofs[0] == a_dofs[1]);
+    dolfin_assert(L_dofs[0].data() == a_dofs[1].data());
 
     // Modify local matrix/element for Dirichlet boundary conditions
     apply_bc(data.Ae.data(), data.be.data(), boundary_values, a_dofs, rescale);
@@ -522,8 +522,8 @@ void SystemAssembler::facet_wise_assembly(GenericMatrix* A, GenericVector* b,
     L_dofmaps.push_back(L.function_space(i)->dofmap().get());
 
   // Vector to hold dof map for a cell
-  std::vector<const std::vector<dolfin::la_index>* > a_dofs(a_rank);
-  std::vector<const std::vector<dolfin::la_index>* > L_dofs(L_rank);
+  std::vector<ArrayView<const dolfin::la_index> > a_dofs(a_rank);
+  std::vector<ArrayView<const dolfin::la_index> > L_dofs(L_rank);
 
   // Iterate over facets
   Progress p("Assembling system (facet-wise)", mesh.num_facets());
@@ -612,7 +612,7 @@ void SystemAssembler::compute_tensor_on_one_interior_facet(const Form& a,
 //-----------------------------------------------------------------------------
 inline void SystemAssembler::apply_bc(double* A, double* b,
          const DirichletBC::Map& boundary_values,
-         const std::vector<const std::vector<dolfin::la_index>* >& global_dofs,
+         const std::vector<ArrayView<const dolfin::la_index> >& global_dofs,
          const bool rescale)
 {
   dolfin_assert(A);
@@ -620,13 +620,13 @@ inline void SystemAssembler::apply_bc(double* A, double* b,
 
   // Wrap matrix and vector as Armadillo. Armadillo matrix storgae is
   // column-major, so all operations are transposed.
-  arma::mat _A(A, global_dofs[1]->size(), global_dofs[0]->size(), false, true);
-  arma::rowvec _b(b, global_dofs[0]->size(), false, true);
+  arma::mat _A(A, global_dofs[1].size(), global_dofs[0].size(), false, true);
+  arma::rowvec _b(b, global_dofs[0].size(), false, true);
 
   // Loop over rows
   for (std::size_t i = 0; i < _A.n_rows; ++i)
   {
-    const std::size_t ii = (*global_dofs[1])[i];
+    const std::size_t ii = global_dofs[1][i];
     DirichletBC::Map::const_iterator bc_value = boundary_values.find(ii);
     if (bc_value != boundary_values.end())
     {
@@ -684,18 +684,18 @@ void SystemAssembler::assemble_interior_facet(GenericMatrix* A,
   const std::size_t cell1_index = cell1.index();
 
   // Tabulate dofs
-  const std::vector<dolfin::la_index>& a0_dofs0
+  const ArrayView<const dolfin::la_index> a0_dofs0
     = a.function_space(0)->dofmap()->cell_dofs(cell0_index);
-  const std::vector<dolfin::la_index>& a1_dofs0
+  const ArrayView<const dolfin::la_index> a1_dofs0
     = a.function_space(1)->dofmap()->cell_dofs(cell0_index);
-  const std::vector<dolfin::la_index>& L_dofs0
+  const ArrayView<const dolfin::la_index> L_dofs0
     = L.function_space(0)->dofmap()->cell_dofs(cell0_index);
 
-  const std::vector<dolfin::la_index>& a0_dofs1
+  const ArrayView<const dolfin::la_index> a0_dofs1
     = a.function_space(0)->dofmap()->cell_dofs(cell1_index);
-  const std::vector<dolfin::la_index>& a1_dofs1
+  const ArrayView<const dolfin::la_index> a1_dofs1
     = a.function_space(1)->dofmap()->cell_dofs(cell1_index);
-  const std::vector<dolfin::la_index>& L_dofs1
+  const ArrayView<const dolfin::la_index> L_dofs1
     = L.function_space(0)->dofmap()->cell_dofs(cell1_index);
 
   // Cell integrals
@@ -792,9 +792,11 @@ void SystemAssembler::assemble_interior_facet(GenericMatrix* A,
             L_macro_dofs[0].begin() + L_dofs0.size());
 
   // Modify local matrix/element for Dirichlet boundary conditions
-  std::vector<const std::vector<dolfin::la_index>* > _a_macro_dofs(2);
-  _a_macro_dofs[0] = &a_macro_dofs[0];
-  _a_macro_dofs[1] = &a_macro_dofs[1];
+  std::vector<ArrayView<const dolfin::la_index> > _a_macro_dofs(2);
+  _a_macro_dofs[0] = ArrayView<const dolfin::la_index>(a_macro_dofs[0].size(),
+                                                       a_macro_dofs[0].data());
+  _a_macro_dofs[1] = ArrayView<const dolfin::la_index>(a_macro_dofs[1].size(),
+                                                       a_macro_dofs[1].data());
 
   apply_bc(A_ufc.macro_A.data(), b_ufc.macro_A.data(), boundary_values,
            _a_macro_dofs, rescale);
@@ -872,11 +874,11 @@ void SystemAssembler::assemble_exterior_facet(GenericMatrix* A,
 
   // Tabulate dofs
   const std::size_t cell_index = cell.index();
-  std::vector<const std::vector<dolfin::la_index>* > a_dofs(2);
-  std::vector<const std::vector<dolfin::la_index>* > L_dofs(1);
-  a_dofs[0] = &(a.function_space(0)->dofmap()->cell_dofs(cell_index));
-  a_dofs[1] = &(a.function_space(1)->dofmap()->cell_dofs(cell_index));
-  L_dofs[0] = &(L.function_space(0)->dofmap()->cell_dofs(cell_index));
+  std::vector<ArrayView<const dolfin::la_index> > a_dofs(2);
+  std::vector<ArrayView<const dolfin::la_index> > L_dofs(1);
+  a_dofs[0] = a.function_space(0)->dofmap()->cell_dofs(cell_index);
+  a_dofs[1] = a.function_space(1)->dofmap()->cell_dofs(cell_index);
+  L_dofs[0] = L.function_space(0)->dofmap()->cell_dofs(cell_index);
 
   // Modify local matrix/element for Dirichlet boundary conditions
   apply_bc(data.Ae.data(), data.be.data(), boundary_values, a_dofs, rescale);
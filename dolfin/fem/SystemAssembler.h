@@ -26,6 +26,7 @@
 #include <map>
 #include <vector>
 #include <boost/shared_ptr.hpp>
+#include <dolfin/common/ArrayView.h>
 #include "DirichletBC.h"
 #include "AssemblerBase.h"
 
@@ -160,7 +161,7 @@ namespace dolfin
 
     static void apply_bc(double* A, double* b,
                          const DirichletBC::Map& boundary_values,
-                         const std::vector<const std::vector<dolfin::la_index>* >& global_dofs,
+                         const std::vector<ArrayView<const dolfin::la_index> >& global_dofs,
                          const bool rescale);
 
     // Class to hold temporary data
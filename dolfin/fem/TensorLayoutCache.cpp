@@ -0,0 +1,296 @@
+// Copyright (C) 2026 agent
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+//
+// First added:  2026-10-16
+// Last changed: 2026-10-16
+
+#include <list>
+#include <vector>
+#include <boost/functional/hash.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/weak_ptr.hpp>
+
+#include <dolfin/common/Timer.h>
+#include <dolfin/function/FunctionSpace.h>
+#include <dolfin/la/DefaultFactory.h>
+#include <dolfin/la/GenericLinearAlgebraFactory.h>
+#include <dolfin/la/GenericMatrix.h>
+#include <dolfin/la/GenericSparsityPattern.h>
+#include <dolfin/la/TensorLayout.h>
+#include <dolfin/log/log.h>
+#include <dolfin/mesh/Mesh.h>
+#include <dolfin/parameter/GlobalParameters.h>
+#include "Form.h"
+#include "GenericDofMap.h"
+#include "SparsityPatternBuilder.h"
+#include "TensorLayoutCache.h"
+
+using namespace dolfin;
+
+//-----------------------------------------------------------------------------
+// Cached tensor layout and the data it was built from
+class TensorLayoutCache::Entry
+{
+public:
+
+  // Create key for form
+  Entry(const Form& a, const GenericLinearAlgebraFactory& factory,
+        bool keep_diagonal)
+    : mesh(a.mesh_shared_ptr()), mesh_id(a.mesh().id()),
+      num_vertices(a.mesh().num_vertices()),
+      num_cells(a.mesh().num_cells()),
+      topology_hash(compute_topology_hash(a.mesh())),
+      cells(a.ufc_form()->has_cell_integrals()),
+      interior_facets(a.ufc_form()->has_interior_facet_integrals()),
+      exterior_facets(a.ufc_form()->has_exterior_facet_integrals()),
+      keep_diagonal(keep_diagonal), factory(&factory)
+  {
+    for (std::size_t i = 0; i < a.rank(); ++i)
+    {
+      boost::shared_ptr<const GenericDofMap> dofmap
+        = a.function_space(i)->dofmap();
+      dolfin_assert(dofmap);
+      dofmaps.push_back(dofmap);
+      dofmap_ids.push_back(dofmap->id());
+      global_dimensions.push_back(dofmap->global_dimension());
+      ownership_ranges.push_back(dofmap->ownership_range());
+    }
+  }
+
+  // Compute (local) hash of cell-vertex connectivity, which changes
+  // if the mesh is renumbered or reordered in place
+  static std::size_t compute_topology_hash(const Mesh& mesh)
+  {
+    const MeshTopology& topology = mesh.topology();
+    boost::hash<std::vector<unsigned int> > uhash;
+    return uhash(topology(topology.dim(), 0)());
+  }
+
+  // Check whether the mesh and dof maps of the entry are still valid
+  bool valid() const
+  {
+    boost::shared_ptr<const Mesh> _mesh = mesh.lock();
+    if (!_mesh || _mesh->num_vertices() != num_vertices
+        || _mesh->num_cells() != num_cells)
+    {
+      return false;
+    }
+
+    for (std::size_t i = 0; i < dofmaps.size(); ++i)
+    {
+      boost::shared_ptr<const GenericDofMap> dofmap = dofmaps[i].lock();
+      if (!dofmap || dofmap->global_dimension() != global_dimensions[i]
+          || dofmap->ownership_range() != ownership_ranges[i])
+      {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  // Check whether entry has the same key as other entry
+  bool operator== (const Entry& e) const
+  {
+    return mesh_id == e.mesh_id && num_vertices == e.num_vertices
+      && num_cells == e.num_cells && topology_hash == e.topology_hash
+      && dofmap_ids == e.dofmap_ids
+      && global_dimensions == e.global_dimensions
+      && ownership_ranges == e.ownership_ranges
+      && cells == e.cells && interior_facets == e.interior_facets
+      && exterior_facets == e.exterior_facets
+      && keep_diagonal == e.keep_diagonal && factory == e.factory;
+  }
+
+  // Mesh (not owned by cache)
+  boost::weak_ptr<const Mesh> mesh;
+  std::size_t mesh_id, num_vertices, num_cells, topology_hash;
+
+  // Dof maps (not owned by cache)
+  std::vector<boost::weak_ptr<const GenericDofMap> > dofmaps;
+  std::vector<std::size_t> dofmap_ids;
+  std::vector<std::size_t> global_dimensions;
+  std::vector<std::pair<std::size_t, std::size_t> > ownership_ranges;
+
+  // Integral types and diagonal
+  bool cells, interior_facets, exterior_facets, keep_diagonal;
+
+  // Linear algebra backend
+  const GenericLinearAlgebraFactory* factory;
+
+  // Cached layout
+  boost::shared_ptr<const TensorLayout> layout;
+
+};
+//-----------------------------------------------------------------------------
+// Cache data
+class TensorLayoutCache::Data
+{
+public:
+
+  // Maximum number of cached layouts
+  static const std::size_t max_size = 16;
+
+  // Mutex for access to entries
+  boost::mutex mutex;
+
+  // Cached entries, most recently used first
+  std::list<Entry> entries;
+
+};
+//-----------------------------------------------------------------------------
+boost::shared_ptr<const TensorLayout>
+TensorLayoutCache::layout(const Form& a,
+                          const GenericLinearAlgebraFactory& factory,
+                          bool keep_diagonal)
+{
+  dolfin_assert(a.ufc_form());
+
+  // Build layout without caching if caching is turned off or if the
+  // layout has no sparsity pattern (cheap to build)
+  const bool cache_sparsity = dolfin::parameters["cache_sparsity"];
+  if (!cache_sparsity || a.rank() < 2)
+    return build(a, factory, keep_diagonal);
+
+  Entry key(a, factory, keep_diagonal);
+  Data& d = data();
+  {
+    boost::mutex::scoped_lock lock(d.mutex);
+
+    // Remove entries for destroyed or modified meshes and dof maps,
+    // and look for layout
+    std::list<Entry>::iterator it = d.entries.begin();
+    while (it != d.entries.end())
+    {
+      if (!it->valid())
+        it = d.entries.erase(it);
+      else if (*it == key)
+      {
+        // Move to front and return cached layout
+        d.entries.splice(d.entries.begin(), d.entries, it);
+        log(TRACE, "Reusing cached sparsity pattern.");
+        return d.entries.front().layout;
+      }
+      else
+        ++it;
+    }
+  }
+
+  // Build layout (without holding the lock)
+  boost::shared_ptr<TensorLayout> tensor_layout
+    = build(a, factory, keep_diagonal);
+  if (!tensor_layout->sparsity_pattern())
+    return tensor_layout;
+  key.layout = tensor_layout;
+
+  // Add to cache, dropping the least recently used layout if full
+  boost::mutex::scoped_lock lock(d.mutex);
+  d.entries.push_front(key);
+  if (d.entries.size() > Data::max_size)
+    d.entries.pop_back();
+
+  return tensor_layout;
+}
+//-----------------------------------------------------------------------------
+boost::shared_ptr<GenericMatrix> TensorLayoutCache::create_matrix(const Form& a)
+{
+  if (a.rank() != 2)
+  {
+    dolfin_error("TensorLayoutCache.cpp",
+                 "create matrix for form",
+                 "Form must be bilinear (rank 2), not rank %d", a.rank());
+  }
+
+  GenericLinearAlgebraFactory& factory = DefaultFactory::factory();
+  boost::shared_ptr<GenericMatrix> A = factory.create_matrix();
+  A->init(*layout(a, factory));
+  return A;
+}
+//-----------------------------------------------------------------------------
+std::size_t TensorLayoutCache::size()
+{
+  Data& d = data();
+  boost::mutex::scoped_lock lock(d.mutex);
+  return d.entries.size();
+}
+//-----------------------------------------------------------------------------
+void TensorLayoutCache::clear()
+{
+  Data& d = data();
+  boost::mutex::scoped_lock lock(d.mutex);
+  d.entries.clear();
+}
+//-----------------------------------------------------------------------------
+TensorLayoutCache::Data& TensorLayoutCache::data()
+{
+  static Data d;
+  return d;
+}
+//-----------------------------------------------------------------------------
+boost::shared_ptr<TensorLayout>
+TensorLayoutCache::build(const Form& a,
+                         const GenericLinearAlgebraFactory& factory,
+                         bool keep_diagonal)
+{
+  Timer t0("Build sparsity");
+
+  // Get dof maps
+  std::vector<const GenericDofMap*> dofmaps;
+  for (std::size_t i = 0; i < a.rank(); ++i)
+    dofmaps.push_back(a.function_space(i)->dofmap().get());
+
+  // Create layout for initialising tensor
+  boost::shared_ptr<TensorLayout> tensor_layout = factory.create_layout(a.rank());
+  dolfin_assert(tensor_layout);
+
+  std::vector<std::size_t> global_dimensions(a.rank());
+  std::vector<std::pair<std::size_t, std::size_t> > local_range(a.rank());
+  std::vector<std::size_t> block_sizes;
+  for (std::size_t i = 0; i < a.rank(); i++)
+  {
+    dolfin_assert(dofmaps[i]);
+    global_dimensions[i] = dofmaps[i]->global_dimension();
+    local_range[i]       = dofmaps[i]->ownership_range();
+    block_sizes.push_back(dofmaps[i]->block_size);
+  }
+
+  // Set block size for sparsity graphs
+  std::size_t block_size = 1;
+  if (a.rank() == 2)
+  {
+    const std::vector<std::size_t> _bs(a.rank(), dofmaps[0]->block_size);
+    block_size = (block_sizes == _bs) ? dofmaps[0]->block_size : 1;
+  }
+
+  // Initialise tensor layout
+  tensor_layout->init(global_dimensions, block_size, local_range);
+
+  // Build sparsity pattern if required
+  if (tensor_layout->sparsity_pattern())
+  {
+    GenericSparsityPattern& pattern = *tensor_layout->sparsity_pattern();
+    SparsityPatternBuilder::build(pattern,
+                              a.mesh(), dofmaps,
+                              a.ufc_form()->has_cell_integrals(),
+                              a.ufc_form()->has_interior_facet_integrals(),
+                              a.ufc_form()->has_exterior_facet_integrals(),
+                              keep_diagonal);
+  }
+
+  return tensor_layout;
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,107 @@
+// Copyright (C) 2026 agent
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+//
+// First added:  2026-10-16
+// Last changed: 2026-10-16
+
+#ifndef __TENSOR_LAYOUT_CACHE_H
+#define __TENSOR_LAYOUT_CACHE_H
+
+#include <cstddef>
+#include <boost/shared_ptr.hpp>
+
+namespace dolfin
+{
+
+  class Form;
+  class GenericLinearAlgebraFactory;
+  class GenericMatrix;
+  class TensorLayout;
+
+  /// This class caches tensor layouts (including sparsity patterns)
+  /// for assembly of forms, such that repeated assembly of forms on
+  /// the same mesh and function spaces does not need to recompute
+  /// the sparsity pattern.
+  ///
+  /// Layouts are keyed on the mesh (including a hash of its
+  /// cell-vertex connectivity), the dof maps of the form arguments,
+  /// the types of integrals present in the form and the linear
+  /// algebra backend. A cached layout is not reused when the mesh is
+  /// renumbered in place, and it is discarded when the mesh or one of
+  /// the dof maps is destroyed or modified (changed number of
+  /// entities or dofs). Dof maps are identified by their id, so a dof
+  /// map must not be renumbered in place while caching is on. The cache is used by the assemblers
+  /// if the global parameter "cache_sparsity" is true (default
+  /// false).
+  ///
+  /// Caching trades memory for assembly time: each cached sparsity
+  /// pattern is about as large as the index arrays of the matrix, and
+  /// up to 16 patterns are kept alive after the matrices assembled
+  /// with them have been destroyed. Turn caching on when the same
+  /// forms are assembled repeatedly (e.g. in time stepping) and the
+  /// memory is available.
+
+  class TensorLayoutCache
+  {
+  public:
+
+    /// Return tensor layout for assembly of form, built and cached
+    /// if not already in the cache
+    ///
+    /// *Arguments*
+    ///     a (_Form_)
+    ///         The form.
+    ///     factory (_GenericLinearAlgebraFactory_)
+    ///         The factory of the linear algebra backend.
+    ///     keep_diagonal (bool)
+    ///         Include diagonal entries in the sparsity pattern.
+    ///
+    /// *Returns*
+    ///     _TensorLayout_
+    ///         The (shared) tensor layout. It must not be modified.
+    static boost::shared_ptr<const TensorLayout>
+      layout(const Form& a, const GenericLinearAlgebraFactory& factory,
+             bool keep_diagonal=false);
+
+    /// Create matrix with the nonzero structure for assembly of the
+    /// bilinear form a (using the default linear algebra backend)
+    static boost::shared_ptr<GenericMatrix> create_matrix(const Form& a);
+
+    /// Return number of cached layouts
+    static std::size_t size();
+
+    /// Remove all cached layouts
+    static void clear();
+
+  private:
+
+    class Entry;
+    class Data;
+
+    // Return cache data
+    static Data& data();
+
+    // Build tensor layout for form
+    static boost::shared_ptr<TensorLayout>
+      build(const Form& a, const GenericLinearAlgebraFactory& factory,
+            bool keep_diagonal);
+
+  };
+
+}
+
+#endif
@@ -82,6 +82,10 @@ namespace dolfin
     const double* const * macro_w() const
     { return &macro_w_pointer[0]; }
 
+    /// Number of values of coefficient i restricted to a cell
+    std::size_t coefficient_dimension(std::size_t i) const
+    { return _w[i].size(); }
+
   private:
 
     // Finite elements for coefficients
@@ -17,6 +17,7 @@
 #include <dolfin/fem/AssemblerBase.h>
 #include <dolfin/fem/Assembler.h>
 #include <dolfin/fem/SparsityPatternBuilder.h>
+#include <dolfin/fem/TensorLayoutCache.h>
 #include <dolfin/fem/SystemAssembler.h>
 #include <dolfin/fem/LinearVariationalProblem.h>
 #include <dolfin/fem/LinearVariationalSolver.h>
@@ -20,9 +20,10 @@
 // Modified by Andre Massing 2009
 //
 // First added:  2003-11-28
-// Last changed: 2013-05-08
+// Last changed: 2026-10-16
 
 #include <algorithm>
+#include <limits>
 #include <map>
 #include <utility>
 #include <vector>
@@ -36,6 +37,7 @@
 #include <dolfin/fem/GenericDofMap.h>
 #include <dolfin/fem/DirichletBC.h>
 #include <dolfin/fem/UFC.h>
+#include <dolfin/geometry/BoundingBoxTree.h>
 #include <dolfin/io/File.h>
 #include <dolfin/io/XMLFile.h>
 #include <dolfin/la/GenericVector.h>
@@ -437,6 +439,127 @@ void Function::eval(Array<double>& values,
   }
 }
 //-----------------------------------------------------------------------------
+void Function::eval_points(Array<double>& values, const Array<double>& x) const
+{
+  dolfin_assert(_function_space);
+  dolfin_assert(_function_space->mesh());
+  dolfin_assert(_function_space->element());
+  const Mesh& mesh = *_function_space->mesh();
+  const FiniteElement& element = *_function_space->element();
+
+  Timer timer("Function eval points");
+
+  // Get dimensions and check size of arrays
+  const std::size_t gdim = mesh.geometry().dim();
+  const std::size_t value_size_loc = value_size();
+  const std::size_t space_dim = element.space_dimension();
+  const std::size_t num_points = x.size()/gdim;
+  if (x.size() != num_points*gdim || values.size() != num_points*value_size_loc)
+  {
+    dolfin_error("Function.cpp",
+                 "evaluate function at points",
+                 "Size of arrays (%d coordinates, %d values) does not match geometric dimension and value size of function",
+                 x.size(), values.size());
+  }
+
+  // Number of threads used to find cells and evaluate function
+  const std::size_t num_threads = parameters["num_threads"];
+
+  // Build bounding box tree for cells of mesh
+  BoundingBoxTree tree;
+  tree.build(mesh);
+
+  // Find cell containing each point
+  const unsigned int not_found = std::numeric_limits<unsigned int>::max();
+  std::vector<std::pair<unsigned int, std::size_t> > point_cells(num_points);
+  #ifdef HAS_OPENMP
+  #pragma omp parallel for num_threads(std::max(num_threads, (std::size_t) 1))
+  #endif
+  for (int i = 0; i < (int) num_points; ++i)
+  {
+    const Point point(gdim, &x[i*gdim]);
+    point_cells[i].first = tree.compute_first_entity_collision(point, mesh);
+    point_cells[i].second = i;
+  }
+
+  // Use the closest cell for points not inside the domain (serial,
+  // since the tree for closest entity search is built on demand)
+  for (std::size_t i = 0; i < num_points; ++i)
+  {
+    if (point_cells[i].first != not_found)
+      continue;
+
+    const Point point(gdim, &x[i*gdim]);
+    if (allow_extrapolation)
+    {
+      point_cells[i].first = tree.compute_closest_entity(point, mesh).first;
+      cout << "Extrapolating function value at x = " << point << " (not inside domain)." << endl;
+    }
+    else
+    {
+      cout << "Evaluating at x = " << point << endl;
+      dolfin_error("Function.cpp",
+                   "evaluate function at points",
+                   "The point is not inside the domain. Consider setting \"allow_extrapolation\" to allow extrapolation");
+    }
+  }
+
+  // Sort points by cell
+  std::sort(point_cells.begin(), point_cells.end());
+
+  // Compute start of each group of points in the same cell
+  std::vector<std::size_t> offsets;
+  for (std::size_t i = 0; i < num_points; ++i)
+  {
+    if (i == 0 || point_cells[i].first != point_cells[i - 1].first)
+      offsets.push_back(i);
+  }
+  offsets.push_back(num_points);
+  const std::size_t num_groups = offsets.size() - 1;
+
+  // Evaluate function for each group of points
+  #ifdef HAS_OPENMP
+  #pragma omp parallel num_threads(std::max(num_threads, (std::size_t) 1))
+  #endif
+  {
+    // Work arrays (one per thread)
+    UFCCell ufc_cell(mesh);
+    std::vector<double> coefficients(space_dim);
+    std::vector<double> basis(space_dim*value_size_loc);
+
+    #ifdef HAS_OPENMP
+    #pragma omp for schedule(dynamic)
+    #endif
+    for (int g = 0; g < (int) num_groups; ++g)
+    {
+      // Restrict function to cell (once for all points in cell)
+      const Cell cell(mesh, point_cells[offsets[g]].first);
+      ufc_cell.update(cell);
+      restrict(&coefficients[0], element, cell, ufc_cell);
+
+      for (std::size_t p = offsets[g]; p < offsets[g + 1]; ++p)
+      {
+        const std::size_t i = point_cells[p].second;
+
+        // Evaluate all basis functions at point
+        element.evaluate_basis_all(&basis[0], &x[i*gdim],
+                                   &ufc_cell.vertex_coordinates[0],
+                                   ufc_cell.orientation);
+
+        // Compute linear combination
+        double* _values = &values[i*value_size_loc];
+        for (std::size_t j = 0; j < value_size_loc; ++j)
+          _values[j] = 0.0;
+        for (std::size_t k = 0; k < space_dim; ++k)
+        {
+          for (std::size_t j = 0; j < value_size_loc; ++j)
+            _values[j] += coefficients[k]*basis[k*value_size_loc + j];
+        }
+      }
+    }
+  }
+}
+//-----------------------------------------------------------------------------
 void Function::interpolate(const GenericFunction& v)
 {
   // Gather off-process dofs
@@ -564,7 +687,7 @@ void Function::restrict(double* w,
   {
     // Get dofmap for cell
     const GenericDofMap& dofmap = *_function_space->dofmap();
-    const std::vector<dolfin::la_index>& dofs = dofmap.cell_dofs(dolfin_cell.index());
+    const ArrayView<const dolfin::la_index> dofs = dofmap.cell_dofs(dolfin_cell.index());
 
     // Pick values from vector(s)
     _vector->get_local(w, dofs.size(), dofs.data());
@@ -727,7 +850,7 @@ void Function::compute_ghost_indices(std::pair<std::size_t, std::size_t> range,
   for (CellIterator cell(mesh); !cell.end(); ++cell)
   {
     // Get dofs on cell
-    const std::vector<dolfin::la_index>& dofs = dofmap.cell_dofs(cell->index());
+    const ArrayView<const dolfin::la_index> dofs = dofmap.cell_dofs(cell->index());
     for (std::size_t d = 0; d < dofs.size(); ++d)
     {
       const std::size_t dof = dofs[d];
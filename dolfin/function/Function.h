@@ -21,7 +21,7 @@
 // Modified by Andre Massing, 2009.
 //
 // First added:  2003-11-28
-// Last changed: 2012-10-02
+// Last changed: 2026-10-16
 
 #ifndef __FUNCTION_H
 #define __FUNCTION_H
@@ -277,6 +277,22 @@ namespace dolfin
               const Cell& dolfin_cell,
               const ufc::cell& ufc_cell) const;
 
+    /// Evaluate function at multiple points. The points are sorted
+    /// by containing cell such that the function is restricted only
+    /// once for each cell, and the evaluation is multi-threaded if
+    /// the global parameter "num_threads" is nonzero. A bounding box
+    /// tree is built for the mesh on each call, so this function
+    /// should be used with large batches of points.
+    ///
+    /// *Arguments*
+    ///     values (_Array_ <double>)
+    ///         The values (value_size() values for each point, point
+    ///         by point).
+    ///     x (_Array_ <double>)
+    ///         The coordinates (geometric_dimension() coordinates for
+    ///         each point, point by point).
+    void eval_points(Array<double>& values, const Array<double>& x) const;
+
     /// Interpolate function (on possibly non-matching meshes)
     ///
     /// *Arguments*
@@ -178,7 +178,7 @@ void FunctionSpace::interpolate(GenericVector& expansion_coefficients,
     v.restrict(&cell_coefficients[0], *_element, *cell, ufc_cell);
 
     // Tabulate dofs
-    const std::vector<dolfin::la_index>& cell_dofs = _dofmap->cell_dofs(cell->index());
+    const ArrayView<const dolfin::la_index> cell_dofs = _dofmap->cell_dofs(cell->index());
 
     // Copy dofs to vector
     expansion_coefficients.set(&cell_coefficients[0],
@@ -286,7 +286,7 @@ void FunctionSpace::print_dofmap() const
   dolfin_assert(_mesh);
   for (CellIterator cell(*_mesh); !cell.end(); ++cell)
   {
-    const std::vector<dolfin::la_index>& dofs = _dofmap->cell_dofs(cell->index());
+    const ArrayView<const dolfin::la_index> dofs = _dofmap->cell_dofs(cell->index());
     cout << cell->index() << ":";
     for (std::size_t i = 0; i < dofs.size(); i++)
       cout << " " << static_cast<std::size_t>(dofs[i]);
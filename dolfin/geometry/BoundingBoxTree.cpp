@@ -16,7 +16,7 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2013-04-09
-// Last changed: 2013-05-28
+// Last changed: 2026-10-16
 
 #include <dolfin/log/log.h>
 #include <dolfin/common/NoDeleter.h>
@@ -96,6 +96,26 @@ void BoundingBoxTree::build(const std::vector<Point>& points, std::size_t gdim)
   _tree->build(points);
 }
 //-----------------------------------------------------------------------------
+void BoundingBoxTree::refit(const Mesh& mesh)
+{
+  // Check that tree has been built
+  check_built();
+
+  // Delegate call to implementation
+  dolfin_assert(_tree);
+  _tree->refit(mesh);
+}
+//-----------------------------------------------------------------------------
+void BoundingBoxTree::refit(const std::vector<Point>& points)
+{
+  // Check that tree has been built
+  check_built();
+
+  // Delegate call to implementation
+  dolfin_assert(_tree);
+  _tree->refit(points);
+}
+//-----------------------------------------------------------------------------
 std::vector<unsigned int>
 BoundingBoxTree::compute_collisions(const Point& point) const
 {
@@ -165,6 +185,60 @@ BoundingBoxTree::compute_closest_point(const Point& point) const
   return _tree->compute_closest_point(point);
 }
 //-----------------------------------------------------------------------------
+void
+BoundingBoxTree::compute_collisions(const std::vector<double>& points,
+                                    std::vector<unsigned int>& offsets,
+                                    std::vector<unsigned int>& entities) const
+{
+  // Check that tree has been built
+  check_built();
+
+  // Delegate call to implementation
+  dolfin_assert(_tree);
+  _tree->compute_collisions(points, offsets, entities);
+}
+//-----------------------------------------------------------------------------
+void
+BoundingBoxTree::compute_entity_collisions(const std::vector<double>& points,
+                                           const Mesh& mesh,
+                                           std::vector<unsigned int>& offsets,
+                                           std::vector<unsigned int>& entities) const
+{
+  // Check that tree has been built
+  check_built();
+
+  // Delegate call to implementation
+  dolfin_assert(_tree);
+  _tree->compute_entity_collisions(points, mesh, offsets, entities);
+}
+//-----------------------------------------------------------------------------
+void
+BoundingBoxTree::compute_first_entity_collisions(const std::vector<double>& points,
+                                                 const Mesh& mesh,
+                                                 std::vector<unsigned int>& entities) const
+{
+  // Check that tree has been built
+  check_built();
+
+  // Delegate call to implementation
+  dolfin_assert(_tree);
+  _tree->compute_first_entity_collisions(points, mesh, entities);
+}
+//-----------------------------------------------------------------------------
+void
+BoundingBoxTree::compute_closest_entities(const std::vector<double>& points,
+                                          const Mesh& mesh,
+                                          std::vector<unsigned int>& entities,
+                                          std::vector<double>& distances) const
+{
+  // Check that tree has been built
+  check_built();
+
+  // Delegate call to implementation
+  dolfin_assert(_tree);
+  _tree->compute_closest_entities(points, mesh, entities, distances);
+}
+//-----------------------------------------------------------------------------
 void BoundingBoxTree::check_built() const
 {
   if (!_tree)
@@ -16,7 +16,7 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2013-04-09
-// Last changed: 2013-05-28
+// Last changed: 2026-10-16
 
 #ifndef __BOUNDING_BOX_TREE_H
 #define __BOUNDING_BOX_TREE_H
@@ -37,6 +37,10 @@ namespace dolfin
   /// This class implements a (distributed) axis aligned bounding box
   /// tree (AABB tree). Bounding box trees can be created from meshes
   /// and [other data structures, to be filled in].
+  ///
+  /// Trees are built (and refitted) in parallel if the global
+  /// parameter "num_threads" is nonzero. The resulting tree does not
+  /// depend on the number of threads.
 
   class BoundingBoxTree
   {
@@ -74,6 +78,29 @@ namespace dolfin
     ///         The geometric dimension.
     void build(const std::vector<Point>& points, std::size_t gdim);
 
+    /// Update the bounding boxes of the tree after the vertices of
+    /// the mesh have moved. The topology of the mesh must be the same
+    /// as when the tree was built. The tree structure is kept, so
+    /// this is much cheaper than rebuilding the tree (but the tree
+    /// may become less efficient for large deformations).
+    ///
+    /// Trees built for point clouds are refitted from the moved
+    /// points instead, see refit(points).
+    ///
+    /// *Arguments*
+    ///     mesh (_Mesh_)
+    ///         The mesh for which the tree was built.
+    void refit(const Mesh& mesh);
+
+    /// Update the bounding boxes of a tree built for a point cloud
+    /// after the points have moved. The number of points must be the
+    /// same as when the tree was built.
+    ///
+    /// *Arguments*
+    ///     points (std::vector<_Point_>)
+    ///         The moved points, in the order used to build the tree.
+    void refit(const std::vector<Point>& points);
+
     /// Compute all collisions between bounding boxes and given _Point_.
     ///
     /// *Returns*
@@ -179,6 +206,77 @@ namespace dolfin
     std::pair<unsigned int, double>
     compute_closest_point(const Point& point) const;
 
+    /// Compute all collisions between bounding boxes and a list of
+    /// points. The points are processed in parallel if the global
+    /// parameter "num_threads" is nonzero, and are ordered along a
+    /// space-filling curve for locality of the tree traversal. The
+    /// same holds for the other functions for lists of points below.
+    ///
+    /// *Arguments*
+    ///     points (std::vector<double>)
+    ///         The coordinates of the points (gdim values per point).
+    ///     offsets (std::vector<unsigned int>)
+    ///         Offsets into entities for each point (output). The
+    ///         collisions for point i are entities[offsets[i]]
+    ///         through entities[offsets[i + 1] - 1].
+    ///     entities (std::vector<unsigned int>)
+    ///         Local indices for entities contained in (leaf)
+    ///         bounding boxes that collide with the points (output).
+    void compute_collisions(const std::vector<double>& points,
+                            std::vector<unsigned int>& offsets,
+                            std::vector<unsigned int>& entities) const;
+
+    /// Compute all collisions between entities and a list of points.
+    ///
+    /// *Arguments*
+    ///     points (std::vector<double>)
+    ///         The coordinates of the points (gdim values per point).
+    ///     mesh (_Mesh_)
+    ///         The mesh.
+    ///     offsets (std::vector<unsigned int>)
+    ///         Offsets into entities for each point (output).
+    ///     entities (std::vector<unsigned int>)
+    ///         Local indices for entities that collide with the
+    ///         points (output).
+    void compute_entity_collisions(const std::vector<double>& points,
+                                   const Mesh& mesh,
+                                   std::vector<unsigned int>& offsets,
+                                   std::vector<unsigned int>& entities) const;
+
+    /// Compute first collision between entities and each point in a
+    /// list of points.
+    ///
+    /// *Arguments*
+    ///     points (std::vector<double>)
+    ///         The coordinates of the points (gdim values per point).
+    ///     mesh (_Mesh_)
+    ///         The mesh.
+    ///     entities (std::vector<unsigned int>)
+    ///         The local index of the first found entity for each
+    ///         point, or std::numeric_limits<unsigned int>::max() if
+    ///         not found (output).
+    void compute_first_entity_collisions(const std::vector<double>& points,
+                                         const Mesh& mesh,
+                                         std::vector<unsigned int>& entities) const;
+
+    /// Compute closest entity to each point in a list of points.
+    ///
+    /// *Arguments*
+    ///     points (std::vector<double>)
+    ///         The coordinates of the points (gdim values per point).
+    ///     mesh (_Mesh_)
+    ///         The mesh.
+    ///     entities (std::vector<unsigned int>)
+    ///         The local index of the closest entity for each point
+    ///         (output).
+    ///     distances (std::vector<double>)
+    ///         The distance to the closest entity for each point
+    ///         (output).
+    void compute_closest_entities(const std::vector<double>& points,
+                                  const Mesh& mesh,
+                                  std::vector<unsigned int>& entities,
+                                  std::vector<double>& distances) const;
+
   private:
 
     // Check that tree has been built
@@ -16,7 +16,7 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2013-05-02
-// Last changed: 2013-05-27
+// Last changed: 2026-10-16
 
 #ifndef __BOUNDING_BOX_TREE_1D_H
 #define __BOUNDING_BOX_TREE_1D_H
@@ -114,33 +114,6 @@ namespace dolfin
       axis = 0;
     }
 
-    // Compute bounding box of points
-    void compute_bbox_of_points(double* bbox,
-                                std::size_t& axis,
-                                const std::vector<Point>& points,
-                                const std::vector<unsigned int>::iterator& begin,
-                                const std::vector<unsigned int>::iterator& end)
-    {
-      typedef std::vector<unsigned int>::const_iterator iterator;
-
-      // Get coordinates for first point
-      iterator it = begin;
-      const double* p = points[*it].coordinates();
-      bbox[0] = p[0];
-      bbox[1] = p[1];
-
-      // Compute min and max over remaining boxes
-      for (; it != end; ++it)
-      {
-        const double* p = points[*it].coordinates();
-        if (p[0] < bbox[0]) bbox[0] = p[0];
-        if (p[0] > bbox[1]) bbox[1] = p[0];
-      }
-
-      // Compute longest axis
-      axis = 0;
-    }
-
     // Sort leaf bounding boxes along given axis
     void sort_bboxes(std::size_t axis,
                      const std::vector<double>& leaf_bboxes,
@@ -16,7 +16,7 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2013-04-09
-// Last changed: 2013-05-27
+// Last changed: 2026-10-16
 
 #ifndef __BOUNDING_BOX_TREE_3D_H
 #define __BOUNDING_BOX_TREE_3D_H
@@ -165,50 +165,6 @@ namespace dolfin
         axis = 2;
     }
 
-    // Compute bounding box of points
-    void compute_bbox_of_points(double* bbox,
-                                std::size_t& axis,
-                                const std::vector<Point>& points,
-                                const std::vector<unsigned int>::iterator& begin,
-                                const std::vector<unsigned int>::iterator& end)
-    {
-      typedef std::vector<unsigned int>::const_iterator iterator;
-
-      // Get coordinates for first point
-      iterator it = begin;
-      const double* p = points[*it].coordinates();
-      bbox[0] = p[0];
-      bbox[1] = p[1];
-      bbox[2] = p[2];
-      bbox[3] = p[0];
-      bbox[4] = p[1];
-      bbox[5] = p[2];
-
-      // Compute min and max over remaining points
-      for (; it != end; ++it)
-      {
-        const double* p = points[*it].coordinates();
-        if (p[0] < bbox[0]) bbox[0] = p[0];
-        if (p[1] < bbox[1]) bbox[1] = p[1];
-        if (p[2] < bbox[2]) bbox[2] = p[2];
-        if (p[0] > bbox[3]) bbox[3] = p[0];
-        if (p[1] > bbox[4]) bbox[4] = p[1];
-        if (p[2] > bbox[5]) bbox[5] = p[2];
-      }
-
-      // Compute longest axis
-      const double x = bbox[3] - bbox[0];
-      const double y = bbox[4] - bbox[1];
-      const double z = bbox[5] - bbox[2];
-
-      if (x > y && x > z)
-        axis = 0;
-      else if (y > z)
-        axis = 1;
-      else
-        axis = 2;
-    }
-
     // Sort leaf bounding boxes along given axis
     void sort_bboxes(std::size_t axis,
                      const std::vector<double>& leaf_bboxes,
@@ -16,13 +16,23 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2013-05-02
-// Last changed: 2013-05-28
+// Last changed: 2026-10-16
 
 // Define a maximum dimension used for a local array in the recursive
 // build function. Speeds things up compared to allocating it in each
 // recursion and is more convenient than sending it around.
 #define MAX_DIM 6
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+#ifdef HAS_OPENMP
+#include <omp.h>
+#endif
+
+#include <dolfin/parameter/GlobalParameters.h>
 #include <dolfin/mesh/Mesh.h>
 #include <dolfin/mesh/Cell.h>
 #include <dolfin/mesh/Point.h>
@@ -63,22 +73,14 @@ void GenericBoundingBoxTree::build(const Mesh& mesh, std::size_t tdim)
   mesh.init(tdim);
 
   // Create bounding boxes for all entities (leaves)
-  const std::size_t _gdim = gdim();
-  const unsigned int num_leaves = mesh.num_entities(tdim);
-  std::vector<double> leaf_bboxes(2*_gdim*num_leaves);
-  for (MeshEntityIterator it(mesh, tdim); !it.end(); ++it)
-    compute_bbox_of_entity(leaf_bboxes.data() + 2*_gdim*it->index(), *it, _gdim);
-
-  // Create leaf partition (to be sorted)
-  std::vector<unsigned int> leaf_partition(num_leaves);
-  for (unsigned int i = 0; i < num_leaves; ++i)
-    leaf_partition[i] = i;
+  std::vector<double> leaf_bboxes;
+  compute_leaf_bboxes(leaf_bboxes, mesh, tdim);
 
-  // Recursively build the bounding box tree from the leaves
-  build(leaf_bboxes, leaf_partition.begin(), leaf_partition.end(), _gdim);
+  // Build the bounding box tree from the leaves
+  build(leaf_bboxes, gdim());
 
   info("Computed bounding box tree with %d nodes for %d entities.",
-       _bboxes.size(), num_leaves);
+       _bboxes.size(), mesh.num_entities(tdim));
 }
 //-----------------------------------------------------------------------------
 void GenericBoundingBoxTree::build(const std::vector<Point>& points)
@@ -86,25 +88,84 @@ void GenericBoundingBoxTree::build(const std::vector<Point>& points)
   // Clear existing data if any
   clear();
 
-  // Create leaf partition (to be sorted)
-  const unsigned int num_leaves = points.size();
-  std::vector<unsigned int> leaf_partition(num_leaves);
-  for (unsigned int i = 0; i < num_leaves; ++i)
-    leaf_partition[i] = i;
+  // Create bounding boxes for all points (leaves)
+  const std::size_t _gdim = gdim();
+  std::vector<double> leaf_bboxes(2*_gdim*points.size());
+  for (std::size_t i = 0; i < points.size(); ++i)
+  {
+    const double* x = points[i].coordinates();
+    std::copy(x, x + _gdim, leaf_bboxes.begin() + 2*_gdim*i);
+    std::copy(x, x + _gdim, leaf_bboxes.begin() + 2*_gdim*i + _gdim);
+  }
 
-  // Recursively build the bounding box tree from the leaves
-  build(points, leaf_partition.begin(), leaf_partition.end(), gdim());
+  // Build the bounding box tree from the leaves
+  build(leaf_bboxes, _gdim);
 
   info("Computed bounding box tree with %d nodes for %d points.",
-       _bboxes.size(), num_leaves);
+       _bboxes.size(), points.size());
+}
+//-----------------------------------------------------------------------------
+void GenericBoundingBoxTree::refit(const Mesh& mesh)
+{
+  // Trees for point clouds (tdim 0) are refitted from the points
+  if (_tdim == 0)
+  {
+    dolfin_error("GenericBoundingBoxTree.cpp",
+                 "refit bounding box tree",
+                 "Bounding box tree has been built for a point cloud, not for mesh entities");
+  }
+
+  // Check that tree has been built for entities of mesh
+  const std::size_t num_leaves = (_bboxes.size() + 1) / 2;
+  if (_bboxes.empty() || mesh.num_entities(_tdim) != num_leaves)
+  {
+    dolfin_error("GenericBoundingBoxTree.cpp",
+                 "refit bounding box tree",
+                 "Bounding box tree has not been built for entities of given mesh");
+  }
+
+  // Update bounding boxes for entities
+  std::vector<double> leaf_bboxes;
+  compute_leaf_bboxes(leaf_bboxes, mesh, _tdim);
+  refit(leaf_bboxes, gdim());
+
+  // Update point search tree (cell midpoints) if built
+  if (_point_search_tree)
+  {
+    compute_midpoint_bboxes(leaf_bboxes, mesh);
+    _point_search_tree->refit(leaf_bboxes, gdim());
+  }
+}
+//-----------------------------------------------------------------------------
+void GenericBoundingBoxTree::refit(const std::vector<Point>& points)
+{
+  // Check that tree has been built for point cloud of same size
+  const std::size_t num_leaves = (_bboxes.size() + 1) / 2;
+  if (_tdim != 0 || _bboxes.empty() || points.size() != num_leaves)
+  {
+    dolfin_error("GenericBoundingBoxTree.cpp",
+                 "refit bounding box tree",
+                 "Bounding box tree has not been built for point cloud of given size");
+  }
+
+  // Update bounding boxes for points
+  const std::size_t _gdim = gdim();
+  std::vector<double> leaf_bboxes(2*_gdim*points.size());
+  for (std::size_t i = 0; i < points.size(); ++i)
+  {
+    const double* x = points[i].coordinates();
+    std::copy(x, x + _gdim, leaf_bboxes.begin() + 2*_gdim*i);
+    std::copy(x, x + _gdim, leaf_bboxes.begin() + 2*_gdim*i + _gdim);
+  }
+  refit(leaf_bboxes, _gdim);
 }
 //-----------------------------------------------------------------------------
 std::vector<unsigned int>
 GenericBoundingBoxTree::compute_collisions(const Point& point) const
 {
-  // Call recursive find function
-  std::vector<unsigned int> entities;
-  compute_collisions(point, _bboxes.size() - 1, entities);
+  // Call search function
+  std::vector<unsigned int> entities, stack;
+  compute_collisions(point, 0, entities, stack);
 
   return entities;
 }
@@ -121,9 +182,9 @@ GenericBoundingBoxTree::compute_entity_collisions(const Point& point,
                  "Point-in-entity is only implemented for cells");
   }
 
-  // Call recursive find function
-  std::vector<unsigned int> entities;
-  compute_entity_collisions(point, _bboxes.size() - 1, entities, mesh);
+  // Call search function
+  std::vector<unsigned int> entities, stack;
+  compute_collisions(point, &mesh, entities, stack);
 
   return entities;
 }
@@ -131,8 +192,9 @@ GenericBoundingBoxTree::compute_entity_collisions(const Point& point,
 unsigned int
 GenericBoundingBoxTree::compute_first_collision(const Point& point) const
 {
-  // Call recursive find function
-  return compute_first_collision(point, _bboxes.size() - 1);
+  // Call search function
+  std::vector<unsigned int> stack;
+  return compute_first_collision(point, 0, stack);
 }
 //-----------------------------------------------------------------------------
 unsigned int
@@ -147,8 +209,9 @@ GenericBoundingBoxTree::compute_first_entity_collision(const Point& point,
                  "Point-in-entity is only implemented for cells");
   }
 
-  // Call recursive find function
-  return compute_first_entity_collision(point, _bboxes.size() - 1, mesh);
+  // Call search function
+  std::vector<unsigned int> stack;
+  return compute_first_collision(point, &mesh, stack);
 }
 //-----------------------------------------------------------------------------
 std::pair<unsigned int, double>
@@ -174,8 +237,9 @@ GenericBoundingBoxTree::compute_closest_entity(const Point& point,
   unsigned int closest_entity = std::numeric_limits<unsigned int>::max();
   double R2 = r*r;
 
-  // Call recursive find function
-  compute_closest_entity(point, _bboxes.size() - 1, mesh, closest_entity, R2);
+  // Call search function
+  NodeStack stack;
+  compute_closest_entity(point, mesh, closest_entity, R2, stack);
 
   // Sanity check
   dolfin_assert(closest_entity < std::numeric_limits<unsigned int>::max());
@@ -199,17 +263,143 @@ GenericBoundingBoxTree::compute_closest_point(const Point& point) const
   // be weird.
 
   // Get initial guess by picking the distance to a "random" point
-  unsigned int closest_point = 0;
-  double R2 = compute_squared_distance_point(point.coordinates(),
-                                             closest_point);
+  // (the first leaf)
+  unsigned int closest_point = _bboxes[0].child_1;
+  double R2 = compute_squared_distance_point(point.coordinates(), 0);
 
-  // Call recursive find function
-  compute_closest_point(point, _bboxes.size() - 1, closest_point, R2);
+  // Call search function
+  NodeStack stack;
+  compute_closest_point(point, closest_point, R2, stack);
 
   std::pair<unsigned int, double> ret(closest_point, sqrt(R2));
   return ret;
 }
 //-----------------------------------------------------------------------------
+void
+GenericBoundingBoxTree::compute_collisions(const std::vector<double>& points,
+                                           std::vector<unsigned int>& offsets,
+                                           std::vector<unsigned int>& entities) const
+{
+  compute_collisions(points, 0, offsets, entities);
+}
+//-----------------------------------------------------------------------------
+void
+GenericBoundingBoxTree::compute_entity_collisions(const std::vector<double>& points,
+                                                  const Mesh& mesh,
+                                                  std::vector<unsigned int>& offsets,
+                                                  std::vector<unsigned int>& entities) const
+{
+  // Point in entity only implemented for cells. Consider extending this.
+  if (_tdim != mesh.topology().dim())
+  {
+    dolfin_error("GenericBoundingBoxTree.cpp",
+                 "compute collision between points and mesh entities",
+                 "Point-in-entity is only implemented for cells");
+  }
+
+  compute_collisions(points, &mesh, offsets, entities);
+}
+//-----------------------------------------------------------------------------
+void
+GenericBoundingBoxTree::compute_first_entity_collisions(const std::vector<double>& points,
+                                                        const Mesh& mesh,
+                                                        std::vector<unsigned int>& entities) const
+{
+  // Point in entity only implemented for cells. Consider extending this.
+  if (_tdim != mesh.topology().dim())
+  {
+    dolfin_error("GenericBoundingBoxTree.cpp",
+                 "compute collision between points and mesh entities",
+                 "Point-in-entity is only implemented for cells");
+  }
+
+  // Order points for locality of tree traversal
+  const std::size_t _gdim = gdim();
+  const std::size_t num_points = points.size() / _gdim;
+  std::vector<unsigned int> order;
+  sort_points_morton(order, points);
+
+  entities.resize(num_points);
+  const std::size_t num_threads = dolfin::parameters["num_threads"];
+
+  #ifdef HAS_OPENMP
+  #pragma omp parallel num_threads(std::max(num_threads, (std::size_t) 1))
+  #endif
+  {
+    std::vector<unsigned int> stack;
+
+    #ifdef HAS_OPENMP
+    #pragma omp for schedule(guided)
+    #endif
+    for (int i = 0; i < (int) num_points; ++i)
+    {
+      const unsigned int p = order[i];
+      const Point point(_gdim, points.data() + _gdim*p);
+      entities[p] = compute_first_collision(point, &mesh, stack);
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+void
+GenericBoundingBoxTree::compute_closest_entities(const std::vector<double>& points,
+                                                 const Mesh& mesh,
+                                                 std::vector<unsigned int>& entities,
+                                                 std::vector<double>& distances) const
+{
+  // Closest entity only implemented for cells. Consider extending this.
+  if (_tdim != mesh.topology().dim())
+  {
+    dolfin_error("GenericBoundingBoxTree.cpp",
+                 "compute closest entity of points",
+                 "Closest-entity is only implemented for cells");
+  }
+
+  // Compute point search tree if not already done (before entering
+  // the parallel region since the tree is shared)
+  build_point_search_tree(mesh);
+  dolfin_assert(_point_search_tree);
+  const GenericBoundingBoxTree& point_tree = *_point_search_tree;
+
+  // Order points for locality of tree traversal
+  const std::size_t _gdim = gdim();
+  const std::size_t num_points = points.size() / _gdim;
+  std::vector<unsigned int> order;
+  sort_points_morton(order, points);
+
+  entities.resize(num_points);
+  distances.resize(num_points);
+  const std::size_t num_threads = dolfin::parameters["num_threads"];
+
+  #ifdef HAS_OPENMP
+  #pragma omp parallel num_threads(std::max(num_threads, (std::size_t) 1))
+  #endif
+  {
+    NodeStack stack;
+
+    #ifdef HAS_OPENMP
+    #pragma omp for schedule(guided)
+    #endif
+    for (int i = 0; i < (int) num_points; ++i)
+    {
+      const unsigned int p = order[i];
+      const Point point(_gdim, points.data() + _gdim*p);
+
+      // Search point cloud to get a good starting guess
+      unsigned int closest_point = point_tree._bboxes[0].child_1;
+      double R2 = point_tree.compute_squared_distance_point(point.coordinates(), 0);
+      point_tree.compute_closest_point(point, closest_point, R2, stack);
+
+      // Search entities within distance of closest point
+      unsigned int closest_entity = std::numeric_limits<unsigned int>::max();
+      compute_closest_entity(point, mesh, closest_entity, R2, stack);
+      dolfin_assert(closest_entity < std::numeric_limits<unsigned int>::max());
+
+      entities[p] = closest_entity;
+      distances[p] = sqrt(R2);
+    }
+  }
+}
+//-----------------------------------------------------------------------------
 // Implementation of protected functions
 //-----------------------------------------------------------------------------
 void GenericBoundingBoxTree::clear()
@@ -220,28 +410,93 @@ void GenericBoundingBoxTree::clear()
   _point_search_tree.reset();
 }
 //-----------------------------------------------------------------------------
+void GenericBoundingBoxTree::build(const std::vector<double>& leaf_bboxes,
+                                   std::size_t gdim)
+{
+  const unsigned int num_leaves = leaf_bboxes.size() / (2*gdim);
+  if (num_leaves == 0)
+    return;
+
+  // Allocate nodes (a binary tree with n leaves has 2n - 1 nodes)
+  const unsigned int num_nodes = 2*num_leaves - 1;
+  _bboxes.resize(num_nodes);
+  _bbox_coordinates.resize(2*gdim*num_nodes);
+
+  // Create leaf partition (to be sorted)
+  std::vector<unsigned int> leaf_partition(num_leaves);
+  for (unsigned int i = 0; i < num_leaves; ++i)
+    leaf_partition[i] = i;
+
+  // Build tree serially if not running in parallel
+  const std::size_t num_threads = dolfin::parameters["num_threads"];
+  if (num_threads < 2)
+  {
+    build(leaf_bboxes, leaf_partition.begin(), leaf_partition.end(),
+          0, gdim, 0, 0);
+    return;
+  }
+
+  // Build top of tree and collect the subtrees below it. Since the
+  // node range of each subtree is known, the subtrees can be built
+  // independently.
+  std::vector<Subtree> subtrees;
+  const std::size_t min_leaves
+    = std::max(num_leaves / (8*num_threads), (std::size_t) 1);
+  build(leaf_bboxes, leaf_partition.begin(), leaf_partition.end(),
+        0, gdim, min_leaves, &subtrees);
+
+  // Build subtrees in parallel
+  #ifdef HAS_OPENMP
+  #pragma omp parallel for schedule(dynamic) num_threads(num_threads)
+  #endif
+  for (int i = 0; i < (int) subtrees.size(); ++i)
+  {
+    build(leaf_bboxes, subtrees[i].begin, subtrees[i].end,
+          subtrees[i].node, gdim, 0, 0);
+  }
+}
+//-----------------------------------------------------------------------------
 unsigned int
 GenericBoundingBoxTree::build(const std::vector<double>& leaf_bboxes,
                               const std::vector<unsigned int>::iterator& begin,
                               const std::vector<unsigned int>::iterator& end,
-                              std::size_t gdim)
+                              unsigned int node,
+                              std::size_t gdim,
+                              std::size_t min_leaves,
+                              std::vector<Subtree>* subtrees)
 {
   dolfin_assert(begin < end);
 
+  // Subtree root is stored last
+  const unsigned int num_leaves = end - begin;
+  const unsigned int root = node + 2*num_leaves - 2;
+
+  // Leave small subtree to be built later
+  if (subtrees && num_leaves <= min_leaves)
+  {
+    Subtree subtree;
+    subtree.begin = begin;
+    subtree.end = end;
+    subtree.node = node;
+    subtrees->push_back(subtree);
+    return root;
+  }
+
   // Create empty bounding box data
   BBox bbox;
 
   // Reached leaf
-  if (end - begin == 1)
+  if (num_leaves == 1)
   {
     // Get bounding box coordinates for leaf
     const unsigned int entity_index = *begin;
     const double* b = leaf_bboxes.data() + 2*gdim*entity_index;
 
     // Store bounding box data
-    bbox.child_0 = _bboxes.size(); // child_0 == node denotes a leaf
-    bbox.child_1 = entity_index;   // index of entity contained in leaf
-    return add_bbox(bbox, b, gdim);
+    bbox.child_0 = root;         // child_0 == node denotes a leaf
+    bbox.child_1 = entity_index; // index of entity contained in leaf
+    set_bbox(root, bbox, b, gdim);
+    return root;
   }
 
   // Compute bounding box of all bounding boxes
@@ -250,53 +505,145 @@ GenericBoundingBoxTree::build(const std::vector<double>& leaf_bboxes,
   compute_bbox_of_bboxes(b, axis, leaf_bboxes, begin, end);
 
   // Sort bounding boxes along longest axis
-  std::vector<unsigned int>::iterator middle = begin + (end - begin) / 2;
+  std::vector<unsigned int>::iterator middle = begin + num_leaves / 2;
   sort_bboxes(axis, leaf_bboxes, begin, middle, end);
 
-  // Split bounding boxes into two groups and call recursively
-  bbox.child_0 = build(leaf_bboxes, begin, middle, gdim);
-  bbox.child_1 = build(leaf_bboxes, middle, end, gdim);
-
-  // Store bounding box data. Note that root box will be added last.
-  return add_bbox(bbox, b, gdim);
+  // Split bounding boxes into two groups and call recursively. The
+  // nodes of the first group are stored first.
+  const unsigned int num_leaves_0 = middle - begin;
+  bbox.child_0 = build(leaf_bboxes, begin, middle, node,
+                       gdim, min_leaves, subtrees);
+  bbox.child_1 = build(leaf_bboxes, middle, end, node + 2*num_leaves_0 - 1,
+                       gdim, min_leaves, subtrees);
+
+  // Store bounding box data
+  set_bbox(root, bbox, b, gdim);
+  return root;
 }
 //-----------------------------------------------------------------------------
-unsigned int
-GenericBoundingBoxTree::build(const std::vector<Point>& points,
-                              const std::vector<unsigned int>::iterator& begin,
-                              const std::vector<unsigned int>::iterator& end,
-                              std::size_t gdim)
+void GenericBoundingBoxTree::refit(const std::vector<double>& leaf_bboxes,
+                                   std::size_t gdim)
 {
-  dolfin_assert(begin < end);
-
-  // Create empty bounding box data
-  BBox bbox;
+  if (_bboxes.empty())
+    return;
+  const unsigned int root = _bboxes.size() - 1;
 
-  // Reached leaf
-  if (end - begin == 1)
+  // Update serially if not running in parallel
+  const std::size_t num_threads = dolfin::parameters["num_threads"];
+  if (num_threads < 2)
   {
-    // Store bounding box data
-    const unsigned int point_index = *begin;
-    bbox.child_0 = _bboxes.size(); // child_0 == node denotes a leaf
-    bbox.child_1 = point_index;    // index of entity contained in leaf
-    return add_point(bbox, points[point_index], gdim);
+    refit(leaf_bboxes, 0, root, gdim);
+    return;
   }
 
-  // Compute bounding box of all points
-  double b[MAX_DIM];
-  std::size_t axis;
-  compute_bbox_of_points(b, axis, points, begin, end);
+  // Split tree into subtrees and the nodes above them
+  std::vector<std::pair<unsigned int, unsigned int> > subtrees;
+  std::vector<unsigned int> top_nodes;
+  const std::size_t max_nodes
+    = std::max(_bboxes.size() / (8*num_threads), (std::size_t) 1);
+  split_nodes(0, root, max_nodes, subtrees, top_nodes);
+
+  // Update subtrees in parallel
+  #ifdef HAS_OPENMP
+  #pragma omp parallel for schedule(dynamic) num_threads(num_threads)
+  #endif
+  for (int i = 0; i < (int) subtrees.size(); ++i)
+    refit(leaf_bboxes, subtrees[i].first, subtrees[i].second, gdim);
+
+  // Update nodes above subtrees (children come before parents)
+  for (std::size_t i = 0; i < top_nodes.size(); ++i)
+    refit(leaf_bboxes, top_nodes[i], top_nodes[i], gdim);
+}
+//-----------------------------------------------------------------------------
+void GenericBoundingBoxTree::refit(const std::vector<double>& leaf_bboxes,
+                                   unsigned int first, unsigned int last,
+                                   std::size_t gdim)
+{
+  // Nodes are stored in post-order, so children are updated before
+  // their parents
+  for (unsigned int node = first; node <= last; ++node)
+  {
+    const BBox& bbox = _bboxes[node];
+    double* b = _bbox_coordinates.data() + 2*gdim*node;
 
-  // Sort bounding boxes along longest axis
-  std::vector<unsigned int>::iterator middle = begin + (end - begin) / 2;
-  sort_points(axis, points, begin, middle, end);
+    // Copy bounding box of entity for leaves
+    if (is_leaf(bbox, node))
+    {
+      const double* b_leaf = leaf_bboxes.data() + 2*gdim*bbox.child_1;
+      std::copy(b_leaf, b_leaf + 2*gdim, b);
+    }
 
-  // Split bounding boxes into two groups and call recursively
-  bbox.child_0 = build(points, begin, middle, gdim);
-  bbox.child_1 = build(points, middle, end, gdim);
+    // Compute bounding box of children
+    else
+    {
+      const double* b0 = _bbox_coordinates.data() + 2*gdim*bbox.child_0;
+      const double* b1 = _bbox_coordinates.data() + 2*gdim*bbox.child_1;
+      for (std::size_t j = 0; j < gdim; ++j)
+      {
+        b[j] = std::min(b0[j], b1[j]);
+        b[gdim + j] = std::max(b0[gdim + j], b1[gdim + j]);
+      }
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+void GenericBoundingBoxTree::split_nodes(unsigned int first, unsigned int root,
+     std::size_t max_nodes,
+     std::vector<std::pair<unsigned int, unsigned int> >& subtrees,
+     std::vector<unsigned int>& top_nodes) const
+{
+  // The subtree of the first child is stored at [first, child_0]
+  // and the subtree of the second child at [child_0 + 1, child_1]
+  const BBox& bbox = _bboxes[root];
+  if (root - first + 1 <= max_nodes || is_leaf(bbox, root))
+  {
+    subtrees.push_back(std::make_pair(first, root));
+    return;
+  }
+
+  split_nodes(first, bbox.child_0, max_nodes, subtrees, top_nodes);
+  split_nodes(bbox.child_0 + 1, bbox.child_1, max_nodes, subtrees, top_nodes);
+  top_nodes.push_back(root);
+}
+//-----------------------------------------------------------------------------
+void GenericBoundingBoxTree::compute_leaf_bboxes(std::vector<double>& leaf_bboxes,
+                                                 const Mesh& mesh,
+                                                 std::size_t tdim) const
+{
+  const std::size_t _gdim = gdim();
+  const unsigned int num_leaves = mesh.num_entities(tdim);
+  leaf_bboxes.resize(2*_gdim*num_leaves);
 
-  // Store bounding box data. Note that root box will be added last.
-  return add_bbox(bbox, b, gdim);
+  const std::size_t num_threads = dolfin::parameters["num_threads"];
+  #ifdef HAS_OPENMP
+  #pragma omp parallel for num_threads(std::max(num_threads, (std::size_t) 1))
+  #endif
+  for (int i = 0; i < (int) num_leaves; ++i)
+  {
+    MeshEntity entity(mesh, tdim, i);
+    compute_bbox_of_entity(leaf_bboxes.data() + 2*_gdim*i, entity, _gdim);
+  }
+}
+//-----------------------------------------------------------------------------
+void
+GenericBoundingBoxTree::compute_midpoint_bboxes(std::vector<double>& leaf_bboxes,
+                                                const Mesh& mesh) const
+{
+  const std::size_t _gdim = gdim();
+  const unsigned int num_cells = mesh.num_cells();
+  leaf_bboxes.resize(2*_gdim*num_cells);
+
+  const std::size_t num_threads = dolfin::parameters["num_threads"];
+  #ifdef HAS_OPENMP
+  #pragma omp parallel for num_threads(std::max(num_threads, (std::size_t) 1))
+  #endif
+  for (int i = 0; i < (int) num_cells; ++i)
+  {
+    const Point p = Cell(mesh, i).midpoint();
+    double* b = leaf_bboxes.data() + 2*_gdim*i;
+    std::copy(p.coordinates(), p.coordinates() + _gdim, b);
+    std::copy(p.coordinates(), p.coordinates() + _gdim, b + _gdim);
+  }
 }
 //-----------------------------------------------------------------------------
 void GenericBoundingBoxTree::build_point_search_tree(const Mesh& mesh) const
@@ -306,11 +653,6 @@ void GenericBoundingBoxTree::build_point_search_tree(const Mesh& mesh) const
     return;
   info("Building point search tree to accelerate distance queries.");
 
-  // Create list of midpoints for all cells
-  std::vector<Point> points;
-  for (CellIterator cell(mesh); !cell.end(); ++cell)
-    points.push_back(cell->midpoint());
-
   // Select implementation
   const std::size_t gdim = mesh.geometry().dim();
   switch (gdim)
@@ -331,218 +673,362 @@ void GenericBoundingBoxTree::build_point_search_tree(const Mesh& mesh) const
                  gdim);
   }
 
-  // Build tree
+  // Build tree for cell midpoints
+  std::vector<double> leaf_bboxes;
+  compute_midpoint_bboxes(leaf_bboxes, mesh);
   dolfin_assert(_point_search_tree);
-  _point_search_tree->build(points);
+  _point_search_tree->build(leaf_bboxes, gdim);
 }
 //-----------------------------------------------------------------------------
 void
 GenericBoundingBoxTree::compute_collisions(const Point& point,
-                                           unsigned int node,
-                                           std::vector<unsigned int>& entities) const
+                                           const Mesh* mesh,
+                                           std::vector<unsigned int>& entities,
+                                           std::vector<unsigned int>& stack) const
 {
-  // Get bounding box for current node
-  const BBox& bbox = _bboxes[node];
-
-  // If point is not in bounding box, then don't search further
-  if (!point_in_bbox(point.coordinates(), node))
+  if (_bboxes.empty())
     return;
+  const double* x = point.coordinates();
 
-  // If box is a leaf (which we know contains the point), then add it
-  else if (is_leaf(bbox, node))
-    entities.push_back(bbox.child_1); // child_1 denotes entity for leaves
+  // Start at root (added last)
+  stack.clear();
+  stack.push_back(_bboxes.size() - 1);
 
-  // Check both children
-  else
+  while (!stack.empty())
   {
-    compute_collisions(point, bbox.child_0, entities);
-    compute_collisions(point, bbox.child_1, entities);
-  }
-}
-//-----------------------------------------------------------------------------
-void
-GenericBoundingBoxTree::compute_entity_collisions(const Point& point,
-                                                  unsigned int node,
-                                                  std::vector<unsigned int>& entities,
-                                                  const Mesh& mesh) const
-{
-  // Get bounding box for current node
-  const BBox& bbox = _bboxes[node];
+    const unsigned int node = stack.back();
+    stack.pop_back();
 
-  // If point is not in bounding box, then don't search further
-  if (!point_in_bbox(point.coordinates(), node))
-    return;
+    // If point is not in bounding box, then don't search further
+    if (!point_in_bbox(x, node))
+      continue;
 
-  // If box is a leaf (which we know contains the point), then check entity
-  else if (is_leaf(bbox, node))
-  {
-    // Get entity (child_1 denotes entity index for leaves)
-    dolfin_assert(_tdim == mesh.topology().dim());
-    const unsigned int entity_index = bbox.child_1;
-    Cell cell(mesh, entity_index);
+    // Get bounding box for current node
+    const BBox& bbox = _bboxes[node];
 
-    // Check entity
-    if (cell.contains(point))
-      entities.push_back(entity_index);
-  }
+    // If box is a leaf (which we know contains the point), then add
+    // it, or check entity if mesh is given (child_1 denotes entity
+    // index for leaves)
+    if (is_leaf(bbox, node))
+    {
+      if (!mesh)
+        entities.push_back(bbox.child_1);
+      else
+      {
+        dolfin_assert(_tdim == mesh->topology().dim());
+        Cell cell(*mesh, bbox.child_1);
+        if (cell.contains(point))
+          entities.push_back(bbox.child_1);
+      }
+    }
 
-  // Check both children
-  else
-  {
-    compute_entity_collisions(point, bbox.child_0, entities, mesh);
-    compute_entity_collisions(point, bbox.child_1, entities, mesh);
+    // Check both children (first child on top of stack)
+    else
+    {
+      stack.push_back(bbox.child_1);
+      stack.push_back(bbox.child_0);
+    }
   }
 }
 //-----------------------------------------------------------------------------
 unsigned int
 GenericBoundingBoxTree::compute_first_collision(const Point& point,
-                                                unsigned int node) const
+                                                const Mesh* mesh,
+                                                std::vector<unsigned int>& stack) const
 {
   // Get max integer to signify not found
-  unsigned int not_found = std::numeric_limits<unsigned int>::max();
+  const unsigned int not_found = std::numeric_limits<unsigned int>::max();
 
-  // Get bounding box for current node
-  const BBox& bbox = _bboxes[node];
-
-  // If point is not in bounding box, then don't search further
-  if (!point_in_bbox(point.coordinates(), node))
+  if (_bboxes.empty())
     return not_found;
+  const double* x = point.coordinates();
 
-  // If box is a leaf (which we know contains the point), then return it
-  else if (is_leaf(bbox, node))
-    return bbox.child_1; // child_1 denotes entity for leaves
+  // Start at root (added last)
+  stack.clear();
+  stack.push_back(_bboxes.size() - 1);
 
-  // Check both children
-  else
+  while (!stack.empty())
   {
-    unsigned int c0 = compute_first_collision(point, bbox.child_0);
-    if (c0 != not_found)
-      return c0;
+    const unsigned int node = stack.back();
+    stack.pop_back();
+
+    // If point is not in bounding box, then don't search further
+    if (!point_in_bbox(x, node))
+      continue;
+
+    // Get bounding box for current node
+    const BBox& bbox = _bboxes[node];
+
+    // If box is a leaf (which we know contains the point), then return
+    // it, or check entity if mesh is given
+    if (is_leaf(bbox, node))
+    {
+      if (!mesh)
+        return bbox.child_1;
+
+      dolfin_assert(_tdim == mesh->topology().dim());
+      Cell cell(*mesh, bbox.child_1);
+      if (cell.contains(point))
+        return bbox.child_1;
+    }
 
-    // Check second child
-    unsigned int c1 = compute_first_collision(point, bbox.child_1);
-    if (c1 != not_found)
-      return c1;
+    // Check both children (first child on top of stack)
+    else
+    {
+      stack.push_back(bbox.child_1);
+      stack.push_back(bbox.child_0);
+    }
   }
 
   // Point not found
   return not_found;
 }
 //-----------------------------------------------------------------------------
-unsigned int
-GenericBoundingBoxTree::compute_first_entity_collision(const Point& point,
-                                                       unsigned int node,
-                                                       const Mesh& mesh) const
+void
+GenericBoundingBoxTree::compute_closest_entity(const Point& point,
+                                               const Mesh& mesh,
+                                               unsigned int& closest_entity,
+                                               double& R2,
+                                               NodeStack& stack) const
 {
-  // Get max integer to signify not found
-  unsigned int not_found = std::numeric_limits<unsigned int>::max();
-
-  // Get bounding box for current node
-  const BBox& bbox = _bboxes[node];
+  if (_bboxes.empty())
+    return;
+  const double* x = point.coordinates();
 
-  // If point is not in bounding box, then don't search further
-  if (!point_in_bbox(point.coordinates(), node))
-    return not_found;
+  // Start at root (added last)
+  const unsigned int root = _bboxes.size() - 1;
+  stack.clear();
+  stack.push_back(std::make_pair(root, compute_squared_distance_bbox(x, root)));
 
-  // If box is a leaf (which we know contains the point), then check entity
-  else if (is_leaf(bbox, node))
+  while (!stack.empty())
   {
-    // Get entity (child_1 denotes entity index for leaves)
-    dolfin_assert(_tdim == mesh.topology().dim());
-    const unsigned int entity_index = bbox.child_1;
-    Cell cell(mesh, entity_index);
+    const unsigned int node = stack.back().first;
+    const double r2 = stack.back().second;
+    stack.pop_back();
 
-    // Check entity
-    if (cell.contains(point))
-      return entity_index;
-  }
+    // If bounding box is outside radius, then don't search further
+    // (radius may have shrunk since node was pushed)
+    if (r2 > R2)
+      continue;
 
-  // Check both children
-  else
-  {
-    unsigned int c0 = compute_first_entity_collision(point, bbox.child_0, mesh);
-    if (c0 != not_found)
-      return c0;
+    // Get bounding box for current node
+    const BBox& bbox = _bboxes[node];
 
-    unsigned int c1 = compute_first_entity_collision(point, bbox.child_1, mesh);
-    if (c1 != not_found)
-      return c1;
-  }
+    // If box is leaf (which we know is inside radius), then shrink radius
+    if (is_leaf(bbox, node))
+    {
+      // Get entity (child_1 denotes entity index for leaves)
+      dolfin_assert(_tdim == mesh.topology().dim());
+      const unsigned int entity_index = bbox.child_1;
+      Cell cell(mesh, entity_index);
+
+      // If entity is closer than best result so far, then return it
+      const double r2 = cell.squared_distance(point);
+      if (r2 < R2)
+      {
+        closest_entity = entity_index;
+        R2 = r2;
+      }
+    }
 
-  // Point not found
-  return not_found;
+    // Check children inside radius, closest child first
+    else
+    {
+      const double r2_0 = compute_squared_distance_bbox(x, bbox.child_0);
+      const double r2_1 = compute_squared_distance_bbox(x, bbox.child_1);
+      if (r2_0 <= r2_1)
+      {
+        if (r2_1 <= R2)
+          stack.push_back(std::make_pair(bbox.child_1, r2_1));
+        if (r2_0 <= R2)
+          stack.push_back(std::make_pair(bbox.child_0, r2_0));
+      }
+      else
+      {
+        if (r2_0 <= R2)
+          stack.push_back(std::make_pair(bbox.child_0, r2_0));
+        if (r2_1 <= R2)
+          stack.push_back(std::make_pair(bbox.child_1, r2_1));
+      }
+    }
+  }
 }
 //-----------------------------------------------------------------------------
 void
-GenericBoundingBoxTree::compute_closest_entity(const Point& point,
-                                               unsigned int node,
-                                               const Mesh& mesh,
-                                               unsigned int& closest_entity,
-                                               double& R2) const
+GenericBoundingBoxTree::compute_closest_point(const Point& point,
+                                              unsigned int& closest_point,
+                                              double& R2,
+                                              NodeStack& stack) const
 {
-  // Get bounding box for current node
-  const BBox& bbox = _bboxes[node];
-
-  // If bounding box is outside radius, then don't search further
-  const double r2 = compute_squared_distance_bbox(point.coordinates(), node);
-  if (r2 > R2)
+  if (_bboxes.empty())
     return;
+  const double* x = point.coordinates();
+
+  // Start at root (added last)
+  const unsigned int root = _bboxes.size() - 1;
+  stack.clear();
+  stack.push_back(std::make_pair(root, compute_squared_distance_bbox(x, root)));
 
-  // If box is leaf (which we know is inside radius), then shrink radius
-  else if (is_leaf(bbox, node))
+  while (!stack.empty())
   {
-    // Get entity (child_1 denotes entity index for leaves)
-    dolfin_assert(_tdim == mesh.topology().dim());
-    const unsigned int entity_index = bbox.child_1;
-    Cell cell(mesh, entity_index);
+    const unsigned int node = stack.back().first;
+    const double r2 = stack.back().second;
+    stack.pop_back();
+
+    // If bounding box is outside radius, then don't search further
+    if (r2 > R2)
+      continue;
+
+    // Get bounding box for current node
+    const BBox& bbox = _bboxes[node];
 
-    // If entity is closer than best result so far, then return it
-    const double r2 = cell.squared_distance(point);
-    if (r2 < R2)
+    // If box is leaf, then compute distance and shrink radius
+    if (is_leaf(bbox, node))
     {
-      closest_entity = entity_index;
-      R2 = r2;
+      const double r2 = compute_squared_distance_point(x, node);
+      if (r2 < R2)
+      {
+        closest_point = bbox.child_1;
+        R2 = r2;
+      }
+    }
+
+    // Check children inside radius, closest child first
+    else
+    {
+      const double r2_0 = compute_squared_distance_bbox(x, bbox.child_0);
+      const double r2_1 = compute_squared_distance_bbox(x, bbox.child_1);
+      if (r2_0 <= r2_1)
+      {
+        if (r2_1 <= R2)
+          stack.push_back(std::make_pair(bbox.child_1, r2_1));
+        if (r2_0 <= R2)
+          stack.push_back(std::make_pair(bbox.child_0, r2_0));
+      }
+      else
+      {
+        if (r2_0 <= R2)
+          stack.push_back(std::make_pair(bbox.child_0, r2_0));
+        if (r2_1 <= R2)
+          stack.push_back(std::make_pair(bbox.child_1, r2_1));
+      }
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+void
+GenericBoundingBoxTree::compute_collisions(const std::vector<double>& points,
+                                           const Mesh* mesh,
+                                           std::vector<unsigned int>& offsets,
+                                           std::vector<unsigned int>& entities) const
+{
+  // Order points for locality of tree traversal
+  const std::size_t _gdim = gdim();
+  const std::size_t num_points = points.size() / _gdim;
+  std::vector<unsigned int> order;
+  sort_points_morton(order, points);
+
+  // Points handled by each thread and their collisions
+  const std::size_t num_threads
+    = std::max((std::size_t) dolfin::parameters["num_threads"], (std::size_t) 1);
+  std::vector<std::vector<unsigned int> > thread_points(num_threads);
+  std::vector<std::vector<unsigned int> > thread_entities(num_threads);
+
+  // Number of collisions for point i is first stored in offsets[i + 1]
+  offsets.assign(num_points + 1, 0);
+
+  #ifdef HAS_OPENMP
+  #pragma omp parallel num_threads(num_threads)
+  #endif
+  {
+    #ifdef HAS_OPENMP
+    const std::size_t thread = omp_get_thread_num();
+    #else
+    const std::size_t thread = 0;
+    #endif
+    std::vector<unsigned int>& _points = thread_points[thread];
+    std::vector<unsigned int>& _entities = thread_entities[thread];
+    std::vector<unsigned int> stack;
+
+    #ifdef HAS_OPENMP
+    #pragma omp for schedule(guided)
+    #endif
+    for (int i = 0; i < (int) num_points; ++i)
+    {
+      const unsigned int p = order[i];
+      const Point point(_gdim, points.data() + _gdim*p);
+      const std::size_t n = _entities.size();
+      compute_collisions(point, mesh, _entities, stack);
+      offsets[p + 1] = _entities.size() - n;
+      _points.push_back(p);
     }
   }
 
-  // Check both children
-  else
+  // Compute offsets and copy collisions into place
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  entities.resize(offsets.back());
+
+  #ifdef HAS_OPENMP
+  #pragma omp parallel for num_threads(num_threads)
+  #endif
+  for (int thread = 0; thread < (int) num_threads; ++thread)
   {
-    compute_closest_entity(point, bbox.child_0, mesh, closest_entity, R2);
-    compute_closest_entity(point, bbox.child_1, mesh, closest_entity, R2);
+    std::vector<unsigned int>::const_iterator e = thread_entities[thread].begin();
+    for (std::size_t i = 0; i < thread_points[thread].size(); ++i)
+    {
+      const unsigned int p = thread_points[thread][i];
+      const std::size_t n = offsets[p + 1] - offsets[p];
+      std::copy(e, e + n, entities.begin() + offsets[p]);
+      e += n;
+    }
   }
 }
 //-----------------------------------------------------------------------------
 void
-GenericBoundingBoxTree::compute_closest_point(const Point& point,
-                                              unsigned int node,
-                                              unsigned int& closest_point,
-                                              double& R2) const
+GenericBoundingBoxTree::sort_points_morton(std::vector<unsigned int>& order,
+                                           const std::vector<double>& points) const
 {
-  // Get bounding box for current node
-  const BBox& bbox = _bboxes[node];
+  const std::size_t _gdim = gdim();
+  dolfin_assert(points.size() % _gdim == 0);
+  const std::size_t num_points = points.size() / _gdim;
+  order.resize(num_points);
+  for (std::size_t i = 0; i < num_points; ++i)
+    order[i] = i;
+  if (_bboxes.empty() || num_points < 2)
+    return;
 
-  // If box is leaf, then compute distance and shrink radius
-  if (is_leaf(bbox, node))
+  // Get root bounding box (points outside are moved to its boundary)
+  const double* xmin = _bbox_coordinates.data() + 2*_gdim*(_bboxes.size() - 1);
+  const double* xmax = xmin + _gdim;
+
+  // Number of bits per coordinate such that keys fit in 32 bits
+  const std::size_t num_bits = 30 / _gdim;
+  const double max_cell = static_cast<double>((1u << num_bits) - 1);
+  double scale[MAX_DIM];
+  for (std::size_t j = 0; j < _gdim; ++j)
+    scale[j] = xmax[j] > xmin[j] ? max_cell / (xmax[j] - xmin[j]) : 0.0;
+
+  // Compute keys by interleaving the bits of the (quantized)
+  // coordinates
+  std::vector<std::pair<unsigned int, unsigned int> > keys(num_points);
+  for (std::size_t i = 0; i < num_points; ++i)
   {
-    const double r2 = compute_squared_distance_point(point.coordinates(), node);
-    if (r2 < R2)
+    const double* x = points.data() + _gdim*i;
+    unsigned int key = 0;
+    for (std::size_t j = 0; j < _gdim; ++j)
     {
-      closest_point = bbox.child_1;
-      R2 = r2;
+      const double s = std::min(std::max((x[j] - xmin[j])*scale[j], 0.0), max_cell);
+      const unsigned int c = static_cast<unsigned int>(s);
+      for (std::size_t b = 0; b < num_bits; ++b)
+        key |= ((c >> b) & 1u) << (_gdim*b + j);
     }
+    keys[i] = std::make_pair(key, i);
   }
-  else
-  {
-    // If bounding box is outside radius, then don't search further
-    const double r2 = compute_squared_distance_bbox(point.coordinates(), node);
-    if (r2 > R2)
-      return;
 
-    // Check both children
-    compute_closest_point(point, bbox.child_0, closest_point, R2);
-    compute_closest_point(point, bbox.child_1, closest_point, R2);
-  }
+  // Sort points by key
+  std::sort(keys.begin(), keys.end());
+  for (std::size_t i = 0; i < num_points; ++i)
+    order[i] = keys[i].second;
 }
 //-----------------------------------------------------------------------------
 void GenericBoundingBoxTree::compute_bbox_of_entity(double* b,
@@ -576,23 +1062,3 @@ void GenericBoundingBoxTree::compute_bbox_of_entity(double* b,
   }
 }
 //-----------------------------------------------------------------------------
-void
-GenericBoundingBoxTree::sort_points(std::size_t axis,
-                                    const std::vector<Point>& points,
-                                    const std::vector<unsigned int>::iterator& begin,
-                                    const std::vector<unsigned int>::iterator& middle,
-                                    const std::vector<unsigned int>::iterator& end)
-{
-  switch (axis)
-  {
-  case 0:
-    std::nth_element(begin, middle, end, less_x_point(points));
-    break;
-  case 1:
-    std::nth_element(begin, middle, end, less_y_point(points));
-    break;
-  default:
-    std::nth_element(begin, middle, end, less_z_point(points));
-  }
-}
-//-----------------------------------------------------------------------------
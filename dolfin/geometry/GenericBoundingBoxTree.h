@@ -16,12 +16,15 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2013-04-23
-// Last changed: 2013-05-28
+// Last changed: 2026-10-16
 
 #ifndef __GENERIC_BOUNDING_BOX_TREE_H
 #define __GENERIC_BOUNDING_BOX_TREE_H
 
+#include <algorithm>
+#include <utility>
 #include <vector>
+#include <boost/scoped_ptr.hpp>
 
 namespace dolfin
 {
@@ -49,6 +52,14 @@ namespace dolfin
     /// Build bounding box tree for point cloud
     void build(const std::vector<Point>& points);
 
+    /// Update bounding boxes of tree built for mesh entities after
+    /// the mesh vertices have moved (same topology)
+    void refit(const Mesh& mesh);
+
+    /// Update bounding boxes of tree built for point cloud after the
+    /// points have moved (same number of points)
+    void refit(const std::vector<Point>& points);
+
     /// Compute all collisions between bounding boxes and given _Point_
     std::vector<unsigned int> compute_collisions(const Point& point) const;
 
@@ -70,6 +81,34 @@ namespace dolfin
     /// Compute closest point and distance to given _Point_
     std::pair<unsigned int, double> compute_closest_point(const Point& point) const;
 
+    /// Compute all collisions between bounding boxes and given
+    /// points (flattened coordinates). The collisions of point i are
+    /// entities[offsets[i]:offsets[i + 1]].
+    void compute_collisions(const std::vector<double>& points,
+                            std::vector<unsigned int>& offsets,
+                            std::vector<unsigned int>& entities) const;
+
+    /// Compute all collisions between entities and given points
+    /// (flattened coordinates). The collisions of point i are
+    /// entities[offsets[i]:offsets[i + 1]].
+    void compute_entity_collisions(const std::vector<double>& points,
+                                   const Mesh& mesh,
+                                   std::vector<unsigned int>& offsets,
+                                   std::vector<unsigned int>& entities) const;
+
+    /// Compute first collision between entities and each of given
+    /// points (flattened coordinates)
+    void compute_first_entity_collisions(const std::vector<double>& points,
+                                         const Mesh& mesh,
+                                         std::vector<unsigned int>& entities) const;
+
+    /// Compute closest entity and distance for each of given points
+    /// (flattened coordinates)
+    void compute_closest_entities(const std::vector<double>& points,
+                                  const Mesh& mesh,
+                                  std::vector<unsigned int>& entities,
+                                  std::vector<double>& distances) const;
+
   protected:
 
     // Bounding box data. Leaf nodes are indicated by setting child_0
@@ -96,97 +135,110 @@ namespace dolfin
     // Clear existing data if any
     void clear();
 
-    // Build bounding box tree for entities (recursive)
+    // Build bounding box tree from leaf bounding boxes (in parallel)
+    void build(const std::vector<double>& leaf_bboxes, std::size_t gdim);
+
+    // Subtree to be built for leaves [begin, end), with nodes stored
+    // starting at given node
+    struct Subtree
+    {
+      std::vector<unsigned int>::iterator begin;
+      std::vector<unsigned int>::iterator end;
+      unsigned int node;
+    };
+
+    // Build subtree for leaves [begin, end) (recursive). The nodes of
+    // the subtree are stored (post-order) starting at the given node,
+    // with the root last. If subtrees is nonzero, recursion stops at
+    // subtrees with at most min_leaves leaves, which are added to
+    // subtrees to be built later.
     unsigned int build(const std::vector<double>& leaf_bboxes,
                        const std::vector<unsigned int>::iterator& begin,
                        const std::vector<unsigned int>::iterator& end,
-                       std::size_t gdim);
+                       unsigned int node,
+                       std::size_t gdim,
+                       std::size_t min_leaves,
+                       std::vector<Subtree>* subtrees);
 
-    // Build bounding box tree for points (recursive)
-    unsigned int build(const std::vector<Point>& points,
-                       const std::vector<unsigned int>::iterator& begin,
-                       const std::vector<unsigned int>::iterator& end,
-                       std::size_t gdim);
+    // Update bounding boxes from leaf bounding boxes (in parallel)
+    void refit(const std::vector<double>& leaf_bboxes, std::size_t gdim);
+
+    // Update bounding boxes of nodes [first, last] from children
+    void refit(const std::vector<double>& leaf_bboxes,
+               unsigned int first, unsigned int last, std::size_t gdim);
+
+    // Split nodes [first, root] (a subtree) into subtrees with at most
+    // max_nodes nodes, stored as (first, last), and nodes above these
+    void split_nodes(unsigned int first, unsigned int root,
+                     std::size_t max_nodes,
+                     std::vector<std::pair<unsigned int, unsigned int> >& subtrees,
+                     std::vector<unsigned int>& top_nodes) const;
+
+    // Compute leaf bounding boxes for mesh entities (in parallel)
+    void compute_leaf_bboxes(std::vector<double>& leaf_bboxes,
+                             const Mesh& mesh, std::size_t tdim) const;
+
+    // Compute leaf bounding boxes (points) for cell midpoints
+    void compute_midpoint_bboxes(std::vector<double>& leaf_bboxes,
+                                 const Mesh& mesh) const;
 
     // Compute point search tree if not already done
     void build_point_search_tree(const Mesh& mesh) const;
 
-    /// Compute collisions (recursive)
-    void compute_collisions(const Point& point,
-                            unsigned int node,
-                            std::vector<unsigned int>& entities) const;
+    // Stack of nodes (with squared distances) for tree traversal
+    typedef std::vector<std::pair<unsigned int, double> > NodeStack;
 
-    /// Compute entity collisions (recursive)
-    void compute_entity_collisions(const Point& point,
-                                   unsigned int node,
-                                   std::vector<unsigned int>& entities,
-                                   const Mesh& mesh) const;
+    // Compute collisions with bounding boxes, or with entities if
+    // mesh is given (non-recursive, using stack for traversal)
+    void compute_collisions(const Point& point,
+                            const Mesh* mesh,
+                            std::vector<unsigned int>& entities,
+                            std::vector<unsigned int>& stack) const;
 
-    /// Compute first collision (recursive)
+    // Compute first collision with bounding boxes, or with entities
+    // if mesh is given (non-recursive)
     unsigned int compute_first_collision(const Point& point,
-                                         unsigned int node) const;
-
-    /// Compute first entity collision (recursive)
-    unsigned int compute_first_entity_collision(const Point& point,
-                                                unsigned int node,
-                                                const Mesh& mesh) const;
+                                         const Mesh* mesh,
+                                         std::vector<unsigned int>& stack) const;
 
-    /// Compute closest entity (recursive)
+    // Compute closest entity within distance sqrt(R2) (non-recursive)
     void compute_closest_entity(const Point& point,
-                                unsigned int node,
                                 const Mesh& mesh,
                                 unsigned int& closest_entity,
-                                double& R2) const;
+                                double& R2,
+                                NodeStack& stack) const;
 
-    /// Compute closest point (recursive)
+    // Compute closest point (non-recursive)
     void compute_closest_point(const Point& point,
-                               unsigned int node,
                                unsigned int& closest_point,
-                               double& R2) const;
+                               double& R2,
+                               NodeStack& stack) const;
+
+    // Compute collisions for list of points and store as offsets and
+    // entities (compressed rows)
+    void compute_collisions(const std::vector<double>& points,
+                            const Mesh* mesh,
+                            std::vector<unsigned int>& offsets,
+                            std::vector<unsigned int>& entities) const;
+
+    // Compute order of points along a space-filling (Morton) curve
+    // through the root bounding box
+    void sort_points_morton(std::vector<unsigned int>& order,
+                            const std::vector<double>& points) const;
 
     // Compute bounding box of mesh entity
     void compute_bbox_of_entity(double* b,
                                 const MeshEntity& entity,
                                 std::size_t gdim) const;
 
-    // Sort points along given axis
-    void sort_points(std::size_t axis,
-                     const std::vector<Point>& points,
-                     const std::vector<unsigned int>::iterator& begin,
-                     const std::vector<unsigned int>::iterator& middle,
-                     const std::vector<unsigned int>::iterator& end);
-
-    // Add bounding box and coordinates
-    inline unsigned int add_bbox(const BBox& bbox,
-                                 const double* b,
-                                 std::size_t gdim)
+    // Set bounding box and coordinates of node
+    inline void set_bbox(unsigned int node,
+                         const BBox& bbox,
+                         const double* b,
+                         std::size_t gdim)
     {
-      // Add bounding box
-      _bboxes.push_back(bbox);
-
-      // Add bounding box coordinates
-      for (std::size_t i = 0; i < 2*gdim; ++i)
-        _bbox_coordinates.push_back(b[i]);
-
-      return _bboxes.size() - 1;
-    }
-
-    // Add bounding box and point coordinates
-    inline unsigned int add_point(const BBox& bbox,
-                                  const Point& point,
-                                  std::size_t gdim)
-    {
-      // Add bounding box
-      _bboxes.push_back(bbox);
-
-      // Add point coordinates (twice)
-      const double* x = point.coordinates();
-      for (std::size_t i = 0; i < gdim; ++i)
-        _bbox_coordinates.push_back(x[i]);
-      for (std::size_t i = 0; i < gdim; ++i)
-        _bbox_coordinates.push_back(x[i]);
-
-      return _bboxes.size() - 1;
+      _bboxes[node] = bbox;
+      std::copy(b, b + 2*gdim, _bbox_coordinates.begin() + 2*gdim*node);
     }
 
     // Check whether bounding box is a leaf node
@@ -196,49 +248,6 @@ namespace dolfin
       return bbox.child_0 == node;
     }
 
-    // Comparison operators for sorting of points. The corresponding
-    // comparison operators for bounding boxes are dimension-dependent
-    // and are therefore implemented in the subclasses.
-
-    struct less_x_point
-    {
-      const std::vector<Point>& points;
-      less_x_point(const std::vector<Point>& points): points(points) {}
-
-      inline bool operator()(unsigned int i, unsigned int j)
-      {
-        const double* pi = points[i].coordinates();
-        const double* pj = points[j].coordinates();
-        return pi[0] < pj[0];
-      }
-    };
-
-    struct less_y_point
-    {
-      const std::vector<Point>& points;
-      less_y_point(const std::vector<Point>& points): points(points) {}
-
-      inline bool operator()(unsigned int i, unsigned int j)
-      {
-        const double* pi = points[i].coordinates();
-        const double* pj = points[j].coordinates();
-        return pi[1] < pj[1];
-      }
-    };
-
-    struct less_z_point
-    {
-      const std::vector<Point>& points;
-      less_z_point(const std::vector<Point>& points): points(points) {}
-
-      inline bool operator()(unsigned int i, unsigned int j)
-      {
-        const double* pi = points[i].coordinates();
-        const double* pj = points[j].coordinates();
-        return pi[2] < pj[2];
-      }
-    };
-
     //--- Dimension-dependent functions to be implemented by subclass ---
 
     // Return geometric dimension
@@ -264,14 +273,6 @@ namespace dolfin
                            const std::vector<unsigned int>::iterator& begin,
                            const std::vector<unsigned int>::iterator& end) = 0;
 
-    // Compute bounding box of points
-    virtual void
-    compute_bbox_of_points(double* bbox,
-                           std::size_t& axis,
-                           const std::vector<Point>& points,
-                           const std::vector<unsigned int>::iterator& begin,
-                           const std::vector<unsigned int>::iterator& end) = 0;
-
     // Sort leaf bounding boxes along given axis
     virtual void
     sort_bboxes(std::size_t axis,
@@ -0,0 +1,140 @@
+// Copyright (C) 2026 agent
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+//
+// First added:  2026-10-16
+// Last changed: 2026-10-16
+
+#include <algorithm>
+#include <exception>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+
+#include <dolfin/log/log.h>
+#include "AsyncWriter.h"
+
+using namespace dolfin;
+
+//-----------------------------------------------------------------------------
+AsyncWriter::AsyncWriter(std::size_t max_pending)
+  : _max_pending(std::max(max_pending, (std::size_t) 1)), _running(false),
+    _stop(false)
+{
+  _thread.reset(new boost::thread(boost::bind(&AsyncWriter::run, this)));
+}
+//-----------------------------------------------------------------------------
+AsyncWriter::~AsyncWriter()
+{
+  // Let output thread finish pending jobs and stop
+  {
+    boost::mutex::scoped_lock lock(_mutex);
+    _stop = true;
+  }
+  _job_submitted.notify_all();
+  _thread->join();
+
+  if (!_error.empty())
+    warning("Asynchronous output failed: %s", _error.c_str());
+}
+//-----------------------------------------------------------------------------
+void AsyncWriter::submit(const boost::function<void ()>& job)
+{
+  check_error();
+
+  // Wait for room in queue
+  {
+    boost::mutex::scoped_lock lock(_mutex);
+    while (_jobs.size() + (_running ? 1 : 0) >= _max_pending)
+      _job_done.wait(lock);
+    _jobs.push_back(job);
+  }
+  _job_submitted.notify_one();
+}
+//-----------------------------------------------------------------------------
+void AsyncWriter::wait()
+{
+  {
+    boost::mutex::scoped_lock lock(_mutex);
+    while (!_jobs.empty() || _running)
+      _job_done.wait(lock);
+  }
+
+  check_error();
+}
+//-----------------------------------------------------------------------------
+std::size_t AsyncWriter::num_pending() const
+{
+  boost::mutex::scoped_lock lock(_mutex);
+  return _jobs.size() + (_running ? 1 : 0);
+}
+//-----------------------------------------------------------------------------
+void AsyncWriter::run()
+{
+  while (true)
+  {
+    // Get next job
+    boost::function<void ()> job;
+    {
+      boost::mutex::scoped_lock lock(_mutex);
+      while (_jobs.empty() && !_stop)
+        _job_submitted.wait(lock);
+      if (_jobs.empty())
+        return;
+      job = _jobs.front();
+      _jobs.pop_front();
+      _running = true;
+    }
+
+    // Execute job. Later jobs are executed even if the job fails,
+    // since jobs may take part in collective (MPI) operations which
+    // would otherwise hang on the other processes.
+    std::string error;
+    try
+    {
+      job();
+    }
+    catch (std::exception& e)
+    {
+      error = e.what();
+    }
+
+    // Keep first error until reported
+    {
+      boost::mutex::scoped_lock lock(_mutex);
+      if (_error.empty())
+        _error = error;
+      _running = false;
+    }
+    _job_done.notify_all();
+  }
+}
+//-----------------------------------------------------------------------------
+void AsyncWriter::check_error()
+{
+  std::string error;
+  {
+    boost::mutex::scoped_lock lock(_mutex);
+    error.swap(_error);
+  }
+
+  if (!error.empty())
+  {
+    dolfin_error("AsyncWriter.cpp",
+                 "write output asynchronously",
+                 "%s", error.c_str());
+  }
+}
+//-----------------------------------------------------------------------------
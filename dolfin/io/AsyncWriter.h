@@ -0,0 +1,105 @@
+// Copyright (C) 2026 agent
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+//
+// First added:  2026-10-16
+// Last changed: 2026-10-16
+
+#ifndef __DOLFIN_ASYNC_WRITER_H
+#define __DOLFIN_ASYNC_WRITER_H
+
+#include <deque>
+#include <string>
+#include <boost/function.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+
+namespace boost
+{
+  class thread;
+}
+
+namespace dolfin
+{
+
+  /// This class runs output jobs (e.g. writing of data to file) in
+  /// order on a dedicated thread, so that output may overlap with
+  /// computation. The number of pending jobs is bounded: submitting
+  /// a job blocks until fewer than the maximum number of jobs are
+  /// pending, which bounds the memory held by the data of the jobs.
+  ///
+  /// Errors raised by a job are reported to the calling thread on the
+  /// next call to submit() or wait(). Jobs submitted after a failed
+  /// job are still executed, since jobs may take part in collective
+  /// (MPI) operations. If several jobs fail, the first error is
+  /// reported.
+
+  class AsyncWriter
+  {
+  public:
+
+    /// Create writer with given maximum number of pending jobs
+    explicit AsyncWriter(std::size_t max_pending=2);
+
+    /// Destructor (waits for pending jobs)
+    ~AsyncWriter();
+
+    /// Submit job for execution on the output thread
+    void submit(const boost::function<void ()>& job);
+
+    /// Wait until all submitted jobs have been executed
+    void wait();
+
+    /// Return number of pending (queued or running) jobs
+    std::size_t num_pending() const;
+
+  private:
+
+    // Execute jobs until stopped (run by output thread)
+    void run();
+
+    // Report error from job, if any
+    void check_error();
+
+    // Maximum number of pending jobs
+    const std::size_t _max_pending;
+
+    // Queued jobs
+    std::deque<boost::function<void ()> > _jobs;
+
+    // True while a job is running
+    bool _running;
+
+    // True when the output thread should stop
+    bool _stop;
+
+    // Error message from first failed job (since last reported)
+    std::string _error;
+
+    // Synchronization
+    mutable boost::mutex _mutex;
+    boost::condition_variable _job_submitted;
+    boost::condition_variable _job_done;
+
+    // Output thread
+    boost::scoped_ptr<boost::thread> _thread;
+
+  };
+
+}
+
+#endif
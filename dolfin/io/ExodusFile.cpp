@@ -262,7 +262,7 @@ void ExodusFile::write_function(const Function& u, double time) const
     std::vector<int> dof_set;
     for (CellIterator cell(mesh); !cell.end(); ++cell)
     {
-      const std::vector<int>& dofs = dofmap.cell_dofs(cell->index());
+      const ArrayView<const dolfin::la_index> dofs = dofmap.cell_dofs(cell->index());
       for(std::size_t i = 0; i < dofmap.cell_dimension(cell->index()); ++i)
         dof_set.push_back(dofs[i]);
     }
@@ -16,9 +16,10 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // Modified by Garth N. Wells, 2012
+// Modified by agent, 2026
 //
 // First added:  2012-06-01
-// Last changed: 2013-05-20
+// Last changed: 2026-10-16
 
 #ifdef HAS_HDF5
 
@@ -32,11 +33,15 @@
 #include <boost/multi_array.hpp>
 #include <boost/unordered_map.hpp>
 
+#include <dolfin/common/ArrayView.h>
 #include <dolfin/common/constants.h>
 #include <dolfin/common/MPI.h>
 #include <dolfin/common/NoDeleter.h>
 #include <dolfin/common/Timer.h>
+#include <dolfin/fem/FiniteElement.h>
+#include <dolfin/fem/GenericDofMap.h>
 #include <dolfin/function/Function.h>
+#include <dolfin/function/FunctionSpace.h>
 #include <dolfin/la/GenericVector.h>
 #include <dolfin/log/log.h>
 #include <dolfin/mesh/Cell.h>
@@ -48,6 +53,7 @@
 #include <dolfin/mesh/MeshFunction.h>
 #include <dolfin/mesh/MeshValueCollection.h>
 #include <dolfin/mesh/Vertex.h>
+#include <dolfin/parameter/GlobalParameters.h>
 #include "HDF5Interface.h"
 #include "HDF5Utility.h"
 #include "HDF5File.h"
@@ -60,11 +66,25 @@ HDF5File::HDF5File(const std::string filename, const std::string file_mode,
   : hdf5_file_open(false), hdf5_file_id(0),
     mpi_io(MPI::num_processes() > 1 && use_mpiio ? true : false)
 {
-  // HDF5 chunking
+  // HDF5 chunking, with given number of rows per chunk (0 =
+  // automatic)
   parameters.add("chunking", false);
+  parameters.add("chunk_size", 0);
+
+  // Compression (deflate level 0-9) and shuffle filter of written
+  // datasets (imply chunking, not supported with MPI-IO)
+  parameters.add("compression", 0);
+  parameters.add("shuffle", false);
+
+  // Read collectively (with MPI-IO) instead of independently
+  parameters.add("collective_read", true);
 
   // Open HDF5 file
-  hdf5_file_id = HDF5Interface::open_file(filename, file_mode, mpi_io);
+  const int alignment = dolfin::parameters["hdf5_alignment"];
+  const int metadata_cache_size = dolfin::parameters["hdf5_metadata_cache_size"];
+  hdf5_file_id = HDF5Interface::open_file(filename, file_mode, mpi_io,
+                                          std::max(alignment, 0),
+                                          std::max(metadata_cache_size, 0));
   hdf5_file_open = true;
 }
 //-----------------------------------------------------------------------------
@@ -92,10 +112,8 @@ void HDF5File::write(const GenericVector& x, const std::string dataset_name)
 
   // Write data to file
   std::pair<std::size_t, std::size_t> local_range = x.local_range();
-  const bool chunking = parameters["chunking"];
   const std::vector<std::size_t> global_size(1, x.size());
-  HDF5Interface::write_dataset(hdf5_file_id, dataset_name, local_data,
-                               local_range, global_size, mpi_io, chunking);
+  write_data(dataset_name, local_data, local_range, global_size);
 
   // Add partitioning attribute to dataset
   std::vector<std::size_t> partitions;
@@ -349,8 +367,7 @@ void HDF5File::read_mesh_function(MeshFunction<T>& meshfunction,
   // Read a block of cells
   std::vector<std::size_t> topology_data;
   topology_data.reserve(num_read_cells*vert_per_cell);
-  HDF5Interface::read_dataset(hdf5_file_id, topology_name, cell_range,
-                              topology_data);
+  read_data(topology_name, cell_range, topology_data);
 
   boost::multi_array_ref<std::size_t, 2>
     topology_array(topology_data.data(),
@@ -358,8 +375,7 @@ void HDF5File::read_mesh_function(MeshFunction<T>& meshfunction,
 
   std::vector<T> value_data;
   value_data.reserve(num_read_cells);
-  HDF5Interface::read_dataset(hdf5_file_id, values_name, cell_range,
-                              value_data);
+  read_data(values_name, cell_range, value_data);
 
 
   // Now send the read data to each process on the basis of the first
@@ -711,14 +727,13 @@ void HDF5File::read_mesh_value_collection(MeshValueCollection<T>& mesh_vc,
 
     std::vector<T> values_data;
     values_data.reserve(local_size);
-    HDF5Interface::read_dataset(hdf5_file_id, values_name, range, values_data);
+    read_data(values_name, range, values_data);
     std::vector<std::size_t> entities_data;
     entities_data.reserve(local_size);
-    HDF5Interface::read_dataset(hdf5_file_id, entities_name, range,
-                                entities_data);
+    read_data(entities_name, range, entities_data);
     std::vector<std::size_t> cells_data;
     cells_data.reserve(local_size);
-    HDF5Interface::read_dataset(hdf5_file_id, cells_name, range, cells_data);
+    read_data(cells_name, range, cells_data);
 
     // Get global mapping to restore values
     const Mesh& mesh = *mesh_vc.mesh();
@@ -756,16 +771,13 @@ void HDF5File::read_mesh_value_collection(MeshValueCollection<T>& mesh_vc,
     // Read local range of values, entities and cells
     std::vector<T> values_data;
     values_data.reserve(local_size);
-    HDF5Interface::read_dataset(hdf5_file_id, values_name, data_range,
-                                values_data);
+    read_data(values_name, data_range, values_data);
     std::vector<std::size_t> entities_data;
     entities_data.reserve(local_size);
-    HDF5Interface::read_dataset(hdf5_file_id, entities_name, data_range,
-                                entities_data);
+    read_data(entities_name, data_range, entities_data);
     std::vector<std::size_t> cells_data;
     cells_data.reserve(local_size);
-    HDF5Interface::read_dataset(hdf5_file_id, cells_name, data_range,
-                                cells_data);
+    read_data(cells_name, data_range, cells_data);
 
     // Send entities and values to correct global cells
     const std::size_t n_global_cells = mesh.size_global(mesh.topology().dim());
@@ -931,12 +943,362 @@ void HDF5File::read(GenericVector& x, const std::string dataset_name,
 
   // Read data from file
   std::vector<double> data;
-  HDF5Interface::read_dataset(hdf5_file_id, dataset_name, local_range, data);
+  read_data(dataset_name, local_range, data);
 
   // Set data
   x.set_local(data);
 }
 //-----------------------------------------------------------------------------
+void HDF5File::write(const Function& u, const std::string name)
+{
+  Timer t0("HDF5: write Function");
+
+  dolfin_assert(hdf5_file_open);
+  dolfin_assert(u.function_space());
+  dolfin_assert(u.function_space()->mesh());
+  dolfin_assert(u.function_space()->dofmap());
+  dolfin_assert(u.function_space()->element());
+  const Mesh& mesh = *u.function_space()->mesh();
+  const GenericDofMap& dofmap = *u.function_space()->dofmap();
+  const std::size_t tdim = mesh.topology().dim();
+
+  // Get number of dofs of local cells
+  std::size_t num_local_cell_dofs = 0;
+  for (CellIterator cell(mesh); !cell.end(); ++cell)
+    num_local_cell_dofs += dofmap.cell_dofs(cell->index()).size();
+  const std::size_t dof_offset = MPI::global_offset(num_local_cell_dofs, true);
+
+  // Get cells (as global vertex indices, which identify the cells
+  // independently of the partitioning) and their global dofs
+  std::vector<std::size_t> cells, x_cell_dofs, cell_dofs;
+  cells.reserve(mesh.num_cells()*(tdim + 1));
+  x_cell_dofs.reserve(mesh.num_cells());
+  cell_dofs.reserve(num_local_cell_dofs);
+  for (CellIterator cell(mesh); !cell.end(); ++cell)
+  {
+    for (VertexIterator v(*cell); !v.end(); ++v)
+      cells.push_back(v->global_index());
+
+    x_cell_dofs.push_back(dof_offset + cell_dofs.size());
+    const ArrayView<const dolfin::la_index> dofs
+      = dofmap.cell_dofs(cell->index());
+    for (std::size_t i = 0; i < dofs.size(); ++i)
+      cell_dofs.push_back(dofs[i]);
+  }
+
+  // Write cells
+  const std::string cells_name = name + "/cells";
+  std::vector<std::size_t> global_size(2);
+  global_size[0] = MPI::sum(mesh.num_cells());
+  global_size[1] = tdim + 1;
+  write_data(cells_name, cells, global_size);
+
+  // Add element signature and partitioning attributes to cells
+  HDF5Interface::add_attribute(hdf5_file_id, cells_name, "signature",
+                               u.function_space()->element()->signature());
+  std::vector<std::size_t> partitions;
+  MPI::gather(MPI::global_offset(mesh.num_cells(), true), partitions);
+  MPI::broadcast(partitions);
+  HDF5Interface::add_attribute(hdf5_file_id, cells_name, "partition",
+                               partitions);
+
+  // Write offsets of cell dofs and cell dofs
+  write_data(name + "/x_cell_dofs", x_cell_dofs,
+             std::vector<std::size_t>(1, global_size[0]));
+  write_data(name + "/cell_dofs", cell_dofs,
+             std::vector<std::size_t>(1, MPI::sum(num_local_cell_dofs)));
+
+  // Write vector
+  dolfin_assert(u.vector());
+  write(*u.vector(), name + "/vector");
+}
+//-----------------------------------------------------------------------------
+void HDF5File::read(Function& u, const std::string name)
+{
+  Timer t0("HDF5: read Function");
+
+  dolfin_assert(hdf5_file_open);
+
+  // Check that datasets exist
+  const std::string cells_name = name + "/cells";
+  const std::string x_cell_dofs_name = name + "/x_cell_dofs";
+  const std::string cell_dofs_name = name + "/cell_dofs";
+  const std::string vector_name = name + "/vector";
+  const std::string dataset_names[] = {cells_name, x_cell_dofs_name,
+                                       cell_dofs_name, vector_name};
+  for (std::size_t i = 0; i < 4; ++i)
+  {
+    if (!HDF5Interface::has_dataset(hdf5_file_id, dataset_names[i]))
+    {
+      dolfin_error("HDF5File.cpp",
+                   "read function from file",
+                   "Dataset \"%s\" not found", dataset_names[i].c_str());
+    }
+  }
+
+  dolfin_assert(u.function_space());
+  dolfin_assert(u.function_space()->mesh());
+  dolfin_assert(u.function_space()->dofmap());
+  dolfin_assert(u.function_space()->element());
+  dolfin_assert(u.vector());
+  const Mesh& mesh = *u.function_space()->mesh();
+  const GenericDofMap& dofmap = *u.function_space()->dofmap();
+  GenericVector& x = *u.vector();
+  const std::size_t tdim = mesh.topology().dim();
+  const std::size_t num_processes = MPI::num_processes();
+
+  // Check that element and mesh match data in file
+  std::string signature;
+  HDF5Interface::get_attribute(hdf5_file_id, cells_name, "signature",
+                               signature);
+  if (signature != u.function_space()->element()->signature())
+  {
+    dolfin_error("HDF5File.cpp",
+                 "read function from file",
+                 "Element of Function does not match element in file");
+  }
+  const std::vector<std::size_t> cells_size
+    = HDF5Interface::get_dataset_size(hdf5_file_id, cells_name);
+  const std::size_t num_global_cells = cells_size[0];
+  const std::size_t num_vertices_per_cell = cells_size[1];
+  if (num_global_cells != mesh.size_global(tdim)
+      || num_vertices_per_cell != tdim + 1)
+  {
+    dolfin_error("HDF5File.cpp",
+                 "read function from file",
+                 "Mesh of Function does not match mesh in file");
+  }
+  const std::size_t vector_size
+    = HDF5Interface::get_dataset_size(hdf5_file_id, vector_name)[0];
+  if (vector_size != dofmap.global_dimension() || x.size() != vector_size)
+  {
+    dolfin_error("HDF5File.cpp",
+                 "read function from file",
+                 "Size mis-match between vector in file and Function");
+  }
+  const std::size_t num_file_dofs
+    = HDF5Interface::get_dataset_size(hdf5_file_id, cell_dofs_name)[0];
+
+  // Read block of cells, using the partition from file if the
+  // number of processes matches
+  std::vector<std::size_t> partitions;
+  HDF5Interface::get_attribute(hdf5_file_id, cells_name, "partition",
+                               partitions);
+  std::pair<std::size_t, std::size_t> cell_range;
+  if (partitions.size() == num_processes)
+  {
+    partitions.push_back(num_global_cells);
+    const std::size_t proc = MPI::process_number();
+    cell_range = std::make_pair(partitions[proc], partitions[proc + 1]);
+  }
+  else
+    cell_range = MPI::local_range(num_global_cells);
+  const std::size_t num_read_cells = cell_range.second - cell_range.first;
+
+  std::vector<std::size_t> file_cells;
+  read_data(cells_name, cell_range, file_cells);
+
+  // Read offsets of cell dofs (including offset of next block) and
+  // cell dofs
+  std::vector<std::size_t> x_cell_dofs;
+  const std::pair<std::size_t, std::size_t>
+    x_range(cell_range.first, std::min(cell_range.second + 1,
+                                       num_global_cells));
+  read_data(x_cell_dofs_name, x_range, x_cell_dofs);
+  if (cell_range.second == num_global_cells)
+    x_cell_dofs.push_back(num_file_dofs);
+  dolfin_assert(x_cell_dofs.size() == num_read_cells + 1);
+
+  std::vector<std::size_t> file_cell_dofs;
+  const std::pair<std::size_t, std::size_t>
+    dof_range(x_cell_dofs.front(), x_cell_dofs.back());
+  read_data(cell_dofs_name, dof_range, file_cell_dofs);
+
+  // Check whether local cells and their dofs are the ones read from
+  // file (same partitioning and dof map), in which case the values
+  // can be read directly
+  bool same_dofs = (num_read_cells == mesh.num_cells());
+  for (CellIterator cell(mesh); !cell.end() && same_dofs; ++cell)
+  {
+    const std::size_t i = cell->index();
+    std::size_t j = i*num_vertices_per_cell;
+    for (VertexIterator v(*cell); !v.end(); ++v, ++j)
+      same_dofs = same_dofs && (v->global_index() == file_cells[j]);
+
+    const ArrayView<const dolfin::la_index> dofs = dofmap.cell_dofs(i);
+    const std::size_t offset = x_cell_dofs[i] - x_cell_dofs[0];
+    same_dofs = same_dofs && (dofs.size() == x_cell_dofs[i + 1] - x_cell_dofs[i]);
+    for (std::size_t k = 0; k < dofs.size() && same_dofs; ++k)
+      same_dofs = (std::size_t) dofs[k] == file_cell_dofs[offset + k];
+  }
+
+  const std::pair<std::size_t, std::size_t> local_range = x.local_range();
+  if (MPI::min((std::size_t) (same_dofs ? 1 : 0)) == 1)
+  {
+    std::vector<double> values;
+    read_data(vector_name, local_range, values);
+    x.set_local(values);
+    x.apply("insert");
+    return;
+  }
+
+  // Otherwise, match cells by their (sorted) global vertex indices:
+  // send the cells read from file with their dofs to the process
+  // owning the lowest vertex of the cell, and the local cells to
+  // the same process, which then returns the dofs in file for each
+  // local cell
+  const std::size_t num_global_vertices = mesh.size_global(0);
+  const std::size_t num_cell_dofs = dofmap.max_cell_dimension();
+
+  std::vector<std::vector<std::size_t> > send_cells(num_processes);
+  std::vector<std::vector<std::size_t> > receive_cells(num_processes);
+  std::vector<std::vector<std::size_t> > send_dofs(num_processes);
+  std::vector<std::vector<std::size_t> > receive_dofs(num_processes);
+  for (std::size_t i = 0; i < num_read_cells; ++i)
+  {
+    if (x_cell_dofs[i + 1] - x_cell_dofs[i] != num_cell_dofs)
+    {
+      dolfin_error("HDF5File.cpp",
+                   "read function from file",
+                   "Number of cell dofs does not match dof map");
+    }
+
+    std::vector<std::size_t>::iterator c
+      = file_cells.begin() + i*num_vertices_per_cell;
+    std::sort(c, c + num_vertices_per_cell);
+    const std::size_t dest = MPI::index_owner(*c, num_global_vertices);
+    send_cells[dest].insert(send_cells[dest].end(),
+                            c, c + num_vertices_per_cell);
+    std::vector<std::size_t>::const_iterator d = file_cell_dofs.begin()
+      + (x_cell_dofs[i] - x_cell_dofs[0]);
+    send_dofs[dest].insert(send_dofs[dest].end(), d, d + num_cell_dofs);
+  }
+  MPI::all_to_all(send_cells, receive_cells);
+  MPI::all_to_all(send_dofs, receive_dofs);
+
+  std::vector<std::vector<std::size_t> > send_requests(num_processes);
+  std::vector<std::vector<std::size_t> > receive_requests(num_processes);
+  std::vector<std::vector<std::size_t> > request_cells(num_processes);
+  std::vector<std::size_t> cell_vertices(num_vertices_per_cell);
+  for (CellIterator cell(mesh); !cell.end(); ++cell)
+  {
+    std::size_t j = 0;
+    for (VertexIterator v(*cell); !v.end(); ++v)
+      cell_vertices[j++] = v->global_index();
+    std::sort(cell_vertices.begin(), cell_vertices.end());
+    const std::size_t dest = MPI::index_owner(cell_vertices.front(),
+                                              num_global_vertices);
+    send_requests[dest].insert(send_requests[dest].end(),
+                               cell_vertices.begin(), cell_vertices.end());
+    request_cells[dest].push_back(cell->index());
+  }
+  MPI::all_to_all(send_requests, receive_requests);
+
+  // Map from cell to position of its dofs (in receive_dofs)
+  typedef boost::unordered_map<std::vector<std::size_t>,
+    std::pair<std::size_t, std::size_t> > VectorKeyMap;
+  VectorKeyMap cell_to_dofs;
+  for (std::size_t p = 0; p < num_processes; ++p)
+  {
+    dolfin_assert(receive_cells[p].size()/num_vertices_per_cell*num_cell_dofs
+                  == receive_dofs[p].size());
+    std::vector<std::size_t>::const_iterator c = receive_cells[p].begin();
+    for (std::size_t i = 0; c != receive_cells[p].end();
+         ++i, c += num_vertices_per_cell)
+    {
+      const std::vector<std::size_t> key(c, c + num_vertices_per_cell);
+      cell_to_dofs[key] = std::make_pair(p, i*num_cell_dofs);
+    }
+  }
+
+  // Return dofs in file of requested cells
+  send_dofs = std::vector<std::vector<std::size_t> >(num_processes);
+  for (std::size_t p = 0; p < num_processes; ++p)
+  {
+    std::vector<std::size_t>::const_iterator c = receive_requests[p].begin();
+    for (; c != receive_requests[p].end(); c += num_vertices_per_cell)
+    {
+      const std::vector<std::size_t> key(c, c + num_vertices_per_cell);
+      const VectorKeyMap::const_iterator it = cell_to_dofs.find(key);
+      if (it == cell_to_dofs.end())
+      {
+        dolfin_error("HDF5File.cpp",
+                     "read function from file",
+                     "Cell of mesh not found in file");
+      }
+      std::vector<std::size_t>::const_iterator d
+        = receive_dofs[it->second.first].begin() + it->second.second;
+      send_dofs[p].insert(send_dofs[p].end(), d, d + num_cell_dofs);
+    }
+  }
+  MPI::all_to_all(send_dofs, receive_dofs);
+
+  // Get dof in file of each locally owned dof
+  const std::size_t num_owned_dofs = local_range.second - local_range.first;
+  std::vector<std::size_t> file_dofs(num_owned_dofs, num_file_dofs);
+  for (std::size_t p = 0; p < num_processes; ++p)
+  {
+    dolfin_assert(request_cells[p].size()*num_cell_dofs
+                  == receive_dofs[p].size());
+    for (std::size_t i = 0; i < request_cells[p].size(); ++i)
+    {
+      const ArrayView<const dolfin::la_index> dofs
+        = dofmap.cell_dofs(request_cells[p][i]);
+      dolfin_assert(dofs.size() == num_cell_dofs);
+      for (std::size_t k = 0; k < num_cell_dofs; ++k)
+      {
+        const std::size_t dof = dofs[k];
+        if (dof >= local_range.first && dof < local_range.second)
+          file_dofs[dof - local_range.first] = receive_dofs[p][i*num_cell_dofs + k];
+      }
+    }
+  }
+
+  // Read block of vector and get values of owned dofs from the
+  // processes which read them
+  const std::pair<std::size_t, std::size_t> vector_range
+    = MPI::local_range(vector_size);
+  std::vector<double> file_values;
+  read_data(vector_name, vector_range, file_values);
+
+  std::vector<std::vector<std::size_t> > send_indices(num_processes);
+  std::vector<std::vector<std::size_t> > receive_indices(num_processes);
+  std::vector<std::vector<std::size_t> > owned_positions(num_processes);
+  for (std::size_t i = 0; i < num_owned_dofs; ++i)
+  {
+    dolfin_assert(file_dofs[i] < vector_size);
+    const std::size_t dest = MPI::index_owner(file_dofs[i], vector_size);
+    send_indices[dest].push_back(file_dofs[i]);
+    owned_positions[dest].push_back(i);
+  }
+  MPI::all_to_all(send_indices, receive_indices);
+
+  std::vector<std::vector<double> > send_values(num_processes);
+  std::vector<std::vector<double> > receive_values(num_processes);
+  for (std::size_t p = 0; p < num_processes; ++p)
+  {
+    send_values[p].reserve(receive_indices[p].size());
+    for (std::size_t i = 0; i < receive_indices[p].size(); ++i)
+    {
+      dolfin_assert(receive_indices[p][i] >= vector_range.first);
+      send_values[p].push_back(file_values[receive_indices[p][i]
+                                           - vector_range.first]);
+    }
+  }
+  MPI::all_to_all(send_values, receive_values);
+
+  std::vector<double> values(num_owned_dofs);
+  for (std::size_t p = 0; p < num_processes; ++p)
+  {
+    dolfin_assert(receive_values[p].size() == owned_positions[p].size());
+    for (std::size_t i = 0; i < owned_positions[p].size(); ++i)
+      values[owned_positions[p][i]] = receive_values[p][i];
+  }
+
+  x.set_local(values);
+  x.apply("insert");
+}
+//-----------------------------------------------------------------------------
 void HDF5File::read(Mesh& input_mesh, const std::string mesh_name)
 {
   dolfin_assert(hdf5_file_open);
@@ -1012,8 +1374,7 @@ void HDF5File::read_mesh_repartition(Mesh& input_mesh,
   // Read a block of cells
   std::vector<std::size_t> topology_data;
   topology_data.reserve(num_local_cells*num_vertices_per_cell);
-  HDF5Interface::read_dataset(hdf5_file_id, topology_name, cell_range,
-                              topology_data);
+  read_data(topology_name, cell_range, topology_data);
 
   mesh_data.global_cell_indices.reserve(num_local_cells);
   for (std::size_t i = 0; i < num_local_cells; i++)
@@ -1040,8 +1401,7 @@ void HDF5File::read_mesh_repartition(Mesh& input_mesh,
   // Read vertex data to temporary vector
   std::vector<double> coordinates_data;
   coordinates_data.reserve(num_local_vertices*mesh_data.gdim);
-  HDF5Interface::read_dataset(hdf5_file_id, coordinates_name, vertex_range,
-                              coordinates_data);
+  read_data(coordinates_name, vertex_range, coordinates_data);
 
   // Copy to boost::multi_array
   mesh_data.vertex_coordinates.resize(boost::extents[num_local_vertices][mesh_data.gdim]);
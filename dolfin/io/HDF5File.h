@@ -16,15 +16,17 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // Modified by Garth N. Wells, 2012
+// Modified by agent, 2026
 //
 // First added:  2012-05-22
-// Last changed: 2013-05-14
+// Last changed: 2026-10-16
 
 #ifndef __DOLFIN_HDF5FILE_H
 #define __DOLFIN_HDF5FILE_H
 
 #ifdef HAS_HDF5
 
+#include <algorithm>
 #include <string>
 #include <utility>
 #include <vector>
@@ -48,7 +50,10 @@ namespace dolfin
   public:
 
     /// Constructor. file_mode should "a" (append), "w" (write) ot "r"
-    /// (read).
+    /// (read). Chunking, compression and collective reads are
+    /// controlled by parameters of the file, alignment and metadata
+    /// cache size by the global parameters "hdf5_alignment" and
+    /// "hdf5_metadata_cache_size" (when the file is opened).
     HDF5File(const std::string filename, const std::string file_mode,
              bool use_mpiio = true);
 
@@ -62,6 +67,15 @@ namespace dolfin
     void read(GenericVector& x, const std::string dataset_name,
               const bool use_partition_from_file = true);
 
+    /// Write Function to file, together with its dof map, in a format
+    /// suitable for re-reading (also on a different number of
+    /// processes)
+    void write(const Function& u, const std::string name);
+
+    /// Read Function from file. The mesh of the Function must be the
+    /// mesh the Function was saved on (e.g. read from the same file),
+    /// but may be distributed differently.
+    void read(Function& u, const std::string name);
 
     /// Write Mesh to file in a format suitable for re-reading
     void write(const Mesh& mesh, const std::string name);
@@ -170,6 +184,21 @@ namespace dolfin
                     const std::vector<T>& data,
                     const std::vector<std::size_t> global_size);
 
+    // Write data to HDF5 data set, with given local range (rows),
+    // using the chunking and compression parameters
+    template <typename T>
+    void write_data(const std::string dataset_name,
+                    const std::vector<T>& data,
+                    const std::pair<std::size_t, std::size_t> range,
+                    const std::vector<std::size_t> global_size);
+
+    // Read given range (rows) of HDF5 data set, collectively if
+    // requested by parameters
+    template <typename T>
+    void read_data(const std::string dataset_name,
+                   const std::pair<std::size_t, std::size_t> range,
+                   std::vector<T>& data) const;
+
     // Reorder values into global order (used by XDMFFile when saving
     // vertex data)
     void reorder_values_by_global_indices(const Mesh& mesh,
@@ -204,11 +233,40 @@ namespace dolfin
     const std::size_t offset = MPI::global_offset(num_local_items, true);
     std::pair<std::size_t, std::size_t> range(offset,
                                               offset + num_local_items);
+    dolfin_assert(MPI::sum(num_local_items) == global_size[0]);
 
-    const bool chunking = parameters["chunking"];
     // Write data to HDF5 file
+    write_data(dataset_name, data, range, global_size);
+  }
+  //---------------------------------------------------------------------------
+  template <typename T>
+  void HDF5File::write_data(const std::string dataset_name,
+                            const std::vector<T>& data,
+                            const std::pair<std::size_t, std::size_t> range,
+                            const std::vector<std::size_t> global_size)
+  {
+    dolfin_assert(hdf5_file_open);
+
+    const bool chunking = parameters["chunking"];
+    const int chunk_size = parameters["chunk_size"];
+    const int compression = parameters["compression"];
+    const bool shuffle = parameters["shuffle"];
     HDF5Interface::write_dataset(hdf5_file_id, dataset_name, data,
-                                 range, global_size, mpi_io, chunking);
+                                 range, global_size, mpi_io, chunking,
+                                 std::max(chunk_size, 0), compression,
+                                 shuffle);
+  }
+  //---------------------------------------------------------------------------
+  template <typename T>
+  void HDF5File::read_data(const std::string dataset_name,
+                           const std::pair<std::size_t, std::size_t> range,
+                           std::vector<T>& data) const
+  {
+    dolfin_assert(hdf5_file_open);
+
+    const bool collective_read = parameters["collective_read"];
+    HDF5Interface::read_dataset(hdf5_file_id, dataset_name, range, data,
+                                mpi_io && collective_read);
   }
   //---------------------------------------------------------------------------
 
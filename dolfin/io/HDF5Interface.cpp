@@ -16,10 +16,12 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // Modified by Johannes Ring, 2012
+// Modified by agent, 2026
 //
 // First Added: 2012-09-21
-// Last Changed: 2013-05-13
+// Last Changed: 2026-10-16
 
+#include <algorithm>
 #include <boost/filesystem.hpp>
 
 #include <dolfin/common/MPI.h>
@@ -36,7 +38,9 @@ using namespace dolfin;
 
 //-----------------------------------------------------------------------------
 hid_t HDF5Interface::open_file(const std::string filename, const std::string mode,
-                               const bool use_mpi_io)
+                               const bool use_mpi_io,
+                               const std::size_t alignment,
+                               const std::size_t metadata_cache_size)
 {
   // Set parallel access with communicator
   const hid_t plist_id = H5Pcreate(H5P_FILE_ACCESS);
@@ -54,6 +58,31 @@ hid_t HDF5Interface::open_file(const std::string filename, const std::string mod
     #endif
   }
 
+  // Align objects larger than 64 kB (or the alignment, if smaller),
+  // so that small (metadata) objects do not waste space
+  if (alignment > 0)
+  {
+    const hsize_t threshold = std::min((std::size_t) 65536, alignment);
+    herr_t status = H5Pset_alignment(plist_id, threshold, alignment);
+    dolfin_assert(status != HDF5_FAIL);
+  }
+
+  // Set initial size of metadata cache (growing the limits of the
+  // cache if needed)
+  if (metadata_cache_size > 0)
+  {
+    H5AC_cache_config_t config;
+    config.version = H5AC__CURR_CACHE_CONFIG_VERSION;
+    herr_t status = H5Pget_mdc_config(plist_id, &config);
+    dolfin_assert(status != HDF5_FAIL);
+    config.set_initial_size = true;
+    config.initial_size = metadata_cache_size;
+    config.max_size = std::max(config.max_size, metadata_cache_size);
+    config.min_size = std::min(config.min_size, metadata_cache_size);
+    status = H5Pset_mdc_config(plist_id, &config);
+    dolfin_assert(status != HDF5_FAIL);
+  }
+
   hid_t file_id = HDF5_FAIL;
   if (mode == "w")
   {
@@ -16,13 +16,14 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2012-09-21
-// Last changed:
+// Last changed: 2026-10-16
 
 #ifndef __DOLFIN_HDF5_INTERFACE_H
 #define __DOLFIN_HDF5_INTERFACE_H
 
 #ifdef HAS_HDF5
 
+#include <algorithm>
 #include <vector>
 #include <string>
 #include <hdf5.h>
@@ -43,8 +44,14 @@ namespace dolfin
   public:
 
     /// Open HDF5 and return file descriptor
+    /// alignment: alignment (in bytes) of large objects in file, e.g.
+    /// the stripe size of a parallel file system (0 = HDF5 default)
+    /// metadata_cache_size: initial size (in bytes) of the metadata
+    /// cache (0 = HDF5 default)
     static hid_t open_file(const std::string filename, const std::string mode,
-                           const bool use_mpi_io);
+                           const bool use_mpi_io,
+                           const std::size_t alignment=0,
+                           const std::size_t metadata_cache_size=0);
 
     /// Close HDF5 file
     static void close_file(const hid_t hdf5_file_handle);
@@ -59,23 +66,62 @@ namespace dolfin
     /// global_size: the global multidimensional shape of the array
     /// use_mpio: whether using MPI or not
     /// use_chunking: whether using chunking or not
+    /// chunk_rows: number of rows per chunk (0 = automatic)
+    /// compression_level: deflate level 1-9, or 0 for no compression
+    /// shuffle: whether to apply the shuffle filter (improves
+    /// compression of numerical data)
+    /// Filters imply chunking, and are not supported with MPI-IO.
+    /// The local ranges must together cover the dataset (this is not
+    /// checked here, as it would require communication).
     template <typename T>
     static void write_dataset(const hid_t file_handle,
                               const std::string dataset_name,
                               const std::vector<T>& data,
                               const std::pair<std::size_t, std::size_t> range,
                               const std::vector<std::size_t> global_size,
-                              bool use_mpio, bool use_chunking);
+                              bool use_mpio, bool use_chunking,
+                              std::size_t chunk_rows=0,
+                              int compression_level=0, bool shuffle=false);
 
     /// Read data from a HDF5 dataset "dataset_name"
     /// as defined by range blocks on each process
     /// range: the local range on this processor
     /// data: a flattened 1D array of values
+    /// use_mpio: whether to read collectively (must then be called
+    /// on all processes)
     template <typename T>
     static void read_dataset(const hid_t file_handle,
                              const std::string dataset_name,
                              const std::pair<std::size_t, std::size_t> range,
-                             std::vector<T>& data);
+                             std::vector<T>& data, bool use_mpio=false);
+
+    /// Append one row to a rank 2 dataset with an unlimited number of
+    /// rows, creating the (chunked) dataset if it does not exist
+    /// data: the values of the row on this process
+    /// range: the local range (of columns) on this processor
+    /// row_size: the global number of columns
+    /// use_mpio: whether using MPI or not
+    /// compression_level: deflate level 1-9, or 0 for no compression
+    template <typename T>
+    static void append_row(const hid_t file_handle,
+                           const std::string dataset_name,
+                           const std::vector<T>& data,
+                           const std::pair<std::size_t, std::size_t> range,
+                           const std::size_t row_size,
+                           bool use_mpio, int compression_level);
+
+    /// Read a block of rows from a rank 2 dataset
+    /// rows: the range of rows to read
+    /// range: the local range (of columns) on this processor
+    /// data: the values, row by row
+    /// use_mpio: whether to read collectively (must then be called
+    /// on all processes, also those with an empty range)
+    template <typename T>
+    static void read_rows(const hid_t file_handle,
+                          const std::string dataset_name,
+                          const std::pair<std::size_t, std::size_t> rows,
+                          const std::pair<std::size_t, std::size_t> range,
+                          std::vector<T>& data, bool use_mpio=false);
 
     /// Check for existence of group in HDF5 file
     static bool has_group(const hid_t hdf5_file_handle,
@@ -195,7 +241,9 @@ namespace dolfin
                                            const std::vector<T>& data,
                                            const std::pair<std::size_t, std::size_t> range,
                                            const std::vector<std::size_t> global_size,
-                                           bool use_mpi_io, bool use_chunking)
+                                           bool use_mpi_io, bool use_chunking,
+                                           std::size_t chunk_rows,
+                                           int compression_level, bool shuffle)
   {
     // Data rank
     const std::size_t rank = global_size.size();
@@ -222,9 +270,6 @@ namespace dolfin
     // Dataset dimensions
     const std::vector<hsize_t> dimsf(global_size.begin(), global_size.end());
 
-    // Check sizes
-    dolfin_assert(MPI::sum(count[0]) == global_size[0]);
-
     // Generic status report
     herr_t status;
 
@@ -232,23 +277,55 @@ namespace dolfin
     const hid_t filespace0 = H5Screate_simple(rank, dimsf.data(), NULL);
     dolfin_assert(filespace0 != HDF5_FAIL);
 
-    // Set chunking parameters
-    hid_t chunking_properties;
-    if (use_chunking)
+    // Set chunking parameters (filters require chunking, and chunks
+    // cannot be empty)
+    const bool use_filters = compression_level > 0 || shuffle;
+    hid_t chunking_properties = H5P_DEFAULT;
+    if ((use_chunking || use_filters) && dimsf[0] > 0)
     {
-      // Set chunk size and limit to 1kB min/1MB max
-      hsize_t chunk_size = dimsf[0]/2;
-      if (chunk_size > 1048576)
-        chunk_size = 1048576;
-      if (chunk_size < 1024)
-        chunk_size = 1024;
-
-      hsize_t chunk_dims[2] = {chunk_size, dimsf[1]};
+      // Set chunk size (number of rows). By default, use half the
+      // dataset, limited to 1024-1048576 rows.
+      hsize_t chunk_size = chunk_rows;
+      if (chunk_size == 0)
+      {
+        chunk_size = dimsf[0]/2;
+        if (chunk_size > 1048576)
+          chunk_size = 1048576;
+        if (chunk_size < 1024)
+          chunk_size = 1024;
+      }
+
+      // Chunks of a fixed size dataset may not be larger than the
+      // dataset
+      chunk_size = std::min(chunk_size, dimsf[0]);
+
+      std::vector<hsize_t> chunk_dims(dimsf);
+      chunk_dims[0] = chunk_size;
       chunking_properties = H5Pcreate(H5P_DATASET_CREATE);
-      H5Pset_chunk(chunking_properties, rank, chunk_dims);
+      status = H5Pset_chunk(chunking_properties, rank, chunk_dims.data());
+      dolfin_assert(status != HDF5_FAIL);
+
+      // Set filters (not supported with MPI-IO)
+      if (use_filters && use_mpi_io)
+      {
+        warning("HDF5 compression is not supported with MPI-IO. "
+                "Dataset \"%s\" will not be compressed.",
+                dataset_name.c_str());
+      }
+      else
+      {
+        if (shuffle)
+        {
+          status = H5Pset_shuffle(chunking_properties);
+          dolfin_assert(status != HDF5_FAIL);
+        }
+        if (compression_level > 0)
+        {
+          status = H5Pset_deflate(chunking_properties, compression_level);
+          dolfin_assert(status != HDF5_FAIL);
+        }
+      }
     }
-    else
-      chunking_properties = H5P_DEFAULT;
 
     // Check that group exists and recursively create if required
     const std::string group_name(dataset_name, 0, dataset_name.rfind('/'));
@@ -260,6 +337,13 @@ namespace dolfin
                                      chunking_properties, H5P_DEFAULT);
     dolfin_assert(dset_id != HDF5_FAIL);
 
+    // Release dataset creation properties
+    if (chunking_properties != H5P_DEFAULT)
+    {
+      status = H5Pclose(chunking_properties);
+      dolfin_assert(status != HDF5_FAIL);
+    }
+
     // Close global data space
     status = H5Sclose(filespace0);
     dolfin_assert(status != HDF5_FAIL);
@@ -308,7 +392,7 @@ namespace dolfin
   inline void HDF5Interface::read_dataset(const hid_t file_handle,
                                           const std::string dataset_name,
                                           const std::pair<std::size_t, std::size_t> range,
-                                          std::vector<T>& data)
+                                          std::vector<T>& data, bool use_mpio)
   {
     // Open the dataset
     const hid_t dset_id = H5Dopen2(file_handle, dataset_name.c_str(), H5P_DEFAULT);
@@ -355,12 +439,247 @@ namespace dolfin
       data_size *= count[i];
     data.resize(data_size);
 
+    // Set parallel access
+    const hid_t plist_id = H5Pcreate(H5P_DATASET_XFER);
+    if (use_mpio)
+    {
+      status = H5Pset_dxpl_mpio(plist_id, H5FD_MPIO_COLLECTIVE);
+      dolfin_assert(status != HDF5_FAIL);
+    }
+
     // Read data on each process
     const int h5type = hdf5_type<T>();
-    status = H5Dread(dset_id, h5type, memspace, dataspace, H5P_DEFAULT,
+    status = H5Dread(dset_id, h5type, memspace, dataspace, plist_id,
                      data.data());
     dolfin_assert(status != HDF5_FAIL);
 
+    // Release data transfer property list
+    status = H5Pclose(plist_id);
+    dolfin_assert(status != HDF5_FAIL);
+
+    // Close dataspace
+    status = H5Sclose(dataspace);
+    dolfin_assert(status != HDF5_FAIL);
+
+    // Close dataset
+    status = H5Dclose(dset_id);
+    dolfin_assert(status != HDF5_FAIL);
+  }
+  //-----------------------------------------------------------------------------
+  template <typename T>
+  inline void HDF5Interface::append_row(const hid_t file_handle,
+                                        const std::string dataset_name,
+                                        const std::vector<T>& data,
+                                        const std::pair<std::size_t, std::size_t> range,
+                                        const std::size_t row_size,
+                                        bool use_mpi_io, int compression_level)
+  {
+    dolfin_assert(row_size > 0);
+    dolfin_assert(data.size() == range.second - range.first);
+
+    // Get HDF5 data type
+    const hid_t h5type = hdf5_type<T>();
+
+    // Generic status report
+    herr_t status;
+
+    // Create dataset if not present
+    if (!has_dataset(file_handle, dataset_name))
+    {
+      // Create data space with no rows, extendible in the first
+      // dimension
+      const hsize_t dims[2] = {0, row_size};
+      const hsize_t max_dims[2] = {H5S_UNLIMITED, row_size};
+      const hid_t filespace = H5Screate_simple(2, dims, max_dims);
+      dolfin_assert(filespace != HDF5_FAIL);
+
+      // Set chunk size: (at most) 1024 rows and 131072 values
+      // (1MB of doubles), such that large rows are stored one row
+      // per chunk and small rows are grouped
+      const hsize_t max_chunk = 131072;
+      const hsize_t chunk_cols = std::min((hsize_t) row_size, max_chunk);
+      const hsize_t chunk_rows = std::min((hsize_t) 1024, max_chunk/chunk_cols);
+      const hsize_t chunk_dims[2] = {chunk_rows, chunk_cols};
+      const hid_t chunking_properties = H5Pcreate(H5P_DATASET_CREATE);
+      status = H5Pset_chunk(chunking_properties, 2, chunk_dims);
+      dolfin_assert(status != HDF5_FAIL);
+
+      // Set compression (filters are not supported with MPI-IO)
+      if (compression_level > 0 && use_mpi_io)
+      {
+        warning("HDF5 compression is not supported with MPI-IO. "
+                "Dataset \"%s\" will not be compressed.",
+                dataset_name.c_str());
+      }
+      else if (compression_level > 0)
+      {
+        status = H5Pset_deflate(chunking_properties, compression_level);
+        dolfin_assert(status != HDF5_FAIL);
+      }
+
+      // Check that group exists and recursively create if required
+      const std::string group_name(dataset_name, 0, dataset_name.rfind('/'));
+      add_group(file_handle, group_name);
+
+      // Create dataset
+      const hid_t dset_id = H5Dcreate2(file_handle, dataset_name.c_str(),
+                                       h5type, filespace, H5P_DEFAULT,
+                                       chunking_properties, H5P_DEFAULT);
+      dolfin_assert(dset_id != HDF5_FAIL);
+
+      status = H5Dclose(dset_id);
+      dolfin_assert(status != HDF5_FAIL);
+      status = H5Pclose(chunking_properties);
+      dolfin_assert(status != HDF5_FAIL);
+      status = H5Sclose(filespace);
+      dolfin_assert(status != HDF5_FAIL);
+    }
+
+    // Open the dataset
+    const hid_t dset_id = H5Dopen2(file_handle, dataset_name.c_str(),
+                                   H5P_DEFAULT);
+    dolfin_assert(dset_id != HDF5_FAIL);
+
+    // Get current number of rows
+    const hid_t filespace0 = H5Dget_space(dset_id);
+    dolfin_assert(filespace0 != HDF5_FAIL);
+    hsize_t dims[2];
+    const int ndims = H5Sget_simple_extent_dims(filespace0, dims, NULL);
+    dolfin_assert(ndims == 2);
+    if (dims[1] != row_size)
+    {
+      dolfin_error("HDF5Interface.cpp",
+                   "append row to HDF5 dataset",
+                   "Row size (%d) does not match dataset \"%s\" (%d)",
+                   row_size, dataset_name.c_str(), dims[1]);
+    }
+    status = H5Sclose(filespace0);
+    dolfin_assert(status != HDF5_FAIL);
+
+    // Extend dataset by one row (collectively)
+    const hsize_t new_dims[2] = {dims[0] + 1, row_size};
+    status = H5Dset_extent(dset_id, new_dims);
+    dolfin_assert(status != HDF5_FAIL);
+
+    // Select local part of new row. Processes without values select
+    // nothing but still take part in the (collective) write.
+    const hsize_t offset[2] = {dims[0], range.first};
+    const hsize_t count[2] = {1, range.second - range.first};
+    const hsize_t one[2] = {1, 1};
+    const hid_t filespace1 = H5Dget_space(dset_id);
+    dolfin_assert(filespace1 != HDF5_FAIL);
+    const hid_t memspace = H5Screate_simple(2, count[1] > 0 ? count : one,
+                                            NULL);
+    dolfin_assert(memspace != HDF5_FAIL);
+    if (count[1] > 0)
+    {
+      status = H5Sselect_hyperslab(filespace1, H5S_SELECT_SET, offset, NULL,
+                                   count, NULL);
+    }
+    else
+    {
+      status = H5Sselect_none(filespace1);
+      dolfin_assert(status != HDF5_FAIL);
+      status = H5Sselect_none(memspace);
+    }
+    dolfin_assert(status != HDF5_FAIL);
+
+    // Set parallel access
+    const hid_t plist_id = H5Pcreate(H5P_DATASET_XFER);
+    if (use_mpi_io)
+    {
+      status = H5Pset_dxpl_mpio(plist_id, H5FD_MPIO_COLLECTIVE);
+      dolfin_assert(status != HDF5_FAIL);
+    }
+
+    // Write local values into selected hyperslab
+    status = H5Dwrite(dset_id, h5type, memspace, filespace1, plist_id,
+                      data.data());
+    dolfin_assert(status != HDF5_FAIL);
+
+    // Close dataset collectively
+    status = H5Dclose(dset_id);
+    dolfin_assert(status != HDF5_FAIL);
+
+    // Close hyperslab
+    status = H5Sclose(filespace1);
+    dolfin_assert(status != HDF5_FAIL);
+
+    // Close local dataset
+    status = H5Sclose(memspace);
+    dolfin_assert(status != HDF5_FAIL);
+
+    // Release file-access template
+    status = H5Pclose(plist_id);
+    dolfin_assert(status != HDF5_FAIL);
+  }
+  //-----------------------------------------------------------------------------
+  template <typename T>
+  inline void HDF5Interface::read_rows(const hid_t file_handle,
+                                       const std::string dataset_name,
+                                       const std::pair<std::size_t, std::size_t> rows,
+                                       const std::pair<std::size_t, std::size_t> range,
+                                       std::vector<T>& data, bool use_mpio)
+  {
+    // Resize local data to read into
+    const hsize_t count[2] = {rows.second - rows.first,
+                              range.second - range.first};
+    const hsize_t one[2] = {1, 1};
+    data.resize(count[0]*count[1]);
+
+    // Open the dataset
+    const hid_t dset_id = H5Dopen2(file_handle, dataset_name.c_str(),
+                                   H5P_DEFAULT);
+    dolfin_assert(dset_id != HDF5_FAIL);
+
+    // Open dataspace
+    const hid_t dataspace = H5Dget_space(dset_id);
+    dolfin_assert(dataspace != HDF5_FAIL);
+    dolfin_assert(H5Sget_simple_extent_ndims(dataspace) == 2);
+
+    // Select block of rows and columns. Processes without values
+    // select nothing but still take part in the (collective) read.
+    const hsize_t offset[2] = {rows.first, range.first};
+    const hid_t memspace = H5Screate_simple(2, data.empty() ? one : count,
+                                            NULL);
+    dolfin_assert(memspace != HDF5_FAIL);
+    herr_t status;
+    if (!data.empty())
+    {
+      status = H5Sselect_hyperslab(dataspace, H5S_SELECT_SET, offset, NULL,
+                                   count, NULL);
+    }
+    else
+    {
+      status = H5Sselect_none(dataspace);
+      dolfin_assert(status != HDF5_FAIL);
+      status = H5Sselect_none(memspace);
+    }
+    dolfin_assert(status != HDF5_FAIL);
+
+    // Set parallel access
+    const hid_t plist_id = H5Pcreate(H5P_DATASET_XFER);
+    if (use_mpio)
+    {
+      status = H5Pset_dxpl_mpio(plist_id, H5FD_MPIO_COLLECTIVE);
+      dolfin_assert(status != HDF5_FAIL);
+    }
+
+    // Read data on each process
+    T dummy;
+    const hid_t h5type = hdf5_type<T>();
+    status = H5Dread(dset_id, h5type, memspace, dataspace, plist_id,
+                     data.empty() ? &dummy : data.data());
+    dolfin_assert(status != HDF5_FAIL);
+
+    // Release data transfer property list
+    status = H5Pclose(plist_id);
+    dolfin_assert(status != HDF5_FAIL);
+
+    // Close memory dataspace
+    status = H5Sclose(memspace);
+    dolfin_assert(status != HDF5_FAIL);
+
     // Close dataspace
     status = H5Sclose(dataspace);
     dolfin_assert(status != HDF5_FAIL);
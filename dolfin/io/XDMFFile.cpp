@@ -16,17 +16,21 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // Modified by Garth N. Wells, 2012
+// Modified by agent, 2026
 //
 // First added:  2012-05-28
-// Last changed: 2013-05-14
+// Last changed: 2026-10-16
 
 #ifdef HAS_HDF5
 
+#include <exception>
+#include <fstream>
 #include <ostream>
 #include <sstream>
 #include <vector>
 #include <boost/algorithm/string.hpp>
 #include <boost/assign.hpp>
+#include <boost/bind.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/format.hpp>
 #include <boost/lexical_cast.hpp>
@@ -42,6 +46,7 @@
 #include <dolfin/mesh/MeshEntityIterator.h>
 #include <dolfin/mesh/Mesh.h>
 #include <dolfin/mesh/Vertex.h>
+#include "AsyncWriter.h"
 #include "HDF5File.h"
 #include "HDF5Interface.h"
 #include "XDMFFile.h"
@@ -49,7 +54,36 @@
 using namespace dolfin;
 
 //----------------------------------------------------------------------------
-XDMFFile::XDMFFile(const std::string filename) : GenericFile(filename, "XDMF")
+// Values and XML description of a Function at a time step
+class XDMFFile::TimeStep
+{
+public:
+
+  // Values (local part) and layout of HDF5 dataset
+  std::string dataset_name;
+  std::vector<double> values;
+  std::pair<std::size_t, std::size_t> range;
+  std::vector<std::size_t> global_size;
+  bool chunking, shuffle;
+  std::size_t chunk_size;
+  int compression;
+
+  // Data for XML description
+  std::size_t number;
+  double time;
+  bool vertex_data;
+  std::size_t cell_dim, num_global_cells, gdim, num_total_vertices;
+  std::size_t value_rank, padded_value_size;
+  std::string name, mesh_name;
+
+  // Flush files after writing
+  bool flush;
+
+};
+
+//----------------------------------------------------------------------------
+XDMFFile::XDMFFile(const std::string filename) : GenericFile(filename, "XDMF"),
+  xml_tail_position(0)
 {
   // Make name for HDF5 file (used to store data)
   boost::filesystem::path p(filename);
@@ -66,11 +100,21 @@ XDMFFile::XDMFFile(const std::string filename) : GenericFile(filename, "XDMF")
   // Flush datasets to disk at each timestep. Allows inspection of the
   // HDF5 file whilst running, at some performance cost.
   parameters.add("flush_output", false);
+
+  // Write Functions on a separate thread, overlapping output with
+  // computation. At most output_queue_size time steps are held in
+  // memory waiting to be written.
+  parameters.add("asynchronous_output", false);
+  parameters.add("output_queue_size", 2);
 }
 //----------------------------------------------------------------------------
 XDMFFile::~XDMFFile()
 {
-  // Do nothing
+  // Wait for pending output
+  async_writer.reset();
+
+  // Complete XDMF file
+  close_time_series();
 }
 //----------------------------------------------------------------------------
 void XDMFFile::operator<< (const Function& u)
@@ -81,9 +125,10 @@ void XDMFFile::operator<< (const Function& u)
 //----------------------------------------------------------------------------
 void XDMFFile::operator<< (const std::pair<const Function*, double> ut)
 {
-
   if (hdf5_filemode != "w")
   {
+    wait_for_output();
+
     // Create HDF5 file (truncate)
     hdf5_file.reset(new HDF5File(hdf5_filename, "w"));
     hdf5_filemode = "w";
@@ -179,7 +224,7 @@ void XDMFFile::operator<< (const std::pair<const Function*, double> ut)
     for (CellIterator cell(mesh); !cell.end(); ++cell)
     {
       // Tabulate dofs
-      const std::vector<dolfin::la_index>& dofs
+      const ArrayView<const dolfin::la_index> dofs
         = dofmap.cell_dofs(cell->index());
       for (std::size_t i = 0; i < dofmap.cell_dimension(cell->index()); ++i)
         dof_set.push_back(dofs[i]);
@@ -246,6 +291,7 @@ void XDMFFile::operator<< (const std::pair<const Function*, double> ut)
   // Write mesh to HDF5 file
   if (parameters["rewrite_function_mesh"] || counter == 0)
   {
+      wait_for_output();
       current_mesh_name = "/Mesh/" + boost::lexical_cast<std::string>(counter);
       hdf5_file->write(mesh, current_mesh_name);
   }
@@ -266,23 +312,51 @@ void XDMFFile::operator<< (const std::pair<const Function*, double> ut)
     num_total_vertices = global_size[0];
   }
 
-  const std::string dataset_name = "/VisualisationVector/"
+  // Collect data for time step (computing the local range here, as
+  // it requires communication)
+  boost::shared_ptr<TimeStep> step(new TimeStep);
+  step->dataset_name = "/VisualisationVector/"
     + boost::lexical_cast<std::string>(counter);
-
-  hdf5_file->write_data(dataset_name, data_values, global_size);
-
-  // Flush file. Improves chances of recovering data if
-  // interrupted. Also makes file somewhat readable between writes.
-  if (parameters["flush_output"])
-    hdf5_file->flush();
-
-  // Write the XML meta description (see http://www.xdmf.org) on
-  // process zero
-  if (MPI::process_number() == 0)
+  step->values.swap(data_values);
+  const std::size_t num_local_items = step->values.size()/padded_value_size;
+  const std::size_t offset = MPI::global_offset(num_local_items, true);
+  step->range = std::make_pair(offset, offset + num_local_items);
+  dolfin_assert(MPI::sum(num_local_items) == global_size[0]);
+  step->global_size = global_size;
+  step->chunking = hdf5_file->parameters["chunking"];
+  const int chunk_size = hdf5_file->parameters["chunk_size"];
+  step->chunk_size = std::max(chunk_size, 0);
+  step->compression = hdf5_file->parameters["compression"];
+  step->shuffle = hdf5_file->parameters["shuffle"];
+  step->number = counter;
+  step->time = time_step;
+  step->vertex_data = vertex_data;
+  step->cell_dim = cell_dim;
+  step->num_global_cells = num_global_cells;
+  step->gdim = gdim;
+  step->num_total_vertices = num_total_vertices;
+  step->value_rank = value_rank;
+  step->padded_value_size = padded_value_size;
+  step->name = u.name();
+  step->mesh_name = current_mesh_name;
+  step->flush = parameters["flush_output"];
+
+  // Write data, on the output thread if asynchronous output is
+  // requested and supported
+  const bool asynchronous_output = parameters["asynchronous_output"];
+  if (asynchronous_output && asynchronous_output_supported())
+  {
+    if (!async_writer)
+    {
+      const int queue_size = parameters["output_queue_size"];
+      async_writer.reset(new AsyncWriter(std::max(queue_size, 1)));
+    }
+    async_writer->submit(boost::bind(&XDMFFile::write_time_step, this, step));
+  }
+  else
   {
-    output_xml(time_step, vertex_data, cell_dim, num_global_cells, gdim,
-               num_total_vertices, value_rank, padded_value_size,
-               u.name(), dataset_name);
+    wait_for_output();
+    write_time_step(step);
   }
 
   // Increment counter
@@ -291,6 +365,9 @@ void XDMFFile::operator<< (const std::pair<const Function*, double> ut)
 //----------------------------------------------------------------------------
 void XDMFFile::operator>> (Mesh& mesh)
 {
+  wait_for_output();
+  close_time_series();
+
   if (hdf5_filemode != "r")
   {
     hdf5_file.reset(new HDF5File(hdf5_filename, "r"));
@@ -364,6 +441,10 @@ void XDMFFile::operator>> (Mesh& mesh)
 //----------------------------------------------------------------------------
 void XDMFFile::operator<< (const Mesh& mesh)
 {
+  // The XDMF file is replaced, so end any time series
+  wait_for_output();
+  close_time_series();
+
   // Write Mesh to HDF5 file
 
   if (hdf5_filemode != "w")
@@ -451,6 +532,8 @@ void XDMFFile::operator<< (const MeshFunction<double>& meshfunction)
 template<typename T>
 void XDMFFile::write_mesh_function(const MeshFunction<T>& meshfunction)
 {
+  wait_for_output();
+
   if (hdf5_filemode != "w")
   {
     // Create HDF5 file (truncate)
@@ -482,10 +565,10 @@ void XDMFFile::write_mesh_function(const MeshFunction<T>& meshfunction)
   // process zero
   if (MPI::process_number() == 0)
   {
-    output_xml((double)counter, false,
+    output_xml(counter, (double)counter, false,
                cell_dim, mesh.size_global(cell_dim),
                mesh.geometry().dim(), mesh.size_global(0),
-               0, 1, meshfunction.name(), dataset_name);
+               0, 1, meshfunction.name(), current_mesh_name, dataset_name);
   }
 
   counter++;
@@ -521,6 +604,9 @@ void XDMFFile::operator>> (MeshFunction<double>& meshfunction)
 template<typename T>
 void XDMFFile::read_mesh_function(MeshFunction<T>& meshfunction)
 {
+  wait_for_output();
+  close_time_series();
+
   if (hdf5_filemode != "r")
   {
     hdf5_file.reset(new HDF5File(hdf5_filename, "r"));
@@ -700,7 +786,8 @@ void XDMFFile::xml_mesh_geometry(pugi::xml_node& xdmf_geometry,
   xdmf_geom_data.append_child(pugi::node_pcdata).set_value(geometry_reference.c_str());
 }
 //----------------------------------------------------------------------------
-void XDMFFile::output_xml(const double time_step, const bool vertex_data,
+void XDMFFile::output_xml(const std::size_t step, const double time_step,
+                          const bool vertex_data,
                           const std::size_t cell_dim,
                           const std::size_t num_global_cells,
                           const std::size_t gdim,
@@ -708,112 +795,226 @@ void XDMFFile::output_xml(const double time_step, const bool vertex_data,
                           const std::size_t value_rank,
                           const std::size_t padded_value_size,
                           const std::string name,
-                          const std::string dataset_name) const
+                          const std::string mesh_name,
+                          const std::string dataset_name)
 {
-  // Working data structure for formatting XML file
+  // Working data structure for formatting XML
   std::string s;
-  pugi::xml_document xml_doc;
-  pugi::xml_node xdmf_timegrid;
-  pugi::xml_node xdmf_timedata;
 
-  if (counter == 0)
+  if (!xml_stream)
   {
-    // First time step - create document template, adding a mesh and
-    // an empty time-series
-    xml_doc.append_child(pugi::node_doctype).set_value("Xdmf SYSTEM \"Xdmf.dtd\" []");
-    pugi::xml_node xdmf = xml_doc.append_child("Xdmf");
-    xdmf.append_attribute("Version") = "2.0";
-    xdmf.append_attribute("xmlns:xi") = "http://www.w3.org/2001/XInclude";
-    pugi::xml_node xdmf_domain = xdmf.append_child("Domain");
-
-    //  /Xdmf/Domain/Grid - actually a TimeSeries, not a spatial grid
-    xdmf_timegrid = xdmf_domain.append_child("Grid");
-    xdmf_timegrid.append_attribute("Name") = "TimeSeries";
-    xdmf_timegrid.append_attribute("GridType") = "Collection";
-    xdmf_timegrid.append_attribute("CollectionType") = "Temporal";
-
-    //  /Xdmf/Domain/Grid/Time
-    pugi::xml_node xdmf_time = xdmf_timegrid.append_child("Time");
-    xdmf_time.append_attribute("TimeType") = "List";
-    xdmf_timedata = xdmf_time.append_child("DataItem");
-    xdmf_timedata.append_attribute("Format") = "XML";
-    xdmf_timedata.append_attribute("Dimensions") = "1";
-    xdmf_timedata.append_child(pugi::node_pcdata);
-  }
-  else
-  {
-    // Subsequent timestep - read in existing XDMF file
-    pugi::xml_parse_result result = xml_doc.load_file(_filename.c_str());
-    if (!result)
+    // First time step - create file and write headers for an empty
+    // time series
+    xml_stream.reset(new std::ofstream(_filename.c_str(),
+                                       std::ios::out | std::ios::trunc));
+    if (!xml_stream->good())
     {
       dolfin_error("XDMFFile.cpp",
                    "write data to XDMF file",
-                   "XML parsing error when reading from existing file");
+                   "Unable to open file \"%s\"", _filename.c_str());
     }
 
-    // Get data node
-    xdmf_timegrid = xml_doc.child("Xdmf").child("Domain").child("Grid");
-    dolfin_assert(xdmf_timegrid);
-
-    // Get time series node
-    xdmf_timedata = xdmf_timegrid.child("Time").child("DataItem");
-    dolfin_assert(xdmf_timedata);
+    //  /Xdmf/Domain/Grid - actually a TimeSeries, not a spatial grid
+    *xml_stream << "<?xml version=\"1.0\"?>\n"
+                << "<!DOCTYPE Xdmf SYSTEM \"Xdmf.dtd\" []>\n"
+                << "<Xdmf Version=\"2.0\" xmlns:xi=\"http://www.w3.org/2001/XInclude\">\n"
+                << "  <Domain>\n"
+                << "    <Grid Name=\"TimeSeries\" GridType=\"Collection\" CollectionType=\"Temporal\">\n";
+    xml_tail_position = xml_stream->tellp();
   }
 
-  //  Add a time step to the TimeSeries List
-  xdmf_timedata.attribute("Dimensions").set_value(static_cast<unsigned int>(counter + 1));
-  s = boost::lexical_cast<std::string>(xdmf_timedata.first_child().value())
-    + " " + boost::str((boost::format("%d") % time_step));
-  xdmf_timedata.first_child().set_value(s.c_str());
+  // Create XML description of mesh topology and geometry, unless the
+  // mesh is the same as for the previous time step
+  if (!mesh_xml || mesh_xml_name != mesh_name)
+  {
+    mesh_xml.reset(new pugi::xml_document);
+
+    // Grid/Topology
+    pugi::xml_node xdmf_topology = mesh_xml->append_child("Topology");
+    xml_mesh_topology(xdmf_topology, cell_dim, num_global_cells,
+                      mesh_name + "/topology");
+
+    // Grid/Geometry
+    pugi::xml_node xdmf_geometry = mesh_xml->append_child("Geometry");
+    xml_mesh_geometry(xdmf_geometry, num_total_vertices, gdim,
+                      mesh_name + "/coordinates");
+
+    mesh_xml_name = mesh_name;
+  }
 
   //   /Xdmf/Domain/Grid/Grid - the actual data for this timestep
-  pugi::xml_node xdmf_grid = xdmf_timegrid.append_child("Grid");
-  s = name + "_" + boost::lexical_cast<std::string>(counter);
+  pugi::xml_document xml_doc;
+  pugi::xml_node xdmf_grid = xml_doc.append_child("Grid");
+  s = name + "_" + boost::lexical_cast<std::string>(step);
   xdmf_grid.append_attribute("Name") = s.c_str();
   xdmf_grid.append_attribute("GridType") = "Uniform";
 
-  // Grid/Topology
-  pugi::xml_node xdmf_topology = xdmf_grid.append_child("Topology");
-  xml_mesh_topology(xdmf_topology, cell_dim, num_global_cells,
-                    current_mesh_name + "/topology");
+  // Grid/Time
+  pugi::xml_node xdmf_time = xdmf_grid.append_child("Time");
+  s = boost::str((boost::format("%d") % time_step));
+  xdmf_time.append_attribute("Value") = s.c_str();
 
-  // Grid/Geometry
-  pugi::xml_node xdmf_geometry = xdmf_grid.append_child("Geometry");
-  xml_mesh_geometry(xdmf_geometry, num_total_vertices, gdim,
-                    current_mesh_name + "/coordinates");
+  // Grid/Topology and Grid/Geometry
+  for (pugi::xml_node node = mesh_xml->first_child(); node;
+       node = node.next_sibling())
+  {
+    xdmf_grid.append_copy(node);
+  }
 
   // Grid/Attribute (Function value data)
   pugi::xml_node xdmf_values = xdmf_grid.append_child("Attribute");
   xdmf_values.append_attribute("Name") = name.c_str();
 
-    if (value_rank == 0)
-      xdmf_values.append_attribute("AttributeType") = "Scalar";
-    else if (value_rank == 1)
-      xdmf_values.append_attribute("AttributeType") = "Vector";
-    else if (value_rank == 2)
-      xdmf_values.append_attribute("AttributeType") = "Tensor";
+  if (value_rank == 0)
+    xdmf_values.append_attribute("AttributeType") = "Scalar";
+  else if (value_rank == 1)
+    xdmf_values.append_attribute("AttributeType") = "Vector";
+  else if (value_rank == 2)
+    xdmf_values.append_attribute("AttributeType") = "Tensor";
 
-    if (vertex_data)
-      xdmf_values.append_attribute("Center") = "Node";
-    else
-      xdmf_values.append_attribute("Center") = "Cell";
+  if (vertex_data)
+    xdmf_values.append_attribute("Center") = "Node";
+  else
+    xdmf_values.append_attribute("Center") = "Cell";
+
+  pugi::xml_node xdmf_data = xdmf_values.append_child("DataItem");
+  xdmf_data.append_attribute("Format") = "HDF";
 
-    pugi::xml_node xdmf_data = xdmf_values.append_child("DataItem");
-    xdmf_data.append_attribute("Format") = "HDF";
+  const std::size_t num_total_entities = vertex_data ? num_total_vertices : num_global_cells;
 
-    const std::size_t num_total_entities = vertex_data ? num_total_vertices : num_global_cells;
+  s = boost::lexical_cast<std::string>(num_total_entities) + " "
+    + boost::lexical_cast<std::string>(padded_value_size);
 
-    s = boost::lexical_cast<std::string>(num_total_entities) + " "
-      + boost::lexical_cast<std::string>(padded_value_size);
+  xdmf_data.append_attribute("Dimensions") = s.c_str();
 
-    xdmf_data.append_attribute("Dimensions") = s.c_str();
+  boost::filesystem::path p(hdf5_filename);
+  s = p.filename().string() + ":" + dataset_name;
+  xdmf_data.append_child(pugi::node_pcdata).set_value(s.c_str());
+
+  // Append time step to XDMF file (overwriting closing tags, if any)
+  xml_stream->seekp(xml_tail_position);
+  xdmf_grid.print(*xml_stream, "  ", pugi::format_default,
+                  pugi::encoding_auto, 3);
+  xml_tail_position = xml_stream->tellp();
+}
+//----------------------------------------------------------------------------
+void XDMFFile::flush()
+{
+  wait_for_output();
+  flush_files();
+}
+//----------------------------------------------------------------------------
+void XDMFFile::write_time_step(boost::shared_ptr<const TimeStep> step)
+{
+  dolfin_assert(step);
+  dolfin_assert(hdf5_file);
 
-    boost::filesystem::path p(hdf5_filename);
-    s = p.filename().string() + ":" + dataset_name;
-    xdmf_data.append_child(pugi::node_pcdata).set_value(s.c_str());
+  // Write values to HDF5 file
+  HDF5Interface::write_dataset(hdf5_file->hdf5_file_id, step->dataset_name,
+                               step->values, step->range, step->global_size,
+                               hdf5_file->mpi_io, step->chunking,
+                               step->chunk_size, step->compression,
+                               step->shuffle);
 
-    // Write XML file
-    xml_doc.save_file(_filename.c_str(), "  ");
+  // Write the XML meta description (see http://www.xdmf.org) on
+  // process zero. Errors are reported after flushing, since flushing
+  // is collective.
+  std::string error;
+  if (MPI::process_number() == 0)
+  {
+    try
+    {
+      output_xml(step->number, step->time, step->vertex_data, step->cell_dim,
+                 step->num_global_cells, step->gdim, step->num_total_vertices,
+                 step->value_rank, step->padded_value_size, step->name,
+                 step->mesh_name, step->dataset_name);
+    }
+    catch (std::exception& e)
+    {
+      error = e.what();
+    }
+  }
+
+  // Flush files. Improves chances of recovering data if
+  // interrupted. Also makes files readable between writes.
+  if (step->flush)
+    flush_files();
+
+  if (!error.empty())
+  {
+    dolfin_error("XDMFFile.cpp",
+                 "write XDMF meta description",
+                 "%s", error.c_str());
+  }
+}
+//----------------------------------------------------------------------------
+void XDMFFile::wait_for_output()
+{
+  if (async_writer)
+    async_writer->wait();
+}
+//----------------------------------------------------------------------------
+bool XDMFFile::asynchronous_output_supported()
+{
+  // The output thread calls HDF5 while the main thread may use HDF5
+  // (e.g. for other files), which requires a thread-safe HDF5 library
+  hbool_t threadsafe = false;
+  #if H5_VERSION_GE(1, 8, 16)
+  H5is_library_threadsafe(&threadsafe);
+  #elif defined(H5_HAVE_THREADSAFE)
+  threadsafe = true;
+  #endif
+  if (!threadsafe)
+  {
+    warning("Asynchronous XDMF output requires a thread-safe HDF5 library, writing synchronously.");
+    return false;
+  }
+
+  // Writing in parallel from the output thread requires that MPI
+  // may be called from multiple threads
+  #ifdef HAS_MPI
+  if (MPI::num_processes() > 1)
+  {
+    int provided = MPI_THREAD_SINGLE;
+    MPI_Query_thread(&provided);
+    if (provided != MPI_THREAD_MULTIPLE)
+    {
+      warning("Asynchronous XDMF output requires MPI_THREAD_MULTIPLE, writing synchronously.");
+      return false;
+    }
   }
+  #endif
+
+  return true;
+}
+//----------------------------------------------------------------------------
+void XDMFFile::flush_files()
+{
+  if (hdf5_file && hdf5_filemode == "w")
+    hdf5_file->flush();
+  finalize_time_series();
+}
+//----------------------------------------------------------------------------
+void XDMFFile::finalize_time_series()
+{
+  if (!xml_stream)
+    return;
+
+  // Write closing tags after the last time step, and return to the
+  // end of the last time step for the next one
+  xml_stream->seekp(xml_tail_position);
+  *xml_stream << "    </Grid>\n"
+              << "  </Domain>\n"
+              << "</Xdmf>\n";
+  xml_stream->flush();
+  xml_stream->seekp(xml_tail_position);
+}
+//----------------------------------------------------------------------------
+void XDMFFile::close_time_series()
+{
+  finalize_time_series();
+  xml_stream.reset();
+  mesh_xml.reset();
+}
 //----------------------------------------------------------------------------
 #endif
@@ -16,18 +16,21 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // Modified by Garth N. Wells, 2012
+// Modified by agent, 2026
 //
 // First added:  2012-05-22
-// Last changed: 2013-05-09
+// Last changed: 2026-10-16
 
 #ifndef __DOLFIN_XDMFFILE_H
 #define __DOLFIN_XDMFFILE_H
 
 #ifdef HAS_HDF5
 
+#include <iosfwd>
 #include <string>
 #include <utility>
 #include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
 
 #include "dolfin/common/Variable.h"
 
@@ -35,6 +38,7 @@
 
 namespace pugi
 {
+  class xml_document;
   class xml_node;
 }
 
@@ -42,6 +46,7 @@ namespace dolfin
 {
 
   // Forward declarations
+  class AsyncWriter;
   class Function;
   class HDF5File;
   class Mesh;
@@ -54,6 +59,22 @@ namespace dolfin
   ///
   /// XDMF is not suitable for checkpointing as it may decimate
   /// some data.
+  ///
+  /// Time series (of Functions and MeshFunctions) are streamed to
+  /// the XDMF file: each time step is appended to the file, and the
+  /// closing XML tags are written when the file is flushed or
+  /// destroyed, so the cost of writing a time step does not depend
+  /// on the number of time steps already written.
+  ///
+  /// If the parameter "asynchronous_output" is set, the values of
+  /// Functions are copied and written to file on a separate thread,
+  /// so that computation may continue while data is written. At most
+  /// "output_queue_size" time steps are held in memory. Writing a
+  /// mesh (e.g. with "rewrite_function_mesh" set) waits for pending
+  /// output. Asynchronous output requires a thread-safe HDF5 library
+  /// (configured with --enable-threadsafe) and, in parallel, an MPI
+  /// library supporting MPI_THREAD_MULTIPLE; otherwise output is
+  /// written synchronously.
 
   class XDMFFile : public GenericFile, public Variable
   {
@@ -90,6 +111,11 @@ namespace dolfin
     void operator>> (MeshFunction<std::size_t>& meshfunction);
     void operator>> (MeshFunction<double>& meshfunction);
 
+    /// Wait for pending output, flush data to disk and complete the
+    /// XDMF file, making it readable while a time series is still
+    /// being written
+    void flush();
+
   private:
 
     // HDF5 data file
@@ -111,7 +137,8 @@ namespace dolfin
 
     // Write XML description for Function and MeshFunction output
     // updating time-series if need be
-    void output_xml(const double time_step, const bool vertex_data,
+    void output_xml(const std::size_t step, const double time_step,
+                    const bool vertex_data,
                     const std::size_t cell_dim,
                     const std::size_t num_global_cells,
                     const std::size_t gdim,
@@ -119,7 +146,31 @@ namespace dolfin
                     const std::size_t value_rank,
                     const std::size_t padded_value_size,
                     const std::string name,
-                    const std::string dataset_name) const;
+                    const std::string mesh_name,
+                    const std::string dataset_name);
+
+    // Values and XML description of a Function at a time step
+    class TimeStep;
+
+    // Write values and XML description of time step (called on the
+    // output thread for asynchronous output)
+    void write_time_step(boost::shared_ptr<const TimeStep> step);
+
+    // Wait until all time steps have been written
+    void wait_for_output();
+
+    // Check whether asynchronous output may be used
+    static bool asynchronous_output_supported();
+
+    // Flush HDF5 file and write closing tags of time series
+    void flush_files();
+
+    // Write closing tags of time series to XDMF file (keeping the
+    // file open for more time steps)
+    void finalize_time_series();
+
+    // Complete and close XDMF file for time series
+    void close_time_series();
 
     // Helper function to add topology reference to XDMF XML file
     void xml_mesh_topology(pugi::xml_node& xdmf_topology,
@@ -135,6 +186,22 @@ namespace dolfin
 
     // Most recent mesh name
     std::string current_mesh_name;
+
+    // XDMF file for time series (open on process zero while time
+    // steps are written)
+    boost::scoped_ptr<std::ofstream> xml_stream;
+
+    // Position of closing tags in XDMF file for time series
+    std::streamoff xml_tail_position;
+
+    // XML description of the topology and geometry of the most recent
+    // mesh (reused while the mesh is not rewritten)
+    boost::scoped_ptr<pugi::xml_document> mesh_xml;
+    std::string mesh_xml_name;
+
+    // Writer for asynchronous output (created on first use)
+    boost::scoped_ptr<AsyncWriter> async_writer;
+
   };
 }
 #endif
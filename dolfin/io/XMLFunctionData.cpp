@@ -192,7 +192,9 @@ void XMLFunctionData::build_global_to_cell_dof(
     {
       const std::size_t local_cell_index = cell->index();
       const std::size_t global_cell_index = cell->global_index();
-      local_dofmap[local_cell_index] = dofmap.cell_dofs(local_cell_index);
+      const ArrayView<const dolfin::la_index> dofs
+        = dofmap.cell_dofs(local_cell_index);
+      local_dofmap[local_cell_index].assign(dofs.begin(), dofs.end());
       local_dofmap[local_cell_index].push_back(global_cell_index);
     }
   }
@@ -202,7 +204,9 @@ void XMLFunctionData::build_global_to_cell_dof(
     for (CellIterator cell(mesh); !cell.end(); ++cell)
     {
       const std::size_t local_cell_index = cell->index();
-      local_dofmap[local_cell_index] = dofmap.cell_dofs(local_cell_index);
+      const ArrayView<const dolfin::la_index> dofs
+        = dofmap.cell_dofs(local_cell_index);
+      local_dofmap[local_cell_index].assign(dofs.begin(), dofs.end());
       local_dofmap[local_cell_index].push_back(local_cell_index);
     }
   }
@@ -255,7 +259,9 @@ void XMLFunctionData::build_dof_map(std::vector<std::vector<dolfin::la_index> >&
     {
       const std::size_t local_cell_index = cell->index();
       const std::size_t global_cell_index = cell->global_index();
-      local_dofmap[local_cell_index] = dofmap.cell_dofs(local_cell_index);
+      const ArrayView<const dolfin::la_index> dofs
+        = dofmap.cell_dofs(local_cell_index);
+      local_dofmap[local_cell_index].assign(dofs.begin(), dofs.end());
       local_dofmap[local_cell_index].push_back(global_cell_index);
     }
   }
@@ -265,7 +271,9 @@ void XMLFunctionData::build_dof_map(std::vector<std::vector<dolfin::la_index> >&
     for (CellIterator cell(mesh); !cell.end(); ++cell)
     {
       const std::size_t local_cell_index = cell->index();
-      local_dofmap[local_cell_index] = dofmap.cell_dofs(local_cell_index);
+      const ArrayView<const dolfin::la_index> dofs
+        = dofmap.cell_dofs(local_cell_index);
+      local_dofmap[local_cell_index].assign(dofs.begin(), dofs.end());
       local_dofmap[local_cell_index].push_back(local_cell_index);
     }
   }
@@ -0,0 +1,606 @@
+// Copyright (C) 2026 agent
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+//
+// First added:  2026-10-16
+// Last changed: 2026-10-16
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+#include <dolfin/common/Timer.h>
+#include <dolfin/log/log.h>
+#include <dolfin/parameter/GlobalParameters.h>
+#include "CSRFactory.h"
+#include "SparsityPattern.h"
+#include "TensorLayout.h"
+#include "uBLASVector.h"
+#include "CSRMatrix.h"
+
+using namespace dolfin;
+
+//-----------------------------------------------------------------------------
+CSRMatrix::CSRMatrix() : _num_rows(0), _num_cols(0), _block_size(1),
+                         _row_offsets(1, 0)
+{
+  // Do nothing
+}
+//-----------------------------------------------------------------------------
+CSRMatrix::~CSRMatrix()
+{
+  // Do nothing
+}
+//-----------------------------------------------------------------------------
+void CSRMatrix::init(const TensorLayout& tensor_layout)
+{
+  Timer timer("Init CSR matrix");
+
+  _num_rows = tensor_layout.size(0);
+  _num_cols = tensor_layout.size(1);
+
+  // Check that matrix is not distributed
+  const std::pair<std::size_t, std::size_t> range = tensor_layout.local_range(0);
+  if (range.first != 0 || range.second != _num_rows)
+  {
+    dolfin_error("CSRMatrix.cpp",
+                 "initialize CSR matrix",
+                 "CSR matrices cannot be distributed (local range [%d, %d] of %d rows)",
+                 range.first, range.second, _num_rows);
+  }
+
+  // Use blocked storage if dimensions are compatible with block size
+  _block_size = tensor_layout.block_size;
+  if (_block_size == 0 || _num_rows % _block_size != 0
+      || _num_cols % _block_size != 0)
+  {
+    _block_size = 1;
+  }
+  const std::size_t bs = _block_size;
+
+  // Get sparsity pattern
+  dolfin_assert(tensor_layout.sparsity_pattern());
+  const SparsityPattern* pattern_pointer
+    = dynamic_cast<const SparsityPattern*>(tensor_layout.sparsity_pattern().get());
+  if (!pattern_pointer)
+  {
+    dolfin_error("CSRMatrix.cpp",
+                 "initialize CSR matrix",
+                 "Cannot convert GenericSparsityPattern to concrete SparsityPattern type");
+  }
+  const std::vector<std::vector<std::size_t> > pattern
+    = pattern_pointer->diagonal_pattern(SparsityPattern::sorted);
+  dolfin_assert(pattern.size() == _num_rows);
+
+  // Build block pattern (union of the patterns of the rows in each
+  // block row)
+  const std::size_t num_block_rows = _num_rows/bs;
+  _row_offsets.resize(num_block_rows + 1);
+  _row_offsets[0] = 0;
+  _columns.clear();
+  std::vector<std::size_t> block_columns;
+  for (std::size_t I = 0; I < num_block_rows; ++I)
+  {
+    block_columns.clear();
+    for (std::size_t r = 0; r < bs; ++r)
+    {
+      const std::vector<std::size_t>& row = pattern[I*bs + r];
+      for (std::size_t k = 0; k < row.size(); ++k)
+        block_columns.push_back(row[k]/bs);
+    }
+    std::sort(block_columns.begin(), block_columns.end());
+    block_columns.erase(std::unique(block_columns.begin(), block_columns.end()),
+                        block_columns.end());
+    _columns.insert(_columns.end(), block_columns.begin(), block_columns.end());
+    _row_offsets[I + 1] = _columns.size();
+  }
+
+  // Allocate values
+  _values.assign(_columns.size()*bs*bs, 0.0);
+}
+//-----------------------------------------------------------------------------
+std::size_t CSRMatrix::size(std::size_t dim) const
+{
+  if (dim > 1)
+  {
+    dolfin_error("CSRMatrix.cpp",
+                 "access size of CSR matrix",
+                 "Illegal axis (%d), must be 0 or 1", dim);
+  }
+  return dim == 0 ? _num_rows : _num_cols;
+}
+//-----------------------------------------------------------------------------
+std::pair<std::size_t, std::size_t> CSRMatrix::local_range(std::size_t dim) const
+{
+  return std::make_pair(0, size(dim));
+}
+//-----------------------------------------------------------------------------
+void CSRMatrix::zero()
+{
+  std::fill(_values.begin(), _values.end(), 0.0);
+}
+//-----------------------------------------------------------------------------
+void CSRMatrix::apply(std::string mode)
+{
+  // Do nothing
+}
+//-----------------------------------------------------------------------------
+std::string CSRMatrix::str(bool verbose) const
+{
+  std::stringstream s;
+
+  if (verbose)
+  {
+    s << str(false) << std::endl << std::endl;
+    std::vector<std::size_t> columns;
+    std::vector<double> values;
+    for (std::size_t i = 0; i < _num_rows; ++i)
+    {
+      getrow(i, columns, values);
+      s << "|";
+      for (std::size_t k = 0; k < columns.size(); ++k)
+      {
+        std::stringstream entry;
+        entry << std::setiosflags(std::ios::scientific);
+        entry << std::setprecision(16);
+        entry << " (" << i << ", " << columns[k] << ", " << values[k] << ")";
+        s << entry.str();
+      }
+      s << " |" << std::endl;
+    }
+  }
+  else
+  {
+    s << "<CSRMatrix of size " << _num_rows << " x " << _num_cols
+      << " with block size " << _block_size << ">";
+  }
+
+  return s.str();
+}
+//-----------------------------------------------------------------------------
+boost::shared_ptr<GenericMatrix> CSRMatrix::copy() const
+{
+  boost::shared_ptr<GenericMatrix> A(new CSRMatrix(*this));
+  return A;
+}
+//-----------------------------------------------------------------------------
+void CSRMatrix::resize(GenericVector& z, std::size_t dim) const
+{
+  z.resize(size(dim));
+}
+//-----------------------------------------------------------------------------
+void CSRMatrix::get(double* block, std::size_t m, const dolfin::la_index* rows,
+                    std::size_t n, const dolfin::la_index* cols) const
+{
+  for (std::size_t i = 0; i < m; i++)
+  {
+    for (std::size_t j = 0; j < n; j++)
+    {
+      const double* value = find(rows[i], cols[j]);
+      block[i*n + j] = value ? *value : 0.0;
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+void CSRMatrix::set(const double* block, std::size_t m,
+                    const dolfin::la_index* rows, std::size_t n,
+                    const dolfin::la_index* cols)
+{
+  for (std::size_t i = 0; i < m; i++)
+    for (std::size_t j = 0; j < n; j++)
+      *find_or_error(rows[i], cols[j]) = block[i*n + j];
+}
+//-----------------------------------------------------------------------------
+void CSRMatrix::add(const double* block, std::size_t m,
+                    const dolfin::la_index* rows, std::size_t n,
+                    const dolfin::la_index* cols)
+{
+  for (std::size_t i = 0; i < m; i++)
+    for (std::size_t j = 0; j < n; j++)
+      *find_or_error(rows[i], cols[j]) += block[i*n + j];
+}
+//-----------------------------------------------------------------------------
+void CSRMatrix::axpy(double a, const GenericMatrix& A,
+                     bool same_nonzero_pattern)
+{
+  // Check for same size
+  if (size(0) != A.size(0) || size(1) != A.size(1))
+  {
+    dolfin_error("CSRMatrix.cpp",
+                 "perform axpy operation with CSR matrix",
+                 "Dimensions don't match");
+  }
+
+  // Add values directly if the storage is the same
+  if (has_type<const CSRMatrix>(A))
+  {
+    const CSRMatrix& B = as_type<const CSRMatrix>(A);
+    if (B._block_size == _block_size && B._row_offsets == _row_offsets
+        && B._columns == _columns)
+    {
+      for (std::size_t k = 0; k < _values.size(); ++k)
+        _values[k] += a*B._values[k];
+      return;
+    }
+  }
+
+  // Add row by row
+  std::vector<std::size_t> columns;
+  std::vector<double> values;
+  for (std::size_t i = 0; i < _num_rows; ++i)
+  {
+    A.getrow(i, columns, values);
+    for (std::size_t k = 0; k < columns.size(); ++k)
+      *find_or_error(i, columns[k]) += a*values[k];
+  }
+}
+//-----------------------------------------------------------------------------
+double CSRMatrix::norm(std::string norm_type) const
+{
+  const std::size_t bs = _block_size;
+  const std::size_t num_block_rows = _row_offsets.size() - 1;
+
+  if (norm_type == "frobenius")
+  {
+    double sum = 0.0;
+    for (std::size_t k = 0; k < _values.size(); ++k)
+      sum += _values[k]*_values[k];
+    return std::sqrt(sum);
+  }
+  else if (norm_type == "linf")
+  {
+    // Maximum row sum
+    double max_sum = 0.0;
+    for (std::size_t I = 0; I < num_block_rows; ++I)
+    {
+      for (std::size_t r = 0; r < bs; ++r)
+      {
+        double sum = 0.0;
+        for (std::size_t k = _row_offsets[I]; k < _row_offsets[I + 1]; ++k)
+          for (std::size_t c = 0; c < bs; ++c)
+            sum += std::abs(_values[k*bs*bs + r*bs + c]);
+        max_sum = std::max(max_sum, sum);
+      }
+    }
+    return max_sum;
+  }
+  else if (norm_type == "l1")
+  {
+    // Maximum column sum
+    std::vector<double> sums(_num_cols, 0.0);
+    for (std::size_t I = 0; I < num_block_rows; ++I)
+      for (std::size_t k = _row_offsets[I]; k < _row_offsets[I + 1]; ++k)
+        for (std::size_t r = 0; r < bs; ++r)
+          for (std::size_t c = 0; c < bs; ++c)
+            sums[_columns[k]*bs + c] += std::abs(_values[k*bs*bs + r*bs + c]);
+    return sums.empty() ? 0.0 : *std::max_element(sums.begin(), sums.end());
+  }
+  else
+  {
+    dolfin_error("CSRMatrix.cpp",
+                 "compute norm of CSR matrix",
+                 "Unknown norm type (\"%s\")",
+                 norm_type.c_str());
+  }
+
+  return 0.0;
+}
+//-----------------------------------------------------------------------------
+void CSRMatrix::getrow(std::size_t row, std::vector<std::size_t>& columns,
+                       std::vector<double>& values) const
+{
+  dolfin_assert(row < _num_rows);
+  const std::size_t bs = _block_size;
+  const std::size_t I = row/bs;
+  const std::size_t r = row % bs;
+
+  columns.clear();
+  values.clear();
+  for (std::size_t k = _row_offsets[I]; k < _row_offsets[I + 1]; ++k)
+  {
+    for (std::size_t c = 0; c < bs; ++c)
+    {
+      columns.push_back(_columns[k]*bs + c);
+      values.push_back(_values[k*bs*bs + r*bs + c]);
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+void CSRMatrix::setrow(std::size_t row,
+                       const std::vector<std::size_t>& columns,
+                       const std::vector<double>& values)
+{
+  dolfin_assert(columns.size() == values.size());
+  for (std::size_t k = 0; k < columns.size(); ++k)
+    *find_or_error(row, columns[k]) = values[k];
+}
+//-----------------------------------------------------------------------------
+void CSRMatrix::zero(std::size_t m, const dolfin::la_index* rows)
+{
+  const std::size_t bs = _block_size;
+  for (std::size_t i = 0; i < m; ++i)
+  {
+    const std::size_t I = rows[i]/bs;
+    const std::size_t r = rows[i] % bs;
+    for (std::size_t k = _row_offsets[I]; k < _row_offsets[I + 1]; ++k)
+      std::fill_n(&_values[k*bs*bs + r*bs], bs, 0.0);
+  }
+}
+//-----------------------------------------------------------------------------
+void CSRMatrix::ident(std::size_t m, const dolfin::la_index* rows)
+{
+  zero(m, rows);
+  for (std::size_t i = 0; i < m; ++i)
+    *find_or_error(rows[i], rows[i]) = 1.0;
+}
+//-----------------------------------------------------------------------------
+void CSRMatrix::mult(const GenericVector& x, GenericVector& y) const
+{
+  const uBLASVector& xx = as_type<const uBLASVector>(x);
+  uBLASVector& yy = as_type<uBLASVector>(y);
+
+  if (size(1) != xx.size())
+  {
+    dolfin_error("CSRMatrix.cpp",
+                 "compute matrix-vector product with CSR matrix",
+                 "Non-matching dimensions for matrix-vector product");
+  }
+
+  // Resize RHS if empty
+  if (yy.size() == 0)
+    resize(yy, 0);
+
+  if (size(0) != yy.size())
+  {
+    dolfin_error("CSRMatrix.cpp",
+                 "compute matrix-vector product with CSR matrix",
+                 "Vector for matrix-vector result has wrong size");
+  }
+
+  // Compute product, with the block size known at compile time for
+  // common block sizes
+  switch (_block_size)
+  {
+  case 1:
+    mult_blocks<1>(xx.data(), yy.data());
+    break;
+  case 2:
+    mult_blocks<2>(xx.data(), yy.data());
+    break;
+  case 3:
+    mult_blocks<3>(xx.data(), yy.data());
+    break;
+  case 4:
+    mult_blocks<4>(xx.data(), yy.data());
+    break;
+  default:
+    mult_blocks(xx.data(), yy.data());
+  }
+}
+//-----------------------------------------------------------------------------
+void CSRMatrix::transpmult(const GenericVector& x, GenericVector& y) const
+{
+  const uBLASVector& xx = as_type<const uBLASVector>(x);
+  uBLASVector& yy = as_type<uBLASVector>(y);
+
+  if (size(0) != xx.size())
+  {
+    dolfin_error("CSRMatrix.cpp",
+                 "compute transpose matrix-vector product with CSR matrix",
+                 "Non-matching dimensions for transpose matrix-vector product");
+  }
+
+  // Resize RHS if empty
+  if (yy.size() == 0)
+    resize(yy, 1);
+
+  if (size(1) != yy.size())
+  {
+    dolfin_error("CSRMatrix.cpp",
+                 "compute transpose matrix-vector product with CSR matrix",
+                 "Vector for transpose matrix-vector result has wrong size");
+  }
+
+  // Scatter rows (serial)
+  const std::size_t bs = _block_size;
+  const double* _x = xx.data();
+  double* _y = yy.data();
+  std::fill(_y, _y + _num_cols, 0.0);
+  for (std::size_t I = 0; I + 1 < _row_offsets.size(); ++I)
+    for (std::size_t k = _row_offsets[I]; k < _row_offsets[I + 1]; ++k)
+      for (std::size_t r = 0; r < bs; ++r)
+        for (std::size_t c = 0; c < bs; ++c)
+          _y[_columns[k]*bs + c] += _values[k*bs*bs + r*bs + c]*_x[I*bs + r];
+}
+//-----------------------------------------------------------------------------
+const CSRMatrix& CSRMatrix::operator*= (double a)
+{
+  for (std::size_t k = 0; k < _values.size(); ++k)
+    _values[k] *= a;
+  return *this;
+}
+//-----------------------------------------------------------------------------
+const CSRMatrix& CSRMatrix::operator/= (double a)
+{
+  for (std::size_t k = 0; k < _values.size(); ++k)
+    _values[k] /= a;
+  return *this;
+}
+//-----------------------------------------------------------------------------
+const GenericMatrix& CSRMatrix::operator= (const GenericMatrix& A)
+{
+  *this = as_type<const CSRMatrix>(A);
+  return *this;
+}
+//-----------------------------------------------------------------------------
+const CSRMatrix& CSRMatrix::operator= (const CSRMatrix& A)
+{
+  if (this != &A)
+  {
+    _num_rows = A._num_rows;
+    _num_cols = A._num_cols;
+    _block_size = A._block_size;
+    _row_offsets = A._row_offsets;
+    _columns = A._columns;
+    _values = A._values;
+  }
+  return *this;
+}
+//-----------------------------------------------------------------------------
+boost::tuples::tuple<const std::size_t*, const std::size_t*, const double*, int>
+CSRMatrix::data() const
+{
+  typedef boost::tuples::tuple<const std::size_t*, const std::size_t*,
+                               const double*, int> tuple;
+
+  // Use blocks as they are for block size one
+  if (_block_size == 1)
+  {
+    if (_values.empty())
+      return tuple(&_row_offsets[0], 0, 0, 0);
+    return tuple(&_row_offsets[0], &_columns[0], &_values[0], _values.size());
+  }
+
+  // Expand blocks to (scalar) compressed row storage
+  expand(_scalar_row_offsets, _scalar_columns, _scalar_values);
+  if (_scalar_values.empty())
+    return tuple(&_scalar_row_offsets[0], 0, 0, 0);
+  return tuple(&_scalar_row_offsets[0], &_scalar_columns[0],
+               &_scalar_values[0], _scalar_values.size());
+}
+//-----------------------------------------------------------------------------
+void CSRMatrix::expand(std::vector<std::size_t>& row_offsets,
+                       std::vector<std::size_t>& columns,
+                       std::vector<double>& values) const
+{
+  const std::size_t bs = _block_size;
+  row_offsets.resize(_num_rows + 1);
+  row_offsets[0] = 0;
+  columns.resize(_values.size());
+  values.resize(_values.size());
+  std::size_t pos = 0;
+  for (std::size_t i = 0; i < _num_rows; ++i)
+  {
+    const std::size_t I = i/bs;
+    const std::size_t r = i % bs;
+    for (std::size_t k = _row_offsets[I]; k < _row_offsets[I + 1]; ++k)
+    {
+      for (std::size_t c = 0; c < bs; ++c)
+      {
+        columns[pos] = _columns[k]*bs + c;
+        values[pos] = _values[k*bs*bs + r*bs + c];
+        ++pos;
+      }
+    }
+    row_offsets[i + 1] = pos;
+  }
+}
+//-----------------------------------------------------------------------------
+GenericLinearAlgebraFactory& CSRMatrix::factory() const
+{
+  return CSRFactory::instance();
+}
+//-----------------------------------------------------------------------------
+const double* CSRMatrix::find(std::size_t i, std::size_t j) const
+{
+  const std::size_t bs = _block_size;
+  const std::size_t I = i/bs;
+  const std::size_t J = j/bs;
+  if (I + 1 >= _row_offsets.size())
+    return 0;
+
+  // Search for block column in block row
+  std::vector<std::size_t>::const_iterator begin
+    = _columns.begin() + _row_offsets[I];
+  std::vector<std::size_t>::const_iterator end
+    = _columns.begin() + _row_offsets[I + 1];
+  std::vector<std::size_t>::const_iterator it = std::lower_bound(begin, end, J);
+  if (it == end || *it != J)
+    return 0;
+
+  const std::size_t k = it - _columns.begin();
+  return &_values[k*bs*bs + (i % bs)*bs + j % bs];
+}
+//-----------------------------------------------------------------------------
+double* CSRMatrix::find_or_error(std::size_t i, std::size_t j)
+{
+  const double* value = find(i, j);
+  if (!value)
+  {
+    dolfin_error("CSRMatrix.cpp",
+                 "access entry of CSR matrix",
+                 "Entry (%d, %d) is not in the sparsity pattern", i, j);
+  }
+  return const_cast<double*>(value);
+}
+//-----------------------------------------------------------------------------
+template<std::size_t BS>
+void CSRMatrix::mult_blocks(const double* x, double* y) const
+{
+  const int num_block_rows = _row_offsets.size() - 1;
+  const std::size_t* offsets = &_row_offsets[0];
+  const std::size_t* columns = _columns.empty() ? 0 : &_columns[0];
+  const double* values = _values.empty() ? 0 : &_values[0];
+
+  const std::size_t num_threads = dolfin::parameters["num_threads"];
+  #ifdef HAS_OPENMP
+  #pragma omp parallel for schedule(static) num_threads(std::max(num_threads, (std::size_t) 1))
+  #endif
+  for (int I = 0; I < num_block_rows; ++I)
+  {
+    double y_I[BS];
+    for (std::size_t r = 0; r < BS; ++r)
+      y_I[r] = 0.0;
+
+    for (std::size_t k = offsets[I]; k < offsets[I + 1]; ++k)
+    {
+      const double* a = values + k*BS*BS;
+      const double* x_J = x + columns[k]*BS;
+      for (std::size_t r = 0; r < BS; ++r)
+        for (std::size_t c = 0; c < BS; ++c)
+          y_I[r] += a[r*BS + c]*x_J[c];
+    }
+
+    for (std::size_t r = 0; r < BS; ++r)
+      y[I*BS + r] = y_I[r];
+  }
+}
+//-----------------------------------------------------------------------------
+void CSRMatrix::mult_blocks(const double* x, double* y) const
+{
+  const std::size_t bs = _block_size;
+  const int num_block_rows = _row_offsets.size() - 1;
+
+  const std::size_t num_threads = dolfin::parameters["num_threads"];
+  #ifdef HAS_OPENMP
+  #pragma omp parallel for schedule(static) num_threads(std::max(num_threads, (std::size_t) 1))
+  #endif
+  for (int I = 0; I < num_block_rows; ++I)
+  {
+    double* y_I = y + I*bs;
+    std::fill(y_I, y_I + bs, 0.0);
+    for (std::size_t k = _row_offsets[I]; k < _row_offsets[I + 1]; ++k)
+    {
+      const double* a = &_values[k*bs*bs];
+      const double* x_J = x + _columns[k]*bs;
+      for (std::size_t r = 0; r < bs; ++r)
+        for (std::size_t c = 0; c < bs; ++c)
+          y_I[r] += a[r*bs + c]*x_J[c];
+    }
+  }
+}
+//-----------------------------------------------------------------------------
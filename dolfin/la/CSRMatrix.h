@@ -0,0 +1,226 @@
+// Copyright (C) 2026 agent
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+//
+// First added:  2026-10-16
+// Last changed: 2026-10-16
+
+#ifndef __DOLFIN_CSR_MATRIX_H
+#define __DOLFIN_CSR_MATRIX_H
+
+#include <string>
+#include <utility>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+#include <dolfin/common/types.h>
+#include "GenericMatrix.h"
+
+namespace dolfin
+{
+
+  class GenericVector;
+  class TensorLayout;
+
+  /// Serial sparse matrix in compressed row storage (CSR), working
+  /// with uBLASVector and the uBLAS Krylov solvers. The matrix is
+  /// stored directly as arrays of row offsets, column indices and
+  /// values, and the matrix-vector product is computed in parallel
+  /// using the number of threads given by the global parameter
+  /// "num_threads".
+  ///
+  /// If the tensor layout has a block size larger than one (e.g. for
+  /// vector-valued problems with interleaved dofs), the matrix is
+  /// stored in blocked compressed row storage (BSR): each nonzero is a
+  /// dense block (row-major) of size block_size x block_size.
+  ///
+  /// The sparsity pattern is fixed when the matrix is initialized;
+  /// setting or adding entries outside the pattern is an error.
+
+  class CSRMatrix : public GenericMatrix
+  {
+  public:
+
+    /// Create empty matrix
+    CSRMatrix();
+
+    /// Destructor
+    virtual ~CSRMatrix();
+
+    //--- Implementation of the GenericTensor interface ---
+
+    /// Initialize zero tensor using sparsity pattern
+    virtual void init(const TensorLayout& tensor_layout);
+
+    /// Return size of given dimension
+    virtual std::size_t size(std::size_t dim) const;
+
+    /// Return local ownership range
+    virtual std::pair<std::size_t, std::size_t> local_range(std::size_t dim) const;
+
+    /// Set all entries to zero and keep any sparse structure
+    virtual void zero();
+
+    /// Finalize assembly of tensor
+    virtual void apply(std::string mode);
+
+    /// Return informal string representation (pretty-print)
+    virtual std::string str(bool verbose) const;
+
+    //--- Implementation of the GenericMatrix interface ---
+
+    /// Return copy of matrix
+    virtual boost::shared_ptr<GenericMatrix> copy() const;
+
+    /// Resize vector z to be compatible with the matrix-vector product
+    /// y = Ax (dim = 0 --> z = y, dim = 1 --> z = x)
+    virtual void resize(GenericVector& z, std::size_t dim) const;
+
+    /// Get block of values
+    virtual void get(double* block, std::size_t m, const dolfin::la_index* rows,
+                     std::size_t n, const dolfin::la_index* cols) const;
+
+    /// Set block of values
+    virtual void set(const double* block, std::size_t m,
+                     const dolfin::la_index* rows, std::size_t n,
+                     const dolfin::la_index* cols);
+
+    /// Add block of values
+    virtual void add(const double* block, std::size_t m,
+                     const dolfin::la_index* rows, std::size_t n,
+                     const dolfin::la_index* cols);
+
+    /// Add multiple of given matrix (AXPY operation). The nonzero
+    /// pattern of A must be contained in the pattern of this matrix.
+    virtual void axpy(double a, const GenericMatrix& A,
+                      bool same_nonzero_pattern);
+
+    /// Return norm of matrix
+    virtual double norm(std::string norm_type) const;
+
+    /// Get non-zero values of given row
+    virtual void getrow(std::size_t row, std::vector<std::size_t>& columns,
+                        std::vector<double>& values) const;
+
+    /// Set values for given row
+    virtual void setrow(std::size_t row,
+                        const std::vector<std::size_t>& columns,
+                        const std::vector<double>& values);
+
+    /// Set given rows to zero
+    virtual void zero(std::size_t m, const dolfin::la_index* rows);
+
+    /// Set given rows to identity matrix
+    virtual void ident(std::size_t m, const dolfin::la_index* rows);
+
+    /// Matrix-vector product, y = Ax
+    virtual void mult(const GenericVector& x, GenericVector& y) const;
+
+    /// Matrix-vector product, y = A^T x
+    virtual void transpmult(const GenericVector& x, GenericVector& y) const;
+
+    /// Multiply matrix by given number
+    virtual const CSRMatrix& operator*= (double a);
+
+    /// Divide matrix by given number
+    virtual const CSRMatrix& operator/= (double a);
+
+    /// Assignment operator
+    virtual const GenericMatrix& operator= (const GenericMatrix& A);
+
+    /// Return pointers to underlying compressed row storage data.
+    /// For block size larger than one, the blocks are expanded to a
+    /// (scalar) copy, which is valid until the next call to data().
+    virtual boost::tuples::tuple<const std::size_t*, const std::size_t*,
+                                 const double*, int> data() const;
+
+    //--- Special functions ---
+
+    /// Return linear algebra backend factory
+    virtual GenericLinearAlgebraFactory& factory() const;
+
+    //--- Special CSRMatrix functions ---
+
+    /// Assignment operator
+    const CSRMatrix& operator= (const CSRMatrix& A);
+
+    /// Return block size
+    std::size_t block_size() const
+    { return _block_size; }
+
+    /// Return offsets of block rows into column indices (size number
+    /// of block rows + 1)
+    const std::vector<std::size_t>& row_offsets() const
+    { return _row_offsets; }
+
+    /// Return (sorted) block column indices of nonzero blocks
+    const std::vector<std::size_t>& columns() const
+    { return _columns; }
+
+    /// Return values of nonzero blocks (block by block, row-major)
+    const std::vector<double>& values() const
+    { return _values; }
+
+    /// Return number of nonzero entries (including explicit zeros in
+    /// nonzero blocks)
+    std::size_t nnz() const
+    { return _values.size(); }
+
+    /// Copy matrix to (scalar) compressed row storage, expanding
+    /// blocks
+    void expand(std::vector<std::size_t>& row_offsets,
+                std::vector<std::size_t>& columns,
+                std::vector<double>& values) const;
+
+  private:
+
+    // Return pointer to value of entry (i, j), or null if the entry
+    // is not in the sparsity pattern
+    const double* find(std::size_t i, std::size_t j) const;
+
+    // Return pointer to value of entry (i, j), with error if the entry
+    // is not in the sparsity pattern
+    double* find_or_error(std::size_t i, std::size_t j);
+
+    // Compute y = Ax for block size BS (compile-time constant)
+    template<std::size_t BS>
+    void mult_blocks(const double* x, double* y) const;
+
+    // Compute y = Ax for any block size
+    void mult_blocks(const double* x, double* y) const;
+
+    // Number of rows and columns
+    std::size_t _num_rows, _num_cols;
+
+    // Block size
+    std::size_t _block_size;
+
+    // Compressed row storage (of blocks)
+    std::vector<std::size_t> _row_offsets;
+    std::vector<std::size_t> _columns;
+    std::vector<double> _values;
+
+    // Expanded (scalar) compressed row storage returned by data() for
+    // block size larger than one
+    mutable std::vector<std::size_t> _scalar_row_offsets;
+    mutable std::vector<std::size_t> _scalar_columns;
+    mutable std::vector<double> _scalar_values;
+
+  };
+
+}
+
+#endif
@@ -26,6 +26,7 @@
 #include "PETScCuspFactory.h"
 #include "EpetraFactory.h"
 #include "STLFactory.h"
+#include "CSRFactory.h"
 #include "DefaultFactory.h"
 
 using namespace dolfin;
@@ -135,6 +136,10 @@ GenericLinearAlgebraFactory& DefaultFactory::factory()
   {
     return STLFactory::instance();
   }
+  else if (backend == "CSR")
+  {
+    return CSRFactory::instance();
+  }
 
   // Fallback
   log(WARNING, "Linear algebra backend \"" + backend + "\" not available, using " + default_backend + ".");
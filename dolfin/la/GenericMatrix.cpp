@@ -127,9 +127,7 @@ void GenericMatrix::compress()
   offset[0] = 0;
   std::vector<dolfin::la_index> thisrow(1);
   std::vector<dolfin::la_index> thiscolumn;
-  std::vector<const std::vector<dolfin::la_index>* > dofs(2);
-  dofs[0] = &thisrow;
-  dofs[1] = &thiscolumn;
+  std::vector<ArrayView<const dolfin::la_index> > dofs(2);
 
   // Iterate over rows
   for (std::size_t i = 0; i < m; i++)
@@ -155,6 +153,8 @@ void GenericMatrix::compress()
     offset[i + 1] = offset[i] + count;
 
     // Build new compressed sparsity pattern
+    dofs[0] = ArrayView<const dolfin::la_index>(thisrow.size(), thisrow.data());
+    dofs[1] = ArrayView<const dolfin::la_index>(thiscolumn.size(), thiscolumn.data());
     new_sparsity_pattern.insert(dofs);
   }
 
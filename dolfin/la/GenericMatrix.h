@@ -76,13 +76,27 @@ namespace dolfin
     { add(block, num_rows[0], rows[0], num_rows[1], rows[1]); }
 
     /// Add block of values
-    virtual void add(const double* block, const std::vector<const std::vector<dolfin::la_index>* >& rows)
-    { add(block, (rows[0])->size(), &(*rows[0])[0], (rows[1])->size(), &(*rows[1])[0]); }
+    virtual void add(const double* block, const std::vector<ArrayView<const dolfin::la_index> >& rows)
+    { add(block, rows[0].size(), rows[0].data(), rows[1].size(), rows[1].data()); }
 
     /// Add block of values
     virtual void add(const double* block, const std::vector<std::vector<dolfin::la_index> >& rows)
     { add(block, rows[0].size(), &(rows[0])[0], rows[1].size(), &(rows[1])[0]); }
 
+    /// Add a sequence of blocks of values (see GenericTensor::add_blocks)
+    virtual void add_blocks(const double* blocks, std::size_t num_blocks,
+                            const std::vector<ArrayView<const dolfin::la_index> >& rows)
+    {
+      dolfin_assert(rows.size() >= 2*num_blocks);
+      for (std::size_t i = 0; i < num_blocks; ++i)
+      {
+        const ArrayView<const dolfin::la_index>& rows0 = rows[2*i];
+        const ArrayView<const dolfin::la_index>& rows1 = rows[2*i + 1];
+        add(blocks, rows0.size(), rows0.data(), rows1.size(), rows1.data());
+        blocks += rows0.size()*rows1.size();
+      }
+    }
+
     /// Set all entries to zero and keep any sparse structure
     virtual void zero() = 0;
 
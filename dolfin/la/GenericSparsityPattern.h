@@ -20,7 +20,7 @@
 // Modified by Garth N. Wells, 2010.
 //
 // First added:  2007-11-30
-// Last changed: 2010-12-30
+// Last changed: 2026-10-16
 
 #ifndef __GENERIC_SPARSITY_PATTERN_H
 #define __GENERIC_SPARSITY_PATTERN_H
@@ -29,6 +29,7 @@
 #include <vector>
 #include <boost/unordered_map.hpp>
 
+#include <dolfin/common/ArrayView.h>
 #include <dolfin/common/types.h>
 #include <dolfin/common/Variable.h>
 
@@ -56,7 +57,12 @@ namespace dolfin
                       const std::vector<const boost::unordered_map<std::size_t, unsigned int>* > off_process_owner) = 0;
 
     /// Insert non-zero entries
-    virtual void insert(const std::vector<const std::vector<dolfin::la_index>* >& entries) = 0;
+    virtual void insert(const std::vector<ArrayView<const dolfin::la_index> >& entries) = 0;
+
+    /// Return true if insert() may be called concurrently from
+    /// multiple OpenMP threads
+    virtual bool threaded_insert() const
+    { return false; }
 
     /// Add edges (vertex = [index, owning process])
     virtual void add_edges(const std::pair<dolfin::la_index, std::size_t>& vertex,
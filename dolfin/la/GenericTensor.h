@@ -27,8 +27,10 @@
 
 #include <exception>
 #include <typeinfo>
+#include <vector>
 #include <boost/shared_ptr.hpp>
 #include <dolfin/log/log.h>
+#include <dolfin/common/ArrayView.h>
 #include <dolfin/common/types.h>
 #include "LinearAlgebraObject.h"
 
@@ -71,7 +73,7 @@ namespace dolfin
 
     /// Add block of values
     virtual void add(const double* block,
-                     const std::vector<const std::vector<dolfin::la_index>* >& rows) = 0;
+                     const std::vector<ArrayView<const dolfin::la_index> >& rows) = 0;
 
     /// Add block of values
     virtual void add(const double* block,
@@ -81,6 +83,29 @@ namespace dolfin
     virtual void add(const double* block, const dolfin::la_index* num_rows,
                      const dolfin::la_index * const * rows) = 0;
 
+    /// Add a sequence of blocks of values, e.g. the element tensors
+    /// of a block of cells. Block i is stored contiguously after
+    /// block i - 1 and uses the rows rows[i*rank()], ...,
+    /// rows[(i + 1)*rank() - 1]
+    virtual void add_blocks(const double* blocks, std::size_t num_blocks,
+                            const std::vector<ArrayView<const dolfin::la_index> >& rows)
+    {
+      const std::size_t r = rank();
+      dolfin_assert(rows.size() >= num_blocks*r);
+      std::vector<ArrayView<const dolfin::la_index> > block_rows(r);
+      for (std::size_t i = 0; i < num_blocks; ++i)
+      {
+        std::size_t block_size = 1;
+        for (std::size_t j = 0; j < r; ++j)
+        {
+          block_rows[j] = rows[i*r + j];
+          block_size *= block_rows[j].size();
+        }
+        add(blocks, block_rows);
+        blocks += block_size;
+      }
+    }
+
     /// Set all entries to zero and keep any sparse structure
     virtual void zero() = 0;
 
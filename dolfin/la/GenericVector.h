@@ -86,13 +86,25 @@ namespace dolfin
     { add(block, num_rows[0], rows[0]); }
 
     /// Add block of values
-    virtual void add(const double* block, const std::vector<const std::vector<dolfin::la_index>* >& rows)
-    { add(block, rows[0]->size(), &(*rows[0])[0]); }
+    virtual void add(const double* block, const std::vector<ArrayView<const dolfin::la_index> >& rows)
+    { add(block, rows[0].size(), rows[0].data()); }
 
     /// Add block of values
     virtual void add(const double* block, const std::vector<std::vector<dolfin::la_index> >& rows)
     { add(block, rows[0].size(), &(rows[0])[0]); }
 
+    /// Add a sequence of blocks of values (see GenericTensor::add_blocks)
+    virtual void add_blocks(const double* blocks, std::size_t num_blocks,
+                            const std::vector<ArrayView<const dolfin::la_index> >& rows)
+    {
+      dolfin_assert(rows.size() >= num_blocks);
+      for (std::size_t i = 0; i < num_blocks; ++i)
+      {
+        add(blocks, rows[i].size(), rows[i].data());
+        blocks += rows[i].size();
+      }
+    }
+
     /// Set all entries to zero and keep any sparse structure
     virtual void zero() = 0;
 
@@ -97,7 +97,7 @@ namespace dolfin
     }
 
     /// Add block of values
-    void add(const double* block, const std::vector<const std::vector<dolfin::la_index>* >& rows)
+    void add(const double* block, const std::vector<ArrayView<const dolfin::la_index> >& rows)
     {
       dolfin_assert(block);
       _value += block[0];
@@ -110,6 +110,15 @@ namespace dolfin
       _value += block[0];
     }
 
+    /// Add a sequence of blocks of values
+    void add_blocks(const double* blocks, std::size_t num_blocks,
+                    const std::vector<ArrayView<const dolfin::la_index> >& rows)
+    {
+      dolfin_assert(blocks || num_blocks == 0);
+      for (std::size_t i = 0; i < num_blocks; ++i)
+        _value += blocks[i];
+    }
+
     /// Set all entries to zero and keep any sparse structure
     void zero()
     { _value = 0.0; }
@@ -20,13 +20,19 @@
 // Modified by Ola Skavhaug, 2009.
 //
 // First added:  2007-03-13
-// Last changed: 2011-01-02
+// Last changed: 2026-10-16
 
 #include <algorithm>
+#include <numeric>
+
+#ifdef HAS_OPENMP
+#include <omp.h>
+#endif
 
 #include <dolfin/common/MPI.h>
 #include <dolfin/log/log.h>
 #include <dolfin/log/LogStream.h>
+#include <dolfin/parameter/GlobalParameters.h>
 #include "SparsityPattern.h"
 
 using namespace dolfin;
@@ -61,9 +67,11 @@ void SparsityPattern::init(const std::vector<std::size_t>& dims,
   dolfin_assert(dims.size() == off_process_owner.size());
 
   // Clear sparsity pattern data
-  diagonal.clear();
-  off_diagonal.clear();
-  non_local.clear();
+  diagonal_offsets.clear();
+  diagonal_columns.clear();
+  off_diagonal_offsets.clear();
+  off_diagonal_columns.clear();
+  buffers.clear();
   _off_process_owner.clear();
 
   // Set ownership range
@@ -89,92 +97,81 @@ void SparsityPattern::init(const std::vector<std::size_t>& dims,
   if (_local_range[_primary_dim].first != 0 || _local_range[_primary_dim].second != dims[_primary_dim])
     distributed = true;
 
-  // Resize diagonal block
+  // Initialize diagonal block (empty rows)
   dolfin_assert(_local_range[_primary_dim].second > _local_range[_primary_dim].first);
-  diagonal.resize(_local_range[_primary_dim].second - _local_range[_primary_dim].first);
+  const std::size_t num_rows = _local_range[_primary_dim].second - _local_range[_primary_dim].first;
+  diagonal_offsets.resize(num_rows + 1, 0);
 
-  // Resize off-diagonal block (only needed when local range != global range)
+  // Initialize off-diagonal block (only needed when local range != global range)
   if (distributed)
-    off_diagonal.resize(_local_range[_primary_dim].second - _local_range[_primary_dim].first);
+    off_diagonal_offsets.resize(num_rows + 1, 0);
+
+  // Create one buffer for each thread that may insert entries
+  std::size_t num_threads = dolfin::parameters["num_threads"];
+  #ifdef HAS_OPENMP
+  num_threads = std::max(num_threads, (std::size_t) omp_get_max_threads());
+  #endif
+  buffers.resize(std::max(num_threads, (std::size_t) 1));
 }
 //-----------------------------------------------------------------------------
-void SparsityPattern::insert(const std::vector<const std::vector<dolfin::la_index>* >& entries)
+void SparsityPattern::insert(const std::vector<ArrayView<const dolfin::la_index> >& entries)
 {
   dolfin_assert(entries.size() == 2);
-  dolfin_assert(entries[0]);
-  dolfin_assert(entries[1]);
 
   const std::size_t _primary_dim = primary_dim();
 
-  const std::vector<dolfin::la_index>* map_i;
-  const std::vector<dolfin::la_index>* map_j;
   std::size_t primary_codim;
   dolfin_assert(_primary_dim < 2);
   if (_primary_dim == 0)
-  {
     primary_codim = 1;
-    map_i = entries[0];
-    map_j = entries[1];
-  }
   else
-  {
     primary_codim = 0;
-    map_i = entries[1];
-    map_j = entries[0];
-  }
+
+  const ArrayView<const dolfin::la_index>& map_i = entries[_primary_dim];
+  const ArrayView<const dolfin::la_index>& map_j = entries[primary_codim];
 
   const std::pair<dolfin::la_index, dolfin::la_index> local_range0(_local_range[_primary_dim].first,
                                                          _local_range[_primary_dim].second);
-  const std::pair<dolfin::la_index, dolfin::la_index> local_range1(_local_range[primary_codim].first,
-                                                         _local_range[primary_codim].second);
 
-  // Check local range
-  if (!distributed)
-  {
-    // Sequential mode, do simple insertion
-    std::vector<dolfin::la_index>::const_iterator i_index;
-    for (i_index = map_i->begin(); i_index != map_i->end(); ++i_index)
-      diagonal[*i_index].insert(map_j->begin(), map_j->end());
-  }
-  else
+  // Get buffer of calling thread
+  #ifdef HAS_OPENMP
+  const std::size_t thread = omp_get_thread_num();
+  #else
+  const std::size_t thread = 0;
+  #endif
+  dolfin_assert(thread < buffers.size());
+  ThreadBuffer& buffer = buffers[thread];
+
+  const dolfin::la_index* i_index;
+  const dolfin::la_index* j_index;
+  for (i_index = map_i.begin(); i_index != map_i.end(); ++i_index)
   {
-    // Parallel mode, use either diagonal, off_diagonal or non_local
-    std::vector<dolfin::la_index>::const_iterator i_index;
-    for (i_index = map_i->begin(); i_index != map_i->end(); ++i_index)
+    if (!distributed
+        || (local_range0.first <= *i_index && *i_index < local_range0.second))
     {
-      if (local_range0.first <= *i_index && *i_index < local_range0.second)
-      {
-        // Subtract offset
-        const std::size_t I = *i_index - local_range0.first;
-
-        // Store local entry in diagonal or off-diagonal block
-        std::vector<dolfin::la_index>::const_iterator j_index;
-        for (j_index = map_j->begin(); j_index != map_j->end(); ++j_index)
-        {
-          if (local_range1.first <= *j_index && *j_index < local_range1.second)
-          {
-            dolfin_assert(I < diagonal.size());
-            diagonal[I].insert(*j_index);
-          }
-          else
-          {
-            dolfin_assert(I < off_diagonal.size());
-            off_diagonal[I].insert(*j_index);
-          }
-        }
-      }
-      else
+      // Store local entry (split into diagonal and off-diagonal
+      // blocks in apply())
+      const std::size_t I = *i_index - local_range0.first;
+      for (j_index = map_j.begin(); j_index != map_j.end(); ++j_index)
+        buffer.entries.push_back(entry_type(I, *j_index));
+    }
+    else
+    {
+      // Store non-local entry (communicated later during apply())
+      for (j_index = map_j.begin(); j_index != map_j.end(); ++j_index)
       {
-        // Store non-local entry (communicated later during apply())
-        std::vector<dolfin::la_index>::const_iterator j_index;
-        for (j_index = map_j->begin(); j_index != map_j->end(); ++j_index)
-        {
-          non_local.push_back(*i_index);
-          non_local.push_back(*j_index);
-        }
+        buffer.non_local.push_back(*i_index);
+        buffer.non_local.push_back(*j_index);
       }
     }
   }
+
+  // Sort entries and remove duplicates when the number of new
+  // entries is large (compared to the number of sorted entries)
+  const std::size_t min_unsorted = 1 << 20;
+  const std::size_t num_unsorted = buffer.entries.size() - buffer.num_sorted;
+  if (num_unsorted > std::max(buffer.num_sorted, min_unsorted))
+    compress(buffer);
 }
 //-----------------------------------------------------------------------------
 void SparsityPattern::add_edges(const std::pair<dolfin::la_index, std::size_t>& vertex,
@@ -192,10 +189,10 @@ void SparsityPattern::add_edges(const std::pair<dolfin::la_index, std::size_t>&
     _off_process_owner[_primary_dim].insert(vertex);
 
   // Add edges
-  std::vector<dolfin::la_index> dofs0(1, vertex.first);
-  std::vector<const std::vector<dolfin::la_index>* > entries(2);
-  entries[0] = &dofs0;
-  entries[1] = &edges;
+  const dolfin::la_index dofs0 = vertex.first;
+  std::vector<ArrayView<const dolfin::la_index> > entries(2);
+  entries[0] = ArrayView<const dolfin::la_index>(1, &dofs0);
+  entries[1] = ArrayView<const dolfin::la_index>(edges.size(), edges.data());
   insert(entries);
 }
 //-----------------------------------------------------------------------------
@@ -212,41 +209,35 @@ std::pair<std::size_t, std::size_t> SparsityPattern::local_range(std::size_t dim
 //-----------------------------------------------------------------------------
 std::size_t SparsityPattern::num_nonzeros() const
 {
-  std::size_t nz = 0;
-  typedef std::vector<set_type>::const_iterator slice_it;
-  for (slice_it slice = diagonal.begin(); slice != diagonal.end(); ++slice)
-    nz += slice->size();
-  for (slice_it slice = off_diagonal.begin(); slice != off_diagonal.end(); ++slice)
-    nz += slice->size();
-  return nz;
+  return diagonal_columns.size() + off_diagonal_columns.size();
 }
 //-----------------------------------------------------------------------------
 void SparsityPattern::num_nonzeros_diagonal(std::vector<std::size_t>& num_nonzeros) const
 {
   // Resize vector
-  num_nonzeros.resize(diagonal.size());
+  const std::size_t num_rows = diagonal_offsets.empty() ? 0 : diagonal_offsets.size() - 1;
+  num_nonzeros.resize(num_rows);
 
   // Get number of nonzeros per generalised row
-  typedef std::vector<set_type>::const_iterator slice_it;
-  for (slice_it slice = diagonal.begin(); slice != diagonal.end(); ++slice)
-    num_nonzeros[slice - diagonal.begin()] = slice->size();
+  for (std::size_t i = 0; i < num_rows; ++i)
+    num_nonzeros[i] = diagonal_offsets[i + 1] - diagonal_offsets[i];
 }
 //-----------------------------------------------------------------------------
 void SparsityPattern::num_nonzeros_off_diagonal(std::vector<std::size_t>& num_nonzeros) const
 {
   // Resize vector
-  num_nonzeros.resize(off_diagonal.size());
+  const std::size_t num_rows = off_diagonal_offsets.empty() ? 0 : off_diagonal_offsets.size() - 1;
+  num_nonzeros.resize(num_rows);
 
   // Compute number of nonzeros per generalised row
-  typedef std::vector<set_type>::const_iterator slice_it;
-  for (slice_it slice = off_diagonal.begin(); slice != off_diagonal.end(); ++slice)
-    num_nonzeros[slice - off_diagonal.begin()] = slice->size();
+  for (std::size_t i = 0; i < num_rows; ++i)
+    num_nonzeros[i] = off_diagonal_offsets[i + 1] - off_diagonal_offsets[i];
 }
 //-----------------------------------------------------------------------------
 void SparsityPattern::num_local_nonzeros(std::vector<std::size_t>& num_nonzeros) const
 {
   num_nonzeros_diagonal(num_nonzeros);
-  if (!off_diagonal.empty())
+  if (!off_diagonal_offsets.empty())
   {
     std::vector<std::size_t> tmp;
     num_nonzeros_off_diagonal(tmp);
@@ -261,21 +252,19 @@ void SparsityPattern::get_edges(std::size_t vertex, std::vector<dolfin::la_index
   dolfin_assert(vertex >= _local_range[0].first && vertex < _local_range[0].second);
 
   const std::size_t local_vertex = vertex - _local_range[0].first;
-  dolfin_assert(local_vertex < diagonal.size());
-  std::size_t size = diagonal[local_vertex].size();
-  if (!off_diagonal.empty())
-  {
-    dolfin_assert(local_vertex < off_diagonal.size());
-    size += off_diagonal[local_vertex].size();
-  }
-  edges.resize(size);
-
-  std::copy(diagonal[local_vertex].begin(), diagonal[local_vertex].end(), edges.begin());
-  if (!off_diagonal.empty())
+  dolfin_assert(local_vertex + 1 < diagonal_offsets.size());
+  const std::vector<std::size_t>::const_iterator d0
+    = diagonal_columns.begin() + diagonal_offsets[local_vertex];
+  const std::vector<std::size_t>::const_iterator d1
+    = diagonal_columns.begin() + diagonal_offsets[local_vertex + 1];
+  edges.assign(d0, d1);
+
+  if (!off_diagonal_offsets.empty())
   {
-    std::copy(off_diagonal[local_vertex].begin(),
-              off_diagonal[local_vertex].end(),
-              edges.begin() + diagonal[local_vertex].size());
+    dolfin_assert(local_vertex + 1 < off_diagonal_offsets.size());
+    edges.insert(edges.end(),
+                 off_diagonal_columns.begin() + off_diagonal_offsets[local_vertex],
+                 off_diagonal_columns.begin() + off_diagonal_offsets[local_vertex + 1]);
   }
 }
 //-----------------------------------------------------------------------------
@@ -293,41 +282,48 @@ void SparsityPattern::apply()
   const std::size_t num_processes = MPI::num_processes();
   const std::size_t proc_number = MPI::process_number();
 
-  // Print some useful information
-  if (get_log_level() <= DBG)
-    info_statistics();
+  dolfin_assert(!buffers.empty());
 
   // Communicate non-local blocks if any
+  std::size_t num_nonzeros_non_local = 0;
   if (distributed)
   {
     // Figure out correct process for each non-local entry
-    dolfin_assert(non_local.size() % 2 == 0);
     std::vector<std::vector<std::size_t> > non_local_send(num_processes);
-
-    for (std::size_t i = 0; i < non_local.size(); i += 2)
+    for (std::size_t b = 0; b < buffers.size(); ++b)
     {
-      // Get generalised row for non-local entry
-      const std::size_t I = non_local[i];
-      const std::size_t J = non_local[i + 1];
+      std::vector<std::size_t>& non_local = buffers[b].non_local;
+      dolfin_assert(non_local.size() % 2 == 0);
+      num_nonzeros_non_local += non_local.size()/2;
+
+      for (std::size_t i = 0; i < non_local.size(); i += 2)
+      {
+        // Get generalised row for non-local entry
+        const std::size_t I = non_local[i];
+        const std::size_t J = non_local[i + 1];
+
+        // Figure out which process owns the row
+        boost::unordered_map<std::size_t, unsigned int>::const_iterator non_local_index
+            = _off_process_owner[_primary_dim].find(I);
+        dolfin_assert(non_local_index != _off_process_owner[_primary_dim].end());
+        const std::size_t p = non_local_index->second;
 
-      // Figure out which process owns the row
-      boost::unordered_map<std::size_t, unsigned int>::const_iterator non_local_index
-          = _off_process_owner[_primary_dim].find(I);
-      dolfin_assert(non_local_index != _off_process_owner[_primary_dim].end());
-      const std::size_t p = non_local_index->second;
+        dolfin_assert(p < num_processes);
+        dolfin_assert(p != proc_number);
 
-      dolfin_assert(p < num_processes);
-      dolfin_assert(p != proc_number);
+        non_local_send[p].push_back(I);
+        non_local_send[p].push_back(J);
+      }
 
-      non_local_send[p].push_back(I);
-      non_local_send[p].push_back(J);
+      // Clear non-local entries
+      std::vector<std::size_t>().swap(non_local);
     }
 
     // Communicate non-local entries to other processes
     std::vector<std::vector<std::size_t> > non_local_received;
     MPI::all_to_all(non_local_send, non_local_received);
 
-    // Insert non-local entries received from other processes
+    // Add non-local entries received from other processes
     for (std::size_t p = 0; p < num_processes; ++p)
     {
       const std::vector<std::size_t>& non_local_received_p = non_local_received[p];
@@ -336,7 +332,7 @@ void SparsityPattern::apply()
       for (std::size_t i = 0; i < non_local_received_p.size(); i += 2)
       {
         // Get generalised row and column
-        std::size_t I = non_local_received_p[i];
+        const std::size_t I = non_local_received_p[i];
         const std::size_t J = non_local_received_p[i + 1];
 
         // Sanity check
@@ -348,42 +344,132 @@ void SparsityPattern::apply()
                        I, _local_range[_primary_dim].first, _local_range[_primary_dim].second);
         }
 
-        // Subtract offset
-        I -= _local_range[_primary_dim].first;
+        // Subtract offset and store entry
+        buffers[0].entries.push_back(entry_type(I - _local_range[_primary_dim].first, J));
+      }
+    }
+  }
+
+  // Check for new entries
+  bool new_entries = false;
+  for (std::size_t b = 0; b < buffers.size(); ++b)
+  {
+    if (!buffers[b].entries.empty())
+      new_entries = true;
+  }
+
+  // Build compressed row storage (unless there are no new entries)
+  if (new_entries)
+  {
+    const std::size_t num_rows = diagonal_offsets.size() - 1;
+    const std::pair<std::size_t, std::size_t> range1 = _local_range[primary_codim];
 
-        // Insert in diagonal or off-diagonal block
-        if (_local_range[primary_codim].first <= J && J < _local_range[primary_codim].second)
+    // Add entries from previous calls to apply()
+    if (!diagonal_columns.empty() || !off_diagonal_columns.empty())
+    {
+      std::vector<entry_type>& entries = buffers[0].entries;
+      for (std::size_t i = 0; i < num_rows; ++i)
+      {
+        for (std::size_t k = diagonal_offsets[i]; k < diagonal_offsets[i + 1]; ++k)
+          entries.push_back(entry_type(i, diagonal_columns[k]));
+        if (!off_diagonal_offsets.empty())
         {
-          dolfin_assert(I < diagonal.size());
-          diagonal[I].insert(J);
+          for (std::size_t k = off_diagonal_offsets[i]; k < off_diagonal_offsets[i + 1]; ++k)
+            entries.push_back(entry_type(i, off_diagonal_columns[k]));
         }
+      }
+    }
+
+    // Sort entries of each buffer and remove duplicates, and count
+    // buffers with entries (including those from previous calls)
+    std::size_t num_buffers_used = 0;
+    for (std::size_t b = 0; b < buffers.size(); ++b)
+    {
+      compress(buffers[b]);
+      if (!buffers[b].entries.empty())
+        ++num_buffers_used;
+    }
+
+    // Count number of entries in each row of the diagonal and
+    // off-diagonal blocks
+    std::fill(diagonal_offsets.begin(), diagonal_offsets.end(), 0);
+    std::fill(off_diagonal_offsets.begin(), off_diagonal_offsets.end(), 0);
+    for (std::size_t b = 0; b < buffers.size(); ++b)
+    {
+      const std::vector<entry_type>& entries = buffers[b].entries;
+      for (std::size_t k = 0; k < entries.size(); ++k)
+      {
+        const std::size_t I = entries[k].first;
+        const std::size_t J = entries[k].second;
+        dolfin_assert(I < num_rows);
+        if (range1.first <= J && J < range1.second)
+          ++diagonal_offsets[I + 1];
         else
         {
-          dolfin_assert(I < off_diagonal.size());
-          off_diagonal[I].insert(J);
+          dolfin_assert(distributed);
+          ++off_diagonal_offsets[I + 1];
         }
       }
     }
+    std::partial_sum(diagonal_offsets.begin(), diagonal_offsets.end(),
+                     diagonal_offsets.begin());
+    std::partial_sum(off_diagonal_offsets.begin(), off_diagonal_offsets.end(),
+                     off_diagonal_offsets.begin());
+
+    // Fill in columns
+    diagonal_columns.resize(diagonal_offsets.back());
+    off_diagonal_columns.resize(off_diagonal_offsets.empty() ? 0 : off_diagonal_offsets.back());
+    std::vector<std::size_t> diagonal_pos(diagonal_offsets.begin(),
+                                          diagonal_offsets.end() - 1);
+    std::vector<std::size_t> off_diagonal_pos(off_diagonal_offsets.begin(),
+                                              off_diagonal_offsets.end() - (distributed ? 1 : 0));
+    for (std::size_t b = 0; b < buffers.size(); ++b)
+    {
+      const std::vector<entry_type>& entries = buffers[b].entries;
+      for (std::size_t k = 0; k < entries.size(); ++k)
+      {
+        const std::size_t I = entries[k].first;
+        const std::size_t J = entries[k].second;
+        if (range1.first <= J && J < range1.second)
+          diagonal_columns[diagonal_pos[I]++] = J;
+        else
+          off_diagonal_columns[off_diagonal_pos[I]++] = J;
+      }
+
+      // Clear buffer
+      std::vector<entry_type>().swap(buffers[b].entries);
+      buffers[b].num_sorted = 0;
+    }
+
+    // Rows are sorted and without duplicates if all entries come from
+    // one buffer, otherwise sort rows and remove duplicates
+    if (num_buffers_used > 1)
+    {
+      sort_rows(diagonal_offsets, diagonal_columns);
+      if (distributed)
+        sort_rows(off_diagonal_offsets, off_diagonal_columns);
+    }
   }
 
-  // Clear non-local entries
-  non_local.clear();
+  // Print some useful information
+  if (get_log_level() <= DBG)
+    info_statistics(num_nonzeros_non_local);
 }
 //-----------------------------------------------------------------------------
 std::string SparsityPattern::str(bool verbose) const
 {
   // Print each row
   std::stringstream s;
-  typedef set_type::const_iterator entry_it;
-  for (std::size_t i = 0; i < diagonal.size(); i++)
+  const std::size_t num_rows = diagonal_offsets.empty() ? 0 : diagonal_offsets.size() - 1;
+  for (std::size_t i = 0; i < num_rows; i++)
   {
     if (primary_dim() == 0)
       s << "Row " << i << ":";
     else
       s << "Col " << i << ":";
 
-    for (entry_it entry = diagonal[i].begin(); entry != diagonal[i].end(); ++entry)
-      s << " " << *entry;
+    for (std::size_t k = diagonal_offsets[i]; k < diagonal_offsets[i + 1]; ++k)
+      s << " " << diagonal_columns[k];
     s << std::endl;
   }
 
@@ -392,14 +478,13 @@ std::string SparsityPattern::str(bool verbose) const
 //-----------------------------------------------------------------------------
 std::vector<std::vector<std::size_t> > SparsityPattern::diagonal_pattern(Type type) const
 {
-  std::vector<std::vector<std::size_t> > v(diagonal.size());
-  for (std::size_t i = 0; i < diagonal.size(); ++i)
-    v[i].insert(v[i].begin(), diagonal[i].begin(), diagonal[i].end());
-
-  if (type == sorted)
+  // Note: rows are always sorted
+  const std::size_t num_rows = diagonal_offsets.empty() ? 0 : diagonal_offsets.size() - 1;
+  std::vector<std::vector<std::size_t> > v(num_rows);
+  for (std::size_t i = 0; i < num_rows; ++i)
   {
-    for (std::size_t i = 0; i < v.size(); ++i)
-      std::sort(v[i].begin(), v[i].end());
+    v[i].assign(diagonal_columns.begin() + diagonal_offsets[i],
+                diagonal_columns.begin() + diagonal_offsets[i + 1]);
   }
 
   return v;
@@ -407,33 +492,62 @@ std::vector<std::vector<std::size_t> > SparsityPattern::diagonal_pattern(Type ty
 //-----------------------------------------------------------------------------
 std::vector<std::vector<std::size_t> > SparsityPattern::off_diagonal_pattern(Type type) const
 {
-  std::vector<std::vector<std::size_t> > v(off_diagonal.size());
-  for (std::size_t i = 0; i < off_diagonal.size(); ++i)
-    v[i].insert(v[i].begin(), off_diagonal[i].begin(), off_diagonal[i].end());
-
-  if (type == sorted)
+  // Note: rows are always sorted
+  const std::size_t num_rows = off_diagonal_offsets.empty() ? 0 : off_diagonal_offsets.size() - 1;
+  std::vector<std::vector<std::size_t> > v(num_rows);
+  for (std::size_t i = 0; i < num_rows; ++i)
   {
-    for (std::size_t i = 0; i < v.size(); ++i)
-      std::sort(v[i].begin(), v[i].end());
+    v[i].assign(off_diagonal_columns.begin() + off_diagonal_offsets[i],
+                off_diagonal_columns.begin() + off_diagonal_offsets[i + 1]);
   }
 
   return v;
 }
 //-----------------------------------------------------------------------------
-void SparsityPattern::info_statistics() const
+void SparsityPattern::compress(ThreadBuffer& buffer)
+{
+  std::vector<entry_type>& entries = buffer.entries;
+  dolfin_assert(buffer.num_sorted <= entries.size());
+  const std::vector<entry_type>::iterator middle
+    = entries.begin() + buffer.num_sorted;
+
+  // Sort new entries and remove duplicates
+  std::sort(middle, entries.end());
+  entries.erase(std::unique(middle, entries.end()), entries.end());
+
+  // Merge with previously sorted entries and remove duplicates
+  std::inplace_merge(entries.begin(), middle, entries.end());
+  entries.erase(std::unique(entries.begin(), entries.end()), entries.end());
+
+  buffer.num_sorted = entries.size();
+}
+//-----------------------------------------------------------------------------
+void SparsityPattern::sort_rows(std::vector<std::size_t>& offsets,
+                                std::vector<std::size_t>& columns)
+{
+  // Sort each row, remove duplicates and move row to its new
+  // (compressed) position
+  std::size_t pos = 0;
+  std::size_t begin = 0;
+  for (std::size_t i = 0; i + 1 < offsets.size(); ++i)
+  {
+    const std::size_t end = offsets[i + 1];
+    std::sort(columns.begin() + begin, columns.begin() + end);
+    const std::vector<std::size_t>::iterator last
+      = std::unique(columns.begin() + begin, columns.begin() + end);
+    pos = std::copy(columns.begin() + begin, last, columns.begin() + pos)
+      - columns.begin();
+    offsets[i + 1] = pos;
+    begin = end;
+  }
+  columns.resize(pos);
+}
+//-----------------------------------------------------------------------------
+void SparsityPattern::info_statistics(std::size_t num_nonzeros_non_local) const
 {
-  // Count nonzeros in diagonal block
-  std::size_t num_nonzeros_diagonal = 0;
-  for (std::size_t i = 0; i < diagonal.size(); ++i)
-    num_nonzeros_diagonal += diagonal[i].size();
-
-  // Count nonzeros in off-diagonal block
-  std::size_t num_nonzeros_off_diagonal = 0;
-  for (std::size_t i = 0; i < off_diagonal.size(); ++i)
-    num_nonzeros_off_diagonal += off_diagonal[i].size();
-
-  // Count nonzeros in non-local block
-  const std::size_t num_nonzeros_non_local = non_local.size()/2;
+  // Count nonzeros in diagonal and off-diagonal blocks
+  const std::size_t num_nonzeros_diagonal = diagonal_columns.size();
+  const std::size_t num_nonzeros_off_diagonal = off_diagonal_columns.size();
 
   // Count total number of nonzeros
   const std::size_t num_nonzeros_total
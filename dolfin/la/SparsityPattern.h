@@ -18,7 +18,7 @@
 // Modified by Anders Logg, 2007-2009.
 //
 // First added:  2007-03-13
-// Last changed: 2011-01-02
+// Last changed: 2026-10-16
 
 #ifndef __SPARSITY_PATTERN_H
 #define __SPARSITY_PATTERN_H
@@ -27,7 +27,6 @@
 #include <utility>
 #include <vector>
 
-#include "dolfin/common/Set.h"
 #include "dolfin/common/types.h"
 #include "GenericSparsityPattern.h"
 #include <boost/unordered_map.hpp>
@@ -37,15 +36,16 @@ namespace dolfin
 
   /// This class implements the GenericSparsityPattern interface.
   /// It is used by most linear algebra backends.
+  ///
+  /// Inserted entries are collected in one buffer per (OpenMP)
+  /// thread, such that insert() may be called concurrently. The
+  /// buffers are sorted and duplicates removed when they grow large
+  /// and when the pattern is finalized by apply(), which stores the
+  /// pattern in compressed row storage (CSR). The pattern may only
+  /// be accessed after apply() has been called.
 
   class SparsityPattern : public GenericSparsityPattern
   {
-
-    // NOTE: Do not change this typedef without performing careful
-    //       performance profiling
-    // Set type used for the rows of the sparsity pattern
-    typedef dolfin::Set<std::size_t> set_type;
-
   public:
 
     /// Create empty sparsity pattern
@@ -62,8 +62,13 @@ namespace dolfin
               const std::vector<std::pair<std::size_t, std::size_t> >& ownership_range,
               const std::vector<const boost::unordered_map<std::size_t, unsigned int>* > off_process_owner);
 
-    /// Insert non-zero entries
-    void insert(const std::vector<const std::vector<dolfin::la_index>* >& entries);
+    /// Insert non-zero entries. May be called concurrently from
+    /// multiple OpenMP threads.
+    void insert(const std::vector<ArrayView<const dolfin::la_index> >& entries);
+
+    /// Return true since insert() may be called concurrently
+    bool threaded_insert() const
+    { return true; }
 
     /// Add edges (vertex = [index, owning process])
     void add_edges(const std::pair<dolfin::la_index, std::size_t>& vertex,
@@ -110,8 +115,39 @@ namespace dolfin
 
   private:
 
+    // Entry [local primary index, index] inserted into pattern
+    typedef std::pair<std::size_t, std::size_t> entry_type;
+
+    // Entries inserted by one thread
+    class ThreadBuffer
+    {
+    public:
+
+      ThreadBuffer() : num_sorted(0) {}
+
+      // Local entries, sorted and without duplicates up to num_sorted
+      std::vector<entry_type> entries;
+      std::size_t num_sorted;
+
+      // Non-local entries stored as [i0, j0, i1, j1, ...]
+      std::vector<std::size_t> non_local;
+
+      // Padding to keep buffers of different threads on different
+      // cache lines
+      char padding[64];
+
+    };
+
+    // Sort entries of buffer and remove duplicates
+    static void compress(ThreadBuffer& buffer);
+
+    // Sort columns of each row of compressed row storage and remove
+    // duplicates
+    static void sort_rows(std::vector<std::size_t>& offsets,
+                          std::vector<std::size_t>& columns);
+
     // Print some useful information
-    void info_statistics() const;
+    void info_statistics(std::size_t num_nonzeros_non_local) const;
 
     // Indicate if sparsity pattern is distributed
     bool distributed;
@@ -119,12 +155,16 @@ namespace dolfin
     // Ownership range for each dimension
     std::vector<std::pair<std::size_t, std::size_t> > _local_range;
 
-    // Sparsity patterns for diagonal and off-diagonal blocks
-    std::vector<set_type> diagonal;
-    std::vector<set_type> off_diagonal;
+    // Sparsity patterns for diagonal and off-diagonal blocks in
+    // compressed row storage: the (sorted) entries of local row i are
+    // columns[offsets[i]], ..., columns[offsets[i + 1] - 1]
+    std::vector<std::size_t> diagonal_offsets;
+    std::vector<std::size_t> diagonal_columns;
+    std::vector<std::size_t> off_diagonal_offsets;
+    std::vector<std::size_t> off_diagonal_columns;
 
-    // Sparsity pattern for non-local entries stored as [i0, j0, i1, j1, ...]
-    std::vector<std::size_t> non_local;
+    // Entries inserted by each thread since last call to apply()
+    std::vector<ThreadBuffer> buffers;
 
     // Map from non-local vertex to owning process index
     std::vector<boost::unordered_map<std::size_t, unsigned int> > _off_process_owner;
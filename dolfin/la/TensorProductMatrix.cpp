@@ -16,26 +16,230 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2012-08-17
-// Last changed: 2012-08-17
+// Last changed: 2026-10-16
 
+#include <algorithm>
+#include <sstream>
+#include <dolfin/common/MPI.h>
+#include <dolfin/common/types.h>
+#include <dolfin/log/log.h>
+#include "GenericMatrix.h"
+#include "GenericVector.h"
+#include "TensorProductVector.h"
+#include "Vector.h"
 #include "TensorProductMatrix.h"
 
 using namespace dolfin;
 
 //-----------------------------------------------------------------------------
-TensorProductMatrix::TensorProductMatrix(std::size_t num_factors)
+TensorProductMatrix::TensorProductMatrix(const std::vector<boost::shared_ptr<const GenericMatrix> >& factors)
+  : LinearOperator(Vector(tensor_size(factors, 1)),
+                   Vector(tensor_size(factors, 0)))
 {
+  const std::size_t num_factors = factors.size();
+  _rows.resize(num_factors);
+  _cols.resize(num_factors);
+  _factors.resize(num_factors);
 
+  // Copy factors to dense storage
+  std::vector<std::size_t> columns;
+  std::vector<double> values;
+  for (std::size_t k = 0; k < num_factors; k++)
+  {
+    dolfin_assert(factors[k]);
+    const GenericMatrix& B = *factors[k];
+    const std::size_t m = B.size(0);
+    const std::size_t n = B.size(1);
+    _rows[k] = m;
+    _cols[k] = n;
+
+    // Copy local rows
+    std::vector<double>& F = _factors[k];
+    F.resize(m*n, 0.0);
+    const std::pair<std::size_t, std::size_t> range = B.local_range(0);
+    for (std::size_t i = range.first; i < range.second; i++)
+    {
+      B.getrow(i, columns, values);
+      for (std::size_t j = 0; j < columns.size(); j++)
+        F[i*n + columns[j]] = values[j];
+    }
+
+    // Add rows from other processes
+    if (MPI::num_processes() > 1)
+    {
+      std::vector<std::vector<double> > all_values;
+      MPI::all_gather(F, all_values);
+      std::fill(F.begin(), F.end(), 0.0);
+      for (std::size_t p = 0; p < all_values.size(); p++)
+      {
+        dolfin_assert(all_values[p].size() == F.size());
+        for (std::size_t i = 0; i < F.size(); i++)
+          F[i] += all_values[p][i];
+      }
+    }
+  }
 }
 //-----------------------------------------------------------------------------
-std::string TensorProductMatrix::str(bool verbose) const
+std::size_t TensorProductMatrix::size(std::size_t dim) const
 {
-  return "test";
+  dolfin_assert(dim < 2);
+  const std::vector<std::size_t>& dims = (dim == 0 ? _rows : _cols);
+  std::size_t size = dims.empty() ? 0 : 1;
+  for (std::size_t k = 0; k < dims.size(); k++)
+    size *= dims[k];
+  return size;
 }
 //-----------------------------------------------------------------------------
 void TensorProductMatrix::mult(const TensorProductVector& x,
                                TensorProductVector& y) const
 {
+  // Check dimensions
+  if (x.dims() != _cols)
+  {
+    dolfin_error("TensorProductMatrix.cpp",
+                 "compute tensor product matrix-vector product",
+                 "Non-matching dimensions of tensor product matrix and vector");
+  }
+
+  // Resize y if necessary
+  if (y.dims() != _rows)
+    y = TensorProductVector(_rows);
+
+  mult(x.values(), y.values());
+}
+//-----------------------------------------------------------------------------
+void TensorProductMatrix::mult(const GenericVector& x, GenericVector& y) const
+{
+  // Check dimensions
+  const std::size_t M = size(0);
+  const std::size_t N = size(1);
+  if (x.size() != N)
+  {
+    dolfin_error("TensorProductMatrix.cpp",
+                 "compute tensor product matrix-vector product",
+                 "Vector size (%d) does not match matrix size (%d)",
+                 x.size(), N);
+  }
+
+  // Get all values of x (on all processes)
+  std::vector<double> x_values;
+  if (MPI::num_processes() > 1)
+  {
+    std::vector<la_index> indices(N);
+    for (std::size_t i = 0; i < N; i++)
+      indices[i] = i;
+    x.gather(x_values, indices);
+  }
+  else
+    x.get_local(x_values);
+
+  // Compute product
+  std::vector<double> y_values;
+  mult(x_values, y_values);
+
+  // Resize y if necessary
+  if (y.size() != M)
+    y.resize(M);
+
+  // Set local values of y
+  const std::pair<std::size_t, std::size_t> range = y.local_range();
+  const std::vector<double> y_local(y_values.begin() + range.first,
+                                   y_values.begin() + range.second);
+  y.set_local(y_local);
+  y.apply("insert");
+}
+//-----------------------------------------------------------------------------
+std::string TensorProductMatrix::str(bool verbose) const
+{
+  std::stringstream s;
+
+  s << "<TensorProductMatrix of dimension ";
+  for (std::size_t k = 0; k < _factors.size(); k++)
+    s << (k > 0 ? " x " : "") << "(" << _rows[k] << ", " << _cols[k] << ")";
+  s << ">";
+
+  if (verbose)
+  {
+    s << std::endl;
+    for (std::size_t k = 0; k < _factors.size(); k++)
+    {
+      s << std::endl << "  Factor " << k << ":" << std::endl;
+      for (std::size_t i = 0; i < _rows[k]; i++)
+      {
+        s << "   ";
+        for (std::size_t j = 0; j < _cols[k]; j++)
+          s << " " << _factors[k][i*_cols[k] + j];
+        s << std::endl;
+      }
+    }
+  }
+
+  return s.str();
+}
+//-----------------------------------------------------------------------------
+void TensorProductMatrix::mult(const std::vector<double>& x,
+                               std::vector<double>& y) const
+{
+  dolfin_assert(x.size() == size(1));
+  const std::size_t num_factors = _factors.size();
+
+  // Multiply with one factor at a time. Before multiplication with
+  // factor k, the tensor has shape m_0 x ... x m_{k - 1} x n_k x ...
+  // x n_{d - 1} (rows of previous factors, columns of the rest).
+  y = x;
+  std::vector<double> w;
+  std::size_t pre = 1;
+  for (std::size_t k = 0; k < num_factors; k++)
+  {
+    std::size_t post = 1;
+    for (std::size_t l = k + 1; l < num_factors; l++)
+      post *= _cols[l];
 
+    w.resize(pre*_rows[k]*post);
+    contract(_factors[k], _rows[k], _cols[k], pre, post, &y[0], &w[0]);
+    y.swap(w);
+
+    pre *= _rows[k];
+  }
+}
+//-----------------------------------------------------------------------------
+void TensorProductMatrix::contract(const std::vector<double>& F,
+                                   std::size_t m, std::size_t n,
+                                   std::size_t pre, std::size_t post,
+                                   const double* x, double* y)
+{
+  // Compute y_piq = F_ij x_pjq
+  for (std::size_t p = 0; p < pre; p++)
+  {
+    const double* xp = x + p*n*post;
+    double* yp = y + p*m*post;
+    for (std::size_t i = 0; i < m; i++)
+    {
+      double* yi = yp + i*post;
+      std::fill(yi, yi + post, 0.0);
+      for (std::size_t j = 0; j < n; j++)
+      {
+        const double Fij = F[i*n + j];
+        if (Fij == 0.0)
+          continue;
+        const double* xj = xp + j*post;
+        for (std::size_t q = 0; q < post; q++)
+          yi[q] += Fij*xj[q];
+      }
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+std::size_t
+TensorProductMatrix::tensor_size(const std::vector<boost::shared_ptr<const GenericMatrix> >& factors,
+                                 std::size_t dim)
+{
+  std::size_t size = factors.empty() ? 0 : 1;
+  for (std::size_t k = 0; k < factors.size(); k++)
+  {
+    dolfin_assert(factors[k]);
+    size *= factors[k]->size(dim);
+  }
+  return size;
 }
 //-----------------------------------------------------------------------------
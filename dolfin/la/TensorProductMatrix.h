@@ -16,21 +16,25 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2012-08-17
-// Last changed: 2012-08-17
+// Last changed: 2026-10-16
 
 #ifndef __TENSOR_PRODUCT_MATRIX_H
 #define __TENSOR_PRODUCT_MATRIX_H
 
 #include <cstddef>
 #include <string>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include "LinearOperator.h"
 
 namespace dolfin
 {
 
   // Forward declarations
+  class GenericMatrix;
+  class GenericVector;
   class TensorProductVector;
 
-
   /// A _TensorProductMatrix_ is a matrix expressed as a tensor
   /// product (outer product) of a list of matrices:
   ///
@@ -44,25 +48,80 @@ namespace dolfin
   ///   (A a)_ikm = A_ijklmn a_jln
   ///
   /// where a is a _TensorProductVector_ with elements a_jln.
+  ///
+  /// The product is computed by sum factorization, i.e., by
+  /// successive multiplication with each factor along the
+  /// corresponding index, which for d factors of size n x n costs
+  /// O(n^{d + 1}) operations instead of O(n^{2d}) for the assembled
+  /// matrix. Zero entries of the factors are skipped, so sparse
+  /// (e.g. tridiagonal) factors are cheaper still.
+  ///
+  /// A _TensorProductMatrix_ is a _LinearOperator_ and may be passed
+  /// to Krylov solvers for matrix-free solution of linear systems.
+  /// Plain vectors are then interpreted as tensor product vectors,
+  /// i.e., with the ordering of the Kronecker product B x C x D.
+  /// Note that this is in general not the ordering of degrees of
+  /// freedom of a function space on a box mesh.
+  ///
+  /// Multiplication does not modify the matrix, so several threads
+  /// may multiply with the same _TensorProductMatrix_ at the same
+  /// time.
 
-  // FIXME: Either inherit from PETScLinearOperator or a common interface
-
-  class TensorProductMatrix
+  class TensorProductMatrix : public LinearOperator
   {
   public:
 
-    /// Create tensor product matrix with given number of factors
-    TensorProductMatrix(std::size_t num_factors);
+    /// Create tensor product matrix from list of factors. The
+    /// factors are copied (to dense storage).
+    ///
+    /// *Arguments*
+    ///     factors (std::vector<boost::shared_ptr<const _GenericMatrix_> >)
+    ///         The factors B, C, D, ... of the tensor product.
+    TensorProductMatrix(const std::vector<boost::shared_ptr<const GenericMatrix> >& factors);
 
     /// Destructor
     virtual ~TensorProductMatrix() {}
 
-    /// Return informal string representation (pretty-print)
-    std::string str(bool verbose) const;
+    /// Return number of factors
+    std::size_t num_factors() const
+    { return _factors.size(); }
+
+    /// Return size of given dimension
+    std::size_t size(std::size_t dim) const;
 
     /// Compute matrix-vector product y = Ax
     void mult(const TensorProductVector& x, TensorProductVector& y) const;
 
+    /// Compute matrix-vector product y = Ax
+    void mult(const GenericVector& x, GenericVector& y) const;
+
+    /// Return informal string representation (pretty-print)
+    std::string str(bool verbose) const;
+
+  private:
+
+    // Compute y = Ax for flattened tensor product vectors
+    void mult(const std::vector<double>& x, std::vector<double>& y) const;
+
+    // Multiply m x n factor F with index of size n of a tensor of
+    // shape pre x n x post
+    static void contract(const std::vector<double>& F,
+                         std::size_t m, std::size_t n,
+                         std::size_t pre, std::size_t post,
+                         const double* x, double* y);
+
+    // Return product of sizes of factors in given dimension
+    static std::size_t
+    tensor_size(const std::vector<boost::shared_ptr<const GenericMatrix> >& factors,
+                std::size_t dim);
+
+    // Dimensions of factors
+    std::vector<std::size_t> _rows;
+    std::vector<std::size_t> _cols;
+
+    // Factors (dense, row-major)
+    std::vector<std::vector<double> > _factors;
+
   };
 
 }
@@ -16,20 +16,54 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2012-08-17
-// Last changed: 2012-08-17
+// Last changed: 2026-10-16
 
+#include <algorithm>
+#include <sstream>
+#include <dolfin/log/log.h>
 #include "TensorProductVector.h"
 
 using namespace dolfin;
 
 //-----------------------------------------------------------------------------
 TensorProductVector::TensorProductVector(const std::vector<std::size_t>& dims)
+  : _dims(dims)
 {
+  // Compute total size
+  std::size_t size = dims.empty() ? 0 : 1;
+  for (std::size_t i = 0; i < dims.size(); i++)
+    size *= dims[i];
 
+  _values.resize(size, 0.0);
+}
+//-----------------------------------------------------------------------------
+std::size_t TensorProductVector::dim(std::size_t i) const
+{
+  dolfin_assert(i < _dims.size());
+  return _dims[i];
+}
+//-----------------------------------------------------------------------------
+void TensorProductVector::zero()
+{
+  std::fill(_values.begin(), _values.end(), 0.0);
 }
 //-----------------------------------------------------------------------------
 std::string TensorProductVector::str(bool verbose) const
 {
-  return "test";
+  std::stringstream s;
+
+  s << "<TensorProductVector of dimension ";
+  for (std::size_t i = 0; i < _dims.size(); i++)
+    s << (i > 0 ? " x " : "") << _dims[i];
+  s << ">";
+
+  if (verbose)
+  {
+    s << std::endl;
+    for (std::size_t i = 0; i < _values.size(); i++)
+      s << "  " << i << ": " << _values[i] << std::endl;
+  }
+
+  return s.str();
 }
 //-----------------------------------------------------------------------------
@@ -16,10 +16,10 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2012-08-17
-// Last changed: 2012-08-17
+// Last changed: 2026-10-16
 
-#ifndef __TENSOR_PRODUCT_MATRIX_H
-#define __TENSOR_PRODUCT_MATRIX_H
+#ifndef __TENSOR_PRODUCT_VECTOR_H
+#define __TENSOR_PRODUCT_VECTOR_H
 
 #include <cstddef>
 #include <string>
@@ -28,39 +28,74 @@
 namespace dolfin
 {
 
-  // Forward declarations
-  class TensorProductVector;
-
-
-  /// A _TensorProductVector_ is a vector expressed as a tensor
-  /// product (outer product) of a list of matrices:
-  ///
-  ///   A_ijklmn... = B_ij C_kl D_mn ...
+  /// A _TensorProductVector_ is a vector with elements indexed by a
+  /// multi-index, one index for each factor of a tensor product
+  /// space:
   ///
-  /// The tensor rank is twice the number of factors in the tensor
-  /// product. A _TensorProductVector_ can be multiplied with a
-  /// _TensorProductVector_. The matrix-vector multiplication is
-  /// defined by
+  ///   a_jln...
   ///
-  ///   (A a)_ikm = A_ijklmn a_jln
-  ///
-  /// where a is a _TensorProductVector_ with elements a_jln.
-
-  // FIXME: Either inherit from PETScKrylovVector or a common interface
+  /// The elements are stored contiguously with the last index
+  /// running fastest, i.e., a_jln is stored at position
+  /// (j*n_1 + l)*n_2 + n for dimensions (n_0, n_1, n_2). This is the
+  /// ordering used by the Kronecker product of matrices (see
+  /// _TensorProductMatrix_).
 
   class TensorProductVector
   {
   public:
 
-    /// Create tensor product vector with given dimensions
+    /// Create tensor product vector with given dimensions (one
+    /// dimension for each factor). All elements are set to zero.
     TensorProductVector(const std::vector<std::size_t>& dims);
 
     /// Destructor
     virtual ~TensorProductVector() {}
 
+    /// Return number of factors
+    std::size_t num_factors() const
+    { return _dims.size(); }
+
+    /// Return dimension of given factor
+    std::size_t dim(std::size_t i) const;
+
+    /// Return dimensions of all factors
+    const std::vector<std::size_t>& dims() const
+    { return _dims; }
+
+    /// Return total number of elements
+    std::size_t size() const
+    { return _values.size(); }
+
+    /// Return element i (in the flattened ordering)
+    double& operator[] (std::size_t i)
+    { return _values[i]; }
+
+    /// Return element i (in the flattened ordering, const version)
+    const double& operator[] (std::size_t i) const
+    { return _values[i]; }
+
+    /// Return array of elements
+    std::vector<double>& values()
+    { return _values; }
+
+    /// Return array of elements (const version)
+    const std::vector<double>& values() const
+    { return _values; }
+
+    /// Set all elements to zero
+    void zero();
+
     /// Return informal string representation (pretty-print)
     std::string str(bool verbose) const;
 
+  private:
+
+    // Dimensions of factors
+    std::vector<std::size_t> _dims;
+
+    // Elements
+    std::vector<double> _values;
+
   };
 
 }
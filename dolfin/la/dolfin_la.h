@@ -41,6 +41,7 @@
 #include <dolfin/la/PaStiXLUSolver.h>
 
 #include <dolfin/la/STLMatrix.h>
+#include <dolfin/la/CSRMatrix.h>
 #include <dolfin/la/CoordinateMatrix.h>
 #include <dolfin/la/uBLASVector.h>
 #include <dolfin/la/PETScVector.h>
@@ -54,6 +55,7 @@
 #include <dolfin/la/PETScCuspFactory.h>
 #include <dolfin/la/EpetraFactory.h>
 #include <dolfin/la/STLFactory.h>
+#include <dolfin/la/CSRFactory.h>
 #include <dolfin/la/SLEPcEigenSolver.h>
 #include <dolfin/la/TrilinosPreconditioner.h>
 #include <dolfin/la/uBLASSparseMatrix.h>
@@ -16,7 +16,7 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2006-07-04
-// Last changed: 2006-07-04
+// Last changed: 2026-10-16
 
 #ifndef __UBLAS_DUMMY_PRECONDITIONER_H
 #define __UBLAS_DUMMY_PRECONDITIONER_H
@@ -42,6 +42,9 @@ namespace dolfin
     /// Initialise preconditioner (dense matrix)
     void init(const uBLASMatrix<ublas_sparse_matrix>& A) {}
 
+    /// Initialise preconditioner (CSR matrix)
+    void init(const CSRMatrix& A) {}
+
     /// Initialise preconditioner (virtual matrix)
     void init(const uBLASLinearOperator& A) {}
 
@@ -16,17 +16,47 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // Modified by Anders Logg, 2006-2010.
+// Modified by agent, 2026
 //
 // First added:  2006-06-23
-// Last changed: 2010-08-31
+// Last changed: 2026-10-16
 
+#include <algorithm>
+#include <cmath>
 #include <dolfin/common/constants.h>
+#include <dolfin/common/Timer.h>
+#include <dolfin/parameter/GlobalParameters.h>
+#include "CSRMatrix.h"
 #include "uBLASVector.h"
 #include "uBLASSparseMatrix.h"
 #include "uBLASILUPreconditioner.h"
 
 using namespace dolfin;
 
+// Default minimum average number of rows per level for
+// level-scheduled (threaded) triangular solves
+static const std::size_t default_min_rows_per_level = 256;
+
+//-----------------------------------------------------------------------------
+// Group rows in levels, given the level of each row (counting sort)
+static void group_levels(std::vector<std::size_t>& level_offsets,
+                         std::vector<std::size_t>& rows,
+                         const std::vector<std::size_t>& levels)
+{
+  const std::size_t num_levels
+    = levels.empty() ? 0 : *std::max_element(levels.begin(), levels.end()) + 1;
+  level_offsets.assign(num_levels + 1, 0);
+  for (std::size_t i = 0; i < levels.size(); ++i)
+    ++level_offsets[levels[i] + 1];
+  for (std::size_t l = 0; l < num_levels; ++l)
+    level_offsets[l + 1] += level_offsets[l];
+
+  std::vector<std::size_t> position(level_offsets.begin(),
+                                    level_offsets.end() - 1);
+  rows.resize(levels.size());
+  for (std::size_t i = 0; i < levels.size(); ++i)
+    rows[position[levels[i]]++] = i;
+}
 //-----------------------------------------------------------------------------
 uBLASILUPreconditioner::uBLASILUPreconditioner(const Parameters& krylov_parameters)
   : parameters(krylov_parameters)
@@ -41,144 +71,221 @@ uBLASILUPreconditioner::~uBLASILUPreconditioner()
 //-----------------------------------------------------------------------------
 void uBLASILUPreconditioner::init(const uBLASMatrix<ublas_sparse_matrix>& P)
 {
-  ublas_sparse_matrix& _M = M.mat();
+  // Copy compressed row storage
+  const ublas_sparse_matrix& A = P.mat();
+  const std::size_t size = A.size1();
+  const std::size_t nnz = A.index1_data()[size];
+  _row_offsets.assign(A.index1_data().begin(),
+                      A.index1_data().begin() + size + 1);
+  _columns.assign(A.index2_data().begin(), A.index2_data().begin() + nnz);
+  _values.assign(A.value_data().begin(), A.value_data().begin() + nnz);
 
-  const std::size_t size = P.size(0);
-  _M.resize(size, size, false);
-  _M.assign(P.mat());
+  factorize();
+}
+//-----------------------------------------------------------------------------
+void uBLASILUPreconditioner::init(const CSRMatrix& P)
+{
+  // Expand blocks to (scalar) compressed row storage
+  P.expand(_row_offsets, _columns, _values);
 
-  // Add term to diagonal to avoid negative pivots
-  const double zero_shift = parameters("preconditioner")["shift_nonzero"];
-  if(zero_shift > 0.0)
-    _M.plus_assign( zero_shift*ublas::identity_matrix<double>(size) );
-
-  /*
-  // Straightforward and very slow implementation. This is used for verification
-  tic();
-  M.assign(A);
-  for(std::size_t i=1; i < size; ++i)
+  factorize();
+}
+//-----------------------------------------------------------------------------
+void uBLASILUPreconditioner::solve(uBLASVector& x, const uBLASVector& b) const
+{
+  const std::size_t size = _diagonal.size();
+  dolfin_assert(size > 0);
+  dolfin_assert(x.size() == size);
+  dolfin_assert(b.size() == size);
+
+  // Solve in-place
+  double* _x = x.data();
+  const double* _b = b.data();
+  std::copy(_b, _b + size, _x);
+
+  const std::size_t* offsets = &_row_offsets[0];
+  const std::size_t* columns = &_columns[0];
+  const double* values = &_values[0];
+  const std::size_t* diagonal = &_diagonal[0];
+
+  // Use level-scheduled solves if levels are large enough to be
+  // worth sharing between threads
+  const std::size_t num_threads = dolfin::parameters["num_threads"];
+  std::size_t min_rows_per_level = default_min_rows_per_level;
+  if (parameters("preconditioner")("ilu").has_key("min_rows_per_level"))
+    min_rows_per_level = parameters("preconditioner")("ilu")["min_rows_per_level"];
+  const std::size_t num_levels
+    = std::max(_lower_levels.size(), _upper_levels.size()) - 1;
+  if (num_threads > 1 && size >= min_rows_per_level*num_levels)
   {
-    for(std::size_t k=0; k < i; ++k)
+    const std::size_t* lower_levels = &_lower_levels[0];
+    const std::size_t* lower_rows = &_lower_rows[0];
+    const std::size_t* upper_levels = &_upper_levels[0];
+    const std::size_t* upper_rows = &_upper_rows[0];
+    const std::size_t num_lower_levels = _lower_levels.size() - 1;
+    const std::size_t num_upper_levels = _upper_levels.size() - 1;
+
+    #ifdef HAS_OPENMP
+    #pragma omp parallel num_threads(num_threads)
+    #endif
     {
-     if( fabs( M(i,k) ) > 0.0 )
+      // Forward substitution (unit lower triangular)
+      for (std::size_t l = 0; l < num_lower_levels; ++l)
       {
-        M(i,k) = M(i,k)/M(k,k);
-        for(std::size_t j=k+1; j < size; ++j)
+        const int begin = lower_levels[l];
+        const int end = lower_levels[l + 1];
+        #ifdef HAS_OPENMP
+        #pragma omp for schedule(static)
+        #endif
+        for (int p = begin; p < end; ++p)
         {
-          if( fabs( M(i,j) ) > DOLFIN_EPS )
-              M(i,j) = M(i,j) - M(i,k)*M(k,j);
+          const std::size_t i = lower_rows[p];
+          double sum = _x[i];
+          for (std::size_t k = offsets[i]; k < diagonal[i]; ++k)
+            sum -= values[k]*_x[columns[k]];
+          _x[i] = sum;
+        }
+      }
+
+      // Backward substitution
+      for (std::size_t l = 0; l < num_upper_levels; ++l)
+      {
+        const int begin = upper_levels[l];
+        const int end = upper_levels[l + 1];
+        #ifdef HAS_OPENMP
+        #pragma omp for schedule(static)
+        #endif
+        for (int p = begin; p < end; ++p)
+        {
+          const std::size_t i = upper_rows[p];
+          double sum = _x[i];
+          for (std::size_t k = diagonal[i] + 1; k < offsets[i + 1]; ++k)
+            sum -= values[k]*_x[columns[k]];
+          _x[i] = sum/values[diagonal[i]];
         }
       }
     }
+    return;
   }
-  */
 
-  // This approach using uBLAS iterators is simple and quite fast.
-  // Is it possible to remove the M(.,.) calls? This would speed it up a lot.
+  // Perform substitutions for compressed row storage in natural order
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    double sum = _x[i];
+    for (std::size_t k = offsets[i]; k < diagonal[i]; ++k)
+      sum -= values[k]*_x[columns[k]];
+    _x[i] = sum;
+  }
+  for (std::size_t i = size; i-- > 0; )
+  {
+    double sum = _x[i];
+    for (std::size_t k = diagonal[i] + 1; k < offsets[i + 1]; ++k)
+      sum -= values[k]*_x[columns[k]];
+    _x[i] = sum/values[diagonal[i]];
+  }
+}
+//-----------------------------------------------------------------------------
+void uBLASILUPreconditioner::factorize()
+{
+  Timer timer("ILU factorization");
+
+  const std::size_t size = _row_offsets.size() - 1;
+  const std::size_t npos = std::size_t(-1);
 
-  /*
-  // Sparse matrix iterators
-  typedef uBLASMatrix<ublas_sparse_matrix>::iterator1 it1;
-  typedef uBLASMatrix<ublas_sparse_matrix>::iterator2 it2;
-  it2 ij;
-  for (it1 i1 = M.begin1(); i1 != M.end1(); ++i1)  // iterate over rows  i=0 -> size
+  // Locate diagonal entries (columns are sorted within rows)
+  _diagonal.resize(size);
+  for (std::size_t i = 0; i < size; ++i)
   {
-    for (it2 ik = i1.begin(); ik.index2() <  ik.index1(); ++ik) // move along row k=0 -> i
+    std::vector<std::size_t>::const_iterator begin
+      = _columns.begin() + _row_offsets[i];
+    std::vector<std::size_t>::const_iterator end
+      = _columns.begin() + _row_offsets[i + 1];
+    std::vector<std::size_t>::const_iterator it = std::lower_bound(begin, end, i);
+    if (it == end || *it != i)
     {
-      *ik /= M(ik.index2(),ik.index2());    // M(i,k) = M(i,k)/M(k,k)
-      ij=ik;
-      ++ij;
-      for( ; ij != i1.end(); ++ij)                  // over j=k+1 -> size
-        *ij -=  (*ik)*M(ik.index2(), ij.index2());  // M(i,j) = M(i,j) - M(i,k)*M(k, j)
+      dolfin_error("uBLASILUPreconditioner.cpp",
+                   "initialize uBLAS ILU preconditioner",
+                   "Zero pivot detected in row %u", i);
     }
+    _diagonal[i] = it - _columns.begin();
+  }
+
+  // Add term to diagonal to avoid negative pivots
+  const double zero_shift = parameters("preconditioner")["shift_nonzero"];
+  if (zero_shift > 0.0)
+  {
+    for (std::size_t i = 0; i < size; ++i)
+      _values[_diagonal[i]] += zero_shift;
   }
-  */
 
   // The below algorithm is based on that in the book
   // Y. Saad, "Iterative Methods for Sparse Linear Systems", p.276-278.
   // It is specific to compressed row storage
 
-  // Initialise some data
-  diagonal.resize(size);
-  diagonal[0] = 0;
+  // Working array: position of column in current row
+  std::vector<std::size_t> iw(size, npos);
 
-  std::vector<std::size_t> iw(size);
-  for(std::size_t i=0; i< size; ++i)
-    iw[i] = 0;
-
-  std::size_t j0=0, j1=0, j=0, jrow=0, jw=0;
-  double t1;
-
-  for (std::size_t k = 0; k < size ; ++k)        // i (rows)
+  for (std::size_t k = 0; k < size; ++k)
   {
-    j0 = _M.index1_data () [k];    // ia
-    j1 = _M.index1_data () [k+1]-1;
+    const std::size_t j0 = _row_offsets[k];
+    const std::size_t j1 = _row_offsets[k + 1];
 
     // Initialise working array iw
-    for (std::size_t i = j0;  i <= j1; ++i)
-      iw[ _M.index2_data () [i] ] = i;  // ja
+    for (std::size_t i = j0; i < j1; ++i)
+      iw[_columns[i]] = i;
 
-    // Move along row looking for diagonal
-    j=j0;
-    while(j <= j1)
+    // Eliminate entries left of diagonal
+    for (std::size_t j = j0; j < _diagonal[k]; ++j)
     {
-      jrow = _M.index2_data () [j];  // ja
-
-      if( jrow >= k ) // passed or found diagonal, therefore break
-        break;
-
-      t1 = (_M.value_data() [j])/(_M.value_data() [ diagonal[jrow] ]);  //M(k,j) = M(k,j)/M(j,j)
-      _M.value_data() [j] = t1;
-      for(std::size_t jj = diagonal[jrow]+1; jj <= _M.index1_data () [jrow+1]-1; ++jj)
+      const std::size_t jrow = _columns[j];
+      const double t1 = _values[j]/_values[_diagonal[jrow]];
+      _values[j] = t1;
+      for (std::size_t jj = _diagonal[jrow] + 1; jj < _row_offsets[jrow + 1]; ++jj)
       {
-        jw = iw[ _M.index2_data () [jj] ];
-        if(jw != 0)
-          _M.value_data() [jw] = _M.value_data() [jw] -t1*(_M.value_data() [jj]);
-      } // jj
-      ++j;
+        const std::size_t jw = iw[_columns[jj]];
+        if (jw != npos)
+          _values[jw] -= t1*_values[jj];
+      }
     }
-    diagonal[k] = j;
 
-    if (jrow != k || fabs( _M.value_data() [j] ) < DOLFIN_EPS)
+    if (std::abs(_values[_diagonal[k]]) < DOLFIN_EPS)
     {
       dolfin_error("uBLASILUPreconditioner.cpp",
                    "initialize uBLAS ILU preconditioner",
                    "Zero pivot detected in row %u", k);
     }
 
-    for(std::size_t i=j0; i <= j1; ++i)
-      iw[ _M.index2_data () [i] ] = 0;
-  } // k
+    for (std::size_t i = j0; i < j1; ++i)
+      iw[_columns[i]] = npos;
+  }
+
+  compute_levels();
 }
 //-----------------------------------------------------------------------------
-void uBLASILUPreconditioner::solve(uBLASVector& x, const uBLASVector& b) const
+void uBLASILUPreconditioner::compute_levels()
 {
-  // Get uderlying uBLAS matrices and vectors
-  ublas_vector& _x = x.vec();
-  const ublas_vector& _b = b.vec();
-  const ublas_sparse_matrix & _M = M.mat();
-
-  dolfin_assert(_M.size1() > 0 && _M.size2() > 0);
-  dolfin_assert( _x.size() == _M.size1() );
-  dolfin_assert( _x.size() == _b.size());
+  const std::size_t size = _diagonal.size();
+  std::vector<std::size_t> levels(size);
 
-  // Solve in-place
-  _x.assign(_b);
-
-  // Perform substutions for compressed row storage. This is the fastest.
-  const std::size_t size = _M.size1();
-  for(std::size_t i =0; i < size; ++i)
+  // Level of row in L is one more than the highest level of the rows
+  // it depends on
+  for (std::size_t i = 0; i < size; ++i)
   {
-    std::size_t k;
-    for(k = _M.index1_data () [i]; k < diagonal[i]; ++k)
-      _x(i) -= ( _M.value_data () [k] )*x[ _M.index2_data () [k] ];
+    std::size_t level = 0;
+    for (std::size_t k = _row_offsets[i]; k < _diagonal[i]; ++k)
+      level = std::max(level, levels[_columns[k]] + 1);
+    levels[i] = level;
   }
-  for(int i =size-1; i >= 0; --i)
+  group_levels(_lower_levels, _lower_rows, levels);
+
+  // Same for U, starting from the last row
+  for (std::size_t i = size; i-- > 0; )
   {
-    std::size_t k;
-    for(k = _M.index1_data () [i+1]-1; k > diagonal[i]; --k)
-      _x(i) -= ( _M.value_data () [k] )*x[ _M.index2_data () [k] ];
-    _x(i) /= ( _M.value_data () [k] );
+    std::size_t level = 0;
+    for (std::size_t k = _diagonal[i] + 1; k < _row_offsets[i + 1]; ++k)
+      level = std::max(level, levels[_columns[k]] + 1);
+    levels[i] = level;
   }
+  group_levels(_upper_levels, _upper_rows, levels);
 }
 //-----------------------------------------------------------------------------
@@ -16,13 +16,15 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // Modified by Anders Logg 2006.
+// Modified by agent, 2026
 //
 // First added:  2006-06-23
-// Last changed: 2009-07-03
+// Last changed: 2026-10-16
 
 #ifndef __UBLAS_ILU_PRECONDITIONER_H
 #define __UBLAS_ILU_PRECONDITIONER_H
 
+#include <vector>
 #include "ublas.h"
 #include "uBLASPreconditioner.h"
 #include "uBLASMatrix.h"
@@ -31,10 +33,19 @@ namespace dolfin
 {
 
   template<typename Mat> class uBLASMatrix;
+  class CSRMatrix;
   class uBLASVector;
 
-  /// This class implements an incomplete LU factorization (ILU)
+  /// This class implements an incomplete LU factorization (ILU(0))
   /// preconditioner for the uBLAS Krylov solver.
+  ///
+  /// The factors are stored in compressed row storage. When more than
+  /// one thread is used (global parameter "num_threads"), the
+  /// triangular solves are level scheduled: the rows of each factor
+  /// are grouped in levels of mutually independent rows which are
+  /// solved in parallel. Level scheduling is only used if the levels
+  /// have on average at least "min_rows_per_level" rows (Krylov
+  /// solver parameter "preconditioner" -> "ilu", default 256).
 
   class uBLASILUPreconditioner : public uBLASPreconditioner
   {
@@ -46,19 +57,35 @@ namespace dolfin
     /// Destructor
     ~uBLASILUPreconditioner();
 
-    // Initialize preconditioner
+    /// Initialize preconditioner (uBLAS sparse matrix)
     void init(const uBLASMatrix<ublas_sparse_matrix>& P);
 
+    /// Initialize preconditioner (CSR matrix, possibly blocked)
+    void init(const CSRMatrix& P);
+
     /// Solve linear system Ax = b approximately
     void solve(uBLASVector& x, const uBLASVector& b) const;
 
   private:
 
-    // Preconditioner matrix (factorised)
-    uBLASMatrix<ublas_sparse_matrix> M;
+    // Compute factorization in place and levels for triangular solves
+    void factorize();
+
+    // Group rows in levels for the triangular solves
+    void compute_levels();
+
+    // Factorized matrix (L and U in compressed row storage, L with
+    // unit diagonal not stored)
+    std::vector<std::size_t> _row_offsets;
+    std::vector<std::size_t> _columns;
+    std::vector<double> _values;
+
+    // Position of diagonal entry in each row
+    std::vector<std::size_t> _diagonal;
 
-    // Diagonal
-    std::vector<std::size_t> diagonal;
+    // Rows of L and U grouped by level (offsets into rows)
+    std::vector<std::size_t> _lower_levels, _lower_rows;
+    std::vector<std::size_t> _upper_levels, _upper_rows;
 
     const Parameters& parameters;
 
@@ -16,13 +16,15 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // Modified by Anders Logg 2006-2012
+// Modified by agent, 2026
 //
 // First added:  2006-05-31
-// Last changed: 2012-05-07
+// Last changed: 2026-10-16
 
 #include <boost/assign/list_of.hpp>
 #include <dolfin/common/NoDeleter.h>
 #include <dolfin/log/LogStream.h>
+#include "CSRMatrix.h"
 #include "uBLASILUPreconditioner.h"
 #include "uBLASDummyPreconditioner.h"
 #include "uBLASKrylovSolver.h"
@@ -54,6 +56,11 @@ Parameters uBLASKrylovSolver::default_parameters()
 {
   Parameters p(KrylovSolver::default_parameters());
   p.rename("ublas_krylov_solver");
+
+  // Minimum average number of rows per level for level-scheduled
+  // (threaded) ILU triangular solves
+  p("preconditioner")("ilu").add("min_rows_per_level", 256);
+
   return p;
 }
 //-----------------------------------------------------------------------------
@@ -110,6 +117,21 @@ std::size_t uBLASKrylovSolver::solve(GenericVector& x, const GenericVector& b)
                         *P);
   }
 
+  // Try native compressed row storage
+  if (has_type<const CSRMatrix>(*_A))
+  {
+    boost::shared_ptr<const CSRMatrix> A = as_type<const CSRMatrix>(_A);
+    boost::shared_ptr<const CSRMatrix> P = as_type<const CSRMatrix>(_P);
+
+    dolfin_assert(A);
+    dolfin_assert(P);
+
+    return solve_krylov(*A,
+                        as_type<uBLASVector>(x),
+                        as_type<const uBLASVector>(b),
+                        *P);
+  }
+
   // If that fails, try to use it as a uBLAS linear operator
   if (has_type<const uBLASLinearOperator>(*_A))
   {
@@ -600,7 +600,7 @@ namespace dolfin
 
     // Add entries
     std::vector<std::vector<std::size_t> >::const_iterator row;
-    Set<std::size_t>::const_iterator element;
+    std::vector<std::size_t>::const_iterator element;
     for(row = pattern.begin(); row != pattern.end(); ++row)
       for(element = row->begin(); element != row->end(); ++element)
         _A.push_back(row - pattern.begin(), *element, 0.0);
@@ -16,9 +16,10 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // Modified by Anders Logg 2006-2011
+// Modified by agent, 2026
 //
 // First added:  2006-06-23
-// Last changed: 2011-11-11
+// Last changed: 2026-10-16
 
 #ifndef __UBLAS_PRECONDITIONER_H
 #define __UBLAS_PRECONDITIONER_H
@@ -28,6 +29,7 @@
 namespace dolfin
 {
 
+  class CSRMatrix;
   class uBLASVector;
   class uBLASLinearOperator;
   template<typename Mat> class uBLASMatrix;
@@ -61,6 +63,14 @@ namespace dolfin
                    "No init() function for preconditioner uBLASMatrix<ublas_dense_matrix>");
     }
 
+    /// Initialise preconditioner (CSR matrix)
+    virtual void init(const CSRMatrix& P)
+    {
+      dolfin_error("uBLASPreconditioner",
+                   "initialize uBLAS preconditioner",
+                   "No init() function for preconditioner CSRMatrix");
+    }
+
     /// Initialise preconditioner (virtual matrix)
     virtual void init(const uBLASLinearOperator& P)
     {
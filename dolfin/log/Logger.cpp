@@ -19,7 +19,7 @@
 // Modified by Garth N. Wells, 2011.
 //
 // First added:  2003-03-13
-// Last changed: 2013-04-18
+// Last changed: 2026-10-16
 
 #include <unistd.h>
 #include <iomanip>
@@ -28,6 +28,7 @@
 #include <fstream>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 #include <boost/thread.hpp>
 #include <boost/bind.hpp>
@@ -40,6 +41,7 @@
 
 #include <dolfin/common/constants.h>
 #include <dolfin/common/MPI.h>
+#include <dolfin/common/Profiler.h>
 #include <dolfin/parameter/GlobalParameters.h>
 #include "LogLevel.h"
 #include "Logger.h"
@@ -245,7 +247,8 @@ void Logger::set_log_level(int log_level)
   _log_level = log_level;
 }
 //-----------------------------------------------------------------------------
-void Logger::register_timing(std::string task, double elapsed_time)
+void Logger::register_timing(std::string task, double elapsed_time,
+                             std::size_t num_timings)
 {
   // Remove small or negative numbers
   if (elapsed_time < DOLFIN_EPS)
@@ -260,18 +263,21 @@ void Logger::register_timing(std::string task, double elapsed_time)
   map_iterator it = _timings.find(task);
   if (it == _timings.end())
   {
-    std::pair<std::size_t, double> timing(1, elapsed_time);
+    std::pair<std::size_t, double> timing(num_timings, elapsed_time);
     _timings[task] = timing;
   }
   else
   {
-    it->second.first += 1;
+    it->second.first += num_timings;
     it->second.second += elapsed_time;
   }
 }
 //-----------------------------------------------------------------------------
 void Logger::list_timings(bool reset)
 {
+  // Collect timings from profiler
+  Profiler::flush();
+
   // Check if timings are empty
   if (_timings.empty())
   {
@@ -296,6 +302,9 @@ void Logger::list_timings(bool reset)
 //-----------------------------------------------------------------------------
 Table Logger::timings(bool reset)
 {
+  // Collect timings from profiler
+  Profiler::flush();
+
   // Generate timing table
   Table table("Summary of timings");
   for (const_map_iterator it = _timings.begin(); it != _timings.end(); ++it)
@@ -319,6 +328,9 @@ Table Logger::timings(bool reset)
 //-----------------------------------------------------------------------------
 double Logger::timing(std::string task, bool reset)
 {
+  // Collect timings from profiler
+  Profiler::flush();
+
   // Find timing
   map_iterator it = _timings.find(task);
   if (it == _timings.end())
@@ -341,6 +353,91 @@ double Logger::timing(std::string task, bool reset)
   return average_time;
 }
 //-----------------------------------------------------------------------------
+void Logger::dump_timings(std::string filename)
+{
+  // Collect timings from profiler
+  Profiler::flush();
+
+  // Check format
+  const bool json = filename.size() > 5
+    && filename.substr(filename.size() - 5) == ".json";
+  const bool csv = filename.size() > 4
+    && filename.substr(filename.size() - 4) == ".csv";
+  if (!json && !csv)
+  {
+    std::stringstream line;
+    line << "Unknown file format for \"" << filename
+         << "\" (expecting suffix .json or .csv)";
+    dolfin_error("Logger.cpp",
+                 "dump timings",
+                 line.str());
+  }
+
+  std::ofstream file(filename.c_str());
+  if (!file.good())
+  {
+    std::stringstream line;
+    line << "Unable to open file \"" << filename << "\"";
+    dolfin_error("Logger.cpp",
+                 "dump timings",
+                 line.str());
+  }
+  file << std::setprecision(16);
+
+  // Write header
+  if (json)
+    file << "{\n  \"timings\": [";
+  else
+    file << "task,reps,total_time,average_time\n";
+
+  // Write timings. Nested tasks (from the profiler) are named
+  // "parent > child" and written with the path as a list in JSON.
+  for (const_map_iterator it = _timings.begin(); it != _timings.end(); ++it)
+  {
+    const std::size_t num_timings = it->second.first;
+    const double total_time = it->second.second;
+    const double average_time = total_time / static_cast<double>(num_timings);
+
+    if (json)
+    {
+      // Split task into path
+      std::vector<std::string> path;
+      std::size_t start = 0;
+      std::size_t end = 0;
+      while ((end = it->first.find(" > ", start)) != std::string::npos)
+      {
+        path.push_back(it->first.substr(start, end - start));
+        start = end + 3;
+      }
+      path.push_back(it->first.substr(start));
+
+      file << (it == _timings.begin() ? "\n" : ",\n")
+           << "    {\"task\": \"" << json_escape(it->first) << "\", \"path\": [";
+      for (std::size_t i = 0; i < path.size(); ++i)
+        file << (i > 0 ? ", " : "") << "\"" << json_escape(path[i]) << "\"";
+      file << "], \"reps\": " << num_timings
+           << ", \"total_time\": " << total_time
+           << ", \"average_time\": " << average_time << "}";
+    }
+    else
+    {
+      // Quote task and escape quotes
+      std::string task;
+      for (std::size_t i = 0; i < it->first.size(); ++i)
+      {
+        if (it->first[i] == '"')
+          task += '"';
+        task += it->first[i];
+      }
+      file << "\"" << task << "\"," << num_timings << "," << total_time
+           << "," << average_time << "\n";
+    }
+  }
+
+  if (json)
+    file << "\n  ]\n}\n";
+}
+//-----------------------------------------------------------------------------
 void Logger::monitor_memory_usage()
 {
   #ifndef __linux__
@@ -423,3 +520,15 @@ void Logger::write(int log_level, std::string msg) const
   *logstream << msg << std::endl;
 }
 //----------------------------------------------------------------------------
+std::string Logger::json_escape(std::string s)
+{
+  std::string escaped;
+  for (std::size_t i = 0; i < s.size(); ++i)
+  {
+    if (s[i] == '"' || s[i] == '\\')
+      escaped += '\\';
+    escaped += s[i];
+  }
+  return escaped;
+}
+//----------------------------------------------------------------------------
@@ -20,7 +20,7 @@
 // Modified by Ola Skavhaug 2007, 2009
 //
 // First added:  2003-03-13
-// Last changed: 2013-01-07
+// Last changed: 2026-10-16
 
 #ifndef __LOGGER_H
 #define __LOGGER_H
@@ -97,8 +97,10 @@ namespace dolfin
     /// Get log level
     inline int get_log_level() const { return _log_level; }
 
-    /// Register timing (for later summary)
-    void register_timing(std::string task, double elapsed_time);
+    /// Register timing (for later summary). If num_timings > 1, then
+    /// elapsed_time is the total time of num_timings timings.
+    void register_timing(std::string task, double elapsed_time,
+                         std::size_t num_timings=1);
 
     /// Return a summary of timings and tasks as a Table, optionally clearing
     /// stored timings
@@ -110,6 +112,10 @@ namespace dolfin
     /// Return timing (average) for given task, optionally clearing timing for task
     double timing(std::string task, bool reset=false);
 
+    /// Write timings to file in JSON (suffix .json) or CSV (suffix
+    /// .csv) format
+    void dump_timings(std::string filename);
+
     /// Monitor memory usage. Call this function at the start of a
     /// program to continuously monitor the memory usage of the process.
     void monitor_memory_usage();
@@ -129,6 +135,9 @@ namespace dolfin
     // Write message
     void write(int log_level, std::string msg) const;
 
+    // Escape string for output in JSON format
+    static std::string json_escape(std::string s);
+
     // True iff logging is active
     bool _active;
 
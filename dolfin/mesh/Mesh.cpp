@@ -26,7 +26,7 @@
 // Modified by Jan Blechta 2013
 //
 // First added:  2006-05-09
-// Last changed: 2013-04-18
+// Last changed: 2026-10-16
 
 #include <dolfin/ale/ALE.h>
 #include <dolfin/common/Array.h>
@@ -345,9 +345,9 @@ void Mesh::move(const GenericFunction& displacement)
   ALE::move(*this, displacement);
 }
 //-----------------------------------------------------------------------------
-void Mesh::smooth(std::size_t num_iterations)
+void Mesh::smooth(std::size_t num_iterations, bool quality_weighted)
 {
-  MeshSmoothing::smooth(*this, num_iterations);
+  MeshSmoothing::smooth(*this, num_iterations, quality_weighted);
 }
 //-----------------------------------------------------------------------------
 void Mesh::smooth_boundary(std::size_t num_iterations, bool harmonic_smoothing)
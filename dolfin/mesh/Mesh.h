@@ -26,7 +26,7 @@
 // Modified by Jan Blechta 2013
 //
 // First added:  2006-05-08
-// Last changed: 2013-05-23
+// Last changed: 2026-10-16
 
 #ifndef __MESH_H
 #define __MESH_H
@@ -476,7 +476,11 @@ namespace dolfin
     ///     num_iterations (std::size_t)
     ///         Number of iterations to perform smoothing,
     ///         default value is 1.
-    void smooth(std::size_t num_iterations=1);
+    ///     quality_weighted (bool)
+    ///         Flag to scale the movement of each vertex by the
+    ///         quality of the surrounding cells, default value is
+    ///         false.
+    void smooth(std::size_t num_iterations=1, bool quality_weighted=false);
 
     /// Smooth boundary vertices of mesh by local averaging.
     ///
@@ -21,7 +21,7 @@
 // Modified by Garth N. Wells 2011-2012
 //
 // First added:  2008-12-01
-// Last changed: 2013-04-20
+// Last changed: 2026-10-16
 
 #include <algorithm>
 #include <iterator>
@@ -369,9 +369,8 @@ void MeshPartitioning::build_mesh(Mesh& mesh,
 {
   Timer timer("PARALLEL 3: Build mesh (from local mesh data)");
 
-  // Get number of processes and process number
+  // Get number of processes
   const std::size_t num_processes = MPI::num_processes();
-  const std::size_t process_number = MPI::process_number();
 
   // Open mesh for editing
   mesh.clear();
@@ -421,15 +420,10 @@ void MeshPartitioning::build_mesh(Mesh& mesh,
   const MeshFunction<std::size_t>& boundary_vertex_map = bmesh.entity_map(0);
   const std::size_t boundary_size = boundary_vertex_map.size();
 
-  // Build sorted array of global boundary vertex indices (global
-  // numbering)
+  // Build array of global boundary vertex indices (global numbering)
   std::vector<std::size_t> global_vertex_send(boundary_size);
   for (std::size_t i = 0; i < boundary_size; ++i)
     global_vertex_send[i] = vertex_indices[boundary_vertex_map[i]];
-  std::sort(global_vertex_send.begin(), global_vertex_send.end());
-
-  // Receive buffer
-  std::vector<std::size_t> global_vertex_recv;
 
   // Create shared_vertices data structure: mapping from shared vertices
   // to list of neighboring processes
@@ -437,42 +431,95 @@ void MeshPartitioning::build_mesh(Mesh& mesh,
         = mesh.topology().shared_entities(0);
   shared_vertices.clear();
 
-  // FIXME: Remove computation from inside communication loop
-
   // Build shared vertex to sharing processes map
-  for (std::size_t i = 1; i < num_processes; ++i)
+  if (num_processes > 1)
+  {
+    compute_shared_vertices(global_vertex_send, vertex_global_to_local,
+                            num_global_vertices, shared_vertices);
+  }
+}
+//-----------------------------------------------------------------------------
+void MeshPartitioning::compute_shared_vertices(
+  const std::vector<std::size_t>& global_vertex_indices,
+  const std::map<std::size_t, std::size_t>& vertex_global_to_local,
+  std::size_t num_global_vertices,
+  std::map<unsigned int, std::set<unsigned int> >& shared_vertices)
+{
+  Timer timer("PARALLEL 3b: Compute shared vertices");
+
+  const std::size_t num_processes = MPI::num_processes();
+
+  // Send global vertex indices to the rendezvous process for each
+  // vertex (the process owning the global index)
+  std::vector<std::vector<std::size_t> > send_buffer(num_processes);
+  for (std::size_t i = 0; i < global_vertex_indices.size(); ++i)
+  {
+    const std::size_t global_index = global_vertex_indices[i];
+    send_buffer[MPI::index_owner(global_index, num_global_vertices)].push_back(global_index);
+  }
+  std::vector<std::vector<std::size_t> > recv_buffer;
+  MPI::all_to_all(send_buffer, recv_buffer);
+
+  // Collect (global index, process) for the received vertices and
+  // sort by global index
+  std::vector<std::pair<std::size_t, std::size_t> > vertex_processes;
+  for (std::size_t p = 0; p < recv_buffer.size(); ++p)
+  {
+    for (std::size_t i = 0; i < recv_buffer[p].size(); ++i)
+      vertex_processes.push_back(std::make_pair(recv_buffer[p][i], p));
+  }
+  std::sort(vertex_processes.begin(), vertex_processes.end());
+
+  // For each vertex received from more than one process, send to each
+  // of these processes the global index, the number of other
+  // processes and the other processes
+  for (std::size_t p = 0; p < num_processes; ++p)
+    send_buffer[p].clear();
+  std::vector<std::pair<std::size_t, std::size_t> >::const_iterator
+    begin = vertex_processes.begin();
+  while (begin != vertex_processes.end())
+  {
+    std::vector<std::pair<std::size_t, std::size_t> >::const_iterator end = begin;
+    while (end != vertex_processes.end() && end->first == begin->first)
+      ++end;
+
+    const std::size_t num_sharing = end - begin;
+    if (num_sharing > 1)
+    {
+      std::vector<std::pair<std::size_t, std::size_t> >::const_iterator it, other;
+      for (it = begin; it != end; ++it)
+      {
+        std::vector<std::size_t>& buffer = send_buffer[it->second];
+        buffer.push_back(begin->first);
+        buffer.push_back(num_sharing - 1);
+        for (other = begin; other != end; ++other)
+        {
+          if (other != it)
+            buffer.push_back(other->second);
+        }
+      }
+    }
+    begin = end;
+  }
+  MPI::all_to_all(send_buffer, recv_buffer);
+
+  // Fill shared vertices information
+  for (std::size_t p = 0; p < recv_buffer.size(); ++p)
   {
-    // We send data to process p - i (i steps to the left)
-    const int p = (process_number - i + num_processes) % num_processes;
-
-    // We receive data from process p + i (i steps to the right)
-    const int q = (process_number + i) % num_processes;
-
-    // Send and receive
-    MPI::send_recv(global_vertex_send, p, global_vertex_recv, q);
-
-    // Compute intersection of global indices
-    std::vector<std::size_t> intersection(std::min(global_vertex_send.size(),
-                                                   global_vertex_recv.size()));
-    std::vector<std::size_t>::iterator intersection_end
-      = std::set_intersection(global_vertex_send.begin(),
-                              global_vertex_send.end(),
-                              global_vertex_recv.begin(),
-                              global_vertex_recv.end(),
-                              intersection.begin());
-
-    // Fill shared vertices information
-    std::vector<std::size_t>::const_iterator global_index;
-    for (global_index = intersection.begin(); global_index != intersection_end;
-         ++global_index)
+    const std::vector<std::size_t>& buffer = recv_buffer[p];
+    std::size_t i = 0;
+    while (i < buffer.size())
     {
       // Get local index
       std::map<std::size_t, std::size_t>::const_iterator local_index;
-      local_index = vertex_global_to_local.find(*global_index);
+      local_index = vertex_global_to_local.find(buffer[i]);
       dolfin_assert(local_index != vertex_global_to_local.end());
 
       // Insert (local index, [proc])
-      shared_vertices[local_index->second].insert(q);
+      std::set<unsigned int>& processes = shared_vertices[local_index->second];
+      const std::size_t num_other = buffer[i + 1];
+      processes.insert(buffer.begin() + i + 2, buffer.begin() + i + 2 + num_other);
+      i += 2 + num_other;
     }
   }
 }
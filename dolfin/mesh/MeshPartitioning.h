@@ -20,7 +20,7 @@
 // Modified by Kent-Andre Mardal, 2011
 //
 // First added:  2008-12-01
-// Last changed: 2012-12-24
+// Last changed: 2026-10-16
 
 #ifndef __MESH_PARTITIONING_H
 #define __MESH_PARTITIONING_H
@@ -111,6 +111,16 @@ namespace dolfin
                    std::size_t tdim, std::size_t gdim, std::size_t num_global_cells,
                    std::size_t num_global_vertices);
 
+    // Compute processes sharing each of the given (boundary) vertices
+    // (global indices). Each vertex is sent to the process owning its
+    // global index (rendezvous process), which returns the list of
+    // processes that sent it.
+    static void compute_shared_vertices(
+      const std::vector<std::size_t>& global_vertex_indices,
+      const std::map<std::size_t, std::size_t>& vertex_global_to_local_indices,
+      std::size_t num_global_vertices,
+      std::map<unsigned int, std::set<unsigned int> >& shared_vertices);
+
     // Create and attach distributed MeshDomains from local_data
     static void build_mesh_domains(Mesh& mesh,
                                    const LocalMeshData& local_data);
@@ -18,17 +18,22 @@
 // Modified by Garth N. Wells, 2010
 //
 // First added:  2008-07-16
-// Last changed: 2011-03-17
+// Last changed: 2026-10-16
 
+#include <algorithm>
+#include <cmath>
 #include <dolfin/ale/ALE.h>
 #include <dolfin/common/Array.h>
+#include <dolfin/common/Timer.h>
 #include <dolfin/common/constants.h>
+#include <dolfin/parameter/GlobalParameters.h>
 #include "Mesh.h"
 #include "BoundaryMesh.h"
 #include "Vertex.h"
 #include "Edge.h"
 #include "Facet.h"
 #include "Cell.h"
+#include "MeshConnectivity.h"
 #include "MeshData.h"
 #include "SubDomain.h"
 #include "MeshSmoothing.h"
@@ -36,108 +41,109 @@
 using namespace dolfin;
 
 //-----------------------------------------------------------------------------
-void MeshSmoothing::smooth(Mesh& mesh, std::size_t num_iterations)
+void MeshSmoothing::smooth(Mesh& mesh, std::size_t num_iterations,
+                           bool quality_weighted)
 {
   log(PROGRESS, "Smoothing mesh");
+  Timer timer("Mesh smoothing");
 
-  // Make sure we have cell-facet connectivity
-  mesh.init(mesh.topology().dim(), mesh.topology().dim() - 1);
-
-  // Make sure we have vertex-edge connectivity
-  mesh.init(0, 1);
+  const std::size_t D = mesh.topology().dim();
+  const std::size_t gdim = mesh.geometry().dim();
+  const int num_vertices = mesh.num_vertices();
+  const int num_cells = mesh.num_cells();
 
   // Make sure the mesh is ordered
   mesh.order();
 
+  // Compute connectivity needed for the boundary and the cell
+  // inradius (before entering threaded regions)
+  mesh.init(D - 1, D);
+  mesh.init(D, D - 1);
+  mesh.init(0, D);
+
   // Mark vertices on the boundary so we may skip them
-  BoundaryMesh boundary(mesh, "exterior");
-  const MeshFunction<std::size_t> vertex_map = boundary.entity_map(0);
-  MeshFunction<bool> on_boundary(mesh, 0);
-  on_boundary = false;
-  if (boundary.num_vertices() > 0)
-  {
-    for (VertexIterator v(boundary); !v.end(); ++v)
-      on_boundary[vertex_map[*v]] = true;
-  }
+  std::vector<bool> on_boundary;
+  mark_boundary_vertices(on_boundary, mesh);
 
-  // Iterate over all vertices
-  const std::size_t d = mesh.geometry().dim();
-  std::vector<double> xx(d);
+  // Compute vertex-vertex adjacency
+  std::vector<std::size_t> offsets, neighbors;
+  compute_adjacency(offsets, neighbors, mesh);
+
+  const MeshConnectivity& vertex_cells = mesh.topology()(0, D);
+  std::vector<double>& x = mesh.geometry().x();
+  std::vector<double> x_new(x);
+  std::vector<double> inradius(num_cells);
+  std::vector<double> quality(quality_weighted ? num_cells : 0);
+
+  const std::size_t num_threads = dolfin::parameters["num_threads"];
   for (std::size_t iteration = 0; iteration < num_iterations; iteration++)
   {
-    for (VertexIterator v(mesh); !v.end(); ++v)
+    #ifdef HAS_OPENMP
+    #pragma omp parallel num_threads(std::max(num_threads, (std::size_t) 1))
+    #endif
     {
-      // Skip vertices on the boundary
-      if (on_boundary[*v])
-        continue;
-
-      // Get coordinates of vertex
-      double* x = mesh.geometry().x(v->index());
-      const Point p = v->point();
-
-      // Compute center of mass of neighboring vertices
-      for (std::size_t i = 0; i < d; i++) xx[i] = 0.0;
-      std::size_t num_neighbors = 0;
-      for (EdgeIterator e(*v); !e.end(); ++e)
+      // Compute size (and quality) of cells
+      #ifdef HAS_OPENMP
+      #pragma omp for schedule(static)
+      #endif
+      for (int c = 0; c < num_cells; c++)
       {
-        // Get the other vertex
-        dolfin_assert(e->num_entities(0) == 2);
-        std::size_t other_index = e->entities(0)[0];
-        if (other_index == v->index())
-          other_index = e->entities(0)[1];
-
-        // Create the vertex
-        Vertex vn(mesh, other_index);
-
-        // Skip the vertex itself
-        if (v->index() == vn.index())
-          continue;
-        num_neighbors += 1;
-
-        // Compute center of mass
-        const double* xn = vn.x();
-        for (std::size_t i = 0; i < d; i++)
-          xx[i] += xn[i];
+        const Cell cell(mesh, c);
+        inradius[c] = cell.inradius();
+        if (quality_weighted)
+          quality[c] = cell.radius_ratio();
       }
-      for (std::size_t i = 0; i < d; i++)
-        xx[i] /= static_cast<double>(num_neighbors);
 
-      // Compute closest distance to boundary of star
-      double rmin = 0.0;
-      for (CellIterator c(*v); !c.end(); ++c)
+      // Compute new coordinates of interior vertices
+      #ifdef HAS_OPENMP
+      #pragma omp for schedule(static)
+      #endif
+      for (int v = 0; v < num_vertices; v++)
       {
-        // Get local number of vertex relative to facet
-        const std::size_t local_vertex = c->index(*v);
-
-        // Get normal of corresponding facet
-        Point n = c->normal(local_vertex);
+        if (on_boundary[v] || offsets[v] == offsets[v + 1])
+          continue;
 
-        // Get first vertex in facet
-        Facet f(mesh, c->entities(mesh.topology().dim() - 1)[local_vertex]);
-        VertexIterator fv(f);
+        // Compute center of mass of neighboring vertices
+        double xx[3] = {0.0, 0.0, 0.0};
+        for (std::size_t k = offsets[v]; k < offsets[v + 1]; k++)
+        {
+          const double* xn = &x[neighbors[k]*gdim];
+          for (std::size_t i = 0; i < gdim; i++)
+            xx[i] += xn[i];
+        }
+        const double num_neighbors = offsets[v + 1] - offsets[v];
+        for (std::size_t i = 0; i < gdim; i++)
+          xx[i] /= num_neighbors;
 
-        // Compute length of projection of v - fv onto normal
-        const double r = std::abs(n.dot(p - fv->point()));
-        if (rmin == 0.0)
-          rmin = r;
-        else
-          rmin = std::min(rmin, r);
-      }
+        // Compute smallest inradius (and quality) of cells around vertex
+        const unsigned int* cells = vertex_cells(v);
+        double rmin = inradius[cells[0]];
+        double qmin = quality_weighted ? quality[cells[0]] : 0.0;
+        for (std::size_t k = 1; k < vertex_cells.size(v); k++)
+        {
+          rmin = std::min(rmin, inradius[cells[k]]);
+          if (quality_weighted)
+            qmin = std::min(qmin, quality[cells[k]]);
+        }
 
-      // Move vertex at most a distance rmin / 2
-      double r = 0.0;
-      for (std::size_t i = 0; i < d; i++)
-      {
-        const double dx = xx[i] - x[i];
-        r += dx*dx;
+        // Move vertex towards center of mass, at most a distance rmin / 2
+        const double* x_v = &x[v*gdim];
+        double r = 0.0;
+        for (std::size_t i = 0; i < gdim; i++)
+        {
+          const double dx = xx[i] - x_v[i];
+          r += dx*dx;
+        }
+        r = std::sqrt(r);
+        if (r < DOLFIN_EPS)
+          continue;
+        const double step = std::min(0.5*rmin, (1.0 - qmin)*r);
+        for (std::size_t i = 0; i < gdim; i++)
+          x_new[v*gdim + i] = x_v[i] + step*(xx[i] - x_v[i])/r;
       }
-      r = std::sqrt(r);
-      if (r < DOLFIN_EPS)
-        continue;
-      rmin = std::min(0.5*rmin, r);
-      for (std::size_t i = 0; i < d; i++)
-        x[i] += rmin*(xx[i] - x[i])/r;
     }
+
+    x = x_new;
   }
 
   if (num_iterations > 1)
@@ -205,3 +211,89 @@ void MeshSmoothing::move_interior_vertices(Mesh& mesh,
   }
 }
 //-----------------------------------------------------------------------------
+void MeshSmoothing::compute_adjacency(std::vector<std::size_t>& offsets,
+                                      std::vector<std::size_t>& neighbors,
+                                      const Mesh& mesh)
+{
+  // For simplices, the neighbours of a vertex (vertices sharing an
+  // edge) are the other vertices of the cells containing it
+  const std::size_t D = mesh.topology().dim();
+  const MeshConnectivity& vertex_cells = mesh.topology()(0, D);
+  const MeshConnectivity& cell_vertices = mesh.topology()(D, 0);
+  const int num_vertices = mesh.num_vertices();
+
+  const std::size_t num_threads = dolfin::parameters["num_threads"];
+  offsets.assign(num_vertices + 1, 0);
+
+  // Collect neighbours in two passes: count, then fill
+  for (std::size_t pass = 0; pass < 2; pass++)
+  {
+    if (pass == 1)
+    {
+      for (int v = 0; v < num_vertices; v++)
+        offsets[v + 1] += offsets[v];
+      neighbors.resize(offsets[num_vertices]);
+    }
+
+    #ifdef HAS_OPENMP
+    #pragma omp parallel num_threads(std::max(num_threads, (std::size_t) 1))
+    #endif
+    {
+      std::vector<std::size_t> vertices;
+
+      #ifdef HAS_OPENMP
+      #pragma omp for schedule(static)
+      #endif
+      for (int v = 0; v < num_vertices; v++)
+      {
+        vertices.clear();
+        const unsigned int* cells = vertex_cells(v);
+        for (std::size_t k = 0; k < vertex_cells.size(v); k++)
+        {
+          const unsigned int* cv = cell_vertices(cells[k]);
+          for (std::size_t j = 0; j < cell_vertices.size(cells[k]); j++)
+          {
+            if (cv[j] != (unsigned int) v)
+              vertices.push_back(cv[j]);
+          }
+        }
+        std::sort(vertices.begin(), vertices.end());
+        vertices.erase(std::unique(vertices.begin(), vertices.end()),
+                       vertices.end());
+
+        if (pass == 0)
+          offsets[v + 1] = vertices.size();
+        else
+          std::copy(vertices.begin(), vertices.end(),
+                    neighbors.begin() + offsets[v]);
+      }
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+void MeshSmoothing::mark_boundary_vertices(std::vector<bool>& on_boundary,
+                                           const Mesh& mesh)
+{
+  // Boundary facets are connected to exactly one cell (globally)
+  const std::size_t D = mesh.topology().dim();
+  const MeshConnectivity& facet_cells = mesh.topology()(D - 1, D);
+
+  on_boundary.assign(mesh.num_vertices(), false);
+  for (std::size_t f = 0; f < mesh.num_entities(D - 1); f++)
+  {
+    if (facet_cells.size(f) != 1 || facet_cells.size_global(f) != 1)
+      continue;
+
+    // Facets are vertices for intervals
+    if (D == 1)
+      on_boundary[f] = true;
+    else
+    {
+      const MeshConnectivity& facet_vertices = mesh.topology()(D - 1, 0);
+      const unsigned int* vertices = facet_vertices(f);
+      for (std::size_t i = 0; i < facet_vertices.size(f); i++)
+        on_boundary[vertices[i]] = true;
+    }
+  }
+}
+//-----------------------------------------------------------------------------
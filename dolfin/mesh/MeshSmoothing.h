@@ -16,25 +16,54 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2008-07-16
-// Last changed: 2010-03-02
+// Last changed: 2026-10-16
 
 #ifndef __MESH_SMOOTHING_H
 #define __MESH_SMOOTHING_H
 
+#include <vector>
+
 namespace dolfin
 {
 
+  class BoundaryMesh;
   class Mesh;
   class SubDomain;
 
   /// This class implements various mesh smoothing algorithms.
+  ///
+  /// Laplacian smoothing is performed by Jacobi sweeps: all vertices
+  /// are moved simultaneously, based on the coordinates from the
+  /// previous sweep, so that each sweep may be computed in parallel
+  /// using the number of threads given by the global parameter
+  /// "num_threads". The vertex-vertex adjacency is computed once from
+  /// the cells of the mesh (which must be simplices) and reused for
+  /// all iterations.
 
   class MeshSmoothing
   {
   public:
 
     /// Smooth internal vertices of mesh by local averaging
-    static void smooth(Mesh& mesh, std::size_t num_iterations=1);
+    ///
+    /// *Arguments*
+    ///     mesh (_Mesh_)
+    ///         The mesh to be smoothed.
+    ///     num_iterations (std::size_t)
+    ///         Number of smoothing iterations (sweeps).
+    ///     quality_weighted (bool)
+    ///         If true, the step of each vertex towards the average of
+    ///         its neighbours is scaled by 1 - q, where q is the
+    ///         smallest radius ratio of the cells containing the
+    ///         vertex, so that well-shaped regions of the mesh are
+    ///         left (almost) unchanged.
+    ///
+    /// Each vertex is moved at most half the smallest inradius of
+    /// the cells containing it, which guarantees that no cell is
+    /// inverted even though neighbouring vertices move
+    /// simultaneously.
+    static void smooth(Mesh& mesh, std::size_t num_iterations=1,
+                       bool quality_weighted=false);
 
     /// Smooth boundary vertices of mesh by local averaging and
     /// (optionally) use harmonic smoothing on interior vertices
@@ -50,6 +79,16 @@ namespace dolfin
 
   private:
 
+    // Compute vertex-vertex adjacency (compressed row storage) from
+    // the vertices of the cells
+    static void compute_adjacency(std::vector<std::size_t>& offsets,
+                                  std::vector<std::size_t>& neighbors,
+                                  const Mesh& mesh);
+
+    // Mark vertices on the (global) exterior boundary of the mesh
+    static void mark_boundary_vertices(std::vector<bool>& on_boundary,
+                                       const Mesh& mesh);
+
     // Move interior vertices
     static void move_interior_vertices(Mesh& mesh,
                                        BoundaryMesh& boundary,
@@ -18,10 +18,9 @@
 // Modified by Niclas Jansson 2009.
 //
 // First added:  2007-04-24
-// Last changed: 2011-08-31
+// Last changed: 2026-10-16
 
 #include <dolfin/common/Array.h>
-#include <dolfin/common/RangedIndexSet.h>
 #include <dolfin/log/log.h>
 #include "Mesh.h"
 #include "MeshData.h"
@@ -30,6 +29,7 @@
 #include "Vertex.h"
 #include "MeshFunction.h"
 #include "MeshValueCollection.h"
+#include "Point.h"
 #include "SubDomain.h"
 
 using namespace dolfin;
@@ -54,6 +54,19 @@ bool SubDomain::inside(const Array<double>& x, bool on_boundary) const
   return false;
 }
 //-----------------------------------------------------------------------------
+void SubDomain::inside(std::vector<bool>& is_inside, const Array<double>& x,
+                       bool on_boundary) const
+{
+  dolfin_assert(is_inside.size() > 0);
+  dolfin_assert(x.size() % is_inside.size() == 0);
+  const std::size_t gdim = x.size()/is_inside.size();
+  for (std::size_t i = 0; i < is_inside.size(); ++i)
+  {
+    const Array<double> _x(gdim, const_cast<double*>(x.data()) + i*gdim);
+    is_inside[i] = inside(_x, on_boundary);
+  }
+}
+//-----------------------------------------------------------------------------
 void SubDomain::map(const Array<double>& x, Array<double>& y) const
 {
   dolfin_error("SubDomain.cpp",
@@ -166,79 +179,13 @@ void SubDomain::apply_markers(S& sub_domains,
 {
   log(TRACE, "Computing sub domain markers for sub domain %d.", sub_domain);
 
-  // Get the dimension of the entities we are marking
-  const std::size_t dim = sub_domains.dim();
-
-  // Compute facet - cell connectivity if necessary
-  const std::size_t D = mesh.topology().dim();
-  if (dim == D - 1)
-  {
-    mesh.init(D - 1);
-    mesh.init(D - 1, D);
-  }
-
-  // Set geometric dimension (needed for SWIG interface)
-  _geometric_dimension = mesh.geometry().dim();
-
-  // Speed up the computation by only checking each vertex once (or
-  // twice if it is on the boundary for some but not all facets).
-  RangedIndexSet boundary_visited(mesh.num_vertices());
-  RangedIndexSet interior_visited(mesh.num_vertices());
-  std::vector<bool> boundary_inside(mesh.num_vertices());
-  std::vector<bool> interior_inside(mesh.num_vertices());
-
-  // Always false when not marking facets
-  bool on_boundary = false;
-
-  // Compute sub domain markers
-  Progress p("Computing sub domain markers", mesh.num_entities(dim));
-  for (MeshEntityIterator entity(mesh, dim); !entity.end(); ++entity)
-  {
-    // Check if entity is on the boundary if entity is a facet
-    if (dim == D - 1)
-      on_boundary = (entity->num_global_entities(D) == 1);
-
-    // Select the visited-cache to use for this facet (or entity)
-    RangedIndexSet&    is_visited = (on_boundary ? boundary_visited : interior_visited);
-    std::vector<bool>& is_inside  = (on_boundary ? boundary_inside  : interior_inside);
-
-    // Start by assuming all points are inside
-    bool all_points_inside = true;
-
-    // Check all incident vertices if dimension is > 0 (not a vertex)
-    if (entity->dim() > 0)
-    {
-      for (VertexIterator vertex(*entity); !vertex.end(); ++vertex)
-      {
-        if (is_visited.insert(vertex->index()))
-        {
-          Array<double> x(_geometric_dimension, const_cast<double*>(vertex->x()));
-          is_inside[vertex->index()] = inside(x, on_boundary);
-        }
-
-        if (!is_inside[vertex->index()])
-        {
-          all_points_inside = false;
-          break;
-        }
-      }
-    }
-
-    // Check midpoint (works also in the case when we have a single vertex)
-    if (all_points_inside && check_midpoint)
-    {
-      Array<double> x(_geometric_dimension,
-                      const_cast<double*>(entity->midpoint().coordinates()));
-      if (!inside(x, on_boundary))
-        all_points_inside = false;
-    }
+  // Compute entities inside sub domain
+  std::vector<std::size_t> entities;
+  compute_entities(entities, mesh, sub_domains.dim(), check_midpoint);
 
-    // Mark entity with all vertices inside
-    if (all_points_inside)
-      sub_domains.set_value(entity->index(), sub_domain);
-
-    p++;
-  }
+  // Mark entities
+  for (std::size_t i = 0; i < entities.size(); ++i)
+    sub_domains.set_value(entities[i], sub_domain);
 }
 //-----------------------------------------------------------------------------
 template<typename T>
@@ -248,11 +195,24 @@ void SubDomain::apply_markers(std::map<std::size_t, std::size_t>& sub_domains,
                               const Mesh& mesh,
                               bool check_midpoint) const
 {
-  // FIXME: This function can probably be folded into the above
-  //        function operator[] in std::map and MeshFunction.
-
   log(TRACE, "Computing sub domain markers for sub domain %d.", sub_domain);
 
+  // Compute entities inside sub domain
+  std::vector<std::size_t> entities;
+  compute_entities(entities, mesh, dim, check_midpoint);
+
+  // Mark entities
+  for (std::size_t i = 0; i < entities.size(); ++i)
+    sub_domains[entities[i]] = sub_domain;
+}
+//-----------------------------------------------------------------------------
+void SubDomain::compute_entities(std::vector<std::size_t>& entities,
+                                 const Mesh& mesh,
+                                 std::size_t dim,
+                                 bool check_midpoint) const
+{
+  entities.clear();
+
   // Compute facet - cell connectivity if necessary
   const std::size_t D = mesh.topology().dim();
   if (dim == D - 1)
@@ -263,65 +223,115 @@ void SubDomain::apply_markers(std::map<std::size_t, std::size_t>& sub_domains,
 
   // Set geometric dimension (needed for SWIG interface)
   _geometric_dimension = mesh.geometry().dim();
+  const std::size_t gdim = _geometric_dimension;
 
-  // Speed up the computation by only checking each vertex once (or
-  // twice if it is on the boundary for some but not all facets).
-  RangedIndexSet boundary_visited(mesh.num_vertices());
-  RangedIndexSet interior_visited(mesh.num_vertices());
-  std::vector<bool> boundary_inside(mesh.num_vertices());
-  std::vector<bool> interior_inside(mesh.num_vertices());
-
-  // Always false when not marking facets
-  bool on_boundary = false;
-
-  // Compute sub domain markers
-  Progress p("Computing sub domain markers", mesh.num_entities(dim));
-  for (MeshEntityIterator entity(mesh, dim); !entity.end(); ++entity)
+  // Check whether entities are on the boundary (always false when not
+  // marking facets)
+  const std::size_t num_entities = mesh.num_entities(dim);
+  std::vector<bool> on_boundary(num_entities, false);
+  if (dim == D - 1)
   {
-    // Check if entity is on the boundary if entity is a facet
-    if (dim == D - 1)
-      on_boundary = (entity->num_global_entities(D) == 1);
-
-    // Select the visited-cache to use for this facet (or entity)
-    RangedIndexSet&    is_visited = (on_boundary ? boundary_visited : interior_visited);
-    std::vector<bool>& is_inside  = (on_boundary ? boundary_inside  : interior_inside);
-
-    // Start by assuming all points are inside
-    bool all_points_inside = true;
+    for (MeshEntityIterator entity(mesh, dim); !entity.end(); ++entity)
+      on_boundary[entity->index()] = (entity->num_global_entities(D) == 1);
+  }
 
-    // Check all incident vertices if dimension is > 0 (not a vertex)
-    if (entity->dim() > 0)
+  // Vertex markers, for interior (0) and boundary (1) entities. Each
+  // vertex is checked at most once with each value of the boundary
+  // flag, and only if it is a vertex of an entity with that flag.
+  std::vector<bool> vertex_inside[2];
+  vertex_inside[0].resize(mesh.num_vertices(), false);
+  vertex_inside[1].resize(mesh.num_vertices(), false);
+  if (dim > 0)
+  {
+    // Find vertices to check
+    std::vector<bool> check[2];
+    check[0].resize(mesh.num_vertices(), false);
+    check[1].resize(mesh.num_vertices(), false);
+    for (MeshEntityIterator entity(mesh, dim); !entity.end(); ++entity)
     {
+      std::vector<bool>& _check = check[on_boundary[entity->index()]];
       for (VertexIterator vertex(*entity); !vertex.end(); ++vertex)
+        _check[vertex->index()] = true;
+    }
+
+    // Check vertices
+    for (std::size_t b = 0; b < 2; ++b)
+    {
+      std::vector<std::size_t> vertices;
+      std::vector<double> x;
+      for (std::size_t v = 0; v < mesh.num_vertices(); ++v)
       {
-        if (is_visited.insert(vertex->index()))
+        if (check[b][v])
         {
-          Array<double> x(_geometric_dimension, const_cast<double*>(vertex->x()));
-          is_inside[vertex->index()] = inside(x, on_boundary);
+          vertices.push_back(v);
+          const double* _x = mesh.geometry().x(v);
+          x.insert(x.end(), _x, _x + gdim);
         }
+      }
+      if (vertices.empty())
+        continue;
 
-        if (!is_inside[vertex->index()])
+      std::vector<bool> is_inside(vertices.size(), false);
+      const Array<double> _x(x.size(), &x[0]);
+      inside(is_inside, _x, b == 1);
+      for (std::size_t i = 0; i < vertices.size(); ++i)
+        vertex_inside[b][vertices[i]] = is_inside[i];
+    }
+  }
+
+  // Mark entities with all vertices inside
+  std::vector<bool> entity_inside(num_entities, true);
+  if (dim > 0)
+  {
+    for (MeshEntityIterator entity(mesh, dim); !entity.end(); ++entity)
+    {
+      const std::vector<bool>& _vertex_inside
+        = vertex_inside[on_boundary[entity->index()]];
+      for (VertexIterator vertex(*entity); !vertex.end(); ++vertex)
+      {
+        if (!_vertex_inside[vertex->index()])
         {
-          all_points_inside = false;
+          entity_inside[entity->index()] = false;
           break;
         }
       }
     }
+  }
 
-    // Check midpoint (works also in the case when we have a single vertex)
-    if (all_points_inside && check_midpoint)
+  // Check midpoints of entities with all vertices inside (works also
+  // in the case when we have a single vertex)
+  if (check_midpoint)
+  {
+    for (std::size_t b = 0; b < 2; ++b)
     {
-      Array<double> x(_geometric_dimension,
-                      const_cast<double*>(entity->midpoint().coordinates()));
-      if (!inside(x, on_boundary))
-        all_points_inside = false;
-    }
+      std::vector<std::size_t> candidates;
+      std::vector<double> x;
+      for (MeshEntityIterator entity(mesh, dim); !entity.end(); ++entity)
+      {
+        const std::size_t i = entity->index();
+        if (entity_inside[i] && on_boundary[i] == (b == 1))
+        {
+          candidates.push_back(i);
+          const Point p = entity->midpoint();
+          x.insert(x.end(), p.coordinates(), p.coordinates() + gdim);
+        }
+      }
+      if (candidates.empty())
+        continue;
 
-    // Mark entity with all vertices inside
-    if (all_points_inside)
-      sub_domains[entity->index()] =  sub_domain;
+      std::vector<bool> is_inside(candidates.size(), false);
+      const Array<double> _x(x.size(), &x[0]);
+      inside(is_inside, _x, b == 1);
+      for (std::size_t i = 0; i < candidates.size(); ++i)
+        entity_inside[candidates[i]] = is_inside[i];
+    }
+  }
 
-    p++;
+  // Collect entities inside sub domain
+  for (std::size_t i = 0; i < num_entities; ++i)
+  {
+    if (entity_inside[i])
+      entities.push_back(i);
   }
 }
 //-----------------------------------------------------------------------------
@@ -16,13 +16,14 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2007-04-10
-// Last changed: 2013-04-12
+// Last changed: 2026-10-16
 
 #ifndef __SUB_DOMAIN_H
 #define __SUB_DOMAIN_H
 
 #include <cstddef>
 #include <map>
+#include <vector>
 #include <dolfin/common/constants.h>
 
 namespace dolfin
@@ -66,6 +67,22 @@ namespace dolfin
     ///         True for points inside the subdomain.
     virtual bool inside(const Array<double>& x, bool on_boundary) const;
 
+    /// Compute which points are inside the subdomain. The default
+    /// implementation calls inside() for each point. Subclasses may
+    /// overload this function to check many points at once, which is
+    /// how points are checked when marking entities.
+    ///
+    /// *Arguments*
+    ///     is_inside (std::vector<bool>)
+    ///         True for points inside the subdomain (one per point, to
+    ///         be computed).
+    ///     x (_Array_ <double>)
+    ///         The coordinates of the points (point by point).
+    ///     on_boundary (bool)
+    ///         True for points on the boundary.
+    virtual void inside(std::vector<bool>& is_inside, const Array<double>& x,
+                        bool on_boundary) const;
+
     /// Map coordinate x in domain H to coordinate y in domain G (used for
     /// periodic boundary conditions)
     ///
@@ -273,6 +290,15 @@ namespace dolfin
                          const Mesh& mesh,
                          bool check_midpoint) const;
 
+    // Compute the indices of the entities of dimension dim inside the
+    // subdomain. Each vertex is checked at most once for each value of
+    // the boundary flag, and entity markers are computed from the
+    // vertex markers.
+    void compute_entities(std::vector<std::size_t>& entities,
+                          const Mesh& mesh,
+                          std::size_t dim,
+                          bool check_midpoint) const;
+
     // Friends
     friend class DirichletBC;
     friend class PeriodicBC;
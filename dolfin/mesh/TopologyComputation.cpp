@@ -16,9 +16,10 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // Modified by Garth N. Wells 2012.
+// Modified by agent, 2026
 //
 // First added:  2006-06-02
-// Last changed: 2012-02-14
+// Last changed: 2026-10-16
 
 #include <algorithm>
 #include <vector>
@@ -26,6 +27,7 @@
 #include <dolfin/common/Timer.h>
 #include <dolfin/common/utils.h>
 #include <dolfin/log/log.h>
+#include <dolfin/parameter/GlobalParameters.h>
 #include "CellType.h"
 #include "Mesh.h"
 #include "MeshConnectivity.h"
@@ -42,16 +44,20 @@ std::size_t TopologyComputation::compute_entities(Mesh& mesh, std::size_t dim)
   // to generating the connectivity dim - 0 (connections to vertices)
   // and the connectivity mesh.topology().dim() - dim (connections from cells).
   //
-  // We generate entities by iterating over all cells and generating a
-  // new entity only on its first occurence. Entities also contained
-  // in a previously visited cell are not generated. The new entities
-  // are computed in three steps:
+  // Entities are numbered in the order of their first occurrence
+  // when iterating over cells (and over the local entities of each
+  // cell). The new entities are computed in four steps:
   //
-  //   1. Iterate over cells and count new entities
+  //   1. Iterate over cells and create a key (sorted vertex list)
+  //      for each local entity, tagged with its position cell*m + i
   //
-  //   2. Allocate memory / prepare data structures
+  //   2. Sort the keys, so that equal entities become adjacent and
+  //      the first occurrence of each entity comes first
+  //
+  //   3. Number the entities in the order of their first occurrence
   //
-  //   3. Iterate over cells and add new entities
+  //   4. Copy cell - entity and entity - vertex connectivity into
+  //      the static MeshTopology data structures
 
   // Get mesh topology and connectivity
   MeshTopology& topology = mesh.topology();
@@ -79,112 +85,111 @@ std::size_t TopologyComputation::compute_entities(Mesh& mesh, std::size_t dim)
                  "Connectivity for topological dimension %d exists but entities are missing", dim);
   }
 
-  //info("Computing mesh entities of topological dimension %d.", dim);
-
-  // Compute connectivity dim - dim if not already computed
-  compute_connectivity(mesh, mesh.topology().dim(), mesh.topology().dim());
-
   // Start timer
-  //info("Creating mesh entities of dimension %d.", dim);
   Timer timer("compute entities dim = " + to_string(dim));
 
   // Get cell type
   const CellType& cell_type = mesh.type();
 
-  // Initialize local array of entities
+  // Number of entities per cell and number of vertices per entity
   const std::size_t m = cell_type.num_entities(dim);
   const std::size_t n = cell_type.num_vertices(dim);
-  std::vector<std::vector<std::size_t> > entities(m, std::vector<std::size_t>(n, 0));
-
-  // List of entity e indices connected to cell
-  std::vector<std::vector<std::size_t> > connectivity_ce(mesh.num_cells());
-
-  // List of vertces indices connected to entity e
-  std::vector<std::vector<std::size_t> > connectivity_ev;
-
-  // List entities e (std::size_t index, std::vector<std::size_t> vertex_list) connected to each cell
-  std::vector<std::vector<std::pair<std::size_t, std::vector<std::size_t> > > > ce_list(mesh.num_cells());
-
-  std::size_t current_entity = 0;
-  std::size_t max_ce_connections = 1;
-  for (MeshEntityIterator c(mesh, mesh.topology().dim()); !c.end(); ++c)
+  if (n > max_entity_vertices)
   {
-    // Cell index
-    const std::size_t c_index = c->index();
+    dolfin_error("TopologyComputation.cpp",
+                 "compute topological entities",
+                 "Entities with more than %d vertices are not supported",
+                 max_entity_vertices);
+  }
 
-    // Reserve space to reduce dynamic allocations
-    connectivity_ce[c_index].reserve(max_ce_connections);
-    ce_list[c_index].reserve(max_ce_connections);
+  // Cell - vertex connectivity
+  const std::size_t num_cells = mesh.num_cells();
+  const MeshConnectivity& cv = topology(topology.dim(), 0);
 
-    // Get vertices from cell
-    const unsigned int* vertices = c->entities(0);
-    dolfin_assert(vertices);
+  // Number of threads used to create and sort keys
+  const std::size_t num_threads = parameters["num_threads"];
 
-    // Create entities
-    cell_type.create_entities(entities, dim, vertices);
+  // Create entity keys for all cells
+  std::vector<EntityKey> keys(num_cells*m);
+  #ifdef HAS_OPENMP
+  #pragma omp parallel num_threads(std::max(num_threads, (std::size_t) 1))
+  #endif
+  {
+    // Local array of entities (one per thread)
+    std::vector<std::vector<std::size_t> >
+      entities(m, std::vector<std::size_t>(n, 0));
 
-    // Iterate over the given list of entities
-    std::vector<std::vector<std::size_t> >::iterator entity;
-    for (entity = entities.begin(); entity != entities.end(); ++entity)
+    #ifdef HAS_OPENMP
+    #pragma omp for
+    #endif
+    for (int c = 0; c < (int) num_cells; ++c)
     {
-      // Sort entities (so that we can use equality testing later)
-      std::sort(entity->begin(), entity->end());
-
-      // Iterate over connected cells and look for entity
-      for (MeshEntityIterator c0(*c, mesh.topology().dim()); !c0.end(); ++c0)
-      {
-        const std::size_t c0_index = c0->index();
+      // Get vertices from cell
+      const unsigned int* vertices = cv(c);
+      dolfin_assert(vertices);
 
-        // Check only previously visited cells
-        if (c0_index >= c_index)
-          continue;
-
-        // Entities connected to c0
-        const std::vector<std::pair<std::size_t, std::vector<std::size_t> > >& c0_list = ce_list[c0_index];
+      // Create entities
+      cell_type.create_entities(entities, dim, vertices);
 
-        std::vector<std::pair<std::size_t, std::vector<std::size_t> > >::const_iterator other_entity;
-        for (other_entity = c0_list.begin(); other_entity != c0_list.end(); ++other_entity)
-        {
-          // Note: Comparison relies on container being ordered
-          if (other_entity->second == *entity)
-          {
-            // Entity already exists, so pick the index
-            connectivity_ce[c_index].push_back(other_entity->first);
-
-            goto found;
-          }
-        }
+      // Store sorted vertex list of each entity as key
+      for (std::size_t i = 0; i < m; ++i)
+      {
+        EntityKey& key = keys[c*m + i];
+        std::sort(entities[i].begin(), entities[i].end());
+        key.first.assign(0);
+        std::copy(entities[i].begin(), entities[i].end(), key.first.begin());
+        key.second = c*m + i;
       }
+    }
+  }
 
-      // Add (index, list of vertices) pair to ce_list for cell
-      ce_list[c_index].push_back(std::make_pair(current_entity, *entity));
-
-      // Add new entity index to cell - e connectivity
-      connectivity_ce[c_index].push_back(current_entity);
-
-      // Add list of new entity vertices
-      connectivity_ev.push_back(*entity);
-
-      // Update max vector size (used to reserve space for performance);
-      max_ce_connections = std::max(max_ce_connections, connectivity_ce[c_index].size());
+  // Sort keys (ties are broken by position, so the first occurrence
+  // of each entity comes first)
+  sort_entity_keys(keys, num_threads);
 
-      // Increase counter
-      current_entity++;
+  // Mark first occurrence of each entity (entity_index[p] is set to
+  // the position of the first occurrence of the entity at position p)
+  std::vector<std::size_t> entity_index(keys.size());
+  for (std::size_t k = 0, first = 0; k < keys.size(); ++k)
+  {
+    if (k == 0 || keys[k].first != keys[k - 1].first)
+      first = keys[k].second;
+    entity_index[keys[k].second] = first;
+  }
 
-      // Entity found, don't need to create
-      found:
-      ;
-    }
+  // Number entities in order of first occurrence. Since the first
+  // occurrence precedes position p, it has already been numbered.
+  std::size_t num_entities = 0;
+  for (std::size_t p = 0; p < entity_index.size(); ++p)
+  {
+    if (entity_index[p] == p)
+      entity_index[p] = num_entities++;
+    else
+      entity_index[p] = entity_index[entity_index[p]];
   }
 
   // Initialise connectivity data structure
-  topology.init(dim, connectivity_ev.size());
-
-  // Copy connectivity data into static MeshTopology data structures
-  ce.set(connectivity_ce);
-  ev.set(connectivity_ev);
+  topology.init(dim, num_entities);
+
+  // Copy cell - entity connectivity
+  ce.init(num_cells, m);
+  for (std::size_t c = 0; c < num_cells; ++c)
+    ce.set(c, &entity_index[c*m]);
+
+  // Copy entity - vertex connectivity (from the first key of each
+  // group of equal keys)
+  ev.init(num_entities, n);
+  std::vector<std::size_t> entity_vertices(n);
+  for (std::size_t k = 0; k < keys.size(); ++k)
+  {
+    if (k > 0 && keys[k].first == keys[k - 1].first)
+      continue;
+    std::copy(keys[k].first.begin(), keys[k].first.begin() + n,
+              entity_vertices.begin());
+    ev.set(entity_index[keys[k].second], &entity_vertices[0]);
+  }
 
-  return connectivity_ev.size();
+  return num_entities;
 }
 //-----------------------------------------------------------------------------
 void TopologyComputation::compute_connectivity(Mesh& mesh,
@@ -385,3 +390,42 @@ void TopologyComputation::compute_from_intersection(Mesh& mesh,
   topology(d0, d1).set(connectivity);
 }
 //-----------------------------------------------------------------------------
+void TopologyComputation::sort_entity_keys(std::vector<EntityKey>& keys,
+                                           std::size_t num_threads)
+{
+  #ifdef HAS_OPENMP
+  if (num_threads > 1 && keys.size() > num_threads)
+  {
+    // Sort chunks in parallel
+    const int num_chunks = num_threads;
+    std::vector<std::size_t> offsets(num_chunks + 1);
+    for (int i = 0; i <= num_chunks; ++i)
+      offsets[i] = (i*keys.size())/num_chunks;
+
+    #pragma omp parallel for num_threads(num_threads)
+    for (int i = 0; i < num_chunks; ++i)
+      std::sort(keys.begin() + offsets[i], keys.begin() + offsets[i + 1]);
+
+    // Merge neighbouring chunks pairwise (merges at the same level
+    // are independent)
+    for (int step = 1; step < num_chunks; step *= 2)
+    {
+      #pragma omp parallel for num_threads(num_threads)
+      for (int i = 0; i < num_chunks; i += 2*step)
+      {
+        if (i + step < num_chunks)
+        {
+          const int end = std::min(i + 2*step, num_chunks);
+          std::inplace_merge(keys.begin() + offsets[i],
+                             keys.begin() + offsets[i + step],
+                             keys.begin() + offsets[end]);
+        }
+      }
+    }
+    return;
+  }
+  #endif
+
+  std::sort(keys.begin(), keys.end());
+}
+//-----------------------------------------------------------------------------
@@ -18,12 +18,14 @@
 // Modified by Garth N. Wells 2012.
 //
 // First added:  2006-06-02
-// Last changed: 2012-02-14
+// Last changed: 2026-10-16
 
 #ifndef __TOPOLOGY_COMPUTATION_H
 #define __TOPOLOGY_COMPUTATION_H
 
+#include <utility>
 #include <vector>
+#include <boost/array.hpp>
 
 namespace dolfin
 {
@@ -46,6 +48,19 @@ namespace dolfin
 
   private:
 
+    // Maximum number of vertices of an entity (below cell dimension)
+    static const std::size_t max_entity_vertices = 4;
+
+    // Key identifying a local entity of a cell: sorted vertex list
+    // (padded with zeros) and position (cell index*num entities + local
+    // index)
+    typedef std::pair<boost::array<unsigned int, max_entity_vertices>,
+                      std::size_t> EntityKey;
+
+    // Sort entity keys, using OpenMP threads if num_threads > 1
+    static void sort_entity_keys(std::vector<EntityKey>& keys,
+                                 std::size_t num_threads);
+
     /// Compute connectivity from transpose
     static void compute_from_transpose(Mesh& mesh, std::size_t d0,
                                        std::size_t d1);
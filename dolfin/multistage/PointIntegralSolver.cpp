@@ -16,12 +16,18 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2013-02-15
-// Last changed: 2013-05-13
+// Last changed: 2026-10-16
 
+#include <algorithm>
 #include <cmath>
 #include <boost/make_shared.hpp>
 
+#ifdef HAS_OPENMP
+#include <omp.h>
+#endif
+
 #include <dolfin/log/log.h>
+#include <dolfin/common/Profiler.h>
 #include <dolfin/common/Timer.h>
 #include <dolfin/parameter/GlobalParameters.h>
 #include <dolfin/mesh/Mesh.h>
@@ -44,19 +50,25 @@ using namespace dolfin;
 //-----------------------------------------------------------------------------
 PointIntegralSolver::PointIntegralSolver(boost::shared_ptr<MultiStageScheme> scheme) : 
   Variable("PointIntegralSolver", "unamed"), 
-  _scheme(scheme), _vertex_map(), _ufcs(), _coefficient_index(), _retabulate_J(true), 
-  _J(), _J_L(), _J_U()
+  _scheme(scheme), _vertex_map(), _ufcs(), _coefficient_index()
 {
   // Set parameters
   parameters = default_parameters();
 
+  // Register timed tasks
+  _tasks[update_cell] = Profiler::register_task("PointIntegralSolver: update_cell");
+  _tasks[tabulate_F] = Profiler::register_task("PointIntegralSolver: tabulate_tensor (F)");
+  _tasks[tabulate_J] = Profiler::register_task("PointIntegralSolver: tabulate_tensor (J)");
+  _tasks[lu_factorize] = Profiler::register_task("PointIntegralSolver: LU factorize");
+  _tasks[fb_substitution] = Profiler::register_task("PointIntegralSolver: fb substituion");
+
   _check_forms();
   _init();
 }
 //-----------------------------------------------------------------------------
 void PointIntegralSolver::step(double dt)
 {
-  Timer t_step_stage("Step: set the stage");
+  Timer t_step("PointIntegralSolver step");
 
   dolfin_assert(dt > 0.0);
 
@@ -68,343 +80,356 @@ void PointIntegralSolver::step(double dt)
 
   // Extract mesh
   const Mesh& mesh = _scheme->stage_forms()[0][0]->mesh();
+  const std::size_t num_vertices = mesh.num_vertices();
 
-  // Collect ref to dof map only need one as we require same trial and test 
+  // Collect ref to dof map only need one as we require same trial and test
   // space for all forms
   const GenericDofMap& dofmap = *_scheme->stage_forms()[0][0]->function_space(0)->dofmap();
-  
+
   // Get size of system (num dofs per vertex)
   const unsigned int N = dofmap.num_entity_dofs(0);
   const unsigned int dof_offset = mesh.type().num_entities(0);
   const unsigned int num_stages = _scheme->stage_forms().size();
 
-  // Local solution vector at start of time step
-  arma::vec u0;
-  u0.set_size(N);
-
-  // Local stage solutions 
-  std::vector<arma::vec> local_stage_solutions(_scheme->stage_solutions().size());
-  for (unsigned int stage=0; stage<num_stages; stage++)
-    local_stage_solutions[stage].set_size(N);
-
   // Update off-process coefficients
   for (unsigned int i=0; i < num_stages; i++)
   {
     for (unsigned int j=0; j < _scheme->stage_forms()[i].size(); j++)
     {
       const std::vector<boost::shared_ptr<const GenericFunction> >
-	coefficients = _scheme->stage_forms()[i][j]->coefficients();
-      
+        coefficients = _scheme->stage_forms()[i][j]->coefficients();
+
       for (unsigned int k = 0; k < coefficients.size(); ++k)
-	coefficients[k]->update();
+        coefficients[k]->update();
     }
   }
-  
-  // Local to local dofs to be used in tabulate entity dofs
-  std::vector<std::size_t> local_to_local_dofs(N);
 
-  // Local to global dofs used when solution is fanned out to global vector
-  std::vector<dolfin::la_index> local_to_global_dofs(N);
-  
-  //const std::size_t num_threads = dolfin::parameters["num_threads"];
-
-  // Iterate over vertices
-  //Progress p("Solving local point integral problems", mesh.num_vertices());
-  
-  t_step_stage.stop();
-
-  //#pragma omp parallel for schedule(guided, 20) private(_J_L, _J_U, _J, local_to_global_dofs, local_to_local_dofs, _ufcs)
-  for (std::size_t vert_ind=0; vert_ind< mesh.num_vertices(); ++vert_ind)
+  // Newton solver parameters (extracted once since parameter lookup
+  // is expensive)
+  const Parameters& newton_parameters = parameters("newton_solver");
+  const std::size_t maxiter = newton_parameters["maximum_iterations"];
+  const bool reuse_jacobian = newton_parameters["reuse_jacobian"];
+  const std::size_t iterations_to_retabulate_jacobian =
+    newton_parameters["iterations_to_retabulate_jacobian"];
+  const double relaxation = newton_parameters["relaxation_parameter"];
+  const std::string convergence_criterion = newton_parameters["convergence_criterion"];
+  const double rtol = newton_parameters["relative_tolerance"];
+  const double atol = newton_parameters["absolute_tolerance"];
+  const bool report = newton_parameters["report"];
+  if (convergence_criterion != "residual" && convergence_criterion != "incremental")
+    error("Unknown Newton convergence criterion");
+  const bool residual_criterion = convergence_criterion == "residual";
+
+  // Initialize work data for each thread
+  const std::size_t num_threads = dolfin::parameters["num_threads"];
+  _init_thread_data(std::max(num_threads, (std::size_t) 1));
+
+  // When threaded, the Jacobian is retabulated for each vertex, since
+  // otherwise the Jacobian used for a vertex (reused from the
+  // previous vertex of the thread) would depend on the scheduling
+  const bool threaded = num_threads > 1;
+
+  // Local stage solutions for all vertices
+  std::vector<std::vector<double> > local_stage_solutions(num_stages,
+                                       std::vector<double>(num_vertices*N));
+
+  // Data for vertex where the Newton solver failed to converge
+  bool newton_failed = false;
+  std::size_t failed_iteration = 0;
+  double failed_residual = 0.0;
+  double failed_relative_residual = 0.0;
+
+  // Iterate over stages. All vertices are solved for one stage before
+  // moving on to the next such that the time constant can be shared.
+  for (unsigned int stage=0; stage<num_stages; stage++)
   {
+    // Update time
+    *_scheme->t() = t0 + dt*_scheme->dt_stage_offset()[stage];
 
-    Timer t_vert("Step: update vert");
-
-    // Cell containing vertex
-    const Cell cell(mesh, _vertex_map[vert_ind].first);
-
-    // Get all dofs for cell
-    // FIXME: Shold we include logics about empty dofmaps?
-    const std::vector<dolfin::la_index>& cell_dofs = dofmap.cell_dofs(cell.index());
-
-    // Local vertex ind
-    const unsigned int local_vert = _vertex_map[vert_ind].second;
-
-    // Tabulate local-local dofmap
-    dofmap.tabulate_entity_dofs(local_to_local_dofs, 0, local_vert);
-    
-    // Fill local to global dof map
-    for (unsigned int row=0; row<N; row++)
-    {
-      local_to_global_dofs[row] = cell_dofs[local_to_local_dofs[row]];
-    }
-
-    t_vert.stop();
-
-    // Iterate over stage forms
-    for (unsigned int stage=0; stage<num_stages; stage++)
+    // Iterate over vertices
+    #ifdef HAS_OPENMP
+    #pragma omp parallel num_threads(std::max(num_threads, (std::size_t) 1))
+    #endif
     {
-
-      // Update time
-      *_scheme->t() = t0 + dt*_scheme->dt_stage_offset()[stage];
-
-      // Check if we have an explicit stage (only 1 form)
-      if (_ufcs[stage].size()==1)
-      {
-
-	Timer t_expl("Explicit stage");
-
-	// Point integral
-	const ufc::point_integral& integral = *_ufcs[stage][0]->default_point_integral;
-
-	// Update to current cell
-	Timer t_expl_update("Explicit stage: update_cell");
-	_ufcs[stage][0]->update(cell);
-	t_expl_update.stop();
-
-	// Tabulate cell tensor
-	Timer t_expl_tt("Explicit stage: tabulate_tensor");
-	integral.tabulate_tensor(&_ufcs[stage][0]->A[0], _ufcs[stage][0]->w(), 
-				 &_ufcs[stage][0]->cell.vertex_coordinates[0], 
-				 local_vert);
-	t_expl_tt.stop();
-
-	// Extract vertex dofs from tabulated tensor and put them into the local 
-	// stage solution vector
-	// Extract vertex dofs from tabulated tensor
-	for (unsigned int row=0; row < N; row++)
-	  local_stage_solutions[stage](row) = _ufcs[stage][0]->A[local_to_local_dofs[row]];
-
-	// Put solution back into global stage solution vector
-	Timer t_expl_set("Explicit stage: set");
-	_scheme->stage_solutions()[stage]->vector()->set(
-			    local_stage_solutions[stage].memptr(), N, 
-			    &local_to_global_dofs[0]);
-      }
-    
-      // or an implicit stage (2 forms)
-      else
+      #ifdef HAS_OPENMP
+      ThreadData& data = *_thread_data[omp_get_thread_num()];
+      #else
+      ThreadData& data = *_thread_data[0];
+      #endif
+
+      // True if a Newton solve of this thread has failed
+      bool thread_failed = false;
+
+      #ifdef HAS_OPENMP
+      #pragma omp for schedule(guided, 20)
+      #endif
+      for (int vert_ind=0; vert_ind < (int) num_vertices; ++vert_ind)
       {
-	
-	Timer t_impl("Implicit stage");
-	
-	const Parameters& newton_parameters = parameters("newton_solver");
-	
-	// Local solution
-	arma::vec& u = local_stage_solutions[stage];
-	
-	unsigned int newton_iteration = 0;
-	bool newton_converged = false;
-	bool jacobian_retabulated = false;
-	const std::size_t maxiter = newton_parameters["maximum_iterations"];
-	const bool reuse_jacobian = newton_parameters["reuse_jacobian"];
-	const std::size_t iterations_to_retabulate_jacobian = \
-	  newton_parameters["iterations_to_retabulate_jacobian"];
-	const double relaxation = newton_parameters["relaxation_parameter"];
-	const std::string convergence_criterion = newton_parameters["convergence_criterion"];
-	const double rtol = newton_parameters["relative_tolerance"];
-	const double atol = newton_parameters["absolute_tolerance"];
-	const bool report = newton_parameters["report"];
-	//const int num_threads = 0;
-
-	/// Most recent residual and intitial residual
-	double residual = 1.0;
-	double residual0 = 1.0;
-	double relative_residual = 1.0;
-      
-	//const double relaxation = 1.0;
-      
-	// Initialize la structures
-	arma::vec F;
-	arma::vec y;
-	arma::vec dx;
-	F.set_size(N);
-	y.set_size(N);
-	dx.set_size(N);
-      
-	// Get point integrals
-	const ufc::point_integral& F_integral = *_ufcs[stage][0]->default_point_integral;
-	const ufc::point_integral& J_integral = *_ufcs[stage][1]->default_point_integral;
-      
-	// Update to current cell. This only need to be done once for each stage and 
-	// vertex
-
-	Timer t_impl_update("Implicit stage: update_cell");
-	_ufcs[stage][0]->update(cell);
-	_ufcs[stage][1]->update(cell);
-	t_impl_update.stop();
-
-	// Tabulate an initial residual solution
-	Timer t_impl_tt_F("Implicit stage: tabulate_tensor (F)");
-	F_integral.tabulate_tensor(&_ufcs[stage][0]->A[0], _ufcs[stage][0]->w(), 
-				   &_ufcs[stage][0]->cell.vertex_coordinates[0], 
-				   local_vert);
-	t_impl_tt_F.stop();
-
-	// Extract vertex dofs from tabulated tensor, together with the old stage 
-	// solution
-	Timer t_impl_update_F("Implicit stage: update_F");
-	for (unsigned int row=0; row < N; row++)
-	{
-	  F(row) = _ufcs[stage][0]->A[local_to_local_dofs[row]];
-
-	  // Grab old value of stage solution as an initial start value. This 
-	  // value was also used to tabulate the initial value of the F_integral above 
-	  // and we therefore just grab it from the restricted coeffcients
-	  u(row) = _ufcs[stage][0]->w()[_coefficient_index[stage][0]][local_to_local_dofs[row]];
-	}
-	t_impl_update_F.stop();
-
-	// Start iterations
-	while (!newton_converged && newton_iteration < maxiter)
-	{
-        
-	  if (_retabulate_J || !reuse_jacobian)
-	  {
-	    // Tabulate Jacobian
-	    Timer t_impl_tt_J("Implicit stage: tabulate_tensor (J)");
-	    J_integral.tabulate_tensor(&_ufcs[stage][1]->A[0], _ufcs[stage][1]->w(), 
-				       &_ufcs[stage][1]->cell.vertex_coordinates[0], 
-				       local_vert);
-	    t_impl_tt_J.stop();
-
-	    // Extract vertex dofs from tabulated tensor
-	    Timer t_impl_update_J("Implicit stage: update_J");
-	    for (unsigned int row=0; row < N; row++)
-	      for (unsigned int col=0; col < N; col++)
-		_J(row, col) = _ufcs[stage][1]->A[local_to_local_dofs[row]*dof_offset*N+
-						  local_to_local_dofs[col]];
-	    t_impl_update_J.stop();
-
-	    // LU factorize Jacobian
-	    Timer lu_factorize("Implicit stage: LU factorize");
-	    arma::lu(_J_L, _J_U, _J);
-	    _retabulate_J = false;
-
-	  }
-
-	  // Perform linear solve By forward backward substitution
-	  Timer forward_backward_substitution("Implicit stage: fb substituion");
-	  arma::solve(y, _J_L, F);
-	  arma::solve(dx, _J_U, y);
-	  forward_backward_substitution.stop();
-
-	  // Compute resdiual
-	  if (convergence_criterion == "residual")
-	    residual = arma::norm(F, 2);
-	  else if (convergence_criterion == "incremental")
-	    residual = arma::norm(dx, 2);
-	  else
-	    error("Unknown Newton convergence criterion");
-
-          // If initial residual
-          if (newton_iteration == 0)
-	    residual0 = residual;
-	  
-	  // Relative residual
-	  relative_residual = residual / residual0;
-	  
-	  // Update solution
-          if (std::abs(1.0 - relaxation) < DOLFIN_EPS)
-            u -= dx;
-          else
-            u -= relaxation*dx;
-        
-	  // Update number of iterations
-	  ++newton_iteration;
-	  
-	  // Put solution back into restricted coefficients before tabulate new residual
-	  for (unsigned int row=0; row < N; row++)
-	    _ufcs[stage][0]->w()[_coefficient_index[stage][0]][local_to_local_dofs[row]] = u(row);
-
-	  // Tabulate new residual 
-	  t_impl_tt_F.start();
-	  F_integral.tabulate_tensor(&_ufcs[stage][0]->A[0], _ufcs[stage][0]->w(), 
-				     &_ufcs[stage][0]->cell.vertex_coordinates[0], 
-				     local_vert);
-	  t_impl_tt_F.stop();
-
-	  t_impl_update_F.start();
-	  // Extract vertex dofs from tabulated tensor
-	  for (unsigned int row=0; row < N; row++)
-	    F(row) = _ufcs[stage][0]->A[local_to_local_dofs[row]];
-	  t_impl_update_F.stop();
-
-	  // Output iteration number and residual (only first vertex)
-	  if (report && (newton_iteration > 0) && (vert_ind == 0))
-	  {
-	    info("Point solver newton iteration %d: r (abs) = %.3e (tol = %.3e) "\
-		 "r (rel) = %.3e (tol = %.3e)", newton_iteration, residual, atol, 
-		 relative_residual, rtol);
-	  }
-	  
-	  // Check for retabulation of Jacobian
-	  if (reuse_jacobian && newton_iteration > iterations_to_retabulate_jacobian && \
-	      !jacobian_retabulated)
-	  {
-	    jacobian_retabulated = true;
-	    _retabulate_J = true;
+        // Skip remaining vertices if a Newton solve has failed
+        if (thread_failed)
+          continue;
 
-	    if (vert_ind == 0)
-	      info("Retabulating Jacobian.");
+        // Cell containing vertex
+        const Cell cell(mesh, _vertex_map[vert_ind].first);
 
-	    // If there is a solution coefficient in the jacobian form
-	    if (_coefficient_index[stage].size()==2)
-	    {
-	      // Put solution back into restricted coefficients before tabulate new jacobian
-	      for (unsigned int row=0; row < N; row++)
-		_ufcs[stage][1]->w()[_coefficient_index[stage][1]][local_to_local_dofs[row]] = u(row);
-	    }
+        // Local vertex ind
+        const unsigned int local_vert = _vertex_map[vert_ind].second;
 
-	  }
+        // Local to local dofs for vertex
+        const std::size_t* local_to_local_dofs = &_local_to_local_dofs[vert_ind*N];
 
-	  // Return true if convergence criterion is met
-	  if (relative_residual < rtol || residual < atol)
-	    newton_converged = true;
+        // Local stage solution for vertex
+        double* u = &local_stage_solutions[stage][vert_ind*N];
 
-	}
-      
-        if (newton_converged)
+        // Check if we have an explicit stage (only 1 form)
+        if (data.ufcs[stage].size()==1)
         {
-	  Timer t_impl_set("Implicit stage: set");
-          // Put solution back into global stage solution vector
-          _scheme->stage_solutions()[stage]->vector()->set(u.memptr(), u.size(), 
-							   &local_to_global_dofs[0]);
-	}
+          UFC& ufc = *data.ufcs[stage][0];
+
+          // Point integral
+          const ufc::point_integral& integral = *ufc.default_point_integral;
+
+          // Update to current cell
+          {
+            ProfileScope scope(_tasks[update_cell]);
+            ufc.update(cell);
+          }
+
+          // Tabulate cell tensor
+          {
+            ProfileScope scope(_tasks[tabulate_F]);
+            integral.tabulate_tensor(&ufc.A[0], ufc.w(),
+                                     &ufc.cell.vertex_coordinates[0],
+                                     local_vert);
+          }
+
+          // Extract vertex dofs from tabulated tensor and put them into
+          // the local stage solution vector
+          for (unsigned int row=0; row < N; row++)
+            u[row] = ufc.A[local_to_local_dofs[row]];
+        }
+
+        // or an implicit stage (2 forms)
         else
         {
-          info("Last iteration before error %d: r (abs) = %.3e (tol = %.3e) "
-	       "r (rel) = %.3e (tol = %.3e)", newton_iteration, residual, atol, 
-	       relative_residual, rtol);
-	  error("Newton solver in PointIntegralSolver did not converge.");
+          UFC& F_ufc = *data.ufcs[stage][0];
+          UFC& J_ufc = *data.ufcs[stage][1];
+
+          unsigned int newton_iteration = 0;
+          bool newton_converged = false;
+          bool jacobian_retabulated = false;
+          if (threaded)
+            data.retabulate_J = true;
+
+          /// Most recent residual and intitial residual
+          double residual = 1.0;
+          double residual0 = 1.0;
+          double relative_residual = 1.0;
+
+          // Get point integrals
+          const ufc::point_integral& F_integral = *F_ufc.default_point_integral;
+          const ufc::point_integral& J_integral = *J_ufc.default_point_integral;
+
+          // Update to current cell. This only need to be done once for
+          // each stage and vertex
+          {
+            ProfileScope scope(_tasks[update_cell]);
+            F_ufc.update(cell);
+            J_ufc.update(cell);
+          }
+
+          // Tabulate an initial residual solution
+          {
+            ProfileScope scope(_tasks[tabulate_F]);
+            F_integral.tabulate_tensor(&F_ufc.A[0], F_ufc.w(),
+                                       &F_ufc.cell.vertex_coordinates[0],
+                                       local_vert);
+          }
+
+          // Extract vertex dofs from tabulated tensor, together with the
+          // old stage solution
+          double** F_w = F_ufc.w();
+          for (unsigned int row=0; row < N; row++)
+          {
+            data.F(row) = F_ufc.A[local_to_local_dofs[row]];
+
+            // Grab old value of stage solution as an initial start
+            // value. This value was also used to tabulate the initial
+            // value of the F_integral above and we therefore just grab
+            // it from the restricted coeffcients
+            u[row] = F_w[_coefficient_index[stage][0]][local_to_local_dofs[row]];
+          }
+
+          // Start iterations
+          while (!newton_converged && newton_iteration < maxiter)
+          {
+            if (data.retabulate_J || !reuse_jacobian)
+            {
+              // Tabulate Jacobian
+              {
+                ProfileScope scope(_tasks[tabulate_J]);
+                J_integral.tabulate_tensor(&J_ufc.A[0], J_ufc.w(),
+                                           &J_ufc.cell.vertex_coordinates[0],
+                                           local_vert);
+              }
+
+              // Extract vertex dofs from tabulated tensor
+              for (unsigned int row=0; row < N; row++)
+                for (unsigned int col=0; col < N; col++)
+                  data.J(row, col) = J_ufc.A[local_to_local_dofs[row]*dof_offset*N+
+                                             local_to_local_dofs[col]];
+
+              // LU factorize Jacobian
+              {
+                ProfileScope scope(_tasks[lu_factorize]);
+                arma::lu(data.J_L, data.J_U, data.J);
+                data.retabulate_J = false;
+              }
+            }
+
+            // Perform linear solve By forward backward substitution
+            {
+              ProfileScope scope(_tasks[fb_substitution]);
+              arma::solve(data.y, data.J_L, data.F);
+              arma::solve(data.dx, data.J_U, data.y);
+            }
+
+            // Compute resdiual
+            if (residual_criterion)
+              residual = arma::norm(data.F, 2);
+            else
+              residual = arma::norm(data.dx, 2);
+
+            // If initial residual
+            if (newton_iteration == 0)
+              residual0 = residual;
+
+            // Relative residual
+            relative_residual = residual / residual0;
+
+            // Update solution
+            if (std::abs(1.0 - relaxation) < DOLFIN_EPS)
+            {
+              for (unsigned int row=0; row < N; row++)
+                u[row] -= data.dx(row);
+            }
+            else
+            {
+              for (unsigned int row=0; row < N; row++)
+                u[row] -= relaxation*data.dx(row);
+            }
+
+            // Update number of iterations
+            ++newton_iteration;
+
+            // Put solution back into restricted coefficients before
+            // tabulate new residual
+            for (unsigned int row=0; row < N; row++)
+              F_w[_coefficient_index[stage][0]][local_to_local_dofs[row]] = u[row];
+
+            // Tabulate new residual
+            {
+              ProfileScope scope(_tasks[tabulate_F]);
+              F_integral.tabulate_tensor(&F_ufc.A[0], F_ufc.w(),
+                                         &F_ufc.cell.vertex_coordinates[0],
+                                         local_vert);
+            }
+
+            // Extract vertex dofs from tabulated tensor
+            for (unsigned int row=0; row < N; row++)
+              data.F(row) = F_ufc.A[local_to_local_dofs[row]];
+
+            // Output iteration number and residual (only first vertex)
+            if (report && (newton_iteration > 0) && (vert_ind == 0))
+            {
+              info("Point solver newton iteration %d: r (abs) = %.3e (tol = %.3e) "\
+                   "r (rel) = %.3e (tol = %.3e)", newton_iteration, residual, atol,
+                   relative_residual, rtol);
+            }
+
+            // Check for retabulation of Jacobian
+            if (reuse_jacobian && newton_iteration > iterations_to_retabulate_jacobian && \
+                !jacobian_retabulated)
+            {
+              jacobian_retabulated = true;
+              data.retabulate_J = true;
+
+              if (vert_ind == 0)
+                info("Retabulating Jacobian.");
+
+              // If there is a solution coefficient in the jacobian form
+              if (_coefficient_index[stage].size()==2)
+              {
+                // Put solution back into restricted coefficients before
+                // tabulate new jacobian
+                double** J_w = J_ufc.w();
+                for (unsigned int row=0; row < N; row++)
+                  J_w[_coefficient_index[stage][1]][local_to_local_dofs[row]] = u[row];
+              }
+            }
+
+            // Return true if convergence criterion is met
+            if (relative_residual < rtol || residual < atol)
+              newton_converged = true;
+          }
+
+          // Record failure (errors cannot be thrown inside the
+          // parallel region)
+          if (!newton_converged)
+          {
+            thread_failed = true;
+            #ifdef HAS_OPENMP
+            #pragma omp critical (point_integral_solver_failed)
+            #endif
+            {
+              newton_failed = true;
+              failed_iteration = newton_iteration;
+              failed_residual = residual;
+              failed_relative_residual = relative_residual;
+            }
+          }
         }
-	
       }
+    }
 
+    if (newton_failed)
+    {
+      info("Last iteration before error %d: r (abs) = %.3e (tol = %.3e) "
+           "r (rel) = %.3e (tol = %.3e)", failed_iteration, failed_residual,
+           atol, failed_relative_residual, rtol);
+      error("Newton solver in PointIntegralSolver did not converge.");
     }
 
-    Timer t_vert_axpy("Step: AXPY solution");
+    // Put solution back into global stage solution vector
+    GenericVector& stage_vector = *_scheme->stage_solutions()[stage]->vector();
+    stage_vector.set(&local_stage_solutions[stage][0], num_vertices*N,
+                     &_local_to_global_dofs[0]);
+    stage_vector.apply("insert");
+  }
 
-    // Get local u0 solution and add the stage derivatives
-    _scheme->solution()->vector()->get_local(&u0[0], u0.size(), 
-					     &local_to_global_dofs[0]);
-    
-    // Do the last stage and put back into solution vector
-    FunctionAXPY last_stage = _scheme->last_stage()*dt;
-  
-    // Axpy local solution vectors
-    for (unsigned int stage=0; stage < num_stages; stage++)
-      u0 += last_stage.pairs()[stage].first*local_stage_solutions[stage] ;
-    
-    // Update global solution with last stage
-    _scheme->solution()->vector()->set(u0.memptr(), local_to_global_dofs.size(), 
-				       &local_to_global_dofs[0]);
-    
-    //p++;
+  // Get local u0 solution and add the stage derivatives
+  GenericVector& solution_vector = *_scheme->solution()->vector();
+  std::vector<double> u0(num_vertices*N);
+  solution_vector.get_local(&u0[0], u0.size(), &_local_to_global_dofs[0]);
+
+  // Do the last stage and put back into solution vector
+  FunctionAXPY last_stage = _scheme->last_stage()*dt;
+
+  // Axpy local solution vectors
+  for (unsigned int stage=0; stage < num_stages; stage++)
+  {
+    const double a = last_stage.pairs()[stage].first;
+    const std::vector<double>& k = local_stage_solutions[stage];
+    for (std::size_t i = 0; i < u0.size(); ++i)
+      u0[i] += a*k[i];
   }
 
+  // Update global solution with last stage
+  solution_vector.set(&u0[0], u0.size(), &_local_to_global_dofs[0]);
+  solution_vector.apply("insert");
+
   // Update time
   *_scheme->t() = t0 + dt;
-  
 }
 //-----------------------------------------------------------------------------
 void PointIntegralSolver::step_interval(double t0, double t1, double dt)
@@ -484,15 +509,6 @@ void PointIntegralSolver::_init()
   _coefficient_index.resize(stage_forms.size());
   _ufcs.resize(stage_forms.size());
 
-  // Initiate jacobian matrices
-  if (_scheme->implicit())
-  {
-    const unsigned int N = stage_forms[0][0]->function_space(0)->dofmap()->num_entity_dofs(0);
-    _J.set_size(N, N);
-    _J_U.set_size(N, N);
-    _J_L.set_size(N, N);
-  }
-
   // Iterate over stages and collect information
   for (unsigned int stage=0; stage < stage_forms.size(); stage++)
   {
@@ -576,5 +592,58 @@ void PointIntegralSolver::_init()
       }
     }
   }  
+
+  // Tabulate local to local and local to global dofs for each vertex
+  const GenericDofMap& dofmap = *stage_forms[0][0]->function_space(0)->dofmap();
+  const unsigned int N = dofmap.num_entity_dofs(0);
+  std::vector<std::size_t> local_to_local_dofs(N);
+  _local_to_local_dofs.resize(mesh.num_vertices()*N);
+  _local_to_global_dofs.resize(mesh.num_vertices()*N);
+  for (std::size_t vert_ind = 0; vert_ind < mesh.num_vertices(); ++vert_ind)
+  {
+    const ArrayView<const dolfin::la_index> cell_dofs
+      = dofmap.cell_dofs(_vertex_map[vert_ind].first);
+    dofmap.tabulate_entity_dofs(local_to_local_dofs, 0,
+                                _vertex_map[vert_ind].second);
+    for (unsigned int row = 0; row < N; row++)
+    {
+      _local_to_local_dofs[vert_ind*N + row] = local_to_local_dofs[row];
+      _local_to_global_dofs[vert_ind*N + row] = cell_dofs[local_to_local_dofs[row]];
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+void PointIntegralSolver::_init_thread_data(std::size_t num_threads)
+{
+  // Check if already initialized
+  if (_thread_data.size() == num_threads)
+    return;
+
+  const unsigned int N = _scheme->stage_forms()[0][0]->function_space(0)->dofmap()->num_entity_dofs(0);
+
+  // Create copies of UFC objects and work arrays for each thread
+  _thread_data.resize(num_threads);
+  for (std::size_t i = 0; i < num_threads; i++)
+  {
+    _thread_data[i].reset(new ThreadData);
+    ThreadData& data = *_thread_data[i];
+
+    data.ufcs.resize(_ufcs.size());
+    for (std::size_t stage = 0; stage < _ufcs.size(); stage++)
+      for (std::size_t j = 0; j < _ufcs[stage].size(); j++)
+        data.ufcs[stage].push_back(boost::make_shared<UFC>(*_ufcs[stage][j]));
+
+    data.retabulate_J = true;
+    if (_scheme->implicit())
+    {
+      data.J.set_size(N, N);
+      data.J_L.set_size(N, N);
+      data.J_U.set_size(N, N);
+      data.F.set_size(N);
+      data.y.set_size(N);
+      data.dx.set_size(N);
+    }
+
+  }
 }
 //-----------------------------------------------------------------------------
@@ -16,7 +16,7 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2013-02-15
-// Last changed: 2013-05-13
+// Last changed: 2026-10-16
 
 #ifndef __POINTINTEGRALSOLVER_H
 #define __POINTINTEGRALSOLVER_H
@@ -35,7 +35,17 @@ namespace dolfin
   /// This class is a time integrator for general Runge Kutta forms,
   /// which only includes Point integrals with piecewise linear test
   /// functions. Such problems are disconnected at the vertices and
-  /// can therefore be solved locally.
+  /// can therefore be solved locally. The local problems are solved
+  /// in parallel if the global parameter "num_threads" is larger
+  /// than one.
+  ///
+  /// With the Newton solver parameter "reuse_jacobian" set, the
+  /// serial solver reuses the Jacobian from one vertex to the next,
+  /// whereas the threaded solver tabulates the Jacobian once for each
+  /// vertex, so that results do not depend on the scheduling of
+  /// vertices to threads. Results of nonlinear problems may therefore
+  /// differ slightly (within the Newton tolerance) between serial and
+  /// threaded runs, but are the same for any number of threads.
 
   // Forward declarations
   class MultiStageScheme;
@@ -83,25 +93,61 @@ namespace dolfin
     // and initialize UFC data for each form
     void _init();
 
+    class ThreadData;
+
+    // Initialize work data for given number of threads
+    void _init_thread_data(std::size_t num_threads);
+
     // The MultiStageScheme
     boost::shared_ptr<MultiStageScheme> _scheme;
 
     // Vertex map between vertices, cells and corresponding local vertex
     std::vector<std::pair<std::size_t, unsigned int> > _vertex_map;
 
+    // Local to local dofs for each vertex (num_entity_dofs(0) per vertex)
+    std::vector<std::size_t> _local_to_local_dofs;
+
+    // Local to global dofs for each vertex (num_entity_dofs(0) per vertex)
+    std::vector<dolfin::la_index> _local_to_global_dofs;
+
     // UFC objects, one for each form
     std::vector<std::vector<boost::shared_ptr<UFC> > > _ufcs;
 
     // Solution coefficient index in form
     std::vector<std::vector<int> > _coefficient_index;
 
-    // Flag for retabulation of J
-    bool _retabulate_J;
-    
-    // Jacobian and LU factorized jacobian matrices
-    arma::mat _J;
-    arma::mat _J_L;
-    arma::mat _J_U;
+    // Tasks timed during step (accumulated over vertices and threads)
+    enum Task {update_cell, tabulate_F, tabulate_J, lu_factorize,
+               fb_substitution, num_tasks};
+
+    // Profiler ids of timed tasks
+    std::size_t _tasks[num_tasks];
+
+    // Work data for each thread
+    class ThreadData
+    {
+    public:
+
+      // UFC objects, one for each form (copies of _ufcs)
+      std::vector<std::vector<boost::shared_ptr<UFC> > > ufcs;
+
+      // Flag for retabulation of J
+      bool retabulate_J;
+
+      // Jacobian and LU factorized jacobian matrices
+      arma::mat J;
+      arma::mat J_L;
+      arma::mat J_U;
+
+      // Work vectors for Newton solver
+      arma::vec F;
+      arma::vec y;
+      arma::vec dx;
+
+    };
+
+    // Work data, one for each thread
+    std::vector<boost::shared_ptr<ThreadData> > _thread_data;
 
   };
 
@@ -18,7 +18,7 @@
 // Modified by Fredrik Valdmanis, 2011
 //
 // First added:  2009-07-02
-// Last changed: 2013-04-26
+// Last changed: 2026-10-16
 
 #ifndef __GLOBAL_PARAMETERS_H
 #define __GLOBAL_PARAMETERS_H
@@ -59,9 +59,19 @@ namespace dolfin
       p.add("std_out_all_processes", true);                  // Print standard output on all processes
       p.add("relative_line_width", 0.025);                   // Line width relative to edge length in SVG output
 
+      // HDF5 file access: alignment of large objects in file, e.g. the
+      // stripe size of a parallel file system, and initial size of the
+      // metadata cache (bytes, 0 = HDF5 default)
+      p.add("hdf5_alignment", 0);
+      p.add("hdf5_metadata_cache_size", 0);
+
       // Threaded computation
       p.add("num_threads", 0);                               // Number of threads to run, 0 = run serial version
 
+      // Reuse sparsity patterns when assembling over the same mesh and
+      // dof maps (cached patterns are kept in memory, see TensorLayoutCache)
+      p.add("cache_sparsity", false);
+
       // DOF reordering when running in serial
       p.add("reorder_dofs_serial", true);
 
@@ -133,6 +143,7 @@ namespace dolfin
       std::string default_backend("uBLAS");
       allowed_backends.insert("uBLAS");
       allowed_backends.insert("STL");
+      allowed_backends.insert("CSR");
       #ifdef HAS_PETSC
       allowed_backends.insert("PETSc");
       default_backend = "PETSc";
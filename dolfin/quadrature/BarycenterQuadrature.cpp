@@ -16,18 +16,282 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // Modified by Andre Massing, 2010
+// Modified by agent, 2026
 //
 // First added:  2010-03-17
-// Last changed: 2010-04-09
+// Last changed: 2026-10-16
 //
 // Remark: This is an adapted version of Brian Mirtichs original C code for
 // computing polyhedral mass properties, which can be found at
 // http://www.cs.berkeley.edu/~jfc/mirtich/massProps.html
 
-#ifdef HAS_CGAL
+#include <algorithm>
+#include <cmath>
+#include <utility>
 
+#include <dolfin/common/constants.h>
+#include <dolfin/log/log.h>
+#include <dolfin/mesh/Cell.h>
+#include <dolfin/mesh/MeshEntityIterator.h>
+#include <dolfin/mesh/Vertex.h>
 #include "BarycenterQuadrature.h"
 
+#ifdef HAS_CGAL
+#include <CGAL/Polyhedron_3.h>
+#endif
+
+using namespace dolfin;
+
+// Convex polygon (in 3D), and convex polyhedron given by its faces
+typedef std::vector<Point> Polygon;
+typedef std::vector<Polygon> Polyhedron;
+
+// Plane n.x = c, with the inside n.x >= c (n of unit length)
+struct ClipPlane
+{
+  Point n;
+  double c;
+};
+
+// Tolerance for classifying points against planes (relative to the
+// magnitude of the coordinates)
+static const double plane_tolerance = 64.0*DOLFIN_EPS;
+
+// Largest accepted relative error (estimated) of the weight of a
+// floating-point quadrature rule when some points could not be
+// classified reliably, before falling back to exact arithmetic
+static const double max_relative_error = 1.0e-6;
+
+//-----------------------------------------------------------------------------
+// Return plane through a, b, c with d on the inside, or false if the
+// points are collinear
+static bool make_plane(const Point& a, const Point& b, const Point& c,
+                       const Point& d, ClipPlane& plane)
+{
+  plane.n = (b - a).cross(c - a);
+  const double norm = plane.n.norm();
+  if (norm == 0.0)
+    return false;
+  plane.n /= norm;
+  plane.c = plane.n.dot(a);
+  if (plane.n.dot(d) < plane.c)
+  {
+    plane.n *= -1.0;
+    plane.c = -plane.c;
+  }
+  return true;
+}
+//-----------------------------------------------------------------------------
+// Compute the planes bounding a tetrahedron, or the planes through
+// the edges of a triangle (orthogonal to the triangle). Returns false
+// if the simplex is degenerate.
+static bool simplex_planes(const std::vector<Point>& s,
+                           std::vector<ClipPlane>& planes)
+{
+  planes.resize(s.size());
+  if (s.size() == 4)
+  {
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+      if (!make_plane(s[(i + 1) % 4], s[(i + 2) % 4], s[(i + 3) % 4], s[i],
+                      planes[i]))
+      {
+        return false;
+      }
+    }
+  }
+  else
+  {
+    const Point normal = (s[1] - s[0]).cross(s[2] - s[0]);
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+      const Point& a = s[(i + 1) % 3];
+      const Point& b = s[(i + 2) % 3];
+      if (!make_plane(a, b, a + normal, s[i], planes[i]))
+        return false;
+    }
+  }
+  return true;
+}
+//-----------------------------------------------------------------------------
+// Compute signed distance of point to plane, snapping distances
+// within the tolerance to zero
+static double distance(const ClipPlane& plane, const Point& p, double tol,
+                       bool& ambiguous)
+{
+  const double d = plane.n.dot(p) - plane.c;
+  if (std::abs(d) > tol)
+    return d;
+  if (d != 0.0)
+    ambiguous = true;
+  return 0.0;
+}
+//-----------------------------------------------------------------------------
+// Clip polygon against plane (Sutherland-Hodgman), keeping the inside.
+// Points of the clipped polygon on the plane are added to cut.
+static void clip_polygon(const Polygon& polygon, const ClipPlane& plane,
+                         double tol, Polygon& clipped, Polygon& cut,
+                         bool& ambiguous)
+{
+  clipped.clear();
+  const std::size_t n = polygon.size();
+  std::vector<double> d(n);
+  for (std::size_t i = 0; i < n; ++i)
+    d[i] = distance(plane, polygon[i], tol, ambiguous);
+
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    const std::size_t j = (i + 1) % n;
+    if (d[i] >= 0.0)
+    {
+      clipped.push_back(polygon[i]);
+      if (d[i] == 0.0)
+        cut.push_back(polygon[i]);
+    }
+    if ((d[i] > 0.0 && d[j] < 0.0) || (d[i] < 0.0 && d[j] > 0.0))
+    {
+      const Point x = polygon[i] + (polygon[j] - polygon[i])*(d[i]/(d[i] - d[j]));
+      clipped.push_back(x);
+      cut.push_back(x);
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+// Order points of convex polygon in plane with given normal, removing
+// duplicate points
+static void order_polygon(Polygon& polygon, const Point& normal, double tol)
+{
+  Polygon points;
+  for (std::size_t i = 0; i < polygon.size(); ++i)
+  {
+    bool duplicate = false;
+    for (std::size_t j = 0; j < points.size() && !duplicate; ++j)
+      duplicate = polygon[i].distance(points[j]) <= tol;
+    if (!duplicate)
+      points.push_back(polygon[i]);
+  }
+  polygon.clear();
+  if (points.size() < 3)
+    return;
+
+  // Sort by angle around center
+  Point center;
+  for (std::size_t i = 0; i < points.size(); ++i)
+    center += points[i];
+  center /= static_cast<double>(points.size());
+  const Point u = points[0] - center;
+  const Point v = normal.cross(u);
+  std::vector<std::pair<double, std::size_t> > angles(points.size());
+  for (std::size_t i = 0; i < points.size(); ++i)
+  {
+    const Point x = points[i] - center;
+    angles[i] = std::make_pair(std::atan2(x.dot(v), x.dot(u)), i);
+  }
+  std::sort(angles.begin(), angles.end());
+  for (std::size_t i = 0; i < angles.size(); ++i)
+    polygon.push_back(points[angles[i].second]);
+}
+//-----------------------------------------------------------------------------
+// Clip convex polyhedron against plane, keeping the inside
+static void clip_polyhedron(Polyhedron& polyhedron, const ClipPlane& plane,
+                            double tol, bool& ambiguous)
+{
+  // Check whether any point is outside
+  bool outside = false;
+  bool inside = false;
+  for (std::size_t i = 0; i < polyhedron.size(); ++i)
+  {
+    for (std::size_t j = 0; j < polyhedron[i].size(); ++j)
+    {
+      const double d = distance(plane, polyhedron[i][j], tol, ambiguous);
+      outside = outside || d < 0.0;
+      inside = inside || d > 0.0;
+    }
+  }
+  if (!outside)
+    return;
+  if (!inside)
+  {
+    polyhedron.clear();
+    return;
+  }
+
+  // Clip faces and close polyhedron by the polygon cut by the plane
+  Polyhedron clipped;
+  Polygon face, cut;
+  for (std::size_t i = 0; i < polyhedron.size(); ++i)
+  {
+    clip_polygon(polyhedron[i], plane, tol, face, cut, ambiguous);
+    if (face.size() >= 3)
+      clipped.push_back(face);
+  }
+  order_polygon(cut, plane.n, tol);
+  if (cut.size() >= 3)
+    clipped.push_back(cut);
+
+  polyhedron.swap(clipped);
+}
+//-----------------------------------------------------------------------------
+// Compute volume and barycenter of convex polyhedron, by
+// decomposition into tetrahedra with a common interior vertex
+static void polyhedron_quadrature(const Polyhedron& polyhedron,
+                                  double& volume, Point& barycenter)
+{
+  Point center;
+  std::size_t num_points = 0;
+  for (std::size_t i = 0; i < polyhedron.size(); ++i)
+  {
+    for (std::size_t j = 0; j < polyhedron[i].size(); ++j)
+      center += polyhedron[i][j];
+    num_points += polyhedron[i].size();
+  }
+  center /= static_cast<double>(num_points);
+
+  volume = 0.0;
+  barycenter = Point();
+  for (std::size_t i = 0; i < polyhedron.size(); ++i)
+  {
+    const Polygon& face = polyhedron[i];
+    const Point a = face[0] - center;
+    for (std::size_t j = 1; j + 1 < face.size(); ++j)
+    {
+      const Point b = face[j] - center;
+      const Point c = face[j + 1] - center;
+      const double v = std::abs(a.dot(b.cross(c)))/6.0;
+      volume += v;
+      barycenter += (a + b + c)*(v/4.0);
+    }
+  }
+  if (volume > 0.0)
+    barycenter = center + barycenter/volume;
+}
+//-----------------------------------------------------------------------------
+// Compute area and barycenter of convex polygon, by decomposition
+// into triangles with a common interior vertex
+static void polygon_quadrature(const Polygon& polygon, double& area,
+                               Point& barycenter)
+{
+  Point center;
+  for (std::size_t i = 0; i < polygon.size(); ++i)
+    center += polygon[i];
+  center /= static_cast<double>(polygon.size());
+
+  area = 0.0;
+  barycenter = Point();
+  for (std::size_t i = 0; i < polygon.size(); ++i)
+  {
+    const Point a = polygon[i] - center;
+    const Point b = polygon[(i + 1) % polygon.size()] - center;
+    const double A = a.cross(b).norm()/2.0;
+    area += A;
+    barycenter += (a + b)*(A/3.0);
+  }
+  if (area > 0.0)
+    barycenter = center + barycenter/area;
+}
+//-----------------------------------------------------------------------------
+#ifdef HAS_CGAL
+
 const int X = 0;
 const int Y = 1;
 const int Z = 2;
@@ -35,11 +299,42 @@ const int Z = 2;
 #define SQR(x) ((x)*(x))
 #define CUBE(x) ((x)*(x)*(x))
 
-using namespace dolfin;
-
 typedef Nef_polyhedron_3::Plane_3 Plane_3;
 typedef Nef_polyhedron_3::Point_3 Point_3;
+typedef CGAL::Polyhedron_3<Kernel> Polyhedron_3;
 
+//-----------------------------------------------------------------------------
+// Create CGAL polyhedron for simplex
+static Nef_polyhedron_3 make_polyhedron(const std::vector<Point>& s)
+{
+  Polyhedron_3 P;
+  if (s.size() == 4)
+  {
+    P.make_tetrahedron(Point_3(s[0].x(), s[0].y(), s[0].z()),
+                       Point_3(s[1].x(), s[1].y(), s[1].z()),
+                       Point_3(s[2].x(), s[2].y(), s[2].z()),
+                       Point_3(s[3].x(), s[3].y(), s[3].z()));
+  }
+  else
+  {
+    P.make_triangle(Point_3(s[0].x(), s[0].y(), s[0].z()),
+                    Point_3(s[1].x(), s[1].y(), s[1].z()),
+                    Point_3(s[2].x(), s[2].y(), s[2].z()));
+  }
+  return Nef_polyhedron_3(P);
+}
+//-----------------------------------------------------------------------------
+// Check whether CGAL polyhedron has a non-vanishing 3D measure
+static bool has_volume(const Nef_polyhedron_3& polyhedron)
+{
+  Nef_polyhedron_3::Volume_const_iterator vi;
+  CGAL_forall_volumes(vi, polyhedron)
+  {
+    if (vi->mark())
+      return true;
+  }
+  return false;
+}
 //-----------------------------------------------------------------------------
 BarycenterQuadrature::BarycenterQuadrature(const Nef_polyhedron_3& polyhedron)
 {
@@ -237,3 +532,141 @@ void BarycenterQuadrature::compute_quadrature(const Nef_polyhedron_3& polyhedron
 }
 //-----------------------------------------------------------------------------
 #endif
+//-----------------------------------------------------------------------------
+BarycenterQuadrature::BarycenterQuadrature(const std::vector<Point>& simplex_0,
+                                           const std::vector<Point>& simplex_1)
+{
+  compute_quadrature(simplex_0, simplex_1);
+}
+//-----------------------------------------------------------------------------
+BarycenterQuadrature::BarycenterQuadrature(const Cell& cell_0,
+                                           const Cell& cell_1)
+{
+  std::vector<Point> simplex_0, simplex_1;
+  for (VertexIterator v(cell_0); !v.end(); ++v)
+    simplex_0.push_back(v->point());
+  for (VertexIterator v(cell_1); !v.end(); ++v)
+    simplex_1.push_back(v->point());
+  compute_quadrature(simplex_0, simplex_1);
+}
+//-----------------------------------------------------------------------------
+void BarycenterQuadrature::compute_quadrature(const std::vector<Point>& simplex_0,
+                                              const std::vector<Point>& simplex_1)
+{
+  if ((simplex_0.size() != 3 && simplex_0.size() != 4)
+      || (simplex_1.size() != 3 && simplex_1.size() != 4))
+  {
+    dolfin_error("BarycenterQuadrature.cpp",
+                 "compute quadrature rule for intersection of simplices",
+                 "Only intersections of tetrahedra and triangles are supported");
+  }
+
+  // Clip the simplex of lowest dimension against the other
+  const bool swap = simplex_0.size() > simplex_1.size();
+  const std::vector<Point>& a = swap ? simplex_1 : simplex_0;
+  const std::vector<Point>& b = swap ? simplex_0 : simplex_1;
+  const std::size_t dim = a.size() - 1;
+
+  // Compute tolerance from magnitude of coordinates, and size of
+  // clipped simplex (for estimating the error of the weight)
+  double scale = 0.0;
+  double size = 0.0;
+  for (std::size_t i = 0; i < a.size(); ++i)
+  {
+    for (std::size_t j = 0; j < 3; ++j)
+      scale = std::max(scale, std::abs(a[i][j]));
+    for (std::size_t j = 0; j < i; ++j)
+      size = std::max(size, a[i].distance(a[j]));
+  }
+  for (std::size_t i = 0; i < b.size(); ++i)
+    for (std::size_t j = 0; j < 3; ++j)
+      scale = std::max(scale, std::abs(b[i][j]));
+  const double tol = plane_tolerance*scale;
+
+  // Get planes to clip against (empty rule for degenerate simplices)
+  std::vector<ClipPlane> planes;
+  if (!simplex_planes(b, planes))
+    return;
+
+  bool ambiguous = false;
+  bool exact = false;
+  double weight = 0.0;
+  Point barycenter;
+  if (dim == 3)
+  {
+    // Clip faces of tetrahedron
+    Polyhedron polyhedron(4, Polygon(3));
+    for (std::size_t i = 0; i < 4; ++i)
+      for (std::size_t j = 0; j < 3; ++j)
+        polyhedron[i][j] = a[(i + j + 1) % 4];
+    for (std::size_t i = 0; i < planes.size() && !polyhedron.empty(); ++i)
+      clip_polyhedron(polyhedron, planes[i], tol, ambiguous);
+    if (!polyhedron.empty())
+      polyhedron_quadrature(polyhedron, weight, barycenter);
+  }
+  else
+  {
+    // Triangles intersect in a set of positive measure only if they
+    // are coplanar. Decide in exact arithmetic if not certain.
+    if (b.size() == 3)
+    {
+      ClipPlane plane;
+      if (!make_plane(b[0], b[1], b[2], b[0], plane))
+        return;
+      double max_distance = 0.0;
+      for (std::size_t i = 0; i < 3; ++i)
+      {
+        max_distance = std::max(max_distance,
+                                std::abs(plane.n.dot(a[i]) - plane.c));
+      }
+      if (max_distance > tol)
+        return;
+      exact = max_distance > 0.0;
+    }
+
+    // Clip triangle
+    Polygon polygon(a), clipped, cut;
+    for (std::size_t i = 0; i < planes.size() && !polygon.empty(); ++i)
+    {
+      clip_polygon(polygon, planes[i], tol, clipped, cut, ambiguous);
+      polygon.swap(clipped);
+      if (polygon.size() < 3)
+        polygon.clear();
+    }
+    if (!polygon.empty())
+      polygon_quadrature(polygon, weight, barycenter);
+  }
+
+  // Check the estimated error of the weight if some points were
+  // within the tolerance of a plane
+  if (ambiguous)
+  {
+    const double error = tol*std::pow(size, static_cast<double>(dim - 1));
+    exact = exact || weight*max_relative_error < error;
+  }
+
+  #ifdef HAS_CGAL
+  // Fall back to exact arithmetic
+  if (exact)
+  {
+    const Nef_polyhedron_3 polyhedron
+      = make_polyhedron(a)*make_polyhedron(b);
+    if (polyhedron.is_empty() || (dim == 3 && !has_volume(polyhedron)))
+      return;
+    compute_quadrature(polyhedron);
+    if (!(_weights.back() > 0.0))
+    {
+      _weights.pop_back();
+      _points.pop_back();
+    }
+    return;
+  }
+  #endif
+
+  if (weight > 0.0)
+  {
+    _weights.push_back(weight);
+    _points.push_back(barycenter);
+  }
+}
+//-----------------------------------------------------------------------------
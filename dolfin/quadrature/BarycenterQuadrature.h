@@ -16,37 +16,61 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // Modified by Anders Logg, 2010.
+// Modified by agent, 2026
 //
 // First added:  2010-03-17
-// Last changed: 2010-04-12
+// Last changed: 2026-10-16
 
 #ifndef  __BARYCENTER_QUADRATURE_H
 #define  __BARYCENTER_QUADRATURE_H
 
-#ifdef HAS_CGAL
-
 #include <vector>
+#include <dolfin/mesh/Point.h>
+
+#ifdef HAS_CGAL
 #include <CGAL/Exact_predicates_exact_constructions_kernel.h>
 #include <CGAL/Nef_polyhedron_3.h>
-#include <dolfin/mesh/Point.h>
+#endif
 
 namespace dolfin
 {
 
+  #ifdef HAS_CGAL
   typedef CGAL::Exact_predicates_exact_constructions_kernel Kernel;
   typedef CGAL::Nef_polyhedron_3<Kernel> Nef_polyhedron_3;
+  #endif
+
+  class Cell;
 
   /// This class computes the barycenter of an arbitrary polyhedron or
   /// polygon in 3D and therefore allows for barycenter quadrature on
   /// complex polyhedrons. Note: barycenter quadrature is exact for
   /// polynom deg <= 1.
+  ///
+  /// The quadrature rule for the intersection of two simplices
+  /// (tetrahedra or triangles in 3D) is computed in floating point,
+  /// by clipping one simplex against the faces of the other. If the
+  /// result cannot be trusted (nearly degenerate configurations),
+  /// it is recomputed with exact arithmetic (requires CGAL).
 
   class BarycenterQuadrature
   {
   public:
 
+    #ifdef HAS_CGAL
     /// Create barycenter quadrature rule for given CGAL polyhedron
     BarycenterQuadrature(const Nef_polyhedron_3& polyhedron);
+    #endif
+
+    /// Create barycenter quadrature rule for the intersection of two
+    /// simplices (tetrahedra or triangles), given by their vertices.
+    /// The rule is empty if the intersection has zero measure.
+    BarycenterQuadrature(const std::vector<Point>& simplex_0,
+                         const std::vector<Point>& simplex_1);
+
+    /// Create barycenter quadrature rule for the intersection of two
+    /// cells (tetrahedra or triangles)
+    BarycenterQuadrature(const Cell& cell_0, const Cell& cell_1);
 
     /// Return points
     const std::vector<Point>& points() const
@@ -62,8 +86,15 @@ namespace dolfin
 
   private:
 
+    #ifdef HAS_CGAL
     ///Computes barycenter and weight.
     void compute_quadrature(const Nef_polyhedron_3 &);
+    #endif
+
+    // Compute barycenter and weight of intersection of two simplices,
+    // in floating point if possible, otherwise with exact arithmetic
+    void compute_quadrature(const std::vector<Point>& simplex_0,
+                            const std::vector<Point>& simplex_1);
 
     std::vector<Point> _points;
     std::vector<double> _weights;
@@ -73,5 +104,3 @@ namespace dolfin
 }
 
 #endif
-
-#endif
@@ -35,6 +35,7 @@
 %import(module="dolfin.cpp.fem") "dolfin/fem/Form.h"
 %import(module="dolfin.cpp.fem") "dolfin/fem/Assembler.h"
 %import(module="dolfin.cpp.fem") "dolfin/fem/SparsityPatternBuilder.h"
+%import(module="dolfin.cpp.fem") "dolfin/fem/TensorLayoutCache.h"
 %import(module="dolfin.cpp.fem") "dolfin/fem/SymmetricAssembler.h"
 %import(module="dolfin.cpp.fem") "dolfin/fem/SystemAssembler.h"
 %import(module="dolfin.cpp.fem") "dolfin/fem/LinearVariationalProblem.h"
@@ -35,6 +35,7 @@
 %include "dolfin/fem/Form.h"
 %include "dolfin/fem/Assembler.h"
 %include "dolfin/fem/SparsityPatternBuilder.h"
+%include "dolfin/fem/TensorLayoutCache.h"
 %include "dolfin/fem/SymmetricAssembler.h"
 %include "dolfin/fem/SystemAssembler.h"
 %include "dolfin/fem/LinearVariationalProblem.h"
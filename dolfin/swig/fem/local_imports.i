@@ -35,6 +35,7 @@
 %import(module="fem") "dolfin/fem/Form.h"
 %import(module="fem") "dolfin/fem/Assembler.h"
 %import(module="fem") "dolfin/fem/SparsityPatternBuilder.h"
+%import(module="fem") "dolfin/fem/TensorLayoutCache.h"
 %import(module="fem") "dolfin/fem/SymmetricAssembler.h"
 %import(module="fem") "dolfin/fem/SystemAssembler.h"
 %import(module="fem") "dolfin/fem/LinearVariationalProblem.h"
@@ -285,6 +285,11 @@ PROBLEM_RENAMES(NonlinearVariational)
 //-----------------------------------------------------------------------------
 IN_TYPEMAP_STD_VECTOR_OF_STD_VECTOR_OF_SHARED_POINTERS(Form)
 
+//-----------------------------------------------------------------------------
+// Ignore access to cached layouts (only used by the assemblers)
+//-----------------------------------------------------------------------------
+%ignore dolfin::TensorLayoutCache::layout;
+
 //-----------------------------------------------------------------------------
 // Instantiate Hierarchical classes
 //-----------------------------------------------------------------------------
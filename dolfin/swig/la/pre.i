@@ -135,6 +135,7 @@
 %ignore dolfin::GenericTensor::get(double*, const  dolfin::la_index*,        const dolfin::la_index * const *) const;
 %ignore dolfin::GenericTensor::set(const double* , const dolfin::la_index* , const dolfin::la_index * const *);
 %ignore dolfin::GenericTensor::add(const double* , const dolfin::la_index* , const dolfin::la_index * const *);
+%ignore dolfin::GenericTensor::add_blocks;
 %ignore dolfin::PETScLinearOperator::wrapper;
 
 //-----------------------------------------------------------------------------
@@ -206,6 +207,15 @@
 %rename(assign) dolfin::uBLASMatrix<boost::numeric::ublas::matrix<double> >::operator=;
 %rename(assign) dolfin::uBLASMatrix<boost::numeric::ublas::compressed_matrix<double, boost::numeric::ublas::row_major> >::operator=;
 
+//-----------------------------------------------------------------------------
+// Modify CSRMatrix
+//-----------------------------------------------------------------------------
+%rename(assign) dolfin::CSRMatrix::operator=;
+%ignore dolfin::CSRMatrix::data;
+%ignore dolfin::CSRMatrix::row_offsets;
+%ignore dolfin::CSRMatrix::columns;
+%ignore dolfin::CSRMatrix::values;
+
 // Ignore reference version of constructor
 %ignore dolfin::PETScKrylovSolver(std::string, PETScPreconditioner&);
 %ignore dolfin::PETScKrylovSolver(std::string, PETScUserPreconditioner&);
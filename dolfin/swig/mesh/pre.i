@@ -22,7 +22,7 @@
 // Modified by Johan Hake 2008-2011
 //
 // First added:  2006-09-20
-// Last changed: 2013-05-22
+// Last changed: 2026-10-16
 
 //=============================================================================
 // SWIG directives for the DOLFIN Mesh kernel module (pre)
@@ -86,6 +86,14 @@ ALL_VALUES(dolfin::MeshFunction<std::size_t>, size_t)
 //-----------------------------------------------------------------------------
 %rename (_mark) dolfin::SubDomain::mark;
 
+//-----------------------------------------------------------------------------
+// Ignore the batched version of SubDomain::inside, so that the director
+// does not forward it to inside() when implemented in Python
+//-----------------------------------------------------------------------------
+%ignore dolfin::SubDomain::inside(std::vector<bool>&,
+                                  const dolfin::Array<double>&,
+                                  bool) const;
+
 //-----------------------------------------------------------------------------
 // Misc ignores
 //-----------------------------------------------------------------------------
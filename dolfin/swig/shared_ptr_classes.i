@@ -190,8 +190,10 @@
 %shared_ptr(dolfin::Matrix)
 %shared_ptr(dolfin::Vector)
 %shared_ptr(dolfin::LinearOperator)
+%shared_ptr(dolfin::TensorProductMatrix)
 
 %shared_ptr(dolfin::STLMatrix)
+%shared_ptr(dolfin::CSRMatrix)
 %shared_ptr(dolfin::uBLASMatrix<boost::numeric::ublas::matrix<double> >)
 %shared_ptr(dolfin::uBLASMatrix<boost::numeric::ublas::compressed_matrix<double,\
             boost::numeric::ublas::row_major> >)
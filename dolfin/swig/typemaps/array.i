@@ -86,6 +86,27 @@
 }
 %enddef
 
+//-----------------------------------------------------------------------------
+// Macro for defining an out-typemap for dolfin::ArrayView -> NumPy array.
+// The data is copied as the view does not own it.
+//
+// TYPE       : The primitive type
+// NUMPYTYPE  : The NumPy type of the returned array
+//-----------------------------------------------------------------------------
+%define OUT_NUMPY_TYPEMAP_FOR_DOLFIN_ARRAY_VIEW(TYPE, NUMPYTYPE)
+
+%typemap(out) dolfin::ArrayView<const TYPE>
+{
+  // OUT_NUMPY_TYPEMAP_FOR_DOLFIN_ARRAY_VIEW(TYPE, NUMPYTYPE)
+  npy_intp adims = (&$1)->size();
+
+  $result = PyArray_SimpleNew(1, &adims, NUMPYTYPE);
+  TYPE* data = static_cast<TYPE*>(PyArray_DATA(reinterpret_cast<PyArrayObject*>($result)));
+  std::copy((&$1)->begin(), (&$1)->end(), data);
+}
+
+%enddef
+
 //-----------------------------------------------------------------------------
 // Director typemaps for dolfin::Array
 //-----------------------------------------------------------------------------
@@ -117,3 +138,5 @@ IN_NUMPY_TYPEMAP_FOR_DOLFIN_ARRAY(dolfin::la_index, INT32, NPY_UINT, dolfin_inde
 OUT_NUMPY_TYPEMAP_FOR_DOLFIN_ARRAY(std::size_t, NPY_UINTP)
 OUT_NUMPY_TYPEMAP_FOR_DOLFIN_ARRAY(int, NPY_INT)
 OUT_NUMPY_TYPEMAP_FOR_DOLFIN_ARRAY(double, NPY_DOUBLE)
+
+OUT_NUMPY_TYPEMAP_FOR_DOLFIN_ARRAY_VIEW(dolfin::la_index, NPY_INT)
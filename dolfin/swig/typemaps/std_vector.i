@@ -17,7 +17,7 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2009-08-31
-// Last changed: 2013-06-06
+// Last changed: 2026-10-16
 
 //=============================================================================
 // In this file we declare what types that should be able to be passed using a
@@ -581,6 +581,8 @@ TYPEMAPS_STD_VECTOR_OF_POINTERS(Parameters)
 ARGOUT_TYPEMAP_STD_VECTOR_OF_PRIMITIVES(std::size_t, INT32, cells, NPY_UINTP)
 ARGOUT_TYPEMAP_STD_VECTOR_OF_PRIMITIVES(std::size_t, INT32, columns, NPY_INTP)
 ARGOUT_TYPEMAP_STD_VECTOR_OF_PRIMITIVES(std::size_t, INT32, dofs, NPY_INTP)
+ARGOUT_TYPEMAP_STD_VECTOR_OF_PRIMITIVES(unsigned int, INT32, offsets, NPY_UINT)
+ARGOUT_TYPEMAP_STD_VECTOR_OF_PRIMITIVES(unsigned int, INT32, entities, NPY_UINT)
 ARGOUT_TYPEMAP_STD_VECTOR_OF_PRIMITIVES(double, DOUBLE, , NPY_DOUBLE)
 
 // TYPE       : The primitive type
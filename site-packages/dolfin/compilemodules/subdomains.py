@@ -18,7 +18,7 @@
 # along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 #
 # First added:  2008-07-01
-# Last changed: 2011-04-18
+# Last changed: 2026-10-16
 
 import re
 import os
@@ -51,6 +51,18 @@ public:
     %(inside)s
   }
 
+  /// Compute which points are inside the sub domain (for many points)
+  void inside(std::vector<bool>& is_inside, const Array<double>& _x,
+              bool on_boundary) const
+  {
+    const std::size_t gdim = _x.size()/is_inside.size();
+    for (std::size_t i = 0; i < is_inside.size(); ++i)
+    {
+      const Array<double> x(gdim, const_cast<double*>(_x.data()) + i*gdim);
+      is_inside[i] = %(inside_expr)s;
+    }
+  }
+
 };
 """
 
@@ -85,6 +97,7 @@ def expression_to_subdomain(expr, classname):
     # Connect the code fragments using the function template code
     fragments["classname"] = classname
     fragments["inside"]    = insidecode
+    fragments["inside_expr"] = "(%s)" % expr
     #fragments["map"]       = mapcode
     code = _subdomain_template % fragments
     return code, members
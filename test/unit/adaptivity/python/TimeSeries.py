@@ -19,7 +19,7 @@
 #
 #
 # First added:  2011-06-16
-# Last changed: 2011-06-16
+# Last changed: 2026-10-16
 
 import unittest
 #from unittest import skipIf # Awaiting Python 2.7
@@ -102,6 +102,36 @@ class TimeSeriesTest(unittest.TestCase):
         series1.retrieve(m1, 0.1)
         series1.retrieve(x1, 0.15)
 
+    def test_hdf5_reverse_sweep(self):
+        "Test retrieve of interpolated values backward in time (HDF5)"
+
+        if not has_hdf5() or MPI.num_processes() > 1:
+            return
+
+        times = [t/10.0 for t in range(1, 11)]
+
+        writer = TimeSeriesHDF5("TimeSeriesHDF5_test_reverse_sweep")
+        x = Vector(20)
+        for t in times:
+            x[:] = t
+            writer.store(x, t)
+        del writer
+
+        series = TimeSeriesHDF5("TimeSeriesHDF5_test_reverse_sweep")
+        series.parameters["prefetch_steps"] = 3
+        self.assertEqual(len(series.vector_times()), len(times))
+
+        y = Vector()
+        for t in reversed(times[:-1]):
+            s = t + 0.05
+            series.retrieve(y, s)
+            self.assertEqual(y.size(), 20)
+            self.assertAlmostEqual(y.min(), s)
+            self.assertAlmostEqual(y.max(), s)
+
+            series.retrieve(y, t, False)
+            self.assertAlmostEqual(y.max(), t)
+
 if __name__ == "__main__":
     print ""
     print "Testing TimeSeries operations"
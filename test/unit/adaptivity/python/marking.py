@@ -0,0 +1,111 @@
+"""Unit tests for marking of cells for refinement"""
+
+# Copyright (C) 2026 agent
+#
+# This file is part of DOLFIN.
+#
+# DOLFIN is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# DOLFIN is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+#
+# First added:  2026-10-16
+# Last changed: 2026-10-16
+
+import unittest
+import numpy
+from dolfin import *
+
+class MarkingTest(unittest.TestCase):
+
+    def _mark(self, values, strategy, fraction, n=20):
+        mesh = UnitSquareMesh(n, n)
+        indicators = CellFunction("double", mesh)
+        indicators.array()[:] = values(mesh.num_cells())
+        markers = CellFunction("bool", mesh)
+        mark(markers, indicators, strategy, fraction)
+        return indicators.array(), markers.array()
+
+    def test_dorfler(self):
+        "Test that Dorfler marking marks the smallest sufficient set"
+
+        if MPI.num_processes() > 1:
+            return
+
+        eta, marked = self._mark(lambda n: numpy.arange(n, dtype="d"),
+                                 "dorfler", 0.5)
+
+        # Marked cells are the largest, and their sum reaches the fraction
+        self.assertTrue(eta[marked].min() > eta[numpy.logical_not(marked)].max())
+        self.assertTrue(eta[marked].sum() >= 0.5*eta.sum())
+        self.assertTrue(eta[marked].sum() - eta[marked].min() < 0.5*eta.sum())
+
+    def test_dorfler_large(self):
+        "Test Dorfler marking against sorting on a large mesh"
+
+        if MPI.num_processes() > 1:
+            return
+
+        # Use more cells (8192) than are gathered for sorting in
+        # marking.cpp (4096), so the threshold is bracketed by
+        # histograms (computed serially and by threads)
+        numpy.random.seed(2)
+        num_threads = parameters["num_threads"]
+        for threads in (0, 4):
+            parameters["num_threads"] = threads
+            for values in (lambda n: numpy.random.rand(n),
+                           lambda n: numpy.random.rand(n)**8,
+                           lambda n: numpy.random.randint(0, 50, n).astype("d")):
+                for fraction in (0.1, 0.5, 0.9):
+                    eta, marked = self._mark(values, "dorfler", fraction, 64)
+                    self.assertTrue(len(eta) > 4096)
+
+                    # Smallest threshold of largest indicators reaching
+                    # the fraction (cells with equal indicators are marked)
+                    eta_sorted = numpy.sort(eta)[::-1]
+                    k = numpy.searchsorted(numpy.cumsum(eta_sorted),
+                                           fraction*eta.sum())
+                    self.assertTrue((marked == (eta >= eta_sorted[k])).all())
+        parameters["num_threads"] = num_threads
+
+    def test_dorfler_ties(self):
+        "Test that Dorfler marking marks all cells with equal indicators"
+
+        eta, marked = self._mark(lambda n: numpy.ones(n), "dorfler", 0.3)
+        self.assertTrue(marked.all())
+
+        eta, marked = self._mark(lambda n: numpy.arange(n) % 4, "dorfler", 0.4)
+        self.assertTrue(marked[eta == 3].all())
+        self.assertFalse(marked[eta < 3].any())
+
+    def test_strategies(self):
+        "Test maximum, equidistribution and recursive marking"
+
+        if MPI.num_processes() > 1:
+            return
+
+        values = lambda n: numpy.arange(n, dtype="d") % 10
+
+        eta, marked = self._mark(values, "maximum", 0.7)
+        self.assertTrue((marked == (eta >= 0.7*9)).all())
+
+        eta, marked = self._mark(values, "equidistribution", 1.0)
+        self.assertTrue((marked == (eta >= 4.5)).all())
+
+        eta, marked = self._mark(values, "recursive", 0.5)
+        self.assertTrue(eta[marked].sum() >= 0.5*eta.sum())
+        self.assertTrue(marked[eta == 9].all())
+
+if __name__ == "__main__":
+    print ""
+    print "Testing marking of cells"
+    print "------------------------------------------------"
+    unittest.main()
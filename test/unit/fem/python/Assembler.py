@@ -21,7 +21,7 @@
 # Modified by Anders Logg 2011
 #
 # First added:  2011-03-12
-# Last changed: 2011-03-12
+# Last changed: 2026-10-16
 
 import unittest
 import numpy
@@ -363,6 +363,78 @@ class Assembly(unittest.TestCase):
         self.assertAlmostEqual(assemble(L).norm("l2"), b_l2_norm, 10)
         parameters["num_threads"] = 0
 
+    def test_colored_interior_facet_assembly(self):
+
+        # Coloring and renumbering not supported in parallel
+        if MPI.num_processes() != 1:
+            return
+
+        # Create mesh, then color and renumber
+        old_mesh = UnitCubeMesh(4, 4, 4)
+        old_mesh.color("vertex")
+        mesh = old_mesh.renumber_by_color()
+
+        n = FacetNormal(mesh)
+        h = CellSize(mesh)
+        h_avg = (h('+') + h('-'))/2
+
+        # Test both cell-local (DG) and continuous dof maps
+        for family in ["DG", "CG"]:
+            V = FunctionSpace(mesh, family, 1)
+            v = TestFunction(V)
+            u = TrialFunction(V)
+            f = Function(V)
+            f.vector()[:] = 1.0
+            a = inner(jump(v, n), jump(u, n))/h_avg*dS \
+                + inner(avg(grad(v)), jump(u, n))*dS
+            L = inner(avg(v), avg(f))*dS
+            M = jump(f)**2*dS + avg(f)*dS
+
+            # Assemble serially
+            A_frobenius_norm = assemble(a).norm("frobenius")
+            b_l2_norm = assemble(L).norm("l2")
+            m = assemble(M)
+
+            # Assemble multi-threaded and compare
+            parameters["num_threads"] = 4
+            self.assertAlmostEqual(assemble(a).norm("frobenius"), A_frobenius_norm, 10)
+            self.assertAlmostEqual(assemble(L).norm("l2"), b_l2_norm, 10)
+            self.assertAlmostEqual(assemble(M), m, 10)
+            parameters["num_threads"] = 0
+
+    def test_cell_block_assembly(self):
+
+        mesh = UnitSquareMesh(8, 8)
+        V = FunctionSpace(mesh, "CG", 2)
+        v = TestFunction(V)
+        u = TrialFunction(V)
+        f = Expression("1.0 + x[0]*x[1]")
+        a = f*inner(grad(u), grad(v))*dx
+        L = f*v*dx
+        M = interpolate(f, V)*dx
+
+        # Reference values from cell-by-cell assembly
+        A_frobenius_norm = assemble(a).norm("frobenius")
+        b_l2_norm = assemble(L).norm("l2")
+        m = assemble(M)
+
+        # Assemble in blocks of cells (block size not a divisor of
+        # the number of cells)
+        assembler = Assembler()
+        assembler.cell_block_size = 7
+
+        A = Matrix()
+        assembler.assemble(A, Form(a))
+        self.assertAlmostEqual(A.norm("frobenius"), A_frobenius_norm, 10)
+
+        b = Vector()
+        assembler.assemble(b, Form(L))
+        self.assertAlmostEqual(b.norm("l2"), b_l2_norm, 10)
+
+        s = Scalar()
+        assembler.assemble(s, Form(M))
+        self.assertAlmostEqual(s.getval(), m, 10)
+
     def test_nonsquare_assembly(self):
         """Test assembly of a rectangular matrix"""
 
@@ -387,6 +459,45 @@ class Assembly(unittest.TestCase):
                                    A_frobenius_norm, 10)
             parameters["num_threads"] = 0
 
+    def test_sparsity_cache(self):
+        """Test reuse of sparsity pattern in repeated assembly"""
+
+        mesh = UnitSquareMesh(8, 8)
+        V = FunctionSpace(mesh, "CG", 1)
+        v = TestFunction(V)
+        u = TrialFunction(V)
+        a = u*v*dx
+        A_frobenius_norm = assemble(a).norm("frobenius")
+
+        # Repeated assembly reuses the cached layout
+        cache_sparsity = parameters["cache_sparsity"]
+        parameters["cache_sparsity"] = True
+        TensorLayoutCache.clear()
+        self.assertAlmostEqual(assemble(a).norm("frobenius"),
+                               A_frobenius_norm, 12)
+        self.assertEqual(TensorLayoutCache.size(), 1)
+        self.assertAlmostEqual(assemble(2*u*v*dx).norm("frobenius"),
+                               2*A_frobenius_norm, 12)
+        self.assertEqual(TensorLayoutCache.size(), 1)
+
+        # Pre-structured matrix
+        A = TensorLayoutCache.create_matrix(Form(a))
+        assemble(a, tensor=A, reset_sparsity=False)
+        self.assertAlmostEqual(A.norm("frobenius"), A_frobenius_norm, 12)
+
+        # New function space gives new layout
+        W = FunctionSpace(mesh, "CG", 2)
+        assemble(TestFunction(W)*TrialFunction(W)*dx)
+        self.assertEqual(TensorLayoutCache.size(), 2)
+
+        # Cache can be turned off
+        TensorLayoutCache.clear()
+        parameters["cache_sparsity"] = False
+        self.assertAlmostEqual(assemble(a).norm("frobenius"),
+                               A_frobenius_norm, 12)
+        self.assertEqual(TensorLayoutCache.size(), 0)
+        parameters["cache_sparsity"] = cache_sparsity
+
     def test_reference_assembly(self):
         "Test assembly against a reference solution"
 
@@ -22,7 +22,7 @@
 # Modified by Martin Alnaes 2012
 #
 # First added:  2011-09-19
-# Last changed: 2012-10-16
+# Last changed: 2026-10-16
 
 import unittest
 import numpy
@@ -133,6 +133,56 @@ class DirichletBCTest(unittest.TestCase):
             b1 = assemble(inner(u, u)*dx)
             self.assertAlmostEqual(b0, b1)
 
+    def test_repeated_apply(self):
+        "Test that cached boundary dofs give the same result on reapplication"
+
+        mesh = UnitSquareMesh(8, 8)
+        V = FunctionSpace(mesh, "CG", 2)
+        g = Constant(1.0)
+        boundary = "near(x[0], 0.0) || near(x[0], 1.0)"
+        for method in ["topological", "geometric", "pointwise"]:
+            bc = DirichletBC(V, g, boundary, method)
+            u0 = Function(V)
+            bc.apply(u0.vector())
+
+            # Change value (boundary dofs are reused)
+            g.assign(2.0)
+            u1 = Function(V)
+            bc.apply(u1.vector())
+            self.assertAlmostEqual(u1.vector().norm("l2"),
+                                   2.0*u0.vector().norm("l2"))
+
+            # Compare with other method (boundary dofs are recomputed)
+            values = bc.get_boundary_values("pointwise")
+            self.assertEqual(len(values), len(bc.get_boundary_values()))
+            g.assign(1.0)
+
+        # Refined mesh gives new boundary dofs
+        mesh = refine(mesh)
+        V = FunctionSpace(mesh, "CG", 1)
+        bc = DirichletBC(V, g, "on_boundary")
+        u = Function(V)
+        bc.apply(u.vector())
+        self.assertAlmostEqual(u.vector().sum(), 4*16.0)
+
+    def test_moved_mesh(self):
+        "Test that boundary dofs are recomputed when the mesh is moved"
+
+        for method in ["geometric", "pointwise"]:
+            mesh = UnitSquareMesh(8, 8)
+            V = FunctionSpace(mesh, "CG", 1)
+            bc = DirichletBC(V, 1.0, "near(x[0], 1.0)", method)
+            u0 = Function(V)
+            bc.apply(u0.vector())
+
+            # Stretch mesh in place such that x = 0.5 moves to x = 1
+            mesh.coordinates()[:, 0] *= 2.0
+            u1 = Function(V)
+            bc.apply(u1.vector())
+            self.assertAlmostEqual(u1.vector().sum(), u0.vector().sum())
+            self.assertNotAlmostEqual(u1.vector().inner(u0.vector()),
+                                      u0.vector().inner(u0.vector()))
+
 if __name__ == "__main__":
     print ""
     print "Testing Dirichlet boundary conditions"
@@ -18,7 +18,7 @@
 # along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 #
 # First added:  2013-02-13
-# Last changed:
+# Last changed: 2026-10-16
 
 import unittest
 import numpy
@@ -51,6 +51,69 @@ class LocalSolver(unittest.TestCase):
         x[:] = 10.0
         self.assertAlmostEqual((u.vector() - x).norm("l2"), 0.0, 10)
 
+    def test_local_solve_factorized(self):
+
+        mesh = UnitSquareMesh(16, 16)
+        V = FunctionSpace(mesh, "DG", 2)
+
+        v = TestFunction(V)
+        u = TrialFunction(V)
+        f = Constant(10.0)
+        g = Expression("x[0]*x[1]")
+
+        # Forms for projection
+        a = Form(inner(v, u)*dx)
+        L0 = Form(inner(v, f)*dx)
+        L1 = Form(inner(v, g)*dx)
+
+        # Reference solutions
+        u0, u1 = Function(V), Function(V)
+        local_solver = cpp.LocalSolver()
+        local_solver.solve(u0.vector(), a, L0)
+        local_solver.solve(u1.vector(), a, L1, True)
+
+        # Solve with stored factorizations (Cholesky and LU)
+        for symmetric in [True, False]:
+            local_solver.factorize(a, symmetric)
+            w = Function(V)
+            local_solver.solve(w.vector(), L0)
+            self.assertAlmostEqual((w.vector() - u0.vector()).norm("l2"), 0.0, 10)
+            local_solver.solve(w.vector(), L1)
+            self.assertAlmostEqual((w.vector() - u1.vector()).norm("l2"), 0.0, 10)
+
+        local_solver.clear_factorization()
+
+    def test_local_solve_factorized_indefinite(self):
+
+        # Local saddle point problems (symmetric indefinite), for
+        # which the Cholesky factorization fails and LU is used
+        mesh = UnitSquareMesh(8, 8)
+        V = VectorFunctionSpace(mesh, "DG", 1)
+        Q = FunctionSpace(mesh, "DG", 0)
+        W = V*Q
+
+        (u, p) = TrialFunctions(W)
+        (v, q) = TestFunctions(W)
+        f = Expression(("x[0]", "x[1]*x[1]"))
+        g = Expression("x[0]*x[1]")
+
+        a = Form(inner(u, v)*dx + div(v)*p*dx + div(u)*q*dx)
+        L = Form(inner(f, v)*dx + g*q*dx)
+
+        # Reference solution
+        w0 = Function(W)
+        local_solver = cpp.LocalSolver()
+        local_solver.solve(w0.vector(), a, L)
+
+        # Solve with stored factorizations
+        for symmetric in [True, False]:
+            local_solver.factorize(a, symmetric)
+            w = Function(W)
+            local_solver.solve(w.vector(), L)
+            self.assertAlmostEqual((w.vector() - w0.vector()).norm("l2"), 0.0, 10)
+
+        local_solver.clear_factorization()
+
 
 if __name__ == "__main__":
     print ""
@@ -18,7 +18,7 @@
 # along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 #
 # First added:  2011-03-23
-# Last changed: 2011-03-23
+# Last changed: 2026-10-16
 
 import unittest
 from dolfin import *
@@ -290,6 +290,28 @@ class Interpolate(unittest.TestCase):
 
             self.assertAlmostEqual(f3(0.,-1), 1.0)
 
+    def test_eval_points(self):
+        from numpy import array, zeros, random
+        if MPI.num_processes() == 1:
+            random.seed(1)
+            x = random.random(3*100)
+
+            # Linear function is represented exactly in V
+            u = interpolate(Expression("x[0] + 2.0*x[1] - x[2]"), V)
+            values = zeros(100)
+            u.eval_points(values, x)
+            X = x.reshape(100, 3)
+            exact = X[:, 0] + 2.0*X[:, 1] - X[:, 2]
+            self.assertAlmostEqual(abs(values - exact).max(), 0.0)
+
+            # Vector valued function, multi-threaded
+            w = interpolate(Expression(("x[0]", "x[1]", "x[2]")), W)
+            values = zeros(300)
+            parameters["num_threads"] = 2
+            w.eval_points(values, x)
+            parameters["num_threads"] = 0
+            self.assertAlmostEqual(abs(values - x).max(), 0.0)
+
     def test_interpolation_jit_rank1(self):
         f = Expression(("1.0", "1.0", "1.0"))
         w = interpolate(f, W)
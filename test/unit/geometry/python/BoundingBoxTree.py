@@ -18,7 +18,7 @@
 # along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 #
 # First added:  2013-04-15
-# Last changed: 2013-06-06
+# Last changed: 2026-10-16
 
 import unittest
 import numpy
@@ -26,7 +26,7 @@ import numpy
 from dolfin import BoundingBoxTree
 from dolfin import UnitIntervalMesh, UnitSquareMesh, UnitCubeMesh
 from dolfin import Point
-from dolfin import MPI
+from dolfin import MPI, parameters
 
 class BoundingBoxTreeTest(unittest.TestCase):
 
@@ -238,6 +238,95 @@ class BoundingBoxTreeTest(unittest.TestCase):
             self.assertEqual(entity, reference[0])
             self.assertAlmostEqual(distance, reference[1])
 
+    #--- batched queries ---
+
+    def test_batched_queries(self):
+
+        mesh = UnitCubeMesh(8, 8, 8)
+        tree = BoundingBoxTree()
+        tree.build(mesh)
+
+        numpy.random.seed(1)
+        x = numpy.random.uniform(-0.2, 1.2, (50, 3))
+        points = [Point(*xi) for xi in x]
+
+        for num_threads in [0, 2]:
+            parameters["num_threads"] = num_threads
+
+            offsets, entities = tree.compute_entity_collisions(x.flatten(), mesh)
+            self.assertEqual(len(offsets), len(points) + 1)
+            for i, p in enumerate(points):
+                self.assertEqual(list(entities[offsets[i]:offsets[i + 1]]),
+                                 list(tree.compute_entity_collisions(p, mesh)))
+
+            offsets, entities = tree.compute_collisions(x.flatten())
+            for i, p in enumerate(points):
+                self.assertEqual(list(entities[offsets[i]:offsets[i + 1]]),
+                                 list(tree.compute_collisions(p)))
+
+            entities = tree.compute_first_entity_collisions(x.flatten(), mesh)
+            for i, p in enumerate(points):
+                self.assertEqual(entities[i],
+                                 tree.compute_first_entity_collision(p, mesh))
+
+            entities, distances = tree.compute_closest_entities(x.flatten(), mesh)
+            for i, p in enumerate(points):
+                entity, distance = tree.compute_closest_entity(p, mesh)
+                self.assertAlmostEqual(distances[i], distance)
+
+        parameters["num_threads"] = 0
+
+    #--- build and refit ---
+
+    def test_threaded_build(self):
+
+        mesh = UnitCubeMesh(8, 8, 8)
+        p = Point(0.3, 0.3, 0.3)
+        tree = BoundingBoxTree()
+        tree.build(mesh)
+        reference = tree.compute_entity_collisions(p, mesh)
+
+        parameters["num_threads"] = 2
+        tree = BoundingBoxTree()
+        tree.build(mesh)
+        self.assertEqual(list(tree.compute_entity_collisions(p, mesh)),
+                         list(reference))
+        parameters["num_threads"] = 0
+
+    def test_refit(self):
+
+        mesh = UnitCubeMesh(8, 8, 8)
+        tree = BoundingBoxTree()
+        tree.build(mesh)
+        tree.compute_closest_entity(Point(-1.0, -1.0, -1.0), mesh)
+
+        # Move mesh and update tree
+        mesh.coordinates()[:] *= 2.0
+        tree.refit(mesh)
+
+        p = Point(0.6, 0.6, 0.6)
+        reference = [876, 877, 878, 879, 880, 881]
+        if MPI.num_processes() == 1:
+            self.assertEqual(sorted(tree.compute_entity_collisions(p, mesh)),
+                             reference)
+
+        entity, distance = tree.compute_closest_entity(Point(-1.0, -1.0, -1.0), mesh)
+        if MPI.num_processes() == 1:
+            self.assertAlmostEqual(distance, numpy.sqrt(3.0))
+
+    def test_refit_points(self):
+
+        points = [Point(float(i), 0.0) for i in range(10)]
+        tree = BoundingBoxTree()
+        tree.build(points, 2)
+        self.assertEqual(list(tree.compute_collisions(Point(3.0, 0.0))), [3])
+
+        # Move points and update tree
+        points = [Point(float(i), 1.0) for i in range(10)]
+        tree.refit(points)
+        self.assertEqual(list(tree.compute_collisions(Point(3.0, 0.0))), [])
+        self.assertEqual(list(tree.compute_collisions(Point(3.0, 1.0))), [3])
+
 if __name__ == "__main__":
     print ""
     print "Testing BoundingBoxTree"
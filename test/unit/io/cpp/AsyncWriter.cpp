@@ -0,0 +1,169 @@
+// Copyright (C) 2026 agent
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+//
+// First added:  2026-10-16
+// Last changed: 2026-10-16
+//
+// Unit tests for AsyncWriter
+
+#include <stdexcept>
+#include <vector>
+#include <boost/bind.hpp>
+#include <boost/ref.hpp>
+#include <boost/thread.hpp>
+
+#include <dolfin.h>
+#include <dolfin/common/unittest.h>
+#include <dolfin/io/AsyncWriter.h>
+
+using namespace dolfin;
+
+// Job appending value to list
+void append(std::vector<int>& values, int value)
+{
+  values.push_back(value);
+}
+
+// Job failing with given message
+void fail(std::string message)
+{
+  throw std::runtime_error(message);
+}
+
+// Gate blocking jobs until opened
+class Gate
+{
+public:
+
+  Gate() : _open(false) {}
+
+  void pass()
+  {
+    boost::mutex::scoped_lock lock(_mutex);
+    while (!_open)
+      _opened.wait(lock);
+  }
+
+  void open()
+  {
+    {
+      boost::mutex::scoped_lock lock(_mutex);
+      _open = true;
+    }
+    _opened.notify_all();
+  }
+
+private:
+
+  bool _open;
+  boost::mutex _mutex;
+  boost::condition_variable _opened;
+
+};
+
+class AsyncWriterTest : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(AsyncWriterTest);
+  CPPUNIT_TEST(test_order);
+  CPPUNIT_TEST(test_bounded_queue);
+  CPPUNIT_TEST(test_error);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void test_order()
+  {
+    // Jobs are executed in order of submission
+    std::vector<int> values;
+    AsyncWriter writer(3);
+    for (int i = 0; i < 100; i++)
+      writer.submit(boost::bind(append, boost::ref(values), i));
+    writer.wait();
+
+    CPPUNIT_ASSERT(writer.num_pending() == 0);
+    CPPUNIT_ASSERT(values.size() == 100);
+    for (int i = 0; i < 100; i++)
+      CPPUNIT_ASSERT(values[i] == i);
+  }
+
+  void test_bounded_queue()
+  {
+    // Block output thread and fill queue
+    std::vector<int> values;
+    Gate gate;
+    AsyncWriter writer(2);
+    writer.submit(boost::bind(&Gate::pass, &gate));
+    writer.submit(boost::bind(append, boost::ref(values), 0));
+    CPPUNIT_ASSERT(writer.num_pending() == 2);
+
+    // Submitting another job blocks until there is room in the queue
+    const boost::function<void ()> job
+      = boost::bind(append, boost::ref(values), 1);
+    boost::thread thread(boost::bind(&AsyncWriter::submit, &writer, job));
+    boost::this_thread::sleep(boost::posix_time::milliseconds(100));
+    CPPUNIT_ASSERT(writer.num_pending() == 2);
+    CPPUNIT_ASSERT(values.empty());
+
+    // Open gate and wait for all jobs
+    gate.open();
+    thread.join();
+    writer.wait();
+    CPPUNIT_ASSERT(writer.num_pending() == 0);
+    CPPUNIT_ASSERT(values.size() == 2);
+    CPPUNIT_ASSERT(values[0] == 0 && values[1] == 1);
+  }
+
+  void test_error()
+  {
+    // Jobs after failed jobs are still executed, and the first error
+    // is reported by wait(). The jobs are submitted while the output
+    // thread is blocked, so submit() does not report the error.
+    std::vector<int> values;
+    Gate gate;
+    AsyncWriter writer(5);
+    writer.submit(boost::bind(&Gate::pass, &gate));
+    writer.submit(boost::bind(fail, std::string("first")));
+    writer.submit(boost::bind(append, boost::ref(values), 0));
+    writer.submit(boost::bind(fail, std::string("second")));
+    writer.submit(boost::bind(append, boost::ref(values), 1));
+    gate.open();
+
+    bool reported = false;
+    try
+    {
+      writer.wait();
+    }
+    catch (std::runtime_error& e)
+    {
+      reported = true;
+      CPPUNIT_ASSERT(std::string(e.what()).find("first") != std::string::npos);
+    }
+    CPPUNIT_ASSERT(reported);
+    CPPUNIT_ASSERT(values.size() == 2);
+
+    // Errors are only reported once
+    writer.wait();
+  }
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(AsyncWriterTest);
+
+int main()
+{
+  DOLFIN_TEST;
+}
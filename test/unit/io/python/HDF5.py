@@ -18,9 +18,10 @@
 # along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 #
 # Modified by Chris Richardson 2013
+# Modified by agent, 2026
 #
 # First added:  2012-09-14
-# Last changed: 2013-05-24
+# Last changed: 2026-10-16
 
 import unittest
 from dolfin import *
@@ -50,6 +51,27 @@ if has_hdf5():
             self.assertEqual(y.size(), x.size())
             self.assertEqual((x - y).norm("l1"), 0.0)
 
+        def test_save_and_read_vector_chunked(self):
+            # Write to file with small chunks and compression
+            x = Vector(305)
+            x[:] = 1.2
+            vector_file = HDF5File("vector_chunked.h5", "w")
+            vector_file.parameters["chunking"] = True
+            vector_file.parameters["chunk_size"] = 16
+            if MPI.num_processes() == 1:
+                vector_file.parameters["compression"] = 4
+                vector_file.parameters["shuffle"] = True
+            vector_file.write(x, "/my_vector")
+            del vector_file
+
+            # Read from file, independently
+            y = Vector()
+            vector_file = HDF5File("vector_chunked.h5", "r")
+            vector_file.parameters["collective_read"] = False
+            vector_file.read(y, "/my_vector")
+            self.assertEqual(y.size(), x.size())
+            self.assertEqual((x - y).norm("l1"), 0.0)
+
     class HDF5_MeshFunction(unittest.TestCase):
 
         def test_save_and_read_meshfunction_2D(self):
@@ -159,6 +181,45 @@ if has_hdf5():
             dim = mesh0.topology().dim()
             self.assertEqual(mesh0.size_global(dim), mesh1.size_global(dim))
 
+    class HDF5_Function(unittest.TestCase):
+
+        def test_save_and_read_function(self):
+            # Write to file
+            mesh0 = UnitSquareMesh(10, 10)
+            V0 = VectorFunctionSpace(mesh0, "Lagrange", 2)
+            f = Expression(("x[0]*x[1]", "x[0] + 2.0*x[1]*x[1]"))
+            u0 = interpolate(f, V0)
+            hdf5_file = HDF5File("function.h5", "w")
+            hdf5_file.write(mesh0, "/mesh")
+            hdf5_file.write(u0, "/u")
+            del hdf5_file
+
+            # Read back on the same mesh
+            hdf5_file = HDF5File("function.h5", "r")
+            u1 = Function(V0)
+            hdf5_file.read(u1, "/u")
+            self.assertEqual((u0.vector() - u1.vector()).norm("linf"), 0.0)
+
+            # Read back on the mesh in file (possibly distributed
+            # differently). Toggle dof reordering so that the dof
+            # numbering differs also in serial and the values must be
+            # redistributed.
+            mesh1 = Mesh()
+            hdf5_file.read(mesh1, "/mesh")
+            reorder_dofs = parameters["reorder_dofs_serial"]
+            parameters["reorder_dofs_serial"] = not reorder_dofs
+            V1 = VectorFunctionSpace(mesh1, "Lagrange", 2)
+            parameters["reorder_dofs_serial"] = reorder_dofs
+            if MPI.num_processes() == 1:
+                self.assertTrue(any(list(V0.dofmap().cell_dofs(i)) !=
+                                    list(V1.dofmap().cell_dofs(i))
+                                    for i in range(mesh1.num_cells())))
+            u2 = Function(V1)
+            hdf5_file.read(u2, "/u")
+            u3 = interpolate(f, V1)
+            self.assertAlmostEqual((u2.vector() - u3.vector()).norm("linf"),
+                                   0.0, 12)
+
 
 if __name__ == "__main__":
     unittest.main()
@@ -17,8 +17,10 @@
 # You should have received a copy of the GNU Lesser General Public License
 # along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 #
+# Modified by agent, 2026
+#
 # First added:  2012-09-14
-# Last changed: 2013-03-05
+# Last changed: 2026-10-16
 
 import unittest
 from dolfin import *
@@ -120,6 +122,55 @@ if has_hdf5():
             u.vector()[:] = 3.0
             file << (u, 0.3)
 
+        def test_save_series_without_mesh_rewrite(self):
+            mesh = UnitSquareMesh(8, 8)
+            u = Function(FunctionSpace(mesh, "Lagrange", 1))
+            file = XDMFFile("output/u_series.xdmf")
+            file.parameters["rewrite_function_mesh"] = False
+            for i in range(10):
+                u.vector()[:] = float(i)
+                file << (u, 0.1*i)
+
+                # File is complete after flush, also during time series
+                if i == 4:
+                    file.flush()
+                    self.check_series("output/u_series.xdmf", 5)
+            del file
+            self.check_series("output/u_series.xdmf", 10)
+
+        def test_save_series_asynchronous(self):
+            mesh = UnitSquareMesh(8, 8)
+            u = Function(FunctionSpace(mesh, "Lagrange", 1))
+            for rewrite_mesh in [False, True]:
+                file = XDMFFile("output/u_async.xdmf")
+                file.parameters["asynchronous_output"] = True
+                file.parameters["rewrite_function_mesh"] = rewrite_mesh
+                for i in range(10):
+                    u.vector()[:] = float(i)
+                    file << (u, 0.1*i)
+                    if i == 4:
+                        file.flush()
+                        self.check_series("output/u_async.xdmf", 5,
+                                          not rewrite_mesh)
+                del file
+                self.check_series("output/u_async.xdmf", 10, not rewrite_mesh)
+
+        def check_series(self, filename, num_steps, same_mesh=True):
+            if MPI.process_number() != 0:
+                return
+            import xml.etree.ElementTree as ET
+            series = ET.parse(filename).getroot().find("Domain").find("Grid")
+            grids = series.findall("Grid")
+            self.assertEqual(len(grids), num_steps)
+
+            # Check whether all time steps refer to the same mesh
+            topologies = set(g.find("Topology").find("DataItem").text.strip()
+                             for g in grids)
+            self.assertEqual(len(topologies), 1 if same_mesh else num_steps)
+            for i, g in enumerate(grids):
+                self.assertAlmostEqual(float(g.find("Time").get("Value")),
+                                       0.1*i)
+
         def test_save_2d_tensor(self):
             mesh = UnitSquareMesh(16, 16)
             u = Function(TensorFunctionSpace(mesh, "Lagrange", 2))
@@ -0,0 +1,110 @@
+// Copyright (C) 2026 agent
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+//
+// First added:  2026-10-16
+// Last changed: 2026-10-16
+//
+// Unit tests for SparsityPattern
+
+#include <dolfin.h>
+#include <dolfin/common/unittest.h>
+
+#ifdef HAS_OPENMP
+#include <omp.h>
+#endif
+
+using namespace dolfin;
+
+class TestSparsityPattern : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TestSparsityPattern);
+  CPPUNIT_TEST(test_repeated_apply);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void test_repeated_apply()
+  {
+    if (dolfin::MPI::num_processes() > 1)
+      return;
+
+    // Create 4 x 4 pattern with one buffer for each of two threads
+    const int num_threads = parameters["num_threads"];
+    parameters["num_threads"] = 2;
+    std::vector<std::size_t> dims(2, 4);
+    std::vector<std::pair<std::size_t, std::size_t> >
+      ranges(2, std::make_pair(0, 4));
+    boost::unordered_map<std::size_t, unsigned int> off_process_owner;
+    std::vector<const boost::unordered_map<std::size_t, unsigned int>* >
+      owners(2, &off_process_owner);
+    SparsityPattern pattern(0);
+    pattern.init(dims, ranges, owners);
+    parameters["num_threads"] = num_threads;
+
+    // Insert entries (0, 2) and (0, 3) from first thread and apply
+    dolfin::la_index rows[1] = {0};
+    dolfin::la_index cols0[2] = {2, 3};
+    insert(pattern, rows, 1, cols0, 2, 0);
+    pattern.apply();
+
+    // Insert entries (0, 0), (0, 1) and (0, 3) from second thread and
+    // apply again
+    dolfin::la_index cols1[3] = {3, 0, 1};
+    insert(pattern, rows, 1, cols1, 3, 1);
+    pattern.apply();
+
+    // Check that row is sorted and without duplicates
+    const std::vector<std::vector<std::size_t> > p
+      = pattern.diagonal_pattern(GenericSparsityPattern::unsorted);
+    CPPUNIT_ASSERT(p.size() == 4);
+    CPPUNIT_ASSERT(p[0].size() == 4);
+    for (std::size_t j = 0; j < 4; j++)
+      CPPUNIT_ASSERT(p[0][j] == j);
+    CPPUNIT_ASSERT(pattern.num_nonzeros() == 4);
+  }
+
+private:
+
+  // Insert entries from given thread (if available)
+  void insert(SparsityPattern& pattern,
+              const dolfin::la_index* rows, std::size_t m,
+              const dolfin::la_index* cols, std::size_t n,
+              int thread)
+  {
+    std::vector<ArrayView<const dolfin::la_index> > entries;
+    entries.push_back(ArrayView<const dolfin::la_index>(m, rows));
+    entries.push_back(ArrayView<const dolfin::la_index>(n, cols));
+
+    #ifdef HAS_OPENMP
+    #pragma omp parallel num_threads(2)
+    {
+      if (omp_get_thread_num() == thread % omp_get_num_threads())
+        pattern.insert(entries);
+    }
+    #else
+    pattern.insert(entries);
+    #endif
+  }
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestSparsityPattern);
+
+int main()
+{
+  DOLFIN_TEST;
+}
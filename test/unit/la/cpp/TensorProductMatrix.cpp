@@ -0,0 +1,115 @@
+// Copyright (C) 2026 agent
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+//
+// First added:  2026-10-16
+// Last changed: 2026-10-16
+//
+// Unit tests for TensorProductMatrix
+
+#include <dolfin.h>
+#include <dolfin/common/unittest.h>
+
+using namespace dolfin;
+
+class TestTensorProductMatrix : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TestTensorProductMatrix);
+  CPPUNIT_TEST(test_mult);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void test_mult()
+  {
+    if (dolfin::MPI::num_processes() > 1)
+      return;
+
+    parameters["linear_algebra_backend"] = "uBLAS";
+
+    // Create factors B (3 x 2), C (2 x 4) and D (2 x 2)
+    const std::size_t m[3] = {3, 2, 2};
+    const std::size_t n[3] = {2, 4, 2};
+    std::vector<boost::shared_ptr<const GenericMatrix> > factors;
+    std::vector<std::vector<double> > F(3);
+    for (std::size_t k = 0; k < 3; k++)
+    {
+      boost::shared_ptr<uBLASDenseMatrix> A(new uBLASDenseMatrix(m[k], n[k]));
+      for (dolfin::la_index i = 0; i < (dolfin::la_index) m[k]; i++)
+      {
+        for (dolfin::la_index j = 0; j < (dolfin::la_index) n[k]; j++)
+        {
+          const double value = (i == j ? 0.0 : 1.0 + k + i - 0.5*j);
+          A->set(&value, 1, &i, 1, &j);
+          F[k].push_back(value);
+        }
+      }
+      A->apply("insert");
+      factors.push_back(A);
+    }
+    TensorProductMatrix A(factors);
+    CPPUNIT_ASSERT(A.size(0) == 12);
+    CPPUNIT_ASSERT(A.size(1) == 16);
+
+    // Create vector
+    Vector x(16);
+    std::vector<double> values(16);
+    for (std::size_t i = 0; i < 16; i++)
+      values[i] = 1.0 + i*i;
+    x.set_local(values);
+    x.apply("insert");
+
+    // Compute product
+    Vector y;
+    A.mult(x, y);
+    CPPUNIT_ASSERT(y.size() == 12);
+
+    // Compare with product computed from Kronecker product
+    std::vector<double> y_values;
+    y.get_local(y_values);
+    for (std::size_t i = 0; i < 3; i++)
+      for (std::size_t k = 0; k < 2; k++)
+        for (std::size_t p = 0; p < 2; p++)
+        {
+          double y_ref = 0.0;
+          for (std::size_t j = 0; j < 2; j++)
+            for (std::size_t l = 0; l < 4; l++)
+              for (std::size_t q = 0; q < 2; q++)
+                y_ref += F[0][i*2 + j]*F[1][k*4 + l]*F[2][p*2 + q]
+                  *values[(j*4 + l)*2 + q];
+          CPPUNIT_ASSERT_DOUBLES_EQUAL(y_ref, y_values[(i*2 + k)*2 + p],
+                                       1e-12);
+        }
+
+    // Check product with tensor product vector
+    std::vector<std::size_t> dims(n, n + 3);
+    TensorProductVector a(dims);
+    a.values() = values;
+    std::vector<std::size_t> row_dims(m, m + 3);
+    TensorProductVector b(row_dims);
+    A.mult(a, b);
+    for (std::size_t i = 0; i < 12; i++)
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(y_values[i], b[i], 1e-12);
+  }
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestTensorProductMatrix);
+
+int main()
+{
+  DOLFIN_TEST;
+}
@@ -18,9 +18,10 @@
 # along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 #
 # Modified by Anders Logg 2012
+# Modified by agent, 2026
 #
 # First added:  2012-02-21
-# Last changed: 2012-08-27
+# Last changed: 2026-10-16
 
 import unittest
 from dolfin import *
@@ -75,6 +76,99 @@ if has_linear_algebra_backend("PETSc"):
                 solver.solve(A, x_petsc, as_backend_type(b))
                 self.assertAlmostEqual(x_petsc.norm("l2"), direct_norm, 5)
 
+# CSR matrices cannot be distributed
+if MPI.num_processes() == 1:
+    class CSRKrylovSolverTester(unittest.TestCase):
+
+        def setUp(self):
+            self.backend = parameters["linear_algebra_backend"]
+
+        def tearDown(self):
+            parameters["linear_algebra_backend"] = self.backend
+
+        def _solve(self, a, L, bc, backend, method, prec,
+                   min_rows_per_level=256):
+            parameters["linear_algebra_backend"] = backend
+            A, b = assemble_system(a, L, bc)
+            x = b.copy()
+            x.zero()
+            solver = uBLASKrylovSolver(method, prec)
+            solver.parameters["relative_tolerance"] = 1e-12
+            solver.parameters["preconditioner"]["ilu"]["min_rows_per_level"] \
+                = min_rows_per_level
+            solver.solve(A, x, b)
+            return A, x
+
+        def test_csr_matrix(self):
+            "Test CSRMatrix against uBLAS sparse matrix"
+            A_csr, x = self._solve(a, L, bc, "CSR", "gmres", "none")
+            self.assertTrue(has_type(A_csr, CSRMatrix))
+            A_ublas, y = self._solve(a, L, bc, "uBLAS", "gmres", "none")
+            self.assertAlmostEqual(A_csr.norm("frobenius"),
+                                   A_ublas.norm("frobenius"), 10)
+            self.assertAlmostEqual(A_csr.norm("linf"), A_ublas.norm("linf"), 10)
+
+            # Matrix-vector product
+            z0 = A_csr*y
+            z1 = A_ublas*y
+            z0.axpy(-1.0, z1)
+            self.assertAlmostEqual(z0.norm("linf"), 0.0, 10)
+
+        def test_krylov_solver(self):
+            "Test uBLASKrylovSolver with CSRMatrix"
+            for method in ["gmres", "bicgstab"]:
+                for prec in ["none", "ilu"]:
+                    A, x = self._solve(a, L, bc, "CSR", method, prec)
+                    A, y = self._solve(a, L, bc, "uBLAS", method, prec)
+                    x.axpy(-1.0, y)
+                    self.assertAlmostEqual(x.norm("linf"), 0.0, 8)
+
+        def test_krylov_solver_blocked(self):
+            "Test uBLASKrylovSolver with blocked CSRMatrix"
+            W = VectorFunctionSpace(mesh, "CG", 1)
+            u, v = TrialFunction(W), TestFunction(W)
+            a_W = inner(grad(u), grad(v))*dx + inner(u, v)*dx
+            L_W = inner(Constant((1.0, 2.0)), v)*dx
+            bc_W = DirichletBC(W, Constant((0.0, 0.0)),
+                               lambda x, on_boundary: on_boundary)
+            for prec in ["none", "ilu"]:
+                A, x = self._solve(a_W, L_W, bc_W, "CSR", "gmres", prec)
+                A, y = self._solve(a_W, L_W, bc_W, "uBLAS", "gmres", prec)
+                x.axpy(-1.0, y)
+                self.assertAlmostEqual(x.norm("linf"), 0.0, 8)
+
+        def test_lu_solver_blocked(self):
+            "Test LU solver with blocked CSRMatrix"
+            W = VectorFunctionSpace(mesh, "CG", 1)
+            u, v = TrialFunction(W), TestFunction(W)
+            a_W = inner(grad(u), grad(v))*dx + inner(u, v)*dx
+            L_W = inner(Constant((1.0, 2.0)), v)*dx
+            bc_W = DirichletBC(W, Constant((0.0, 0.0)),
+                               lambda x, on_boundary: on_boundary)
+            parameters["linear_algebra_backend"] = "CSR"
+            if not has_lu_solver_method("umfpack"):
+                return
+            A, b = assemble_system(a_W, L_W, bc_W)
+            x = b.copy()
+            solve(A, x, b, "lu")
+            A, y = self._solve(a_W, L_W, bc_W, "uBLAS", "gmres", "ilu")
+            x.axpy(-1.0, y)
+            self.assertAlmostEqual(x.norm("linf"), 0.0, 8)
+
+        def test_threaded_ilu(self):
+            "Test level-scheduled ILU with multiple threads"
+            # The mesh is too small for levels of the default size, so
+            # lower the threshold to use the level-scheduled solves
+            num_threads = parameters["num_threads"]
+            A, x = self._solve(a, L, bc, "CSR", "gmres", "ilu", 1)
+            parameters["num_threads"] = 2
+            try:
+                A, y = self._solve(a, L, bc, "CSR", "gmres", "ilu", 1)
+            finally:
+                parameters["num_threads"] = num_threads
+            x.axpy(-1.0, y)
+            self.assertAlmostEqual(x.norm("linf"), 0.0, 8)
+
 if __name__ == "__main__":
 
     # Turn off DOLFIN output
@@ -21,9 +21,10 @@
 # Modified by Marie E. Rognes 2012
 # Modified by Johannes Ring 2013
 # Modified by Jan Blechta 2013
+# Modified by agent, 2026
 #
 # First added:  2006-08-08
-# Last changed: 2013-02-22
+# Last changed: 2026-10-16
 
 import unittest
 import numpy
@@ -379,6 +380,57 @@ if MPI.num_processes() == 1:
             self.assertAlmostEqual(self.mesh3d.radius_ratio_max(), 1.0)
 
 
+# This test does not work in parallel because the perturbation of
+# the mesh is not consistent across processes
+if MPI.num_processes() == 1:
+    class MeshSmoothingTest(unittest.TestCase):
+
+        def perturbed_mesh(self):
+            mesh = UnitSquareMesh(16, 16)
+            x = mesh.coordinates()
+            interior = (x[:, 0] > DOLFIN_EPS)*(x[:, 0] < 1.0 - DOLFIN_EPS)* \
+                       (x[:, 1] > DOLFIN_EPS)*(x[:, 1] < 1.0 - DOLFIN_EPS)
+            numpy.random.seed(1)
+            x[interior] += 0.02*(numpy.random.rand(interior.sum(), 2) - 0.5)
+            return mesh, interior
+
+        def test_smooth(self):
+            """Smooth perturbed mesh."""
+            mesh, interior = self.perturbed_mesh()
+            x0 = mesh.coordinates().copy()
+            q0 = mesh.radius_ratio_min()
+            mesh.smooth(20)
+            x = mesh.coordinates()
+            self.assertTrue((x[~interior] == x0[~interior]).all())
+            self.assertTrue(mesh.radius_ratio_min() > q0)
+
+        def test_smooth_quality_weighted(self):
+            """Smooth perturbed mesh with quality weighting."""
+            mesh, interior = self.perturbed_mesh()
+            q0 = mesh.radius_ratio_min()
+            mesh.smooth(20, True)
+            self.assertTrue(mesh.radius_ratio_min() > q0)
+
+        def test_smooth_threads(self):
+            """Smoothing is independent of the number of threads."""
+            mesh0, interior = self.perturbed_mesh()
+            mesh0.smooth(5)
+            num_threads = parameters["num_threads"]
+            parameters["num_threads"] = 4
+            try:
+                mesh1, interior = self.perturbed_mesh()
+                mesh1.smooth(5)
+            finally:
+                parameters["num_threads"] = num_threads
+            self.assertAlmostEqual(numpy.abs(mesh0.coordinates() -
+                                             mesh1.coordinates()).max(), 0.0)
+
+        def test_smooth_boundary(self):
+            """Smooth boundary of mesh."""
+            mesh = UnitCubeMesh(4, 4, 4)
+            mesh.smooth_boundary(3, False)
+            self.assertTrue(mesh.radius_ratio_min() > 0.0)
+
 class MeshOrientations(unittest.TestCase):
 
     def setUp(self):
@@ -20,7 +20,7 @@ interaction between Mesh - MeshDomains - MeshMarkers"""
 # along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 #
 # First added:  2011-09-01
-# Last changed: 2011-09-02
+# Last changed: 2026-10-16
 
 import unittest
 from dolfin import *
@@ -63,5 +63,40 @@ class XMLMesMarkers(unittest.TestCase):
         # FIXME: Add test here
         self.assertEqual(0, 0)
 
+    def test_subdomain_marking_vertex_checks(self):
+        "Test that each vertex is checked at most once per boundary flag"
+
+        if MPI.num_processes() > 1:
+            return
+
+        class Left(SubDomain):
+            def __init__(self):
+                SubDomain.__init__(self)
+                self.num_calls = 0
+            def inside(self, x, on_boundary):
+                self.num_calls += 1
+                return x[0] < 0.5 + DOLFIN_EPS
+        left = Left()
+
+        mesh = UnitCubeMesh(4, 4, 4)
+        cells = CellFunction("size_t", mesh, 0)
+        left.mark(cells, 1, False)
+        self.assertEqual(left.num_calls, mesh.num_vertices())
+        self.assertEqual(sum(cells.array() == 1), mesh.num_cells()/2)
+
+        # Compiled sub domains are checked by the batched inside()
+        compiled_left = compile_subdomains("x[0] < 0.5 + DOLFIN_EPS")
+        compiled_cells = CellFunction("size_t", mesh, 0)
+        compiled_left.mark(compiled_cells, 1)
+        self.assertTrue((cells.array() == compiled_cells.array()).all())
+
+        # Boundary facets
+        class Boundary(SubDomain):
+            def inside(self, x, on_boundary):
+                return on_boundary
+        facets = FacetFunction("size_t", mesh, 0)
+        Boundary().mark(facets, 1)
+        self.assertEqual(sum(facets.array() == 1), 6*2*4*4)
+
 if __name__ == "__main__":
     unittest.main()
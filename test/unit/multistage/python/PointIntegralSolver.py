@@ -18,7 +18,7 @@
 # along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 #
 # First added:  2013-02-20
-# Last changed: 2013-02-20
+# Last changed: 2026-10-16
 
 import unittest
 from dolfin import *
@@ -104,6 +104,60 @@ class PointIntegralSolverTest(unittest.TestCase):
 
             self.assertTrue(scheme.order()-min(convergence_order(u_errors))<0.1)
 
+    def test_multi_threaded_step(self):
+
+        for Scheme in [RK4, ESDIRK3]:
+
+            mesh = UnitSquareMesh(10, 10)
+            V = VectorFunctionSpace(mesh, "CG", 1, dim=2)
+            u = Function(V)
+            v = TestFunction(V)
+            form = inner(as_vector((-u[1], u[0])), v)*dP
+
+            scheme = Scheme(form, u)
+            solver = PointIntegralSolver(scheme)
+            solver.parameters.newton_solver.report = False
+
+            # Step serial and with two threads
+            results = []
+            for num_threads in [0, 2]:
+                parameters["num_threads"] = num_threads
+                u.interpolate(Constant((1.0, 0.0)))
+                solver.step_interval(0., 0.5, 0.05)
+                results.append(u.vector().array())
+            parameters["num_threads"] = 0
+
+            self.assertAlmostEqual(abs(results[0] - results[1]).max(), 0.0)
+
+    def test_multi_threaded_nonlinear_step(self):
+
+        mesh = UnitSquareMesh(10, 10)
+        V = VectorFunctionSpace(mesh, "CG", 1, dim=2)
+        u = Function(V)
+        v = TestFunction(V)
+        form = inner(as_vector((-u[0]**3 + u[1], -u[0] - u[1]**3)), v)*dP
+
+        scheme = ESDIRK3(form, u)
+        solver = PointIntegralSolver(scheme)
+        solver.parameters.newton_solver.report = False
+
+        # Step with different numbers of threads (threads retabulate
+        # the Jacobian for each vertex, so results must not depend on
+        # how vertices are scheduled on threads)
+        results = []
+        for num_threads in [0, 2, 3, 4]:
+            parameters["num_threads"] = num_threads
+            u.interpolate(Expression(("1.0 + x[0]", "x[1]*x[1]")))
+            solver.step_interval(0., 0.5, 0.05)
+            results.append(u.vector().array())
+        parameters["num_threads"] = 0
+
+        # Threaded results agree exactly and with serial results up to
+        # the Newton tolerance
+        for i in [2, 3]:
+            self.assertEqual(abs(results[1] - results[i]).max(), 0.0)
+        self.assertAlmostEqual(abs(results[0] - results[1]).max(), 0.0, 6)
+
 if __name__ == "__main__":
     print ""
     print "Testing PyDOLFIN PointIntegralSolver operations"
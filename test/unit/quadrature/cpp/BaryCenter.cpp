@@ -17,9 +17,10 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // Modified by Andre Massing, 2010
+// Modified by agent, 2026
 //
 // First added:  2010-04-01
-// Last changed: 2010-04-09
+// Last changed: 2026-10-16
 //
 // Author:  Andre Massing (am), massing@simula.no
 // Company:  Simula Research Laboratory, Fornebu, Norway
@@ -32,13 +33,82 @@
 #include <dolfin.h>
 #include <dolfin/common/unittest.h>
 
+using namespace dolfin;
+
+// Create tetrahedron or triangle
+std::vector<Point> simplex(const Point& p0, const Point& p1, const Point& p2)
+{
+  std::vector<Point> s;
+  s.push_back(p0);
+  s.push_back(p1);
+  s.push_back(p2);
+  return s;
+}
+
+std::vector<Point> simplex(const Point& p0, const Point& p1, const Point& p2,
+                           const Point& p3)
+{
+  std::vector<Point> s = simplex(p0, p1, p2);
+  s.push_back(p3);
+  return s;
+}
+
+// Check quadrature rule for intersection of simplices (in both orders)
+void check_intersection(const std::vector<Point>& s0,
+                        const std::vector<Point>& s1,
+                        double weight, const Point& point)
+{
+  BarycenterQuadrature q0(s0, s1);
+  BarycenterQuadrature q1(s1, s0);
+  CPPUNIT_ASSERT_EQUAL(weight > 0.0 ? 1 : 0, (int) q0.size());
+  CPPUNIT_ASSERT_EQUAL(weight > 0.0 ? 1 : 0, (int) q1.size());
+  if (weight > 0.0)
+  {
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(weight, q0.weights()[0], 1.0e-12);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(weight, q1.weights()[0], 1.0e-12);
+    CPPUNIT_ASSERT(point.distance(q0.points()[0]) < 1.0e-12);
+    CPPUNIT_ASSERT(point.distance(q1.points()[0]) < 1.0e-12);
+  }
+}
+
+// Test quadrature rules for intersections of tetrahedra and triangles
+void test_simplex_intersections()
+{
+  const Point e0(0.0, 0.0, 0.0);
+  const Point e1(1.0, 0.0, 0.0);
+  const Point e2(0.0, 1.0, 0.0);
+  const Point e3(0.0, 0.0, 1.0);
+  const Point d(0.5, 0.0, 0.0);
+  const std::vector<Point> tet = simplex(e0, e1, e2, e3);
+  const std::vector<Point> tri = simplex(e0, e1, e2);
+
+  // Tetrahedra
+  check_intersection(tet, tet, 1.0/6.0, Point(0.25, 0.25, 0.25));
+  check_intersection(tet, simplex(e0 + d, e1 + d, e2 + d, e3 + d),
+                     1.0/48.0, Point(0.625, 0.125, 0.125));
+  check_intersection(tet, simplex(e0 + e1, e1 + e1, e2 + e1, e3 + e1),
+                     0.0, Point());
+  check_intersection(tet, simplex(Point(0.2, 0.2, 0.2), Point(-1.0, 0.2, 0.2),
+                                  Point(0.2, -1.0, 0.2), Point(0.2, 0.2, -1.0)),
+                     0.008, Point(0.1, 0.1, 0.1));
+
+  // Triangle and tetrahedron
+  check_intersection(tri, tet, 0.5, Point(1.0/3.0, 1.0/3.0, 0.0));
+  const Point h(0.0, 0.0, 0.25);
+  check_intersection(simplex(e0 + h, e1 + h, e2 + h), tet,
+                     0.28125, Point(0.25, 0.25, 0.25));
+
+  // Triangles
+  check_intersection(tri, simplex(e0 + d, e1 + d, e2 + d),
+                     0.125, Point(2.0/3.0, 1.0/6.0, 0.0));
+  check_intersection(tri, simplex(e0 - e3, e1 + e3, e2 + e3), 0.0, Point());
+}
+
 #ifdef HAS_CGAL
 
 #include <CGAL/Nef_polyhedron_3.h>
 #include <CGAL/Polyhedron_3.h>
 
-using namespace dolfin;
-
 typedef Nef_polyhedron_3::Aff_transformation_3 Aff_transformation_3;
 typedef Nef_polyhedron_3::Plane_3 Plane_3;
 typedef Nef_polyhedron_3::Vector_3 Vector_3;
@@ -55,6 +125,59 @@ typedef std::vector<double>::const_iterator DoubleListIterator;
 typedef std::vector<Point> PointList;
 typedef std::vector<Point>::const_iterator PointListIterator;
 
+// Create CGAL polyhedron from tetrahedron or triangle
+Nef_polyhedron_3 make_polyhedron(const std::vector<Point>& s)
+{
+  Polyhedron_3 P;
+  if (s.size() == 4)
+  {
+    P.make_tetrahedron(Point_3(s[0].x(), s[0].y(), s[0].z()),
+                       Point_3(s[1].x(), s[1].y(), s[1].z()),
+                       Point_3(s[2].x(), s[2].y(), s[2].z()),
+                       Point_3(s[3].x(), s[3].y(), s[3].z()));
+  }
+  else
+  {
+    P.make_triangle(Point_3(s[0].x(), s[0].y(), s[0].z()),
+                    Point_3(s[1].x(), s[1].y(), s[1].z()),
+                    Point_3(s[2].x(), s[2].y(), s[2].z()));
+  }
+  return Nef_polyhedron_3(P);
+}
+
+// Check quadrature rule for intersection of nearly degenerate
+// simplices against the rule for the exact intersection (in both
+// orders), which is the result expected from the exact fallback
+void check_exact_intersection(const std::vector<Point>& s0,
+                              const std::vector<Point>& s1)
+{
+  const Nef_polyhedron_3 polyhedron
+    = make_polyhedron(s0)*make_polyhedron(s1);
+  double weight = 0.0;
+  Point point;
+  if (!polyhedron.is_empty())
+  {
+    BarycenterQuadrature q(polyhedron);
+    if (q.size() > 0 && q.weights()[0] > 0.0)
+    {
+      weight = q.weights()[0];
+      point = q.points()[0];
+    }
+  }
+
+  BarycenterQuadrature q0(s0, s1);
+  BarycenterQuadrature q1(s1, s0);
+  CPPUNIT_ASSERT_EQUAL(weight > 0.0 ? 1 : 0, (int) q0.size());
+  CPPUNIT_ASSERT_EQUAL(weight > 0.0 ? 1 : 0, (int) q1.size());
+  if (weight > 0.0)
+  {
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(weight, q0.weights()[0], 1.0e-12*weight);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(weight, q1.weights()[0], 1.0e-12*weight);
+    CPPUNIT_ASSERT(point.distance(q0.points()[0]) < 1.0e-12);
+    CPPUNIT_ASSERT(point.distance(q1.points()[0]) < 1.0e-12);
+  }
+}
+
 class BaryCenter : public CppUnit::TestFixture
 {
   CPPUNIT_TEST_SUITE(BaryCenter);
@@ -62,6 +185,8 @@ class BaryCenter : public CppUnit::TestFixture
   CPPUNIT_TEST(testSimplePolygons);
   CPPUNIT_TEST(testComplexPolyhedrons);
   CPPUNIT_TEST(testComplexPolygons);
+  CPPUNIT_TEST(testSimplexIntersections);
+  CPPUNIT_TEST(testDegenerateSimplexIntersections);
   CPPUNIT_TEST_SUITE_END();
 
 
@@ -602,16 +727,59 @@ class BaryCenter : public CppUnit::TestFixture
   {
   }
 
+  void testSimplexIntersections()
+  {
+    test_simplex_intersections();
+  }
+
+  void testDegenerateSimplexIntersections()
+  {
+    // Cases within the floating-point tolerance of the clipping
+    // planes, which must be decided in exact arithmetic
+    const Point e0(0.0, 0.0, 0.0);
+    const Point e1(1.0, 0.0, 0.0);
+    const Point e2(0.0, 1.0, 0.0);
+    const Point e3(0.0, 0.0, 1.0);
+    const std::vector<Point> tet = simplex(e0, e1, e2, e3);
+    const std::vector<Point> tri = simplex(e0, e1, e2);
+
+    // Tetrahedra overlapping in a sliver of thickness 1e-15 (facet
+    // x = 0 of tet lies 1e-15 inside the reflected tetrahedron)
+    const Point dx(1.0e-15, 0.0, 0.0);
+    check_exact_intersection(tet, simplex(e0 + dx, e2 + dx, e3 + dx,
+                                          dx - e1));
+
+    // Tetrahedra sharing facet x + y + z = 1, with one vertex of the
+    // reflected tetrahedron perturbed by 1e-15 across the facet plane
+    check_exact_intersection(tet, simplex(e1 - dx, e2, e3,
+                                          Point(2.0/3.0, 2.0/3.0, 2.0/3.0)));
+
+    // Triangles almost but not exactly coplanar
+    const Point d(0.5, 0.0, 0.0);
+    const Point dz(0.0, 0.0, 1.0e-15);
+    check_exact_intersection(tri, simplex(e0 + d, e1 + d, e2 + d + dz));
+    check_exact_intersection(simplex(e0, e1 + dz, e2), tri);
+  }
+
 };
 
 #else
 
-//No tests if CGAL is not available.
+//Only floating-point tests if CGAL is not available.
 
 class BaryCenter : public CppUnit::TestFixture
 {
   CPPUNIT_TEST_SUITE(BaryCenter);
+  CPPUNIT_TEST(testSimplexIntersections);
   CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void testSimplexIntersections()
+  {
+    test_simplex_intersections();
+  }
+
 };
 
 #endif
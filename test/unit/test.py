@@ -32,7 +32,7 @@ from dolfin import has_mpi, has_parmetis, has_scotch, has_linear_algebra_backend
 tests = {
     "ale":            ["HarmonicSmoothing"],
     "armadillo":      ["test"],
-    "adaptivity":     ["errorcontrol", "TimeSeries"],
+    "adaptivity":     ["errorcontrol", "marking", "TimeSeries"],
     "book":           ["chapter_1", "chapter_10"],
     "fem":            ["solving", "Assembler", "DirichletBC", "DofMap", \
                            "FiniteElement", "Form", "SystemAssembler",
@@ -43,10 +43,11 @@ tests = {
     "io":             ["vtk", "XMLMeshFunction", "XMLMesh", \
                            "XMLMeshValueCollection", "XMLVector", \
                            "XMLMeshData", "XMLLocalMeshData", \
-                           "XDMF", "HDF5", "Exodus"],
+                           "XDMF", "HDF5", "Exodus", "AsyncWriter"],
     "jit":            ["test"],
     "la":             ["test", "solve", "Matrix", "Scalar", "Vector", \
-                           "KrylovSolver", "LinearOperator"],
+                           "KrylovSolver", "LinearOperator", "SparsityPattern", \
+                           "TensorProductMatrix"],
     "nls":            ["PETScSNESSolver","TAOLinearBoundSolver"],
     "math":           ["test"],
     "meshconvert":    ["test"],